@@ -0,0 +1,203 @@
+#ifndef SOLIS_NBT_DOCUMENT_HPP
+#define SOLIS_NBT_DOCUMENT_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the NBT document model, whose nodes
+  are allocated in a per-document arena.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/nbt/reader.hpp"
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace solis::nbt {
+
+/**
+ * @brief Tag of an NBT document.
+ *
+ * The integral tags hold an int64_t, the floating ones a double. Every
+ * string, array and container of a node is allocated in the arena of its
+ * document. The entries of a compound keep their order.
+ */
+struct Node {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::pmr::vector<Node *> List;
+  typedef std::pair<std::pmr::string, Node *> Entry;
+  typedef std::pmr::vector<Entry> Compound;
+  typedef std::variant<std::monostate, int64_t, double, std::pmr::string,
+                       std::pmr::vector<int8_t>, std::pmr::vector<int32_t>,
+                       std::pmr::vector<int64_t>, List, Compound>
+      Payload;
+
+  TagType type{TagType::END};
+  TagType element_type{TagType::END}; /// Type of the elements of a list
+  Payload payload;
+
+  /*
+   ------------------------------ Value methods -------------------------------
+  */
+public:
+  inline int64_t as_int() const { return std::get<int64_t>(payload); }
+  inline double as_double() const { return std::get<double>(payload); }
+  inline std::string_view as_string() const {
+    return std::get<std::pmr::string>(payload);
+  }
+
+  template <typename T> inline std::pmr::vector<T> &array() {
+    return std::get<std::pmr::vector<T>>(payload);
+  }
+  template <typename T> inline const std::pmr::vector<T> &array() const {
+    return std::get<std::pmr::vector<T>>(payload);
+  }
+
+  inline List &list() { return std::get<List>(payload); }
+  inline const List &list() const { return std::get<List>(payload); }
+  inline Compound &compound() { return std::get<Compound>(payload); }
+  inline const Compound &compound() const {
+    return std::get<Compound>(payload);
+  }
+
+  /*
+   ---------------------------- Compound methods ------------------------------
+  */
+public:
+  /**
+   * @brief Get an entry of a compound.
+   * @return the entry value, nullptr if absent
+   */
+  Node *get(std::string_view key) const;
+
+  /**
+   * @brief Set an entry of a compound, replacing the previous value.
+   */
+  void set(std::string_view key, Node *value);
+
+  /**
+   * @brief Remove an entry of a compound.
+   * @return false if the entry was absent
+   */
+  bool remove(std::string_view key);
+};
+
+/**
+ * @brief NBT document, owning the arena of its nodes.
+ *
+ * The nodes, strings and arrays of a document are carved out of a monotonic
+ * buffer: building a tree costs a few large allocations, and destroying the
+ * document frees all of it at once, without visiting the nodes. The memory
+ * of replaced or removed nodes is only reclaimed with the document.
+ */
+struct Document {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::shared_ptr<Document> SharedPtr;
+
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  /**
+   * @brief Create a document with an empty root compound.
+   * @param initial_size the size of the first arena buffer
+   */
+  explicit Document(size_t initial_size = 16384);
+
+  Document(const Document &) = delete;
+  Document &operator=(const Document &) = delete;
+
+  static Document::SharedPtr make(size_t initial_size = 16384) {
+    return std::make_shared<Document>(initial_size);
+  }
+
+  /**
+   * @brief Parse a big-endian NBT buffer holding a named root compound.
+   */
+  static Document::SharedPtr parse(std::string_view nbt);
+
+  /*
+   ------------------------------ Node methods --------------------------------
+  */
+public:
+  /**
+   * @brief Allocate an empty node of the given type in the arena.
+   */
+  Node *make_node(TagType type);
+
+  Node *make_int(TagType type, int64_t value);
+  Node *make_double(TagType type, double value);
+  Node *make_string(std::string_view value);
+
+  /**
+   * @brief Allocate an empty list of the given element type.
+   */
+  Node *make_list(TagType element_type);
+
+  template <typename T> Node *make_array(const T *values, size_t count) {
+    Node *node = make_node(array_type<T>());
+    node->array<T>().assign(values, values + count);
+    return node;
+  }
+
+  inline Node &root() { return *root_node; }
+  inline const Node &root() const { return *root_node; }
+  inline std::string_view get_name() const { return name; }
+  inline void set_name(std::string_view n) { name = n; }
+
+  inline std::pmr::memory_resource *resource() { return &arena; }
+
+  /*
+   --------------------------- Serialize methods ------------------------------
+  */
+public:
+  /**
+   * @brief Append the document to a buffer, as big-endian NBT.
+   */
+  void serialize(std::string &out) const;
+
+  /**
+   * @brief Serialize the document, as big-endian NBT.
+   */
+  std::string serialize() const;
+
+  /*
+   ---------------------------- Internal methods ------------------------------
+  */
+protected:
+  template <typename T> static constexpr TagType array_type() {
+    static_assert(std::is_same<T, int8_t>::value ||
+                      std::is_same<T, int32_t>::value ||
+                      std::is_same<T, int64_t>::value,
+                  "NBT arrays hold int8_t, int32_t or int64_t");
+    return std::is_same<T, int8_t>::value    ? TagType::BYTE_ARRAY
+           : std::is_same<T, int32_t>::value ? TagType::INT_ARRAY
+                                             : TagType::LONG_ARRAY;
+  }
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  std::pmr::monotonic_buffer_resource arena;
+  std::pmr::string name;
+  Node *root_node;
+};
+
+} // namespace solis::nbt
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef SOLIS_NBT_QUERY_HPP
+#define SOLIS_NBT_QUERY_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the NBT path queries, extracting a few
+  values of an NBT buffer without decoding the whole tree.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/nbt/reader.hpp"
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace solis::nbt {
+
+/**
+ * @brief Value matched by a query: the type and the raw payload of a tag.
+ *
+ * The payload is a view on the queried buffer (still in big-endian), which
+ * should outlive it. Compounds and lists can be walked with reader().
+ */
+struct Value {
+  TagType type{TagType::END};
+  std::string_view payload;
+
+  /**
+   * @brief Get an integral value (BYTE, SHORT, INT or LONG).
+   */
+  int64_t as_int() const;
+
+  /**
+   * @brief Get a numeric value (FLOAT, DOUBLE or an integral type).
+   */
+  double as_double() const;
+
+  /**
+   * @brief Get a STRING value.
+   */
+  std::string_view as_string() const;
+
+  /**
+   * @brief Number of elements of an array or a list.
+   */
+  int32_t size() const;
+
+  /**
+   * @brief Reader over the payload.
+   */
+  inline Reader reader() const { return Reader(payload); }
+};
+
+/**
+ * @brief Set of compiled NBT paths, matched in a single pass over a buffer.
+ *
+ * A path is a list of compound keys separated by dots, each key followed by
+ * optional list selectors: "[]" for all the elements, "[n]" for the n-th one.
+ * For instance "Status", "Level.InhabitedTime" or
+ * "sections[].block_states.palette". Paths start in the root compound.
+ *
+ * Running a query does not allocate: the subtrees no path goes through are
+ * jumped over using their length prefixes, and the traversal stops as soon
+ * as every path without "[]" was matched, if all of them are.
+ */
+struct Query {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  /// Receiver of the matches: the index of the path and its value, called in
+  /// the order of the buffer (a value is given after its own matches)
+  typedef std::function<void(size_t, const Value &)> Sink;
+
+  /// Maximal number of paths of a query
+  static constexpr size_t MAX_PATHS{64};
+
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  Query() = default;
+  explicit Query(const std::vector<std::string> &paths);
+
+  /**
+   * @brief Compile and add a path.
+   * @return the index of the path
+   * @throw NBTError if the path has an empty component, an invalid selector
+   * or a list index above INT32_MAX
+   */
+  size_t add(std::string_view path);
+
+  inline size_t size() const { return paths.size(); }
+
+  /*
+   ------------------------------ Query methods -------------------------------
+  */
+public:
+  /**
+   * @brief Match the paths on an NBT buffer.
+   *
+   * @param nbt the buffer, holding a named root compound
+   * @param sink the receiver of the matches
+   */
+  void run(std::string_view nbt, const Sink &sink) const;
+
+  /**
+   * @brief Get the first value matching a single path.
+   *
+   * @param nbt the buffer, holding a named root compound
+   * @param path the path (compiled on each call)
+   * @return the value, nothing if no tag matches
+   */
+  static std::optional<Value> find(std::string_view nbt,
+                                   std::string_view path);
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  /// Token of a path: a compound key, or a list selector
+  struct Token {
+    static constexpr int32_t KEY{-2}; /// Compound key
+    static constexpr int32_t ALL{-1}; /// Every element of a list
+
+    int32_t index{KEY}; /// Selected list element, or KEY / ALL
+    std::string key;
+  };
+  struct Path {
+    std::vector<Token> tokens;
+    bool unique{true}; /// Whether it can only match once (no "[]")
+  };
+
+  std::vector<Path> paths;
+  uint64_t unique{0}; /// Mask of the paths matching at most once
+
+  friend struct QueryRun;
+};
+
+} // namespace solis::nbt
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef SOLIS_NBT_READER_HPP
+#define SOLIS_NBT_READER_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of a streaming reader for the binary
+  NBT format.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/utils/errors.hpp"
+#include "solis/utils/static.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace solis::nbt {
+
+/**
+ * @brief Type of an NBT tag.
+ */
+enum TagType : uint8_t {
+  END = 0,
+  BYTE = 1,
+  SHORT = 2,
+  INT = 3,
+  LONG = 4,
+  FLOAT = 5,
+  DOUBLE = 6,
+  BYTE_ARRAY = 7,
+  STRING = 8,
+  LIST = 9,
+  COMPOUND = 10,
+  INT_ARRAY = 11,
+  LONG_ARRAY = 12
+};
+
+/**
+ * @brief Streaming reader over a big-endian NBT buffer.
+ *
+ * The reader never allocates: strings and arrays are returned as views on the
+ * underlying buffer, which should outlive them. Any read past the end of the
+ * buffer raises an NBTError.
+ */
+struct Reader {
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  explicit Reader(const char *data, size_t size)
+      : begin(data), cursor(data), end(data + size) {}
+  explicit Reader(std::string_view data)
+      : Reader(data.data(), data.size()) {}
+
+  /*
+   ----------------------------- Scalar methods -------------------------------
+  */
+public:
+  /**
+   * @brief Read an integral value stored in big-endian.
+   */
+  template <typename T> inline T read() {
+    static_assert(std::is_integral<T>::value, "T should be integral");
+    require(sizeof(T));
+    T v;
+    std::memcpy(&v, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return FROM_BIG_ENDIAN(v);
+  }
+
+  inline float read_float() {
+    const uint32_t bits = read<uint32_t>();
+    float v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+  }
+
+  inline double read_double() {
+    const uint64_t bits = read<uint64_t>();
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+  }
+
+  inline TagType read_type() {
+    const uint8_t t = read<uint8_t>();
+    if (t > TagType::LONG_ARRAY)
+      throw NBTError(fmt::format("unknown tag type {} at {}", t, position()));
+    return static_cast<TagType>(t);
+  }
+
+  /**
+   * @brief Read a string (16-bit length prefixed, modified UTF-8).
+   */
+  inline std::string_view read_string() {
+    const uint16_t n = read<uint16_t>();
+    return view(n);
+  }
+
+  /**
+   * @brief Read the raw bytes of N elements of the given size, returning a
+   * view on them (still in big-endian).
+   */
+  inline std::string_view read_raw(size_t count, size_t element_size) {
+    if ((element_size != 0) && (count > remaining() / element_size))
+      throw NBTError(fmt::format("array of {} elements overflows at {}",
+                                 count, position()));
+    return view(count * element_size);
+  }
+
+  /*
+   ----------------------------- Tag methods ----------------------------------
+  */
+public:
+  /**
+   * @brief Read the header of a named tag (type and name).
+   *
+   * @param name the name of the tag (left untouched for END tags)
+   * @return the type of the tag
+   */
+  inline TagType read_header(std::string_view &name) {
+    const TagType t = read_type();
+    if (t != TagType::END)
+      name = read_string();
+    return t;
+  }
+
+  /**
+   * @brief Read the header of a list payload.
+   *
+   * @param count the number of elements of the list
+   * @return the type of the elements
+   * @throw NBTError if elements are announced without a type
+   */
+  inline TagType read_list_header(int32_t &count) {
+    const TagType t = read_type();
+    count = read<int32_t>();
+    if (count < 0)
+      count = 0;
+    if ((t == TagType::END) && (count > 0))
+      throw NBTError(fmt::format("list of {} elements without type at {}",
+                                 count, position()));
+    return t;
+  }
+
+  /**
+   * @brief Skip the payload of a tag of the given type, using the length
+   * prefixes to jump over arrays and strings.
+   */
+  void skip(TagType type);
+
+  /*
+   --------------------------- Properties methods -----------------------------
+  */
+public:
+  inline size_t position() const { return cursor - begin; }
+  inline size_t remaining() const { return end - cursor; }
+  inline bool eof() const { return cursor >= end; }
+  inline const char *data() const { return cursor; }
+
+  /*
+   ---------------------------- Internal methods ------------------------------
+  */
+protected:
+  inline void require(size_t n) const {
+    if (n > remaining())
+      throw NBTError(fmt::format("unexpected end of data at {} (+{})",
+                                 position(), n));
+  }
+
+  inline std::string_view view(size_t n) {
+    require(n);
+    std::string_view v(cursor, n);
+    cursor += n;
+    return v;
+  }
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  const char *begin, *cursor, *end;
+};
+
+} // namespace solis::nbt
+
+#endif
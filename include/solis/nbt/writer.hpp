@@ -0,0 +1,143 @@
+#ifndef SOLIS_NBT_WRITER_HPP
+#define SOLIS_NBT_WRITER_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of a streaming writer for the binary
+  NBT format.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/nbt/reader.hpp"
+#include <string>
+
+namespace solis::nbt {
+
+/**
+ * @brief Streaming writer appending big-endian NBT to a buffer.
+ *
+ * The writer does not check the structure of the written tags: each compound
+ * should be closed with write_end(), and each list should get the announced
+ * number of payloads.
+ */
+struct Writer {
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  explicit Writer(std::string &out) : out(out) {}
+
+  /*
+   ----------------------------- Scalar methods -------------------------------
+  */
+public:
+  /**
+   * @brief Write an integral value in big-endian.
+   */
+  template <typename T> inline void write(T v) {
+    static_assert(std::is_integral<T>::value, "T should be integral");
+    const T be = TO_BIG_ENDIAN<T>(v);
+    out.append(reinterpret_cast<const char *>(&be), sizeof(T));
+  }
+
+  inline void write_float(float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(v));
+    write(bits);
+  }
+
+  inline void write_double(double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(v));
+    write(bits);
+  }
+
+  inline void write_type(TagType t) { out.push_back(static_cast<char>(t)); }
+
+  /**
+   * @brief Write a string (16-bit length prefixed).
+   */
+  inline void write_string(std::string_view s) {
+    if (s.size() > UINT16_MAX)
+      throw NBTError(fmt::format("string of {} bytes is too long", s.size()));
+    write(static_cast<uint16_t>(s.size()));
+    out.append(s);
+  }
+
+  /**
+   * @brief Write raw bytes, already in big-endian.
+   */
+  inline void write_raw(std::string_view bytes) { out.append(bytes); }
+
+  /**
+   * @brief Write the payload of an array (count, then the big-endian values).
+   */
+  template <typename T> void write_array(const T *values, size_t count) {
+    static_assert(std::is_integral<T>::value, "T should be integral");
+    if (count > INT32_MAX)
+      throw NBTError(fmt::format("array of {} elements is too long", count));
+    write(static_cast<int32_t>(count));
+    const size_t start = out.size();
+    out.resize(start + count * sizeof(T));
+    char *dst = out.data() + start;
+    for (size_t i = 0; i < count; i++) {
+      const T be = TO_BIG_ENDIAN<T>(values[i]);
+      std::memcpy(dst + i * sizeof(T), &be, sizeof(T));
+    }
+  }
+
+  /**
+   * @brief Write the payload of a long array.
+   */
+  inline void write_long_array(const int64_t *values, size_t count) {
+    write_array(values, count);
+  }
+
+  /*
+   ----------------------------- Tag methods ----------------------------------
+  */
+public:
+  /**
+   * @brief Write the header of a named tag (type and name).
+   */
+  inline void write_header(TagType type, std::string_view name) {
+    write_type(type);
+    write_string(name);
+  }
+
+  /**
+   * @brief Write the header of a list payload.
+   */
+  inline void write_list_header(TagType type, int32_t count) {
+    write_type(type);
+    write(count);
+  }
+
+  /**
+   * @brief Close a compound.
+   */
+  inline void write_end() { write_type(TagType::END); }
+
+  /*
+   --------------------------- Properties methods -----------------------------
+  */
+public:
+  inline size_t size() const { return out.size(); }
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  std::string &out;
+};
+
+} // namespace solis::nbt
+
+#endif
@@ -14,15 +14,61 @@
   =============================================================================
 */
 
+#include "solis/utils/flags.hpp"
+#include <cstddef>
+#include <string_view>
+
 namespace solis {
 
 struct Block {
+  /*
+   ---------------------------------- Flags -----------------------------------
+  */
+  LFLAG(AIR, 1 << 0)         /// No block at all
+  LFLAG(SOLID, 1 << 1)       /// Blocks the motion of entities
+  LFLAG(TRANSPARENT, 1 << 2) /// Lets the light through
+  LFLAG(DIFFUSING, 1 << 3)   /// Absorbs a single light level
+  LFLAG(WATER, 1 << 4)       /// Holds water (waterlogged blocks included)
+  LFLAG(LAVA, 1 << 5)        /// Holds lava
+  LFLAG(WATERLOGGED, 1 << 6) /// Waterlogged block state
+  LFLAG(REPLACEABLE, 1 << 7) /// Replaced when placing a block in it
+  LFLAG(CLIMBABLE, 1 << 8)   /// Can be climbed (ladders, vines, ...)
+  LFLAG(HAZARD, 1 << 9)      /// Hurts the entities touching it
+  LFLAG(FALLING, 1 << 10)    /// Falls when not supported
+
+  /// Blocks holding a fluid
+  static constexpr FlagL_t LIQUID{WATER | LAVA};
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
   const char *package;
   const char *resource_name;
+  const char *properties; /// Block state ("key=value,..."), empty if none
+  FlagL_t flags;          /// Flags of the block state (see vanilla.hpp)
+
+  Block(const char *pkg, const char *name, const char *props = "");
+
+  /**
+   * @brief Flags of a block, air (nullptr) included.
+   */
+  static inline FlagL_t flags_of(const Block *block) {
+    return (block == nullptr) ? AIR : block->flags;
+  }
+
+  /**
+   * @brief Whether a block has every given flag.
+   */
+  static inline bool is(const Block *block, FlagL_t mask) {
+    return has_flag(flags_of(block), mask);
+  }
 
-  Block(const char *pkg, const char *name);
+  /**
+   * @brief Whether the block state contains a property ("key=value").
+   */
+  bool has_property(std::string_view property) const;
 };
 
 } // namespace solis
 
-#endif
\ No newline at end of file
+#endif
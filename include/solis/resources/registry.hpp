@@ -0,0 +1,121 @@
+#ifndef SOLIS_RESOURCES_REGISTRY_HPP
+#define SOLIS_RESOURCES_REGISTRY_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the block registry, interning the
+  block states met while loading worlds.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/resources/block.hpp"
+#include "solis/resources/vanilla.hpp"
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace solis {
+
+/**
+ * @brief Registry of the known block states.
+ *
+ * Block states are identified by their full name, with their properties
+ * sorted by key: "minecraft:oak_stairs[facing=north,half=top]". Each state is
+ * interned once, so that blocks can be compared by address. The registered
+ * blocks live as long as the registry. The registry can be used from several
+ * threads.
+ *
+ * The vanilla blocks are resolved through the compile-time table of
+ * vanilla.hpp: the ones without properties through an atomic slot per id,
+ * without locking, and their states through a map per id, keyed by their
+ * properties only.
+ */
+struct BlockRegistry {
+  /**
+   * @brief Registry shared by the whole library.
+   */
+  static BlockRegistry &global();
+
+  /**
+   * @brief Get (or register) the block state with the given full name.
+   *
+   * @param state the full name of the block state
+   * @return the interned block
+   */
+  const Block *get(std::string_view state);
+
+  /**
+   * @brief Get (or register) a block state from its name and properties.
+   *
+   * @param name the block name, with its package ("minecraft:stone")
+   * @param properties the properties ("key=value,...") sorted by key
+   * @return the interned block
+   */
+  const Block *get(std::string_view name, std::string_view properties);
+
+  /**
+   * @brief Get (or register) a vanilla block without properties.
+   * @param id the id of the block (see vanilla::find)
+   */
+  const Block *get(vanilla::BlockId id);
+
+  /**
+   * @brief Get (or register) a state of a vanilla block.
+   *
+   * @param id the id of the block (see vanilla::find)
+   * @param properties the properties ("key=value,...") sorted by key
+   */
+  const Block *get(vanilla::BlockId id, std::string_view properties);
+
+  /**
+   * @brief Get a registered block state without registering it.
+   * @return the block, nullptr if unknown
+   */
+  const Block *find(std::string_view state) const;
+
+  /**
+   * @brief Full name of a block state.
+   */
+  static std::string full_name(const Block &block);
+
+  /**
+   * @brief Number of registered block states.
+   */
+  size_t size() const;
+
+protected:
+  /**
+   * @brief Look up, or register, a block state in the runtime index.
+   */
+  const Block *intern(std::string_view state);
+
+  mutable std::shared_mutex mutex;
+  std::deque<std::string> strings; /// Storage of the blocks strings
+  std::deque<Block> blocks;        /// Storage of the blocks
+  std::unordered_map<std::string_view, const Block *> index;
+  std::array<std::atomic<const Block *>, vanilla::BLOCK_COUNT> vanilla_blocks{};
+
+  /// States with properties of a vanilla block, keyed by their properties
+  struct VanillaStates {
+    std::shared_mutex mutex;
+    std::unordered_map<std::string_view, const Block *> by_properties;
+  };
+  std::unique_ptr<VanillaStates[]> vanilla_states{
+      new VanillaStates[vanilla::BLOCK_COUNT]};
+};
+
+} // namespace solis
+
+#endif
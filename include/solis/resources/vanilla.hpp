@@ -0,0 +1,310 @@
+#ifndef SOLIS_RESOURCES_VANILLA_HPP
+#define SOLIS_RESOURCES_VANILLA_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the compile-time table of the vanilla block names, used
+  to resolve the palette entries without a runtime lookup, and their flags.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/resources/block.hpp"
+#include "solis/utils/static.hpp"
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+
+namespace solis::vanilla {
+
+typedef int32_t BlockId; /// Index of a block in BLOCK_NAMES, -1 if unknown
+
+/// Prefix of the vanilla block names
+constexpr std::string_view PREFIX{"minecraft:"};
+
+/// Names of the vanilla blocks with a dedicated id (the most common ones,
+/// the others go through the registry)
+constexpr std::string_view BLOCK_NAMES[]{
+    "air", "cave_air", "void_air", "stone", "granite", "polished_granite",
+    "diorite", "polished_diorite", "andesite", "polished_andesite", "deepslate",
+    "cobbled_deepslate", "polished_deepslate", "calcite", "tuff",
+    "dripstone_block", "grass_block", "dirt", "coarse_dirt", "podzol",
+    "rooted_dirt", "mud", "crimson_nylium", "warped_nylium", "cobblestone",
+    "oak_planks", "spruce_planks", "birch_planks", "jungle_planks",
+    "acacia_planks", "cherry_planks", "dark_oak_planks", "mangrove_planks",
+    "bamboo_planks", "crimson_planks", "warped_planks", "oak_sapling",
+    "spruce_sapling", "birch_sapling", "jungle_sapling", "acacia_sapling",
+    "cherry_sapling", "dark_oak_sapling", "mangrove_propagule", "bedrock",
+    "water", "lava", "sand", "suspicious_sand", "red_sand", "gravel",
+    "suspicious_gravel", "coal_ore", "deepslate_coal_ore", "iron_ore",
+    "deepslate_iron_ore", "copper_ore", "deepslate_copper_ore", "gold_ore",
+    "deepslate_gold_ore", "redstone_ore", "deepslate_redstone_ore",
+    "emerald_ore", "deepslate_emerald_ore", "lapis_ore", "deepslate_lapis_ore",
+    "diamond_ore", "deepslate_diamond_ore", "nether_gold_ore",
+    "nether_quartz_ore", "ancient_debris", "coal_block", "raw_iron_block",
+    "raw_copper_block", "raw_gold_block", "amethyst_block", "budding_amethyst",
+    "iron_block", "copper_block", "gold_block", "diamond_block",
+    "netherite_block", "emerald_block", "lapis_block", "redstone_block",
+    "oak_log", "spruce_log", "birch_log", "jungle_log", "acacia_log",
+    "cherry_log", "dark_oak_log", "mangrove_log", "mangrove_roots",
+    "muddy_mangrove_roots", "crimson_stem", "warped_stem", "stripped_oak_log",
+    "stripped_spruce_log", "stripped_birch_log", "stripped_jungle_log",
+    "stripped_acacia_log", "stripped_cherry_log", "stripped_dark_oak_log",
+    "stripped_mangrove_log", "oak_wood", "spruce_wood", "birch_wood",
+    "jungle_wood", "acacia_wood", "cherry_wood", "dark_oak_wood",
+    "mangrove_wood", "oak_leaves", "spruce_leaves", "birch_leaves",
+    "jungle_leaves", "acacia_leaves", "cherry_leaves", "dark_oak_leaves",
+    "mangrove_leaves", "azalea_leaves", "flowering_azalea_leaves", "sponge",
+    "wet_sponge", "glass", "tinted_glass", "sandstone", "chiseled_sandstone",
+    "cut_sandstone", "red_sandstone", "chiseled_red_sandstone",
+    "cut_red_sandstone", "cobweb", "short_grass", "grass", "fern", "dead_bush",
+    "seagrass", "tall_seagrass", "sea_pickle", "white_wool", "orange_wool",
+    "magenta_wool", "light_blue_wool", "yellow_wool", "lime_wool", "pink_wool",
+    "gray_wool", "light_gray_wool", "cyan_wool", "purple_wool", "blue_wool",
+    "brown_wool", "green_wool", "red_wool", "black_wool", "dandelion", "poppy",
+    "blue_orchid", "allium", "azure_bluet", "red_tulip", "orange_tulip",
+    "white_tulip", "pink_tulip", "oxeye_daisy", "cornflower",
+    "lily_of_the_valley", "wither_rose", "torchflower", "sunflower", "lilac",
+    "rose_bush", "peony", "tall_grass", "large_fern", "brown_mushroom",
+    "red_mushroom", "brown_mushroom_block", "red_mushroom_block",
+    "mushroom_stem", "bricks", "tnt", "bookshelf", "mossy_cobblestone",
+    "obsidian", "crying_obsidian", "torch", "wall_torch", "fire", "soul_fire",
+    "spawner", "chest", "trapped_chest", "ender_chest", "crafting_table",
+    "furnace", "blast_furnace", "smoker", "farmland", "wheat", "carrots",
+    "potatoes", "beetroots", "ladder", "rail", "powered_rail", "detector_rail",
+    "activator_rail", "snow", "snow_block", "ice", "packed_ice", "blue_ice",
+    "powder_snow", "cactus", "clay", "sugar_cane", "jukebox", "note_block",
+    "pumpkin", "carved_pumpkin", "jack_o_lantern", "melon", "melon_stem",
+    "pumpkin_stem", "attached_melon_stem", "attached_pumpkin_stem",
+    "netherrack", "soul_sand", "soul_soil", "basalt", "polished_basalt",
+    "smooth_basalt", "glowstone", "nether_portal", "end_portal",
+    "end_portal_frame", "end_gateway", "end_stone", "end_stone_bricks",
+    "dragon_egg", "stone_bricks", "mossy_stone_bricks", "cracked_stone_bricks",
+    "chiseled_stone_bricks", "deepslate_bricks", "deepslate_tiles",
+    "cracked_deepslate_bricks", "cracked_deepslate_tiles", "chiseled_deepslate",
+    "reinforced_deepslate", "infested_stone", "infested_deepslate",
+    "mud_bricks", "packed_mud", "iron_bars", "chain", "glass_pane", "vine",
+    "glow_lichen", "lily_pad", "nether_bricks", "red_nether_bricks",
+    "nether_wart", "nether_wart_block", "warped_wart_block", "shroomlight",
+    "enchanting_table", "brewing_stand", "cauldron", "water_cauldron",
+    "lava_cauldron", "powder_snow_cauldron", "redstone_lamp", "redstone_wire",
+    "redstone_torch", "redstone_wall_torch", "repeater", "comparator", "lever",
+    "stone_button", "stone_pressure_plate", "hopper", "dropper", "dispenser",
+    "observer", "piston", "sticky_piston", "piston_head", "moving_piston",
+    "slime_block", "honey_block", "honeycomb_block", "bee_nest", "beehive",
+    "beacon", "conduit", "anvil", "chipped_anvil", "damaged_anvil",
+    "quartz_block", "chiseled_quartz_block", "quartz_pillar", "quartz_bricks",
+    "smooth_quartz", "smooth_stone", "smooth_sandstone", "smooth_red_sandstone",
+    "prismarine", "prismarine_bricks", "dark_prismarine", "sea_lantern",
+    "hay_block", "terracotta", "white_terracotta", "orange_terracotta",
+    "yellow_terracotta", "red_terracotta", "brown_terracotta",
+    "light_gray_terracotta", "white_concrete", "gray_concrete",
+    "black_concrete", "white_concrete_powder", "magma_block", "bone_block",
+    "kelp", "kelp_plant", "bubble_column", "tube_coral_block",
+    "brain_coral_block", "bubble_coral_block", "fire_coral_block",
+    "horn_coral_block", "purpur_block", "purpur_pillar", "chorus_plant",
+    "chorus_flower", "end_rod", "sculk", "sculk_vein", "sculk_catalyst",
+    "sculk_shrieker", "sculk_sensor", "moss_block", "moss_carpet", "azalea",
+    "flowering_azalea", "big_dripleaf", "big_dripleaf_stem", "small_dripleaf",
+    "spore_blossom", "hanging_roots", "cave_vines", "cave_vines_plant",
+    "pointed_dripstone", "amethyst_cluster", "large_amethyst_bud",
+    "medium_amethyst_bud", "small_amethyst_bud", "lantern", "soul_lantern",
+    "soul_torch", "soul_wall_torch", "campfire", "soul_campfire",
+    "sweet_berry_bush", "bamboo", "bamboo_sapling", "scaffolding", "lectern",
+    "loom", "barrel", "composter", "grindstone", "stonecutter",
+    "smithing_table", "cartography_table", "fletching_table", "bell",
+    "lodestone", "respawn_anchor", "target", "blackstone", "gilded_blackstone",
+    "polished_blackstone", "polished_blackstone_bricks", "crimson_fungus",
+    "warped_fungus", "crimson_roots", "warped_roots", "nether_sprouts",
+    "weeping_vines", "weeping_vines_plant", "twisting_vines",
+    "twisting_vines_plant", "oxidized_copper", "weathered_copper",
+    "exposed_copper", "cut_copper", "frogspawn", "ochre_froglight",
+    "verdant_froglight", "pearlescent_froglight", "sniffer_egg",
+    "decorated_pot", "pink_petals", "cobblestone_wall", "stone_slab",
+    "cobblestone_stairs", "oak_stairs", "oak_slab", "oak_fence", "oak_door",
+    "oak_trapdoor", "oak_sign", "oak_wall_sign", "oak_fence_gate",
+    "spruce_fence", "spruce_stairs", "stone_brick_stairs",
+    "deepslate_tile_stairs", "white_bed", "red_bed", "light", "structure_void",
+    "barrier", "command_block", "structure_block", "jigsaw", "trial_spawner",
+    "vault", "heavy_core", "crafter"};
+
+constexpr std::size_t BLOCK_COUNT{std::size(BLOCK_NAMES)};
+
+/// Perfect hash table of the names, built while compiling
+inline constexpr PerfectHash<BLOCK_COUNT> BLOCK_TABLE{
+    make_perfect_hash(BLOCK_NAMES)};
+
+/**
+ * @brief Id of a vanilla block name, with or without its package ("stone"
+ * or "minecraft:stone"), without properties.
+ * @return the id, -1 if the block has none
+ */
+constexpr BlockId find(std::string_view name) {
+  if (name.substr(0, PREFIX.size()) == PREFIX)
+    name.remove_prefix(PREFIX.size());
+  return BLOCK_TABLE.find(name);
+}
+
+/**
+ * @brief Id of a vanilla block name, failing to compile in a constant
+ * expression if it has none.
+ */
+constexpr BlockId id(std::string_view name) {
+  const BlockId i = find(name);
+  if (i < 0)
+    throw "not a vanilla block name";
+  return i;
+}
+
+// ============================================================================
+//    Block flags
+// ============================================================================
+//
+//  The vanilla blocks with an id are solid and opaque, but the ones listed
+//  below. Every name of the lists is checked against BLOCK_NAMES while
+//  compiling.
+
+/// Blocks not blocking the motion of entities (as the MOTION_BLOCKING
+/// heightmap sees them)
+constexpr std::string_view NOT_SOLID_BLOCKS[]{
+    "air", "cave_air", "void_air", "oak_sapling", "spruce_sapling",
+    "birch_sapling", "jungle_sapling", "acacia_sapling", "cherry_sapling",
+    "dark_oak_sapling", "mangrove_propagule", "water", "lava", "cobweb",
+    "short_grass", "grass", "fern", "dead_bush", "seagrass", "tall_seagrass",
+    "sea_pickle", "dandelion", "poppy", "blue_orchid", "allium", "azure_bluet",
+    "red_tulip", "orange_tulip", "white_tulip", "pink_tulip", "oxeye_daisy",
+    "cornflower", "lily_of_the_valley", "wither_rose", "torchflower",
+    "sunflower", "lilac", "rose_bush", "peony", "tall_grass", "large_fern",
+    "brown_mushroom", "red_mushroom", "torch", "wall_torch", "fire",
+    "soul_fire", "wheat", "carrots", "potatoes", "beetroots", "ladder", "rail",
+    "powered_rail", "detector_rail", "activator_rail", "snow", "sugar_cane",
+    "melon_stem", "pumpkin_stem", "attached_melon_stem",
+    "attached_pumpkin_stem", "nether_portal", "end_portal", "end_gateway",
+    "vine", "glow_lichen", "lily_pad", "nether_wart", "redstone_wire",
+    "redstone_torch", "redstone_wall_torch", "repeater", "comparator", "lever",
+    "stone_button", "stone_pressure_plate", "kelp", "kelp_plant",
+    "bubble_column", "end_rod", "sculk_vein", "moss_carpet", "small_dripleaf",
+    "big_dripleaf_stem", "spore_blossom", "hanging_roots", "cave_vines",
+    "cave_vines_plant", "soul_torch", "soul_wall_torch", "sweet_berry_bush",
+    "bamboo_sapling", "scaffolding", "crimson_fungus", "warped_fungus",
+    "crimson_roots", "warped_roots", "nether_sprouts", "weeping_vines",
+    "weeping_vines_plant", "twisting_vines", "twisting_vines_plant",
+    "frogspawn", "pink_petals", "oak_sign", "oak_wall_sign", "light",
+    "structure_void"};
+
+/// Blocks letting the light through
+constexpr std::string_view TRANSPARENT_BLOCKS[]{
+    "air", "cave_air", "void_air", "oak_sapling", "spruce_sapling",
+    "birch_sapling", "jungle_sapling", "acacia_sapling", "cherry_sapling",
+    "dark_oak_sapling", "mangrove_propagule", "mangrove_roots", "glass",
+    "short_grass", "grass", "fern", "dead_bush", "sea_pickle", "dandelion",
+    "poppy", "blue_orchid", "allium", "azure_bluet", "red_tulip",
+    "orange_tulip", "white_tulip", "pink_tulip", "oxeye_daisy", "cornflower",
+    "lily_of_the_valley", "wither_rose", "torchflower", "sunflower", "lilac",
+    "rose_bush", "peony", "tall_grass", "large_fern", "brown_mushroom",
+    "red_mushroom", "torch", "wall_torch", "fire", "soul_fire", "spawner",
+    "chest", "trapped_chest", "ender_chest", "wheat", "carrots", "potatoes",
+    "beetroots", "ladder", "rail", "powered_rail", "detector_rail",
+    "activator_rail", "snow", "cactus", "sugar_cane", "melon_stem",
+    "pumpkin_stem", "attached_melon_stem", "attached_pumpkin_stem",
+    "nether_portal", "end_portal", "end_gateway", "dragon_egg", "iron_bars",
+    "chain", "glass_pane", "vine", "glow_lichen", "lily_pad", "nether_wart",
+    "enchanting_table", "brewing_stand", "cauldron", "water_cauldron",
+    "lava_cauldron", "powder_snow_cauldron", "redstone_wire", "redstone_torch",
+    "redstone_wall_torch", "repeater", "comparator", "lever", "stone_button",
+    "stone_pressure_plate", "hopper", "piston_head", "moving_piston", "beacon",
+    "conduit", "anvil", "chipped_anvil", "damaged_anvil", "chorus_plant",
+    "chorus_flower", "end_rod", "sculk_vein", "sculk_shrieker", "sculk_sensor",
+    "moss_carpet", "azalea", "flowering_azalea", "big_dripleaf",
+    "big_dripleaf_stem", "small_dripleaf", "spore_blossom", "hanging_roots",
+    "cave_vines", "cave_vines_plant", "pointed_dripstone", "amethyst_cluster",
+    "large_amethyst_bud", "medium_amethyst_bud", "small_amethyst_bud",
+    "lantern", "soul_lantern", "soul_torch", "soul_wall_torch", "campfire",
+    "soul_campfire", "sweet_berry_bush", "bamboo", "bamboo_sapling",
+    "scaffolding", "lectern", "grindstone", "stonecutter", "bell",
+    "crimson_fungus", "warped_fungus", "crimson_roots", "warped_roots",
+    "nether_sprouts", "weeping_vines", "weeping_vines_plant", "twisting_vines",
+    "twisting_vines_plant", "frogspawn", "sniffer_egg", "decorated_pot",
+    "pink_petals", "cobblestone_wall", "oak_fence", "oak_door", "oak_trapdoor",
+    "oak_sign", "oak_wall_sign", "oak_fence_gate", "spruce_fence", "white_bed",
+    "red_bed", "light", "structure_void", "barrier", "trial_spawner", "vault",
+    "heavy_core"};
+
+/// Blocks absorbing a single light level
+constexpr std::string_view DIFFUSING_BLOCKS[]{
+    "water", "cobweb", "oak_leaves", "spruce_leaves", "birch_leaves",
+    "jungle_leaves", "acacia_leaves", "cherry_leaves", "dark_oak_leaves",
+    "mangrove_leaves", "azalea_leaves", "flowering_azalea_leaves", "seagrass",
+    "tall_seagrass", "ice", "slime_block", "honey_block", "kelp", "kelp_plant",
+    "bubble_column"};
+
+/// Blocks holding water, whatever their state
+constexpr std::string_view WATER_BLOCKS[]{
+    "water", "seagrass", "tall_seagrass", "kelp", "kelp_plant",
+    "bubble_column"};
+
+/// Blocks which can be climbed
+constexpr std::string_view CLIMBABLE_BLOCKS[]{
+    "ladder", "vine", "scaffolding", "cave_vines", "cave_vines_plant",
+    "weeping_vines", "weeping_vines_plant", "twisting_vines",
+    "twisting_vines_plant"};
+
+/// Blocks replaced when placing a block in them
+constexpr std::string_view REPLACEABLE_BLOCKS[]{
+    "air", "cave_air", "void_air", "water", "lava", "short_grass", "grass",
+    "tall_grass", "fern", "large_fern", "dead_bush", "vine", "glow_lichen",
+    "snow", "seagrass", "tall_seagrass", "bubble_column", "fire", "soul_fire",
+    "crimson_roots", "warped_roots", "nether_sprouts", "hanging_roots",
+    "sculk_vein", "light", "structure_void"};
+
+/// Blocks hurting the entities touching them (when lit, for the campfires)
+constexpr std::string_view HAZARD_BLOCKS[]{
+    "lava", "fire", "soul_fire", "campfire", "soul_campfire", "magma_block",
+    "cactus", "sweet_berry_bush", "wither_rose", "powder_snow",
+    "pointed_dripstone"};
+
+/// Blocks falling when not supported
+constexpr std::string_view FALLING_BLOCKS[]{
+    "sand", "red_sand", "gravel", "suspicious_sand", "suspicious_gravel",
+    "anvil", "chipped_anvil", "damaged_anvil", "dragon_egg", "scaffolding",
+    "pointed_dripstone", "white_concrete_powder"};
+
+/**
+ * @brief Build the flags of the vanilla blocks, by id.
+ */
+constexpr std::array<FlagL_t, BLOCK_COUNT> make_block_flags() {
+  std::array<FlagL_t, BLOCK_COUNT> flags{};
+  for (auto &f : flags)
+    f = Block::SOLID;
+  auto apply = [&flags](const auto &names, FlagL_t set, FlagL_t clear) {
+    for (const std::string_view name : names)
+      flags[id(name)] = (flags[id(name)] & ~clear) | set;
+  };
+  apply(NOT_SOLID_BLOCKS, 0, Block::SOLID);
+  apply(TRANSPARENT_BLOCKS, Block::TRANSPARENT, 0);
+  apply(DIFFUSING_BLOCKS, Block::DIFFUSING, 0);
+  apply(WATER_BLOCKS, Block::WATER, 0);
+  apply(CLIMBABLE_BLOCKS, Block::CLIMBABLE, 0);
+  apply(REPLACEABLE_BLOCKS, Block::REPLACEABLE, 0);
+  apply(HAZARD_BLOCKS, Block::HAZARD, 0);
+  apply(FALLING_BLOCKS, Block::FALLING, 0);
+  flags[id("lava")] |= Block::LAVA;
+  for (const std::string_view air : {"air", "cave_air", "void_air"})
+    flags[id(air)] |= Block::AIR;
+  return flags;
+}
+
+/// Flags of the vanilla blocks, by id, without their state (waterlogging...)
+inline constexpr std::array<FlagL_t, BLOCK_COUNT> BLOCK_FLAGS{
+    make_block_flags()};
+
+} // namespace solis::vanilla
+
+#endif
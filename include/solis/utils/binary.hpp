@@ -0,0 +1,77 @@
+#ifndef SOLIS_UTILS_BINARY_HPP
+#define SOLIS_UTILS_BINARY_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains helpers for the binary files of solis (manifests,
+  indexes), written in the native byte order.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace solis {
+
+/**
+ * @brief Append the bytes of a trivially copyable value to a buffer.
+ */
+template <typename T> inline void append(std::string &out, const T &v) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  out.append(reinterpret_cast<const char *>(&v), sizeof(T));
+}
+
+/**
+ * @brief Append a string to a buffer, prefixed by its 16-bit length.
+ */
+inline void append_string(std::string &out, const std::string &s) {
+  append(out, static_cast<uint16_t>(s.size()));
+  out.append(s);
+}
+
+/**
+ * @brief Bounds-checked cursor over a buffer written with append.
+ */
+struct BinaryCursor {
+  const std::string &data;
+  size_t pos{0};
+
+  /**
+   * @brief Read a value.
+   * @return false if the buffer is too short
+   */
+  template <typename T> bool read(T &v) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (pos + sizeof(T) > data.size())
+      return false;
+    std::memcpy(&v, data.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+
+  /**
+   * @brief Read a string written by append_string.
+   * @return false if the buffer is too short
+   */
+  bool read_string(std::string &s) {
+    uint16_t n;
+    if (!read(n) || (pos + n > data.size()))
+      return false;
+    s.assign(data, pos, n);
+    pos += n;
+    return true;
+  }
+};
+
+} // namespace solis
+
+#endif
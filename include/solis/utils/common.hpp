@@ -14,11 +14,29 @@
   =============================================================================
 */
 
+#include <atomic>
+#include <memory>
+
 namespace solis {
 #define constchar constexpr const char *
 #define sconstchar static constchar
 #define sconstval static constexpr
 
+/**
+ * @brief Whether a pointer is the only owner of its object, which can then be
+ * modified in place (copy-on-write).
+ *
+ * The count is read relaxed, while the other owners drop the object with a
+ * release decrement: the acquire fence synchronizes with the last one, so
+ * that its reads of the object happen before the writes of the caller.
+ */
+template <typename T> inline bool is_sole_owner(const std::shared_ptr<T> &p) {
+  if (p.use_count() != 1)
+    return false;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return true;
+}
+
 } // namespace solis
 
 #endif
\ No newline at end of file
@@ -17,19 +17,66 @@
 #include "solis/utils/common.hpp"
 #include <exception>
 #include <fmt/format.h>
+#include <string>
 #include <zlib.h>
 
 namespace solis {
 
+/**
+ * @brief Base error type of the library, holding a formatted message.
+ */
+struct SolisError : std::exception {
+  explicit SolisError(const std::string &message) : msg(message) {}
+  const char *what() const noexcept override { return msg.c_str(); }
 
+protected:
+  std::string msg;
+};
 
 // ----------------------------------------------------------------------------
 
+/**
+ * @brief Error raised when a file that should be read does not exist.
+ */
+struct FileNotFoundError : SolisError {
+  explicit FileNotFoundError(const char *path)
+      : SolisError(fmt::format("File not found: \"{}\"", path)) {}
+};
 
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Error raised when reading or writing a file failed.
+ */
+struct FileIOError : SolisError {
+  explicit FileIOError() : SolisError("File I/O error") {}
+  explicit FileIOError(const std::string &reason)
+      : SolisError(fmt::format("File I/O error: {}", reason)) {}
+};
 
 // ----------------------------------------------------------------------------
 
+/**
+ * @brief Error raised by the ZLib library.
+ */
+struct ZLibError : SolisError {
+  explicit ZLibError(int code, const char *zmsg)
+      : SolisError(fmt::format("ZLib error {} ({}): {}", code, zError(code),
+                               (zmsg != nullptr) ? zmsg : "")),
+        code(code) {}
+
+  const int code; /// ZLib return code
+};
 
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Error raised when decoding malformed NBT data.
+ */
+struct NBTError : SolisError {
+  explicit NBTError(const std::string &reason)
+      : SolisError(fmt::format("Malformed NBT: {}", reason)) {}
+};
 
 // ----------------------------------------------------------------------------
 
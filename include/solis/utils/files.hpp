@@ -0,0 +1,58 @@
+#ifndef SOLIS_UTILS_FILES_HPP
+#define SOLIS_UTILS_FILES_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains helpers for file manipulation.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include <cstdint>
+#include <string>
+
+namespace solis {
+
+/**
+ * @brief Modification time and size of a file, to cheaply detect changes.
+ */
+struct FileStamp {
+  int64_t mtime{0}; /// Modification time (in nanoseconds)
+  uint64_t size{0}; /// Size (in bytes)
+
+  inline bool operator==(const FileStamp &o) const {
+    return (mtime == o.mtime) && (size == o.size);
+  }
+  inline bool operator!=(const FileStamp &o) const { return !(*this == o); }
+
+  /**
+   * @brief Get the stamp of a file.
+   *
+   * @param path the path of the file
+   * @return the stamp of the file
+   */
+  static FileStamp of(const std::string &path);
+};
+
+/**
+ * @brief Write a whole file, replacing the previous one atomically.
+ *
+ * The content goes to a unique temporary file of the same directory, which
+ * is synced then renamed over the file, and the directory is synced: after a
+ * crash, the file is either the previous one or the new one, complete.
+ *
+ * @param path the path of the file
+ * @param content the content of the file
+ * @throw FileIOError if the file cannot be written
+ */
+void write_file_atomic(const std::string &path, const std::string &content);
+
+} // namespace solis
+
+#endif
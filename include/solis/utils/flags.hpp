@@ -40,6 +40,7 @@ typedef TFlag<FlagL_t> LongFlag;
 
 #define CFLAG(name, value) static constexpr solis::FlagC_t name = value;
 #define FLAG(name, value) static constexpr solis::Flag name = value;
+#define LFLAG(name, value) static constexpr solis::FlagL_t name = value;
 
 // ============================================================================
 // Flag operations
@@ -59,7 +60,7 @@ constexpr bool has_flag(const TFlag<T> v, const TFlag<T> flag) {
 template <typename T>
 constexpr TFlag<T> operator|(const TFlag<T> &f1, const TFlag<T> &f2) {
   static_assert(std::is_integral<T>::value, "Flag type should be integral !");
-  return solis::Flag{static_cast<T>(f1.flag | f2.flag)};
+  return TFlag<T>{static_cast<T>(f1.flag | f2.flag)};
 }
 
 } // namespace solis
@@ -67,6 +67,123 @@ template <std::string_view const &...Cs> struct concat {
 template <std::string_view const &...Cs>
 static constexpr auto concat_v = concat<Cs...>::value;
 
+// ============================================================================
+//    Compile-time perfect hashing
+// ============================================================================
+
+/**
+ * @brief FNV-1a hash of a string, usable at compile time.
+ */
+constexpr uint64_t fnv1a(std::string_view s) {
+  uint64_t h = 0xcbf29ce484222325;
+  for (char c : s) {
+    h ^= static_cast<uint8_t>(c);
+    h *= 0x100000001b3;
+  }
+  return h;
+}
+
+constexpr std::size_t next_pow2(std::size_t n) {
+  std::size_t p = 1;
+  while (p < n)
+    p <<= 1;
+  return p;
+}
+
+/**
+ * @brief Perfect hash table of a fixed set of strings, built at compile time
+ * ("hash and displace").
+ *
+ * The keys are spread in buckets by their hash, then each bucket gets the
+ * smallest displacement sending all its keys to free slots. A lookup costs a
+ * single hash of the key and a single comparison with the candidate key.
+ *
+ * @tparam N the number of keys (at most 32768)
+ */
+template <std::size_t N> struct PerfectHash {
+  static constexpr std::size_t SLOTS{next_pow2(N) * 2};
+  static constexpr std::size_t BUCKETS{next_pow2(N) / 2 + 1};
+  static constexpr uint16_t EMPTY{0xffff};
+  static_assert(N <= 32768, "Too many keys for a perfect hash table");
+
+  std::array<std::string_view, N> keys{};
+  std::array<uint16_t, BUCKETS> displacements{};
+  std::array<uint16_t, SLOTS> slots{};
+
+  static constexpr std::size_t bucket(uint64_t h) { return h % BUCKETS; }
+  static constexpr std::size_t slot(uint64_t h, uint16_t d) {
+    // The step is odd, so the displacements go through every slot
+    return ((h >> 32) + d * ((h & 0xffffffff) | 1)) & (SLOTS - 1);
+  }
+
+  /**
+   * @brief Index of a key, -1 if it is not in the table.
+   */
+  constexpr int32_t find(std::string_view key) const {
+    const uint64_t h = fnv1a(key);
+    const uint16_t i = slots[slot(h, displacements[bucket(h)])];
+    return ((i != EMPTY) && (keys[i] == key)) ? i : -1;
+  }
+
+  inline constexpr std::size_t size() const { return N; }
+};
+
+/**
+ * @brief Build the perfect hash table of a set of distinct strings. Fails to
+ * compile if the keys hold a duplicate.
+ */
+template <std::size_t N>
+constexpr PerfectHash<N> make_perfect_hash(const std::string_view (&keys)[N]) {
+  typedef PerfectHash<N> PH;
+  PH out{};
+  for (std::size_t k = 0; k < N; k++)
+    out.keys[k] = keys[k];
+  for (auto &s : out.slots)
+    s = PH::EMPTY;
+
+  std::array<uint64_t, N> hashes{};
+  std::array<uint16_t, PH::BUCKETS> sizes{};
+  std::size_t largest = 0;
+  for (std::size_t k = 0; k < N; k++) {
+    hashes[k] = fnv1a(keys[k]);
+    const std::size_t b = PH::bucket(hashes[k]);
+    if (++sizes[b] > largest)
+      largest = sizes[b];
+  }
+
+  // Place the largest buckets first, while most slots are free
+  std::array<uint16_t, N> members{};
+  for (std::size_t size = largest; size > 0; size--) {
+    for (std::size_t b = 0; b < PH::BUCKETS; b++) {
+      if (sizes[b] != size)
+        continue;
+      std::size_t count = 0;
+      for (std::size_t k = 0; k < N; k++)
+        if (PH::bucket(hashes[k]) == b)
+          members[count++] = static_cast<uint16_t>(k);
+
+      for (uint32_t d = 0;; d++) {
+        if (d >= PH::SLOTS)
+          throw "no displacement found for a bucket (duplicate key?)";
+        std::size_t placed = 0;
+        while ((placed < count) &&
+               (out.slots[PH::slot(hashes[members[placed]], d)] ==
+                PH::EMPTY)) {
+          out.slots[PH::slot(hashes[members[placed]], d)] = members[placed];
+          placed++;
+        }
+        if (placed == count) {
+          out.displacements[b] = static_cast<uint16_t>(d);
+          break;
+        }
+        for (std::size_t m = 0; m < placed; m++)
+          out.slots[PH::slot(hashes[members[m]], d)] = PH::EMPTY;
+      }
+    }
+  }
+  return out;
+}
+
 // ============================================================================
 //    Unsigned <-> Signed conversions
 // ============================================================================
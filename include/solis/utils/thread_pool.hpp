@@ -0,0 +1,98 @@
+#ifndef SOLIS_UTILS_THREAD_POOL_HPP
+#define SOLIS_UTILS_THREAD_POOL_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains a minimal worker pool for the bulk world operations.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace solis {
+
+/**
+ * @brief Fixed-size pool of worker threads consuming a FIFO of tasks.
+ *
+ * Tasks may submit other tasks. The first exception thrown by a task is kept
+ * and rethrown by wait(), the remaining tasks still being run.
+ */
+struct ThreadPool {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::function<void()> Task;
+
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  /**
+   * @brief Start the workers.
+   * @param threads the number of workers (0 for the hardware concurrency)
+   */
+  explicit ThreadPool(size_t threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /*
+   ------------------------------- Task methods -------------------------------
+  */
+public:
+  /**
+   * @brief Queue a task.
+   */
+  void submit(Task task);
+
+  /**
+   * @brief Wait until every queued task (and the ones they submitted) ran.
+   *
+   * @throw the first exception thrown by a task
+   */
+  void wait();
+
+  /**
+   * @brief Run fn(i) for i in [0, n) on the workers, and wait for them.
+   *
+   * The range is split in contiguous chunks of grain indices.
+   */
+  void parallel_for(size_t n, const std::function<void(size_t)> &fn,
+                    size_t grain = 1);
+
+  inline size_t size() const { return workers.size(); }
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  void run();
+
+  std::vector<std::thread> workers;
+  std::deque<Task> tasks;
+  std::mutex mutex;
+  std::condition_variable task_cv; /// A task was queued (or stopping)
+  std::condition_variable idle_cv; /// Every task ran
+  size_t pending{0};               /// Queued or running tasks
+  bool stopping{false};
+  std::exception_ptr error;
+};
+
+} // namespace solis
+
+#endif
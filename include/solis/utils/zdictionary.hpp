@@ -0,0 +1,106 @@
+#ifndef SOLIS_UTILS_ZDICTIONARY_HPP
+#define SOLIS_UTILS_ZDICTIONARY_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the preset dictionaries of the ZLib
+  wrapper, and of their training from sample data.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace solis {
+
+/**
+ * @brief Preset dictionary for the zlib and raw deflate formats.
+ *
+ * A dictionary primes the compression window with content expected in the
+ * data, which mostly benefits small payloads. The zlib format stores the ID
+ * of the dictionary (its Adler-32 checksum) so that a payload cannot be
+ * decoded with another one.
+ */
+struct ZDictionary {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::shared_ptr<const ZDictionary> SharedPtr;
+
+  /// Largest useful dictionary (the deflate window)
+  static constexpr size_t MAX_SIZE{32768};
+
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  /**
+   * @param data the content of the dictionary (only its last MAX_SIZE bytes
+   * are kept)
+   * @throw SolisError if the content is empty
+   */
+  explicit ZDictionary(std::string data);
+
+  static ZDictionary::SharedPtr make(std::string data) {
+    return std::make_shared<const ZDictionary>(std::move(data));
+  }
+
+  /**
+   * @brief Load a dictionary file.
+   * @param path the path of the file (raw dictionary content)
+   */
+  static ZDictionary::SharedPtr load(const std::string &path);
+
+  /**
+   * @brief Save the dictionary, replacing the file atomically.
+   */
+  void save(const std::string &path) const;
+
+  /*
+   -------------------------------- Training ----------------------------------
+  */
+public:
+  /**
+   * @brief Build a dictionary from sample data.
+   *
+   * The segments shared by the most samples are kept, the most common ones
+   * at the end of the dictionary where they are the cheapest to reference.
+   *
+   * @param samples the sample data
+   * @param size the maximal size of the dictionary
+   * @param segment the length of the compared segments
+   * @return the dictionary
+   * @throw SolisError if no segment is shared by two samples (e.g. no sample)
+   */
+  static ZDictionary::SharedPtr train(const std::vector<std::string> &samples,
+                                      size_t size = MAX_SIZE,
+                                      uint8_t segment = 16);
+
+  /*
+   ------------------------------- Properties ---------------------------------
+  */
+public:
+  inline const std::string &get_data() const { return data; }
+
+  /**
+   * @brief ID of the dictionary, as stored in the zlib streams.
+   */
+  inline uint32_t get_id() const { return id; }
+
+protected:
+  std::string data;
+  uint32_t id;
+};
+
+} // namespace solis
+
+#endif
@@ -17,6 +17,7 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 #if defined(_WIN32) && !defined(_CRT_NONSTDC_NO_DEPRECATE)
 #define _CRT_NONSTDC_NO_DEPRECATE
@@ -148,13 +149,15 @@ public:
    * @brief Decode a string content and export it to a string object.
    *
    * @param in the compressed string
+   * @param dictionary the preset dictionary used to compress it (if any)
    * @return a string object containing the decoded bytes
    */
   static std::string decodeFromString(const std::string &in,
-                                      int8_t format = FORMAT_GZIP) {
+                                      int8_t format = FORMAT_GZIP,
+                                      std::string_view dictionary = {}) {
     auto input = ZSStream::make(in);
     auto output = ZSStream::make();
-    uncompress(input, output, format);
+    uncompress(input, output, format, dictionary);
     return output->str();
   }
   /**
@@ -205,14 +208,16 @@ public:
    * @brief Encode a string content and export it to a string object.
    *
    * @param in the uncompressed string
+   * @param dictionary a preset dictionary (not supported by FORMAT_GZIP)
    * @return a string object containing the encoded bytes
    */
   static std::string encodeFromString(const std::string &in,
                                       unsigned char level = 6,
-                                      int8_t format = FORMAT_GZIP) {
+                                      int8_t format = FORMAT_GZIP,
+                                      std::string_view dictionary = {}) {
     auto input = ZSStream::make(in);
     auto output = ZSStream::make();
-    compress(input, output, level, format);
+    compress(input, output, level, format, dictionary);
     return output->str();
   }
   /**
@@ -254,11 +259,13 @@ protected:
 
   static void uncompress(const ZStream::SharedPtr &s1,
                          const ZStream::SharedPtr &s2,
-                         int8_t format = FORMAT_GZIP);
+                         int8_t format = FORMAT_GZIP,
+                         std::string_view dictionary = {});
 
   static void compress(const ZStream::SharedPtr &s1,
                        const ZStream::SharedPtr &s2, unsigned char level = 6,
-                       int8_t format = FORMAT_GZIP);
+                       int8_t format = FORMAT_GZIP,
+                       std::string_view dictionary = {});
 };
 
 } // namespace solis
@@ -0,0 +1,200 @@
+#ifndef SOLIS_WORLD_ANVIL_HPP
+#define SOLIS_WORLD_ANVIL_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the decoder of the Anvil chunk format, turning the NBT
+  chunks stored in region files into format-agnostic chunks.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/resources/registry.hpp"
+#include "solis/utils/zdictionary.hpp"
+#include "solis/world/chunk.hpp"
+#include "solis/world/region_file.hpp"
+#include "solis/world/section_pool.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace solis::world {
+
+/**
+ * @brief Options of the Anvil encoder.
+ */
+struct AnvilWriteOptions {
+  int32_t data_version{3465};                 /// Data version (1.20.1)
+  SectionIndex min_section{-4};               /// Lowest section (if no yPos)
+  SectionIndex max_section{19};               /// Highest section of the world
+  uint8_t compression{CompressionType::ZLIB}; /// Payload compression
+};
+
+/**
+ * @brief Options of the Anvil decoder.
+ */
+struct AnvilReadOptions {
+  /// Keep the NBT as the source of the chunk (see Chunk::get_source), which
+  /// costs its size per chunk. Without it, the savers patch the chunk stored
+  /// in the region file instead.
+  bool keep_source{false};
+};
+
+/**
+ * @brief Codec of the Anvil chunk format.
+ *
+ * Both the 1.18+ layout (root "sections" with "block_states") and the older
+ * one ("Level" compound with "Sections", "Palette" and "BlockStates") are
+ * supported. Air is decoded as null blocks, and all-air sections are dropped.
+ * The decoded chunks may keep their NBT as their source (see
+ * AnvilReadOptions::keep_source).
+ */
+struct Anvil {
+  /// First data version whose block indices do not span across longs (1.16)
+  static constexpr int32_t DATA_VERSION_NO_SPAN{2527};
+  /// First data version whose world goes below Y=0 (1.18)
+  static constexpr int32_t DATA_VERSION_NEGATIVE_Y{2860};
+  /// Minimal number of bits per block index
+  static constexpr uint8_t MIN_BITS{4};
+  /// Name of the air block
+  static constexpr std::string_view AIR{"minecraft:air"};
+
+  // ==========================================================================
+  // Decode instructions
+  // ==========================================================================
+public:
+  /**
+   * @brief Decompress a chunk payload read from a region file.
+   *
+   * @param payload the compressed payload
+   * @param dictionary the preset dictionary of ZLIB_DICT payloads
+   * @return the chunk NBT
+   */
+  static std::string inflate(const ChunkPayload &payload,
+                             const ZDictionary *dictionary = nullptr);
+
+  /**
+   * @brief Decode a chunk NBT.
+   *
+   * @param nbt the uncompressed chunk NBT
+   * @param registry the registry interning the block states
+   * @param pool the pool sharing the identical sections (none if nullptr)
+   * @param options the decoder options
+   * @return the decoded chunk
+   */
+  static Chunk::SharedPtr decode(std::string_view nbt,
+                                 BlockRegistry &registry =
+                                     BlockRegistry::global(),
+                                 SectionPool *pool = nullptr,
+                                 const AnvilReadOptions &options =
+                                     AnvilReadOptions());
+
+  /**
+   * @brief Read and decode a chunk from a region file.
+   *
+   * @param file the region file
+   * @param index the index of the chunk in the region
+   * @param registry the registry interning the block states
+   * @param pool the pool sharing the identical sections (none if nullptr)
+   * @param options the decoder options
+   * @return the decoded chunk, nullptr if absent
+   */
+  static Chunk::SharedPtr read(const RegionFile &file, uint16_t index,
+                               BlockRegistry &registry =
+                                   BlockRegistry::global(),
+                               SectionPool *pool = nullptr,
+                               const AnvilReadOptions &options =
+                                   AnvilReadOptions());
+
+  /**
+   * @brief Number of bits per block index for a palette size.
+   */
+  static uint8_t bits_for(size_t palette_size);
+
+  /**
+   * @brief Unpack the block indices of a section.
+   *
+   * @param data the packed longs, in big-endian
+   * @param bits the number of bits per index
+   * @param span whether indices can span across two longs (before 1.16)
+   * @param out the unpacked indices
+   */
+  static void unpack(std::string_view data, uint8_t bits, bool span,
+                     Section::Indices &out);
+
+  /**
+   * @brief Unpack a given number of values.
+   *
+   * @param data the packed longs, in big-endian
+   * @param bits the number of bits per value
+   * @param span whether values can span across two longs (before 1.16)
+   * @param count the number of values
+   * @param out the unpacked values
+   */
+  static void unpack(std::string_view data, uint8_t bits, bool span,
+                     size_t count, uint16_t *out);
+
+  /**
+   * @brief Pack values in longs, without spanning (1.16+).
+   *
+   * @param values the values to pack
+   * @param count the number of values
+   * @param bits the number of bits per value
+   * @return the packed longs
+   */
+  static std::vector<int64_t> pack(const uint16_t *values, size_t count,
+                                   uint8_t bits);
+
+  // ==========================================================================
+  // Encode instructions
+  // ==========================================================================
+public:
+  /**
+   * @brief Encode a chunk in the 1.18+ layout.
+   *
+   * A chunk which kept the NBT it was decoded from as its source (see
+   * AnvilReadOptions::keep_source) is patched: only the block states and the
+   * light of its sections, its heightmaps and its coordinates are replaced,
+   * every other tag (entities, block entities, biomes, generation state...)
+   * is kept. A chunk without source is written from the data it holds only,
+   * as a full chunk.
+   *
+   * @param chunk the chunk
+   * @param options the encoder options
+   * @return the uncompressed chunk NBT
+   * @throw SolisError if the source is in the layout older than 1.18
+   */
+  static std::string encode(const Chunk &chunk,
+                            const AnvilWriteOptions &options =
+                                AnvilWriteOptions());
+
+  /**
+   * @brief Encode and compress a chunk into a region file payload.
+   */
+  static ChunkPayload deflate(const Chunk &chunk,
+                              const AnvilWriteOptions &options =
+                                  AnvilWriteOptions());
+
+  /**
+   * @brief Compress a chunk NBT into a region file payload.
+   *
+   * @param nbt the uncompressed chunk NBT
+   * @param compression the compression type
+   * @param level the compression level (zlib levels)
+   * @param dictionary the preset dictionary of ZLIB_DICT payloads
+   * @return the compressed payload
+   */
+  static ChunkPayload compress(const std::string &nbt, uint8_t compression,
+                               uint8_t level = 6,
+                               const ZDictionary *dictionary = nullptr);
+};
+
+} // namespace solis::world
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef SOLIS_WORLD_BLOCK_INDEX_HPP
+#define SOLIS_WORLD_BLOCK_INDEX_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the block index, an inverted index
+  from the block states to the sections whose palette holds them.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/resources/registry.hpp"
+#include "solis/world/chunk.hpp"
+#include "solis/world/manifest.hpp"
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace solis::world {
+
+/**
+ * @brief Section of a dimension: the coordinates of its chunk and its Y-index.
+ */
+struct SectionKey {
+  ChunkCoordinate coord;
+  SectionIndex y{0};
+
+  inline bool operator<(const SectionKey &o) const {
+    if (coord.x != o.coord.x)
+      return coord.x < o.coord.x;
+    if (coord.z != o.coord.z)
+      return coord.z < o.coord.z;
+    return y < o.y;
+  }
+};
+
+/**
+ * @brief Inverted index of the block states of a dimension.
+ *
+ * Each indexed chunk records the palettes of its sections, and each block
+ * state the sections whose palette holds it. Palettes may keep entries which
+ * are no longer used, so the sections of a lookup are candidates that still
+ * have to be scanned: the index can only give false positives. Air is not
+ * indexed.
+ *
+ * The index covers chunks which are not loaded, and persists next to the
+ * world. The chunks are recorded with the time they were indexed, so that
+ * the ones saved since then can be found from the world manifest.
+ *
+ * The index is not thread-safe.
+ */
+struct BlockIndex {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::shared_ptr<BlockIndex> SharedPtr;
+  typedef std::set<SectionKey> SectionSet;
+
+  static BlockIndex::SharedPtr make() { return std::make_shared<BlockIndex>(); }
+
+  /**
+   * @brief Name of the index file of a dimension, relative to the world
+   * directory.
+   */
+  static std::string filename(const std::string &dim);
+
+  /*
+   ------------------------------ Index methods -------------------------------
+  */
+public:
+  /**
+   * @brief Index (again) all the sections of a chunk.
+   *
+   * @param chunk the chunk
+   * @param timestamp the time the chunk is indexed (in seconds since epoch,
+   * 0 for the current time)
+   */
+  void add_chunk(const Chunk &chunk, uint32_t timestamp = 0);
+
+  /**
+   * @brief Remove a chunk from the index.
+   */
+  void remove_chunk(const ChunkCoordinate &coord);
+
+  /**
+   * @brief Whether a chunk is indexed.
+   */
+  inline bool has_chunk(const ChunkCoordinate &coord) const {
+    return chunks.count(coord) > 0;
+  }
+
+  /**
+   * @brief Number of indexed chunks.
+   */
+  inline size_t chunk_count() const { return chunks.size(); }
+
+  /**
+   * @brief Drop the chunks saved since they were indexed, or no longer on
+   * disk, and list the chunks to index (again).
+   *
+   * @param dimension the manifest of the dimension
+   * @return the chunks on disk which are not indexed
+   */
+  std::vector<ChunkCoordinate> validate(const DimensionManifest &dimension);
+
+  /*
+   ------------------------------ Query methods -------------------------------
+  */
+public:
+  /**
+   * @brief Sections whose palette holds a block state.
+   * @return the candidate sections, ordered by chunk then Y-index
+   */
+  const SectionSet &find(const Block *block) const;
+
+  /**
+   * @brief Chunks with a section whose palette holds a block state.
+   */
+  std::vector<ChunkCoordinate> find_chunks(const Block *block) const;
+
+  /*
+   ------------------------------- Index I/O ----------------------------------
+  */
+public:
+  /**
+   * @brief Load an index file.
+   *
+   * @param path the path of the file
+   * @param registry the registry interning the block states
+   * @return false if the file does not exist or is not a valid index
+   */
+  bool load(const std::string &path,
+            BlockRegistry &registry = BlockRegistry::global());
+
+  /**
+   * @brief Save the index, replacing the file atomically.
+   */
+  void save(const std::string &path) const;
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  /// Palettes of the sections of an indexed chunk
+  struct ChunkEntry {
+    uint32_t timestamp{0}; /// Time the chunk was indexed
+    std::map<SectionIndex, std::vector<const Block *>> sections;
+  };
+
+  /**
+   * @brief Register the palette of a section of a chunk.
+   */
+  void add_section(ChunkEntry &entry, const SectionKey &key,
+                   std::vector<const Block *> palette);
+
+  std::unordered_map<ChunkCoordinate, ChunkEntry, ChunkCoordinateHash,
+                     ChunkCoordinateEqual>
+      chunks;
+  std::unordered_map<const Block *, SectionSet> blocks; /// Inverted index
+};
+
+} // namespace solis::world
+
+#endif
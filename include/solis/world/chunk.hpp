@@ -16,23 +16,337 @@
 */
 
 #include "solis/world/coordinates.hpp"
+#include "solis/world/heightmap.hpp"
+#include "solis/world/light.hpp"
+#include "solis/world/section.hpp"
 #include "solis/world/typedef.hpp"
+#include <atomic>
+#include <bitset>
 #include <map>
+#include <string>
 #include <vector>
 
 namespace solis::world {
 
-typedef Block *Layer[CHUNK_SIZE][CHUNK_SIZE];
-
 template <typename T> struct LocalizedStructure { T coord; };
 
+struct Chunk;
+
 /**
- * @brief
+ * @brief Interface notified of the modifications made through the chunk API.
+ */
+struct ChunkObserver {
+  virtual ~ChunkObserver() = default;
+
+  /**
+   * @brief Called when a clean chunk receives its first modification.
+   */
+  virtual void on_chunk_dirty(Chunk &chunk) = 0;
+
+  /**
+   * @brief Called after a block of a chunk changed (Chunk::set_block).
+   *
+   * @param chunk the modified chunk
+   * @param x the X coordinate in the chunk
+   * @param y the Y coordinate in the world
+   * @param z the Z coordinate in the chunk
+   * @param old the previous block
+   * @param block the new block
+   */
+  virtual void on_block_changed(Chunk &, InChunkCoord_t, LayerIndex,
+                                InChunkCoord_t, const Block *, const Block *) {
+  }
+
+  /**
+   * @brief Called when a whole section of a chunk is replaced, or handed out
+   * for modification (Chunk::set_section, Chunk::edit_section).
+   */
+  virtual void on_section_changed(Chunk &, SectionIndex) {}
+};
+
+/**
+ * @brief Column of sections, indexed by their Y-index.
+ * Absent sections are filled with air.
  *
+ * The sections are read-only, both through get_section and when iterating
+ * the chunk: they are only modified through the chunk methods, which keep
+ * track of the modified (dirty) sections since the last save.
+ *
+ * Sections are copy-on-write: a section shared with a snapshot (or any other
+ * holder) is copied by the chunk before its first modification, so that
+ * snapshots stay consistent while the chunk keeps being edited. This also
+ * holds for the sections shared through a SectionPool.
  */
-struct Chunk : std::map<LayerIndex, Layer>,
+struct Chunk : std::map<SectionIndex, Section::ConstSharedPtr>,
                LocalizedStructure<ChunkCoordinate> {
   typedef std::shared_ptr<Chunk> SharedPtr;
+  typedef std::bitset<256> SectionMask; /// One bit per section Y-index
+  typedef std::shared_ptr<const std::string> Source; /// Encoded chunk
+
+  /*
+   ------------------------------ Block methods -------------------------------
+  */
+public:
+  /**
+   * @brief Y-index of the section containing the given layer.
+   */
+  static inline SectionIndex section_of(LayerIndex y) {
+    return static_cast<SectionIndex>(floor_div<LayerIndex>(y, CHUNK_SIZE));
+  }
+
+  /**
+   * @brief Get the block at the given coordinates in the chunk.
+   *
+   * @param x the X coordinate in the chunk
+   * @param y the Y coordinate in the world
+   * @param z the Z coordinate in the chunk
+   * @return the block, nullptr for air
+   */
+  const Block *get_block(InChunkCoord_t x, LayerIndex y,
+                         InChunkCoord_t z) const;
+
+  /**
+   * @brief Set the block at the given coordinates in the chunk.
+   *
+   * @param x the X coordinate in the chunk
+   * @param y the Y coordinate in the world
+   * @param z the Z coordinate in the chunk
+   * @param block the new block (nullptr for air)
+   * @return true if the block changed
+   */
+  bool set_block(InChunkCoord_t x, LayerIndex y, InChunkCoord_t z,
+                 const Block *block);
+
+  /**
+   * @brief Replace a whole section of the chunk.
+   *
+   * @param y the Y-index of the section
+   * @param section the new section (nullptr to remove it)
+   */
+  void set_section(SectionIndex y, Section::ConstSharedPtr section);
+
+  /**
+   * @brief Get the section with the given Y-index.
+   * @return the section, nullptr if absent
+   */
+  Section::ConstSharedPtr get_section(SectionIndex y) const;
+
+  /**
+   * @brief Get a section for modification, creating it if absent and copying
+   * it if shared. The section is marked as modified.
+   *
+   * @param y the Y-index of the section
+   * @return the section, owned by this chunk only
+   */
+  Section::SharedPtr edit_section(SectionIndex y);
+
+  /*
+   ---------------------------- Heightmap methods -----------------------------
+  */
+public:
+  /**
+   * @brief Height of a column (Y right above its highest matching block).
+   *
+   * The heightmaps are kept up-to-date by set_block, and rebuilt on the next
+   * query after a whole section was replaced or edited.
+   *
+   * @param type the heightmap
+   * @param x the X coordinate in the chunk
+   * @param z the Z coordinate in the chunk
+   */
+  inline LayerIndex get_height(HeightmapType type, InChunkCoord_t x,
+                               InChunkCoord_t z) {
+    return get_heightmaps().get(type, x, z);
+  }
+
+  /**
+   * @brief Get the heightmaps of the chunk, rebuilding them if needed.
+   */
+  const Heightmaps &get_heightmaps();
+
+  /**
+   * @brief Get the heightmaps of the chunk if they are up-to-date.
+   * @return the heightmaps, nullptr if they have to be rebuilt
+   */
+  inline Heightmaps::SharedPtr get_cached_heightmaps() const {
+    return stale_heightmaps ? nullptr : heightmaps;
+  }
+
+  /**
+   * @brief Compute the heightmaps of the chunk from its sections, down to
+   * the bottom of the world.
+   */
+  inline Heightmaps::SharedPtr build_heightmaps() const {
+    return build_heightmaps(min_section * CHUNK_SIZE);
+  }
+
+  /**
+   * @brief Compute the heightmaps of the chunk from its sections.
+   * @param bottom the height of the empty columns
+   */
+  Heightmaps::SharedPtr build_heightmaps(LayerIndex bottom) const;
+
+  /**
+   * @brief Replace the heightmaps of the chunk (e.g. read from the disk).
+   */
+  inline void set_heightmaps(Heightmaps::SharedPtr h) {
+    heightmaps = std::move(h);
+    stale_heightmaps = (heightmaps == nullptr);
+  }
+
+  /**
+   * @brief Y-index of the lowest section of the world (e.g. the Anvil yPos),
+   * the bottom of the heightmaps.
+   */
+  inline SectionIndex get_min_section() const { return min_section; }
+
+  /**
+   * @brief Set the Y-index of the lowest section of the world.
+   */
+  inline void set_min_section(SectionIndex y) {
+    if (y != min_section)
+      stale_heightmaps = true;
+    min_section = y;
+  }
+
+  /*
+   ------------------------------ Light methods -------------------------------
+  */
+public:
+  /**
+   * @brief Get the light of the chunk.
+   * @return the light, nullptr if it was never computed
+   */
+  inline const ChunkLight::SharedPtr &get_light() const { return light; }
+
+  /**
+   * @brief Replace the light of the chunk (e.g. once relit).
+   */
+  inline void set_light(ChunkLight::SharedPtr l) { light = std::move(l); }
+
+  /*
+   ------------------------------ Source methods ------------------------------
+  */
+public:
+  /**
+   * @brief Get the encoded chunk this chunk was decoded from (e.g. the Anvil
+   * NBT), which holds the data the chunk does not model (entities, biomes,
+   * generation state...) and is patched when the chunk is encoded back.
+   * @return the source, nullptr if the chunk was not decoded or did not keep
+   * it
+   */
+  inline const Source &get_source() const { return source; }
+
+  /**
+   * @brief Replace the encoded chunk this chunk was decoded from.
+   */
+  inline void set_source(Source s) { source = std::move(s); }
+
+  /*
+   ----------------------------- Snapshot methods -----------------------------
+  */
+public:
+  /**
+   * @brief Take a read-only snapshot of the chunk, sharing its sections.
+   * The snapshot should be taken from the thread modifying the chunk, and can
+   * then be read from any thread.
+   */
+  Chunk::SharedPtr snapshot() const;
+
+  /*
+   ------------------------------ Dirty methods -------------------------------
+  */
+public:
+  inline bool is_dirty() const { return dirty.any(); }
+  inline bool is_section_dirty(SectionIndex y) const {
+    return dirty.test(static_cast<uint8_t>(y));
+  }
+
+  /**
+   * @brief Sections modified since the last save, as a mask indexed by the
+   * section Y-index casted to an unsigned byte.
+   */
+  inline const SectionMask &get_dirty_sections() const { return dirty; }
+
+  /**
+   * @brief Mark a section as modified.
+   */
+  void mark_dirty(SectionIndex y);
+
+  /**
+   * @brief Mark several sections as modified.
+   */
+  void mark_dirty(const SectionMask &sections);
+
+  /**
+   * @brief Reset the modification state (e.g. once saved).
+   */
+  inline void clear_dirty() { dirty.reset(); }
+
+  /**
+   * @brief Number of modifications of the chunk, never reset: a chunk whose
+   * revision did not change since a given time was not modified.
+   */
+  inline uint64_t get_revision() const { return revision; }
+
+  /**
+   * @brief Set the object notified of the modifications of the chunk.
+   */
+  inline void set_observer(ChunkObserver *o) { observer = o; }
+
+  /*
+   ------------------------------ Access methods ------------------------------
+  */
+public:
+  /**
+   * @brief Record an access to the chunk, e.g. by Dimension::get_chunk.
+   * @param now the time of the access (steady clock ticks)
+   */
+  inline void touch(int64_t now) const {
+    last_access.store(now, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Time of the last recorded access (steady clock ticks).
+   */
+  inline int64_t get_last_access() const {
+    return last_access.load(std::memory_order_relaxed);
+  }
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  SectionMask dirty;                /// Sections modified since the last save
+  uint64_t revision{0};             /// See get_revision()
+  ChunkObserver *observer{nullptr}; /// Owner notified of the modifications
+  ChunkLight::SharedPtr light;      /// Sky and block light of the sections
+  Heightmaps::SharedPtr heightmaps; /// Shared with the snapshots
+  bool stale_heightmaps{true};      /// Whether to rebuild the heightmaps
+  SectionIndex min_section{-4};     /// Lowest section of the world
+  Source source;                    /// Shared with the snapshots
+
+  mutable std::atomic<int64_t> last_access{0}; /// See touch()
+
+  /**
+   * @brief Update the heightmaps of a column after a block change.
+   */
+  void update_heightmaps(InChunkCoord_t x, LayerIndex y, InChunkCoord_t z,
+                         const Block *block);
+
+  /**
+   * @brief Highest block of a column matching a heightmap, below a layer.
+   * @return the height of the column, min_y if none
+   */
+  LayerIndex find_height(HeightmapType type, InChunkCoord_t x,
+                         InChunkCoord_t z, LayerIndex below,
+                         LayerIndex min_y) const;
+
+  /**
+   * @brief Make the given section owned by this chunk only.
+   * @return the section, writable
+   */
+  static Section::SharedPtr detach(Section::ConstSharedPtr &section);
 };
 
 /**
@@ -41,6 +355,11 @@ struct Chunk : std::map<LayerIndex, Layer>,
 struct Region : std::vector<Chunk::SharedPtr>,
                 LocalizedStructure<RegionCoordinate> {
   typedef std::shared_ptr<Region> SharedPtr;
+
+  /**
+   * @brief Take a read-only snapshot of the region and its chunks.
+   */
+  Region::SharedPtr snapshot() const;
 };
 
 } // namespace solis::world
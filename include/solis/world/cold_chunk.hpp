@@ -0,0 +1,98 @@
+#ifndef SOLIS_WORLD_COLD_CHUNK_HPP
+#define SOLIS_WORLD_COLD_CHUNK_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the cold chunks, kept compressed in
+  memory while they are not used.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/world/chunk.hpp"
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace solis::world {
+
+/**
+ * @brief Options of the compression of the idle chunks of a dimension.
+ */
+struct ColdOptions {
+  std::chrono::milliseconds idle{30000}; /// Time without access before
+  uint8_t level{1};                      /// ZLib level (1 is the fastest)
+};
+
+/**
+ * @brief Chunk compressed in memory.
+ *
+ * The sections owned by the chunk and its light are serialized in the host
+ * layout (palettes as block addresses, which the registry keeps valid) and
+ * deflated. The sections shared with other holders (snapshots, section pool)
+ * are kept as they are, so that compressing a chunk never duplicates them.
+ * A cold chunk is immutable.
+ */
+struct ColdChunk {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::shared_ptr<const ColdChunk> SharedPtr;
+  typedef std::vector<std::pair<SectionIndex, Section::ConstSharedPtr>>
+      Sections;
+
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  /**
+   * @brief Compress a chunk, which should not be modified meanwhile.
+   * @param level the ZLib level
+   */
+  static ColdChunk::SharedPtr compress(const Chunk &chunk, uint8_t level = 1);
+
+  /**
+   * @brief Rebuild the chunk, without modification state nor observer.
+   */
+  Chunk::SharedPtr inflate() const;
+
+  /*
+   --------------------------- Properties methods -----------------------------
+  */
+public:
+  /**
+   * @brief Approximate heap memory of the cold chunk, its shared sections
+   * and source excluded.
+   */
+  inline size_t memory_usage() const {
+    return sizeof(ColdChunk) + data.capacity() +
+           shared.capacity() * sizeof(Sections::value_type);
+  }
+
+  /// Size of the serialized sections and light, before compression
+  inline size_t get_raw_size() const { return raw_size; }
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+public:
+  ChunkCoordinate coord;
+  std::string data;                 /// Deflated sections and light
+  size_t raw_size{0};               /// Size of the data once inflated
+  Sections shared;                  /// Sections kept as they are
+  Heightmaps::SharedPtr heightmaps; /// Up-to-date heightmaps, if any
+  bool has_light{false};            /// Whether the data holds the light
+  SectionIndex min_section{-4};     /// Lowest section of the world
+  Chunk::Source source;             /// Encoded chunk, kept as it is
+};
+
+} // namespace solis::world
+
+#endif
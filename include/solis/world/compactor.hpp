@@ -0,0 +1,104 @@
+#ifndef SOLIS_WORLD_COMPACTOR_HPP
+#define SOLIS_WORLD_COMPACTOR_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the region file compactor, rewriting
+  the region files without their dead sectors.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/world/region_file.hpp"
+#include <array>
+#include <atomic>
+#include <functional>
+#include <string>
+
+namespace solis::world {
+
+/**
+ * @brief Options of a compaction.
+ */
+struct CompactOptions {
+  bool recompress{false}; /// Decompress then compress again the payloads
+  uint8_t compression{CompressionType::ZLIB}; /// Compression when recompressing
+  uint8_t level{6};  /// Compression level when recompressing (zlib levels)
+  bool force{false}; /// Rewrite the files whose layout is already compact
+  size_t threads{0}; /// Number of workers (0 for the hardware concurrency)
+  /// Called with the path of each file to rewrite, once it is read and before
+  /// it is replaced (e.g. to report the progress)
+  std::function<void(const std::string &)> on_read;
+};
+
+/**
+ * @brief Counters of a compaction.
+ */
+struct CompactStats {
+  std::atomic<size_t> regions{0};      /// Region files examined
+  std::atomic<size_t> rewritten{0};    /// Region files rewritten
+  std::atomic<size_t> skipped{0};      /// Unreadable or concurrently modified
+  std::atomic<size_t> chunks{0};       /// Chunks in the rewritten files
+  std::atomic<size_t> recompressed{0}; /// Payloads replaced by a recompression
+  std::atomic<uint64_t> bytes_before{0}; /// Size of the rewritten files before
+  std::atomic<uint64_t> bytes_after{0};  /// Size of the rewritten files after
+};
+
+/**
+ * @brief Compactor of the region files.
+ *
+ * A compacted region file holds its chunks contiguously, right after the
+ * header, and in the Z-order (Morton order) of their coordinates so that
+ * neighbouring chunks are close in the file. The timestamps are kept, and
+ * the new file replaces the old one atomically. Files holding a chunk which
+ * cannot be read (corrupted or stored in an external file) are left as is.
+ */
+struct RegionCompactor {
+  /*
+   ------------------------------- Chunk order --------------------------------
+  */
+public:
+  /**
+   * @brief Indices of the chunks of a region, in Z-order.
+   */
+  static const std::array<uint16_t, REGION_CHUNK_COUNT> &z_order();
+
+  /*
+   ---------------------------- Compaction methods ----------------------------
+  */
+public:
+  /**
+   * @brief Compact a region file.
+   *
+   * The file must not be written by anyone else during the compaction: a file
+   * modified while it was read is left untouched and counted as skipped.
+   *
+   * @param path the path of the region file
+   * @param stats the counters to fill
+   * @param options the compaction options
+   * @return true if the file was rewritten
+   */
+  static bool compact_file(const std::string &path, CompactStats &stats,
+                           const CompactOptions &options = CompactOptions());
+
+  /**
+   * @brief Compact all the region files of a directory, in parallel.
+   *
+   * @param dir the directory of the region files
+   * @param stats the counters to fill
+   * @param options the compaction options
+   */
+  static void compact_directory(const std::string &dir, CompactStats &stats,
+                                const CompactOptions &options =
+                                    CompactOptions());
+};
+
+} // namespace solis::world
+
+#endif
@@ -1,5 +1,5 @@
-#ifndef SOLIS_UTILS_FLAGS_HPP
-#define SOLIS_UTILS_FLAGS_HPP
+#ifndef SOLIS_WORLD_COORDINATES_HPP
+#define SOLIS_WORLD_COORDINATES_HPP
 
 /**
   =================================== SOLIS ===================================
@@ -16,6 +16,7 @@
 
 #include "solis/world/typedef.hpp"
 #include <cmath>
+#include <functional>
 
 namespace solis::world {
 
@@ -65,6 +66,11 @@ template <typename T> struct Coordinate2D {
  * The Y axis is up.
  */
 typedef Coordinate3D<WorldCoordinate_t> WorldCoordinate;
+/**
+ * @brief Integer coordinates of a block in the world.
+ * The Y axis is up.
+ */
+typedef Coordinate3D<BlockCoordinate_t> BlockCoordinate;
 /**
  * @brief Coordinates values of a chunk.
  * It is represented in 2D (X-Z plane) integer values.
@@ -76,6 +82,54 @@ typedef Coordinate2D<ChunkCoordinate_t> ChunkCoordinate;
  */
 typedef Coordinate2D<RegionCoordinate_t> RegionCoordinate;
 
+// ============================================================================
+//    Integer helpers
+// ============================================================================
+
+/**
+ * @brief Integer division rounded towards negative infinity.
+ */
+template <typename T> inline constexpr T floor_div(const T a, const T b) {
+  return (a / b) - (((a % b) != 0) && ((a < 0) != (b < 0)));
+}
+
+/**
+ * @brief Positive remainder of an integer division, matching floor_div.
+ */
+template <typename T> inline constexpr T floor_mod(const T a, const T b) {
+  return a - floor_div(a, b) * b;
+}
+
+// ============================================================================
+//    Coordinate hashing
+// ============================================================================
+
+/**
+ * @brief Hash functor for 2D coordinates, to be used in unordered containers.
+ */
+template <typename T> struct Coordinate2DHash {
+  inline size_t operator()(const Coordinate2D<T> &c) const {
+    return std::hash<uint64_t>()((static_cast<uint64_t>(c.x) << 32) ^
+                                 static_cast<uint32_t>(c.z));
+  }
+};
+
+/**
+ * @brief Equality functor for 2D coordinates, to be used in unordered
+ * containers.
+ */
+template <typename T> struct Coordinate2DEqual {
+  inline bool operator()(const Coordinate2D<T> &a,
+                         const Coordinate2D<T> &b) const {
+    return (a.x == b.x) && (a.z == b.z);
+  }
+};
+
+typedef Coordinate2DHash<ChunkCoordinate_t> ChunkCoordinateHash;
+typedef Coordinate2DEqual<ChunkCoordinate_t> ChunkCoordinateEqual;
+typedef Coordinate2DHash<RegionCoordinate_t> RegionCoordinateHash;
+typedef Coordinate2DEqual<RegionCoordinate_t> RegionCoordinateEqual;
+
 // ============================================================================
 //    Coordinate conversion system
 // ============================================================================
@@ -122,6 +176,38 @@ CVT_COORDINATE_HEADER(WorldCoordinate, ChunkCoordinate) {
   return ChunkCoordinate(std::floor(c_in.x / CHUNK_SIZE),
                          std::floor(c_in.z / CHUNK_SIZE));
 }
+/**
+ * @brief Convert the world coordinates into the coordinates of the block
+ * containing them
+ *
+ * @param c_in the world coordinates
+ * @return the equivalent block coordinate
+ */
+CVT_COORDINATE_HEADER(WorldCoordinate, BlockCoordinate) {
+  return BlockCoordinate(std::floor(c_in.x), std::floor(c_in.y),
+                         std::floor(c_in.z));
+}
+/**
+ * @brief Convert the block coordinates into the chunk coordinates
+ *
+ * @param c_in the block coordinates
+ * @return the equivalent chunk coordinate
+ */
+CVT_COORDINATE_HEADER(BlockCoordinate, ChunkCoordinate) {
+  return ChunkCoordinate(floor_div<BlockCoordinate_t>(c_in.x, CHUNK_SIZE),
+                         floor_div<BlockCoordinate_t>(c_in.z, CHUNK_SIZE));
+}
+/**
+ * @brief Convert the block coordinates into the region coordinates
+ *
+ * @param c_in the block coordinates
+ * @return the equivalent region coordinate
+ */
+CVT_COORDINATE_HEADER(BlockCoordinate, RegionCoordinate) {
+  return RegionCoordinate(
+      floor_div<BlockCoordinate_t>(c_in.x, REGION_WIDTH_BLOCK),
+      floor_div<BlockCoordinate_t>(c_in.z, REGION_WIDTH_BLOCK));
+}
 /**
  * @brief Convert the chunk coordinates into the region coordinates
  *
@@ -0,0 +1,165 @@
+#ifndef SOLIS_WORLD_DIFF_HPP
+#define SOLIS_WORLD_DIFF_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the diff engine between two copies of
+  the region files of a dimension.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/resources/registry.hpp"
+#include "solis/world/chunk.hpp"
+#include "solis/world/region_file.hpp"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace solis::world {
+
+// ============================================================================
+//    Diff records
+// ============================================================================
+
+/**
+ * @brief Kind of difference of a chunk or a section.
+ */
+enum DiffKind : uint8_t {
+  ADDED = 0,   /// Only in the new copy
+  REMOVED = 1, /// Only in the old copy
+  CHANGED = 2, /// In both copies, with different blocks
+  FILLED = 3   /// Section only: the new copy is uniform (see fill)
+};
+
+/**
+ * @brief Change of a single block of a section.
+ */
+struct BlockChange {
+  uint16_t index;     /// Index of the block in the section
+  const Block *from;  /// Block in the old copy
+  const Block *to;    /// Block in the new copy
+};
+
+/**
+ * @brief Difference of a section of a chunk.
+ *
+ * Absent sections are compared as air. Only CHANGED sections list their
+ * block changes (by increasing index), FILLED sections only give the block
+ * now filling them.
+ */
+struct SectionDiff {
+  SectionIndex y{0};
+  DiffKind kind{DiffKind::CHANGED};
+  const Block *fill{nullptr};
+  std::vector<BlockChange> changes;
+};
+
+/**
+ * @brief Difference of a chunk.
+ *
+ * Added and removed chunks are reported without being decoded, so they have
+ * no section diff.
+ */
+struct ChunkDiff {
+  ChunkCoordinate coord;
+  DiffKind kind{DiffKind::CHANGED};
+  std::vector<SectionDiff> sections;
+};
+
+/**
+ * @brief Options of a diff.
+ */
+struct DiffOptions {
+  /**
+   * Consider the chunks with the same region timestamp and sector count as
+   * identical without reading them. Disable it to compare copies written by
+   * tools which do not update the timestamps.
+   */
+  bool trust_timestamps{true};
+  size_t threads{0}; /// Number of workers (0 for the hardware concurrency)
+};
+
+/**
+ * @brief Counters of a diff, to check how much of the world was read.
+ */
+struct DiffStats {
+  std::atomic<size_t> regions{0};   /// Region files compared
+  std::atomic<size_t> compared{0};  /// Chunks present in both copies
+  std::atomic<size_t> read{0};      /// Chunks whose payloads were read
+  std::atomic<size_t> decoded{0};   /// Chunks which had to be decoded
+  std::atomic<size_t> different{0}; /// Reported chunks
+};
+
+// ============================================================================
+//    Diff engine
+// ============================================================================
+
+/**
+ * @brief Diff engine between two copies of the region files of a dimension.
+ *
+ * The region headers are compared first: chunks with the same timestamp are
+ * skipped, then the chunks whose compressed payloads are byte-identical.
+ * Only the remaining candidates are decoded (on a worker pool) and compared
+ * section by section, so that the cost is proportional to what changed.
+ */
+struct WorldDiff {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  /// Receiver of the chunk diffs, called from the workers one at a time and
+  /// in no particular order
+  typedef std::function<void(const ChunkDiff &)> Sink;
+
+  /*
+   ------------------------------ Diff methods --------------------------------
+  */
+public:
+  /**
+   * @brief Diff two region directories.
+   *
+   * @param from the directory of the old copy
+   * @param to the directory of the new copy
+   * @param sink the receiver of the differences
+   * @param stats the counters to fill
+   * @param options the diff options
+   * @param registry the registry interning the block states
+   */
+  static void diff_directories(const std::string &from, const std::string &to,
+                               const Sink &sink, DiffStats &stats,
+                               const DiffOptions &options = DiffOptions(),
+                               BlockRegistry &registry =
+                                   BlockRegistry::global());
+
+  /**
+   * @brief Diff two decoded chunks.
+   *
+   * @param from the chunk in the old copy
+   * @param to the chunk in the new copy
+   * @param out the differences (coord and kind are left untouched)
+   * @return true if the chunks differ
+   */
+  static bool diff_chunks(const Chunk &from, const Chunk &to, ChunkDiff &out);
+
+  /**
+   * @brief Diff two sections (nullptr standing for an all-air section).
+   *
+   * @param from the section in the old copy
+   * @param to the section in the new copy
+   * @param out the differences (y is left untouched)
+   * @return true if the sections differ
+   */
+  static bool diff_sections(const Section *from, const Section *to,
+                            SectionDiff &out);
+};
+
+} // namespace solis::world
+
+#endif
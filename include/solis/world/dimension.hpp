@@ -15,20 +15,60 @@
   =============================================================================
 */
 
+#include "solis/world/block_index.hpp"
 #include "solis/world/chunk.hpp"
+#include "solis/world/cold_chunk.hpp"
+#include "solis/world/journal.hpp"
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace solis::world {
 
+/**
+ * @brief Chunk modified since the last save, with its modified sections.
+ */
+struct DirtyChunk {
+  Chunk::SharedPtr chunk;
+  Chunk::SectionMask sections;
+};
+
+/**
+ * @brief Modified chunks of a region, to be saved together.
+ */
+struct DirtyRegion {
+  RegionCoordinate coord;
+  std::vector<DirtyChunk> chunks;
+};
+
+/**
+ * @brief Box of blocks, bounds included.
+ */
+struct BlockBox {
+  BlockCoordinate min;
+  BlockCoordinate max;
+};
+
+/**
+ * @brief Options of the bulk edits.
+ */
+struct BulkOptions {
+  size_t threads{0}; /// Number of workers (0 for the hardware concurrency)
+};
+
 /**
  * @brief Structure describing a dimension (e.g. Nether, overworld, end, ...)
  */
-struct Dimension {
+struct Dimension : ChunkObserver {
   /*
    --------------------------------- Typedef ----------------------------------
   */
   typedef std::shared_ptr<Dimension> SharedPtr;
   typedef char DimType_t;
+  typedef std::unordered_map<ChunkCoordinate, ColdChunk::SharedPtr,
+                             ChunkCoordinateHash, ChunkCoordinateEqual>
+      ColdChunks;
   enum Type : DimType_t { NETHER = -1, OVERWORLD = 0, END = 1 };
 
   /*
@@ -36,6 +76,10 @@ struct Dimension {
   */
 public:
   explicit Dimension(DimType_t type, const char *name);
+  ~Dimension();
+
+  Dimension(const Dimension &) = delete;
+  Dimension &operator=(const Dimension &) = delete;
 
   /*
    --------------------------- Properties methods -----------------------------
@@ -129,6 +173,19 @@ public:
    */
   bool is_region_loaded(const RegionCoordinate &coordinates) const;
 
+  /**
+   * @brief Get the loaded regions of the dimension. The chunks compressed in
+   * memory are not part of them: see get_cold_chunks.
+   */
+  inline const std::vector<Region::SharedPtr> &get_regions() const {
+    return regions;
+  }
+
+  /**
+   * @brief Get the chunks compressed in memory, which are still loaded.
+   */
+  inline const ColdChunks &get_cold_chunks() const { return cold; }
+
 protected:
   /*
    ------------------------------ Chunk methods -------------------------------
@@ -143,6 +200,11 @@ public:
    */
   template <typename C>
   inline Chunk::SharedPtr
+  get_chunk(const std::shared_ptr<LocalizedStructure<C>> &obj) {
+    return get_chunk(obj->coord);
+  }
+  template <typename C>
+  inline Chunk::SharedPtr
   get_chunk(const std::shared_ptr<LocalizedStructure<C>> &obj) const {
     return get_chunk(obj->coord);
   }
@@ -154,6 +216,12 @@ public:
    * @return a pointer to the chunk, nullptr if it does not exist
    */
   template <typename C>
+  inline Chunk::SharedPtr get_chunk(const C &coordinates) {
+    static_assert(!std::is_base_of<CoordinateInterface, C>::value,
+                  "This function should be called with coordinates");
+    return get_chunk(cvtCoordinate<ChunkCoordinate>(coordinates));
+  }
+  template <typename C>
   inline Chunk::SharedPtr get_chunk(const C &coordinates) const {
     static_assert(!std::is_base_of<CoordinateInterface, C>::value,
                   "This function should be called with coordinates");
@@ -161,7 +229,21 @@ public:
   }
 
   /**
-   * @brief Get the requested chunk given its coordinates.
+   * @brief Get the requested chunk given its coordinates, inflating it back
+   * into its region if it was compressed in memory. The access is recorded
+   * on the chunk.
+   * @param coordinates the chunk coordinates
+   * @return a pointer to the chunk, nullptr if it does not exist
+   */
+  Chunk::SharedPtr get_chunk(const ChunkCoordinate &coordinates);
+
+  /**
+   * @brief Get the requested chunk given its coordinates, without modifying
+   * the dimension, so that it can be called concurrently.
+   *
+   * A chunk compressed in memory stays so: a detached copy is inflated,
+   * whose modifications are neither observed nor kept by the dimension.
+   *
    * @param coordinates the chunk coordinates
    * @return a pointer to the chunk, nullptr if it does not exist
    */
@@ -197,7 +279,7 @@ public:
 
   /**
    * @brief Check whether a chunk with the given coordinates is loaded in
-   * memory.
+   * memory, compressed or not.
    *
    * @param coordinates the coordinates of the chunk
    * @return true if the chunk is loaded, else otherwise
@@ -212,6 +294,206 @@ public:
    */
   void add_chunk(const Chunk::SharedPtr chunk);
 
+  /*
+   ------------------------------- Cold methods -------------------------------
+  */
+public:
+  /**
+   * @brief Compress in memory the chunks not accessed for a while.
+   *
+   * Only the unmodified chunks held by the dimension alone are compressed, as
+   * the others could still be modified. They leave their region (and
+   * get_regions) for get_cold_chunks until get_chunk inflates them back, but
+   * are still loaded: is_chunk_loaded, the scans and the ray casts see them.
+   *
+   * @param options the idle time and the compression level
+   * @return the number of compressed chunks
+   */
+  size_t compress_idle(const ColdOptions &options = ColdOptions());
+
+  /**
+   * @brief Number of chunks compressed in memory.
+   */
+  inline size_t cold_count() const { return cold.size(); }
+
+  /**
+   * @brief Memory of the chunks compressed in memory.
+   */
+  size_t cold_memory() const;
+
+  /*
+   ------------------------------ Block methods -------------------------------
+  */
+public:
+  /**
+   * @brief Get the block at the given coordinates.
+   *
+   * A chunk compressed in memory is inflated at each call (see the const
+   * get_chunk): repeated reads should get the chunk once.
+   *
+   * @param coordinates the block coordinates
+   * @return the block, nullptr for air or if the chunk is not loaded
+   */
+  const Block *get_block(const BlockCoordinate &coordinates) const;
+
+  /**
+   * @brief Set the block at the given coordinates, if its chunk is loaded.
+   *
+   * @param coordinates the block coordinates
+   * @param block the new block (nullptr for air)
+   * @return true if the block changed
+   */
+  bool set_block(const BlockCoordinate &coordinates, const Block *block);
+
+  /*
+   ------------------------------- Bulk methods -------------------------------
+  */
+public:
+  /**
+   * @brief Fill a box with a single block, in the loaded chunks.
+   *
+   * The sections inside of the box are replaced by a uniform one, the others
+   * are filled row by row. The chunks are edited in parallel.
+   *
+   * @param box the box
+   * @param block the block (nullptr for air)
+   * @param options the bulk options
+   * @return the number of modified sections
+   */
+  size_t fill(const BlockBox &box, const Block *block,
+              const BulkOptions &options = BulkOptions());
+
+  /**
+   * @brief Replace a block by another one inside of a box, in the loaded
+   * chunks.
+   *
+   * Only the sections whose palette holds the block are modified, and the
+   * ones inside of the box by remapping their palette. The chunks are edited
+   * in parallel.
+   *
+   * @param box the box
+   * @param from the replaced block (nullptr for air)
+   * @param to the new block (nullptr for air)
+   * @param options the bulk options
+   * @return the number of modified sections
+   */
+  size_t replace(const BlockBox &box, const Block *from, const Block *to,
+                 const BulkOptions &options = BulkOptions());
+
+  /**
+   * @brief Copy a box to another place, between loaded chunks. The boxes
+   * may overlap.
+   *
+   * When the offset is a multiple of the section size, the sections inside
+   * of the box are shared (copy-on-write) instead of copied.
+   *
+   * @param box the copied box
+   * @param destination the new position of the minimal corner of the box
+   * @param options the bulk options
+   * @return the number of modified sections
+   */
+  size_t copy(const BlockBox &box, const BlockCoordinate &destination,
+              const BulkOptions &options = BulkOptions());
+
+  /*
+   ---------------------------- Block index methods ---------------------------
+  */
+public:
+  /**
+   * @brief Attach a block index to the dimension (nullptr to detach it).
+   *
+   * The loaded chunks, and the compressed ones not indexed yet, are indexed
+   * right away, then every added chunk. The chunks modified since they were
+   * indexed (see Chunk::get_revision) are indexed again before the next
+   * query.
+   *
+   * @param index the index, e.g. loaded from the disk
+   */
+  void set_block_index(BlockIndex::SharedPtr index);
+
+  /**
+   * @brief Get the block index, brought up-to-date with the modifications.
+   * @return the index, nullptr if the dimension has none
+   */
+  const BlockIndex::SharedPtr &get_block_index();
+
+  /**
+   * @brief Find the blocks of a given state in the loaded chunks.
+   *
+   * Only the candidate sections of the block index are scanned (the sections
+   * of every loaded chunk without index, the compressed ones being inflated
+   * one at a time without thawing them). Indexed chunks which are not loaded
+   * are skipped: see BlockIndex::find_chunks.
+   *
+   * Air is never found, with or without index: the index does not hold it,
+   * and the absent sections are made of it.
+   *
+   * @param block the block state
+   * @return the coordinates of the blocks, none for air (nullptr)
+   */
+  std::vector<BlockCoordinate> find_blocks(const Block *block);
+
+  /*
+   ------------------------------ Journal methods -----------------------------
+  */
+public:
+  /**
+   * @brief Record the modifications of the chunks in a journal (nullptr to
+   * stop recording). The journal may be shared between several dimensions.
+   */
+  inline void set_journal(ChangeJournal::SharedPtr j) {
+    journal = std::move(j);
+  }
+
+  /**
+   * @brief Get the journal of the modifications.
+   * @return the journal, nullptr if the dimension has none
+   */
+  inline const ChangeJournal::SharedPtr &get_journal() const {
+    return journal;
+  }
+
+  void on_block_changed(Chunk &chunk, InChunkCoord_t x, LayerIndex y,
+                        InChunkCoord_t z, const Block *old,
+                        const Block *block) override;
+  void on_section_changed(Chunk &chunk, SectionIndex y) override;
+
+  /*
+   ------------------------------ Dirty methods -------------------------------
+  */
+public:
+  /**
+   * @brief Take the set of chunks modified since the last collection, grouped
+   * by region, and reset their modification state.
+   *
+   * The cost is proportional to the number of modified chunks. The returned
+   * chunks are copy-on-write snapshots, which a background saver can
+   * serialize while the dimension keeps being modified.
+   *
+   * @return the modified chunks of each region
+   */
+  std::vector<DirtyRegion> collect_dirty();
+
+  /**
+   * @brief Mark again as modified the chunks of a collected region, e.g.
+   * after a failed save.
+   */
+  void restore_dirty(const DirtyRegion &region);
+
+  /**
+   * @brief Take a read-only snapshot of all the loaded chunks of the
+   * dimension. Sections are shared until the live chunks modify them, so the
+   * cost is proportional to the number of chunks.
+   */
+  Dimension::SharedPtr snapshot() const;
+
+  /**
+   * @brief Number of chunks modified since the last collection.
+   */
+  size_t dirty_count() const;
+
+  void on_chunk_dirty(Chunk &chunk) override;
+
   /*
    -------------------------------- Properties --------------------------------
   */
@@ -219,6 +501,40 @@ protected:
   const char *name;                       /// Name of the dimension
   const DimType_t world_type;             // Type of the dimension
   std::vector<Region::SharedPtr> regions; // Loaded regions of the dimension
+
+  typedef std::unordered_set<ChunkCoordinate, ChunkCoordinateHash,
+                             ChunkCoordinateEqual>
+      ChunkSet;
+  mutable std::mutex dirty_mutex;
+  std::unordered_map<RegionCoordinate, ChunkSet, RegionCoordinateHash,
+                     RegionCoordinateEqual>
+      dirty; // Modified chunks, grouped by region
+
+  BlockIndex::SharedPtr block_index; // Optional index of the block states
+  std::unordered_map<ChunkCoordinate, uint64_t, ChunkCoordinateHash,
+                     ChunkCoordinateEqual>
+      unindexed; // Modified chunks, with their indexed revision (dirty_mutex)
+  ChangeJournal::SharedPtr journal; // Optional journal of the modifications
+
+  // Chunks compressed in memory, inflated back by get_chunk
+  ColdChunks cold;
+
+  /**
+   * @brief Loaded chunk of a region, without inflating the cold ones.
+   * @return the chunk, nullptr if it is not in the region
+   */
+  Chunk::SharedPtr find_chunk(const ChunkCoordinate &coordinates) const;
+
+  /**
+   * @brief Loaded chunks intersecting a box, inflating the cold ones.
+   */
+  std::vector<Chunk::SharedPtr> chunks_in(const BlockBox &box);
+
+  /**
+   * @brief Inflate a cold chunk back into its region.
+   * @return the chunk, nullptr if it is not cold
+   */
+  Chunk::SharedPtr thaw(const ChunkCoordinate &coordinates);
 };
 
 } // namespace solis::world
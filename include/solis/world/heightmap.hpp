@@ -0,0 +1,90 @@
+#ifndef SOLIS_WORLD_HEIGHTMAP_HPP
+#define SOLIS_WORLD_HEIGHTMAP_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the heightmaps of the chunks.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/world/typedef.hpp"
+#include <array>
+#include <memory>
+#include <string_view>
+
+namespace solis::world {
+
+/**
+ * @brief Kind of heightmap, named after the Anvil ones.
+ */
+enum HeightmapType : uint8_t {
+  MOTION_BLOCKING = 0, /// Highest block blocking motion or holding a fluid
+  WORLD_SURFACE = 1,   /// Highest non-air block
+  OCEAN_FLOOR = 2      /// Highest block blocking motion
+};
+constexpr uint8_t HEIGHTMAP_COUNT{3};
+
+/**
+ * @brief Heightmaps of a chunk.
+ *
+ * The height of a column is the Y coordinate right above its highest block
+ * matching the heightmap, or min_y if none does.
+ */
+struct Heightmaps {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::shared_ptr<Heightmaps> SharedPtr;
+  typedef std::array<LayerIndex, CHUNK_SIZE * CHUNK_SIZE> Heights;
+
+  /// Names of the heightmaps in the chunk NBT
+  static constexpr std::string_view NAMES[HEIGHTMAP_COUNT]{
+      "MOTION_BLOCKING", "WORLD_SURFACE", "OCEAN_FLOOR"};
+
+  /*
+   ------------------------------ Height methods ------------------------------
+  */
+public:
+  static inline uint8_t column(InChunkCoord_t x, InChunkCoord_t z) {
+    return (z << 4) | x;
+  }
+
+  inline LayerIndex get(HeightmapType type, InChunkCoord_t x,
+                        InChunkCoord_t z) const {
+    return heights[type][column(x, z)];
+  }
+
+  inline void set(HeightmapType type, InChunkCoord_t x, InChunkCoord_t z,
+                  LayerIndex height) {
+    heights[type][column(x, z)] = height;
+  }
+
+  /**
+   * @brief Set every column to empty.
+   */
+  void clear(LayerIndex bottom);
+
+  /**
+   * @brief Heightmaps counting a block, as a mask of (1 << HeightmapType),
+   * from its flags.
+   */
+  static uint8_t classify(const Block *block);
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+public:
+  LayerIndex min_y{0}; /// Height of the empty columns
+  Heights heights[HEIGHTMAP_COUNT];
+};
+
+} // namespace solis::world
+
+#endif
@@ -0,0 +1,223 @@
+#ifndef SOLIS_WORLD_JOURNAL_HPP
+#define SOLIS_WORLD_JOURNAL_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the change journal, recording the
+  modifications of the chunks for the consumers that follow them.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/world/coordinates.hpp"
+#include "solis/world/section.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace solis::world {
+
+/**
+ * @brief Modification of a chunk.
+ */
+struct ChangeEvent {
+  enum Kind : uint8_t {
+    BLOCK,  /// A block changed (set_block)
+    SECTION /// A whole section was replaced or edited
+  };
+
+  uint64_t sequence{0}; /// Position of the event in the journal
+  Kind kind{BLOCK};
+  ChunkCoordinate coord;       /// Chunk of the modification
+  SectionIndex y{0};           /// Y-index of the section
+  uint16_t index{0};           /// Index of the block in the section (BLOCK)
+  const Block *old{nullptr};   /// Previous block (BLOCK)
+  const Block *block{nullptr}; /// New block (BLOCK)
+};
+
+/**
+ * @brief Modifications of a section, merged from consecutive events.
+ */
+struct SectionChange {
+  ChunkCoordinate coord;
+  SectionIndex y{0};
+  uint64_t first{0};           /// Sequence of the first merged event
+  uint64_t last{0};            /// Sequence of the last merged event
+  uint32_t events{0};          /// Number of merged events
+  bool whole{false};           /// Whether the whole section may have changed
+  Section::BlockMask blocks{}; /// Changed blocks, when not whole
+};
+
+struct ChangeSubscription;
+
+/**
+ * @brief Lock-free ring buffer of the modifications of the chunks.
+ *
+ * Producers take a sequence number with a single atomic increment, then
+ * publish the event in its slot under a per-slot sequence lock. Consumers
+ * never block the producers: each one reads at its own pace through its
+ * subscription, and only learns how many events it lost when it falls
+ * behind by more than the capacity.
+ *
+ * Section events are recorded when a section is replaced or handed out for
+ * modification (Chunk::edit_section), so the section should be read once
+ * the producer is done with it.
+ */
+struct ChangeJournal {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::shared_ptr<ChangeJournal> SharedPtr;
+
+  /// Outcome of the read of a slot
+  enum ReadStatus : uint8_t {
+    READ,       /// The event was read
+    PENDING,    /// The event is not published yet
+    OVERWRITTEN /// The event was overwritten by a later one
+  };
+
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  /**
+   * @brief Create an empty journal.
+   * @param capacity the number of events kept (rounded up to a power of two)
+   */
+  explicit ChangeJournal(size_t capacity = 65536);
+
+  ChangeJournal(const ChangeJournal &) = delete;
+  ChangeJournal &operator=(const ChangeJournal &) = delete;
+
+  static ChangeJournal::SharedPtr make(size_t capacity = 65536) {
+    return std::make_shared<ChangeJournal>(capacity);
+  }
+
+  /*
+   ------------------------------ Record methods ------------------------------
+  */
+public:
+  /**
+   * @brief Record the change of a block.
+   * @return the sequence of the event
+   */
+  uint64_t record_block(const ChunkCoordinate &coord, SectionIndex y,
+                        uint16_t index, const Block *old, const Block *block);
+
+  /**
+   * @brief Record the change of a whole section.
+   * @return the sequence of the event
+   */
+  uint64_t record_section(const ChunkCoordinate &coord, SectionIndex y);
+
+  /*
+   ------------------------------- Read methods -------------------------------
+  */
+public:
+  /**
+   * @brief Sequence of the next recorded event.
+   */
+  inline uint64_t head() const { return next.load(std::memory_order_acquire); }
+
+  inline size_t capacity() const { return mask + 1; }
+
+  /**
+   * @brief Read the event with a given sequence.
+   */
+  ReadStatus read(uint64_t sequence, ChangeEvent &out) const;
+
+  /**
+   * @brief Follow the events recorded from now on.
+   */
+  ChangeSubscription subscribe() const;
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  /// Slot of the ring: its stamp is 2s+1 while the event s is written, then
+  /// 2s+2 once published
+  struct Slot {
+    std::atomic<uint64_t> stamp{0};
+    std::atomic<uint64_t> words[5];
+  };
+
+  /**
+   * @brief Publish an event in its slot.
+   */
+  uint64_t record(const uint64_t (&words)[5]);
+
+  std::unique_ptr<Slot[]> slots;
+  uint64_t mask;
+  alignas(64) std::atomic<uint64_t> next{0};
+};
+
+/**
+ * @brief Cursor of a consumer over a journal.
+ */
+struct ChangeSubscription {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::function<void(const ChangeEvent &)> Sink;
+  typedef std::function<void(const SectionChange &)> SectionSink;
+
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  ChangeSubscription(const ChangeJournal *journal, uint64_t cursor)
+      : journal(journal), cursor(cursor) {}
+
+  /*
+   ------------------------------- Poll methods -------------------------------
+  */
+public:
+  /**
+   * @brief Read the published events, in order.
+   *
+   * @param sink the receiver of the events
+   * @param max the maximal number of events to read
+   * @return the number of read events
+   */
+  size_t poll(const Sink &sink, size_t max = SIZE_MAX);
+
+  /**
+   * @brief Read the published events, merging the consecutive ones of the
+   * same section.
+   *
+   * @param sink the receiver of the merged changes
+   * @param max the maximal number of events to read
+   * @return the number of read events
+   */
+  size_t poll_sections(const SectionSink &sink, size_t max = SIZE_MAX);
+
+  /**
+   * @brief Sequence of the next event to read.
+   */
+  inline uint64_t get_cursor() const { return cursor; }
+
+  /**
+   * @brief Number of events overwritten before being read. A consumer which
+   * lost events should rescan what it follows.
+   */
+  inline uint64_t get_lost() const { return lost; }
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  const ChangeJournal *journal;
+  uint64_t cursor;  /// Next event to read
+  uint64_t lost{0}; /// Events overwritten before being read
+};
+
+} // namespace solis::world
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef SOLIS_WORLD_LIGHT_HPP
+#define SOLIS_WORLD_LIGHT_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the light data of the chunks.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/world/typedef.hpp"
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace solis::world {
+
+constexpr uint8_t MAX_LIGHT{15}; /// Maximal light level
+
+/**
+ * @brief Light levels of the blocks of a section, packed in nibbles.
+ *
+ * The packing is the Anvil one (the block at index i is in the low nibble of
+ * the byte i / 2 when i is even). A uniform array only holds its level.
+ */
+struct LightArray {
+  static constexpr uint16_t BYTES{SECTION_VOLUME / 2}; /// Packed size
+
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  explicit LightArray(uint8_t level = 0) : uniform(level) {}
+
+  /**
+   * @brief Pack the light levels of a whole section.
+   *
+   * @param levels one level per block, in section order
+   * @return the packed array, uniform if every level is the same
+   */
+  static LightArray pack(const uint8_t *levels);
+
+  /**
+   * @brief Unpack the light levels in one byte per block.
+   */
+  void unpack(uint8_t *levels) const;
+
+  /*
+   ------------------------------ Light methods -------------------------------
+  */
+public:
+  inline uint8_t get(uint16_t i) const {
+    return data.empty() ? uniform : (data[i >> 1] >> ((i & 1) << 2)) & 0xF;
+  }
+
+  /**
+   * @brief Set the level of a block, unpacking a uniform array if needed.
+   */
+  void set(uint16_t i, uint8_t level);
+
+  /**
+   * @brief Set the level of every block.
+   */
+  inline void fill(uint8_t level) {
+    data.clear();
+    uniform = level;
+  }
+
+  inline bool is_uniform() const { return data.empty(); }
+  inline const std::vector<uint8_t> &get_data() const { return data; }
+
+  bool operator==(const LightArray &other) const;
+  inline bool operator!=(const LightArray &other) const {
+    return !(*this == other);
+  }
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  std::vector<uint8_t> data; /// Packed levels, empty if uniform
+  uint8_t uniform{0};        /// Level of every block, if uniform
+};
+
+/**
+ * @brief Sky and block light of a section.
+ */
+struct SectionLight {
+  LightArray sky{MAX_LIGHT};
+  LightArray block{0};
+
+  inline bool operator==(const SectionLight &o) const {
+    return (sky == o.sky) && (block == o.block);
+  }
+  inline bool operator!=(const SectionLight &o) const { return !(*this == o); }
+};
+
+/**
+ * @brief Light of the sections of a chunk, indexed by their Y-index.
+ *
+ * The sections above the stored ones are in full sky light, the ones below
+ * are dark. The light of a chunk is immutable once computed, so that it can
+ * be shared with the snapshots of the chunk.
+ */
+struct ChunkLight : std::map<SectionIndex, SectionLight> {
+  typedef std::shared_ptr<const ChunkLight> SharedPtr;
+
+  /**
+   * @brief Sky light of the given section index and block index.
+   */
+  uint8_t get_sky(SectionIndex y, uint16_t i) const;
+
+  /**
+   * @brief Block light of the given section index and block index.
+   */
+  uint8_t get_block(SectionIndex y, uint16_t i) const;
+};
+
+} // namespace solis::world
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef SOLIS_WORLD_LIGHT_ENGINE_HPP
+#define SOLIS_WORLD_LIGHT_ENGINE_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the light engine, computing the sky
+  and block light of the chunks after their edition.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/world/dimension.hpp"
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace solis::world {
+
+/**
+ * @brief Light properties of a block.
+ */
+struct LightInfo {
+  uint8_t opacity{MAX_LIGHT}; /// Light absorbed when crossing the block
+  uint8_t emission{0};        /// Light emitted by the block
+};
+
+/**
+ * @brief Source of the light properties of the blocks.
+ */
+struct LightModel {
+  virtual ~LightModel() = default;
+
+  /**
+   * @brief Light properties of a block (nullptr for air).
+   */
+  virtual LightInfo get(const Block *block) const;
+
+  /**
+   * @brief Model of the vanilla blocks, based on their names: unknown blocks
+   * are opaque and do not emit light.
+   */
+  static const LightModel &vanilla();
+};
+
+/**
+ * @brief Options of the light engine.
+ */
+struct LightOptions {
+  size_t threads{0};     /// Number of workers (0 for the hardware concurrency)
+  uint8_t max_rounds{8}; /// Maximal number of propagation rounds across chunks
+};
+
+/**
+ * @brief Batched sky and block light engine.
+ *
+ * The light of a set of chunks is recomputed from scratch: each chunk is lit
+ * on its own first (sky columns, then a breadth-first propagation from the
+ * lit cells and the light sources), then the chunks exchange their border
+ * light in rounds until no light crosses a border anymore. Every round
+ * processes the chunks in parallel, each reading the light of its neighbours
+ * from the previous round.
+ *
+ * Sections above the highest non-empty section are left in full sky light,
+ * and sections whose light is uniform are stored without their levels.
+ */
+struct LightEngine {
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  explicit LightEngine(const LightModel &model = LightModel::vanilla(),
+                       const LightOptions &options = LightOptions())
+      : model(model), options(options) {}
+
+  /*
+   ------------------------------ Light methods -------------------------------
+  */
+public:
+  /**
+   * @brief Relight chunks of a dimension.
+   *
+   * The loaded neighbours outside of the set are used as fixed light sources.
+   * Light they received from the relit chunks before an edit is not removed,
+   * so relight a margin around the edited chunks (see relight_area).
+   * Sections whose light changed are marked as modified.
+   *
+   * @param dimension the dimension
+   * @param chunks the coordinates of the chunks to relight
+   */
+  void relight(Dimension &dimension,
+               const std::vector<ChunkCoordinate> &chunks);
+
+  /**
+   * @brief Relight the loaded chunks of an edited area, and the chunks
+   * around it.
+   *
+   * @param dimension the dimension
+   * @param min the lowest corner of the edited area
+   * @param max the highest corner of the edited area
+   */
+  void relight_area(Dimension &dimension, const BlockCoordinate &min,
+                    const BlockCoordinate &max);
+
+  /**
+   * @brief Relight a single chunk, without any neighbour.
+   */
+  void relight(Chunk &chunk);
+
+  /**
+   * @brief Light properties of a block, cached.
+   */
+  LightInfo get_info(const Block *block);
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  /**
+   * @brief Relight chunks, reading the light of the other loaded chunks of
+   * the dimension (if any) at their borders.
+   */
+  void relight(const std::vector<Chunk *> &chunks, const Dimension *dimension);
+
+  const LightModel &model;
+  LightOptions options;
+
+  std::shared_mutex cache_mutex;
+  std::unordered_map<const Block *, LightInfo> cache;
+};
+
+} // namespace solis::world
+
+#endif
@@ -15,13 +15,146 @@
   =============================================================================
 */
 
+#include "solis/world/block_index.hpp"
+#include "solis/world/chunk.hpp"
+#include "solis/world/manifest.hpp"
+#include "solis/world/region_file.hpp"
+#include "solis/world/section_pool.hpp"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 namespace solis {
 
+/**
+ * @brief Loader of the worlds stored in the Anvil format.
+ *
+ * Opening a world loads its manifest and only scans the region files that
+ * changed since it was written, so that the existence of a chunk on disk is
+ * known without touching the region files. The loaded chunks share their
+ * identical sections through the pool of the loader.
+ */
 struct WorldLoader {
-
+  /*
+   ------------------------------- World methods ------------------------------
+  */
+public:
+  /**
+   * @brief Open a world directory.
+   *
+   * @param world_name the path of the world directory
+   * @return false if the directory does not exist
+   */
   bool load_world(const char *world_name);
+
+  /**
+   * @brief Path of the opened world directory.
+   */
+  inline const std::string &get_path() const { return path; }
+
+  /**
+   * @brief Manifest of the opened world.
+   */
+  inline const world::WorldManifest &get_manifest() const { return manifest; }
+
+  /**
+   * @brief Bring the manifest up-to-date with the region files, rereading
+   * the headers of the files which changed since the last refresh.
+   *
+   * @return the number of region files that had to be scanned
+   */
+  size_t refresh();
+
+  /*
+   ------------------------------- Chunk methods ------------------------------
+  */
+public:
+  /**
+   * @brief Whether a chunk exists on disk, answered from the manifest.
+   *
+   * @param dim the dimension name ("overworld", "the_nether", ...)
+   * @param coord the chunk coordinates
+   */
+  inline bool is_chunk_on_disk(const std::string &dim,
+                               const world::ChunkCoordinate &coord) const {
+    return manifest.has_chunk(dim, coord);
+  }
+
+  /**
+   * @brief Last modification time of a chunk on disk, from the manifest.
+   *
+   * @param dim the dimension name ("overworld", "the_nether", ...)
+   * @param coord the chunk coordinates
+   * @return the timestamp (in seconds since epoch), 0 if it does not exist
+   */
+  uint32_t get_chunk_timestamp(const std::string &dim,
+                               const world::ChunkCoordinate &coord) const;
+
+  /**
+   * @brief Chunks of a dimension modified at or after a time.
+   *
+   * Only the timestamp tables of the manifest are read, so that incremental
+   * jobs can skip the unchanged chunks without decompressing them. Call
+   * refresh() first to see the files written since the world was opened.
+   *
+   * @param dim the dimension name ("overworld", "the_nether", ...)
+   * @param since the time, in seconds since epoch
+   * @return the range of the chunks, empty if the dimension does not exist
+   */
+  world::DimensionManifest::ModifiedRange
+  modified_since(const std::string &dim, uint32_t since) const;
+
+  /**
+   * @brief Load a chunk from the disk.
+   *
+   * @param dim the dimension name ("overworld", "the_nether", ...)
+   * @param coord the chunk coordinates
+   * @return the chunk, nullptr if it does not exist
+   */
+  world::Chunk::SharedPtr load_chunk(const std::string &dim,
+                                     const world::ChunkCoordinate &coord);
+
+  /**
+   * @brief Get the region file containing a chunk, opening it if needed.
+   *
+   * @param dim the dimension name
+   * @param coord the region coordinates
+   * @return the region file, nullptr if it does not exist
+   */
+  world::RegionFile::SharedPtr
+  get_region_file(const std::string &dim,
+                  const world::RegionCoordinate &coord);
+
+  /**
+   * @brief Bring a block index of a dimension up-to-date with the disk.
+   *
+   * The chunks saved since they were indexed are dropped, then the chunks
+   * not indexed are read (without going through the section pool) and
+   * indexed with their timestamp.
+   *
+   * @param dim the dimension name ("overworld", "the_nether", ...)
+   * @param index the index, e.g. loaded from BlockIndex::filename(dim)
+   * @return the number of chunks that had to be read
+   */
+  size_t update_block_index(const std::string &dim, world::BlockIndex &index);
+
+  /**
+   * @brief Pool of the sections of the loaded chunks.
+   */
+  inline world::SectionPool &get_section_pool() { return sections; }
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  std::string path;
+  world::WorldManifest manifest;
+
+  std::mutex files_mutex;
+  std::unordered_map<std::string, world::RegionFile::SharedPtr> files;
+  world::SectionPool sections;
 };
 
 } // namespace solis
 
-#endif
\ No newline at end of file
+#endif
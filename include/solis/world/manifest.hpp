@@ -0,0 +1,237 @@
+#ifndef SOLIS_WORLD_MANIFEST_HPP
+#define SOLIS_WORLD_MANIFEST_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the world manifest, a persistent index
+  of the region files of a world and of the chunks they contain.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/utils/files.hpp"
+#include "solis/world/region_file.hpp"
+#include <array>
+#include <iterator>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+namespace solis::world {
+
+/**
+ * @brief Summary of a region file: presence, size and timestamp of its chunks.
+ */
+struct RegionManifest {
+  static constexpr uint8_t PRESENCE_WORDS{REGION_CHUNK_COUNT / 64};
+
+  RegionCoordinate coord;
+  int64_t mtime{0}; /// Modification time of the region file (ns)
+  uint64_t size{0}; /// Size of the region file
+  std::array<uint64_t, PRESENCE_WORDS> presence{}; /// Chunk presence bitmap
+  std::array<uint8_t, REGION_CHUNK_COUNT> sectors{}; /// Chunk sizes
+  std::array<uint32_t, REGION_CHUNK_COUNT> timestamps{};
+
+  inline bool has_chunk(uint16_t i) const {
+    return (presence[i / 64] >> (i % 64)) & 1;
+  }
+
+  /**
+   * @brief Number of chunks in the region.
+   */
+  uint16_t chunk_count() const;
+
+  /**
+   * @brief Build the summary of a region from its header.
+   *
+   * @param file the region file
+   * @param coord the coordinates of the region
+   * @param stamp the stamp of the file, taken before it was opened
+   */
+  static RegionManifest scan(const RegionFile &file,
+                             const RegionCoordinate &coord,
+                             const FileStamp &stamp);
+
+  /**
+   * @brief Build the summary of a region file, reading its header again if
+   * it was saved meanwhile.
+   *
+   * @param path the path of the region file
+   * @param coord the coordinates of the region
+   * @throw FileIOError if the file cannot be read
+   */
+  static RegionManifest scan(const std::string &path,
+                             const RegionCoordinate &coord);
+};
+
+/**
+ * @brief Chunk of a dimension, with its last modification time.
+ */
+struct ChunkStamp {
+  ChunkCoordinate coord;
+  uint32_t timestamp{0}; /// In seconds since epoch
+};
+
+/**
+ * @brief Summary of the region files of a dimension.
+ */
+struct DimensionManifest {
+  typedef std::map<std::pair<RegionCoordinate_t, RegionCoordinate_t>,
+                   RegionManifest>
+      RegionMap;
+
+  /**
+   * @brief Forward iterator over the chunks modified since a time, region by
+   * region. It only reads the timestamp tables of the manifest.
+   */
+  struct ModifiedIterator {
+    typedef std::forward_iterator_tag iterator_category;
+    typedef ChunkStamp value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const ChunkStamp *pointer;
+    typedef ChunkStamp reference;
+
+    ModifiedIterator(RegionMap::const_iterator region,
+                     RegionMap::const_iterator last, uint32_t since);
+
+    ChunkStamp operator*() const;
+    ModifiedIterator &operator++();
+    inline ModifiedIterator operator++(int) {
+      ModifiedIterator it = *this;
+      ++*this;
+      return it;
+    }
+    inline bool operator==(const ModifiedIterator &o) const {
+      return (region == o.region) && (index == o.index);
+    }
+    inline bool operator!=(const ModifiedIterator &o) const {
+      return !(*this == o);
+    }
+
+  protected:
+    /**
+     * @brief Move to the first matching chunk from the current position.
+     */
+    void settle();
+
+    RegionMap::const_iterator region;
+    RegionMap::const_iterator last;
+    uint16_t index{0};
+    uint32_t since;
+  };
+
+  /**
+   * @brief Range of the chunks modified since a time.
+   */
+  struct ModifiedRange {
+    ModifiedIterator first;
+    ModifiedIterator last;
+
+    inline ModifiedIterator begin() const { return first; }
+    inline ModifiedIterator end() const { return last; }
+  };
+
+  std::string directory; /// Region directory, relative to the world
+  RegionMap regions;
+
+  /**
+   * @brief Get the summary of a region.
+   * @return the summary, nullptr if the region file does not exist
+   */
+  const RegionManifest *get_region(const RegionCoordinate &coord) const;
+
+  /**
+   * @brief Whether a chunk exists in the region files.
+   */
+  bool has_chunk(const ChunkCoordinate &coord) const;
+
+  /**
+   * @brief Last modification time of a chunk.
+   * @return the timestamp, 0 if the chunk does not exist
+   */
+  uint32_t get_timestamp(const ChunkCoordinate &coord) const;
+
+  /**
+   * @brief Chunks modified at or after a time.
+   * @param since the time, in seconds since epoch
+   */
+  inline ModifiedRange modified_since(uint32_t since) const {
+    return ModifiedRange{
+        ModifiedIterator(regions.begin(), regions.end(), since),
+        ModifiedIterator(regions.end(), regions.end(), since)};
+  }
+};
+
+/**
+ * @brief Persistent index of the region files of a world.
+ *
+ * The manifest is validated against the region files modification time and
+ * size, so that only the region files which changed since the last refresh
+ * have their header read again.
+ */
+struct WorldManifest {
+  /// Name of the manifest file, relative to the world directory
+  static constexpr const char *FILENAME{"solis.manifest"};
+
+  /*
+   ------------------------------- Manifest I/O -------------------------------
+  */
+public:
+  /**
+   * @brief Load a manifest file.
+   * @return false if the file does not exist or is not a valid manifest
+   */
+  bool load(const std::string &path);
+
+  /**
+   * @brief Save the manifest, replacing the file atomically.
+   */
+  void save(const std::string &path) const;
+
+  /**
+   * @brief Bring the manifest up-to-date with the region files of a world.
+   *
+   * @param world_dir the world directory
+   * @return the number of region files that had to be scanned
+   */
+  size_t refresh(const std::string &world_dir);
+
+  /*
+   ------------------------------ Query methods -------------------------------
+  */
+public:
+  /**
+   * @brief Get the summary of a dimension, valid until the next refresh or
+   * load.
+   *
+   * @param name the dimension name ("overworld", "the_nether", ...)
+   * @return the summary, nullptr if the dimension has no region directory
+   */
+  const DimensionManifest *get_dimension(const std::string &name) const;
+
+  /**
+   * @brief Whether a chunk exists on disk.
+   */
+  bool has_chunk(const std::string &dim, const ChunkCoordinate &coord) const;
+
+  inline const std::unordered_map<std::string, DimensionManifest> &
+  get_dimensions() const {
+    return dimensions;
+  }
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  std::unordered_map<std::string, DimensionManifest> dimensions;
+};
+
+} // namespace solis::world
+
+#endif
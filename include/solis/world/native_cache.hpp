@@ -0,0 +1,295 @@
+#ifndef SOLIS_WORLD_NATIVE_CACHE_HPP
+#define SOLIS_WORLD_NATIVE_CACHE_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the solis-native chunk cache format,
+  a memory-mappable dump of the decoded chunks of a region file.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/resources/registry.hpp"
+#include "solis/world/chunk.hpp"
+#include "solis/world/region_file.hpp"
+#include "solis/world/section_pool.hpp"
+#include <string>
+#include <string_view>
+
+namespace solis::world {
+
+// ============================================================================
+//    File layout
+// ============================================================================
+//
+//  [FileHeader] [chunk record]... [IndexEntry x 1024] [FileTrailer]
+//
+//  A chunk record is a [ChunkHeader], its [SectionHeader]s, then the data of
+//  each section: the palette end offsets (uint32_t), the palette names, and
+//  the palette index of each block (uint16_t, absent for uniform sections).
+//  Then come the [LightHeader]s of the lit sections and their packed light
+//  arrays (absent when uniform), and the heightmaps if they were up-to-date:
+//  a [HeightmapsHeader] then the heights (int16_t) of each heightmap.
+//  Every offset of a record is relative to its beginning, every structure is
+//  8-bytes aligned, and the values are in the host endianness.
+
+namespace native {
+
+constexpr char MAGIC[4]{'S', 'L', 'S', 'C'};
+constexpr uint16_t VERSION{3};
+constexpr uint8_t ALIGNMENT{8};
+
+struct FileHeader {
+  char magic[4];
+  uint16_t version;
+  uint8_t big_endian;
+  uint8_t reserved;
+  int64_t source_mtime; /// Modification time of the region file (ns)
+  uint64_t source_size; /// Size of the region file
+};
+
+struct IndexEntry {
+  uint64_t offset;    /// Offset of the chunk record, 0 if absent
+  uint32_t size;      /// Size of the chunk record
+  uint32_t timestamp; /// Region timestamp of the chunk when it was cached
+};
+
+struct FileTrailer {
+  uint64_t index_offset;
+  uint32_t count; /// Number of cached chunks
+  char magic[4];
+};
+
+struct ChunkHeader {
+  int64_t x, z;
+  uint32_t size;              /// Size of the record
+  uint16_t sections;          /// Number of sections
+  uint16_t lights;            /// Number of lit sections
+  uint32_t light_offset;      /// Offset of the light headers
+  uint32_t heightmaps_offset; /// Offset of the heightmaps, 0 if absent
+  int8_t min_section;         /// Lowest section of the world
+  uint8_t reserved[7];
+};
+
+struct SectionHeader {
+  int8_t y;
+  uint8_t reserved;
+  uint16_t palette_size;
+  uint32_t palette_offset; /// Offset of the palette end offsets
+  uint32_t names_offset;   /// Offset of the palette names
+  uint32_t indices_offset; /// Offset of the indices, 0 if uniform
+};
+
+struct LightHeader {
+  int8_t y;
+  uint8_t reserved;
+  uint8_t sky;           /// Sky light level, if uniform
+  uint8_t block;         /// Block light level, if uniform
+  uint32_t sky_offset;   /// Offset of the packed sky light, 0 if uniform
+  uint32_t block_offset; /// Offset of the packed block light, 0 if uniform
+  uint32_t reserved2;
+};
+
+struct HeightmapsHeader {
+  int32_t min_y;
+  uint32_t reserved;
+};
+
+} // namespace native
+
+// ============================================================================
+//    Views
+// ============================================================================
+
+/**
+ * @brief Read-only view on a cached section, reading the mapped memory.
+ */
+struct NativeSectionView {
+  const char *record;
+  const native::SectionHeader *header;
+
+  inline SectionIndex y() const { return header->y; }
+  inline bool is_uniform() const { return header->indices_offset == 0; }
+  inline uint16_t palette_size() const { return header->palette_size; }
+
+  /**
+   * @brief Full name of a palette entry (empty for air).
+   */
+  inline std::string_view palette(uint16_t p) const {
+    auto ends = reinterpret_cast<const uint32_t *>(record +
+                                                   header->palette_offset);
+    const uint32_t begin = (p == 0) ? 0 : ends[p - 1];
+    return std::string_view(record + header->names_offset + begin,
+                            ends[p] - begin);
+  }
+
+  /**
+   * @brief Palette indices of the blocks, nullptr for uniform sections.
+   */
+  inline const PaletteIndex_t *indices() const {
+    if (is_uniform())
+      return nullptr;
+    return reinterpret_cast<const PaletteIndex_t *>(record +
+                                                    header->indices_offset);
+  }
+
+  /**
+   * @brief Full name of the block at the given index (empty for air).
+   */
+  inline std::string_view block(uint16_t i) const {
+    return palette(is_uniform() ? 0 : indices()[i]);
+  }
+};
+
+/**
+ * @brief Read-only view on a cached chunk, reading the mapped memory.
+ */
+struct NativeChunkView {
+  const char *record;
+
+  inline const native::ChunkHeader &header() const {
+    return *reinterpret_cast<const native::ChunkHeader *>(record);
+  }
+  inline ChunkCoordinate coord() const {
+    return ChunkCoordinate(header().x, header().z);
+  }
+  inline uint16_t section_count() const { return header().sections; }
+  inline NativeSectionView section(uint16_t k) const {
+    auto sections = reinterpret_cast<const native::SectionHeader *>(
+        record + sizeof(native::ChunkHeader));
+    return NativeSectionView{record, sections + k};
+  }
+
+  /**
+   * @brief Check that the record fits in its size, and that its sections,
+   * palettes, indices, light and heightmaps stay inside of it.
+   *
+   * @param size the size of the record, from the cache index
+   */
+  bool is_valid(size_t size) const;
+
+  /**
+   * @brief Build a chunk from the view, without any NBT decoding.
+   *
+   * @param registry the registry interning the block states
+   * @param pool the pool sharing the identical sections (none if nullptr)
+   */
+  Chunk::SharedPtr to_chunk(BlockRegistry &registry = BlockRegistry::global(),
+                            SectionPool *pool = nullptr) const;
+};
+
+// ============================================================================
+//    Region cache
+// ============================================================================
+
+/**
+ * @brief Memory-mapped native cache of a region file.
+ *
+ * The cache is built from the region file, and only the chunks whose region
+ * timestamp changed since the previous build are decoded again.
+ */
+struct NativeRegionCache {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::shared_ptr<NativeRegionCache> SharedPtr;
+
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  /**
+   * @brief Map a cache file.
+   * @param path the path of the cache file
+   */
+  explicit NativeRegionCache(const std::string &path);
+  ~NativeRegionCache();
+
+  NativeRegionCache(const NativeRegionCache &) = delete;
+  NativeRegionCache &operator=(const NativeRegionCache &) = delete;
+
+  static NativeRegionCache::SharedPtr open(const std::string &path) {
+    return std::make_shared<NativeRegionCache>(path);
+  }
+
+  /**
+   * @brief Get the conventional file name of a cache ("r.<x>.<z>.slc").
+   */
+  static std::string filename(const RegionCoordinate &coord);
+
+  /*
+   ------------------------------ Chunk methods -------------------------------
+  */
+public:
+  inline bool has_chunk(uint16_t i) const { return index[i].offset != 0; }
+  inline uint32_t get_timestamp(uint16_t i) const {
+    return index[i].timestamp;
+  }
+  /**
+   * @brief View on a cached chunk, checked against the bounds of its record.
+   * @throw FileIOError if the record is damaged
+   */
+  NativeChunkView chunk(uint16_t i) const;
+
+  /**
+   * @brief Load a chunk from the cache.
+   * @return the chunk, nullptr if absent
+   */
+  Chunk::SharedPtr load_chunk(uint16_t i, BlockRegistry &registry =
+                                              BlockRegistry::global()) const;
+
+  /*
+   ------------------------------ Build methods -------------------------------
+  */
+public:
+  /**
+   * @brief Whether the cache is up-to-date with the given region file.
+   */
+  bool is_fresh(const std::string &region_path) const;
+
+  /**
+   * @brief Build (or refresh) the cache of a region file.
+   *
+   * @param region_path the path of the region file
+   * @param cache_path the path of the cache file
+   * @return true if the cache was (re)built, false if it was up-to-date
+   */
+  static bool refresh(const std::string &region_path,
+                      const std::string &cache_path);
+
+  /**
+   * @brief Build (or refresh) the caches of all the region files of a
+   * directory.
+   *
+   * @param region_dir the directory of the region files
+   * @param cache_dir the directory of the cache files
+   * @return the number of rebuilt caches
+   */
+  static size_t refresh_directory(const std::string &region_dir,
+                                  const std::string &cache_dir);
+
+  /**
+   * @brief Append the native record of a chunk to a buffer.
+   */
+  static void append_record(std::string &out, const Chunk &chunk);
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  std::string path;
+  const char *base{nullptr};
+  size_t size{0};
+  const native::FileHeader *header{nullptr};
+  const native::IndexEntry *index{nullptr};
+};
+
+} // namespace solis::world
+
+#endif
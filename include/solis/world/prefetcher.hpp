@@ -0,0 +1,202 @@
+#ifndef SOLIS_WORLD_PREFETCHER_HPP
+#define SOLIS_WORLD_PREFETCHER_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of a movement-aware chunk prefetcher
+  warming the chunks of a dimension ahead of the viewers moving in it.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/world/dimension.hpp"
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace solis::world {
+
+/**
+ * @brief Motion state of a viewer tracked by a chunk prefetcher.
+ */
+struct PrefetchViewer {
+  WorldCoordinate position; /// Current position (in blocks)
+  WorldCoordinate velocity; /// Current velocity (in blocks per second)
+};
+
+/**
+ * @brief Tuning parameters of a chunk prefetcher.
+ */
+struct PrefetchConfig {
+  double horizon{4.0};       /// Look-ahead time (in seconds)
+  uint8_t radius{2};         /// Chunk radius warmed around the path
+  size_t capacity{256};      /// Maximum number of pending prefetches
+  size_t loads_per_tick{16}; /// Maximum number of loads issued per tick
+};
+
+/**
+ * @brief Counters to tune a chunk prefetcher against a workload.
+ */
+struct PrefetchStats {
+  uint64_t hits{0};      /// Demanded chunks warmed by the prefetcher
+  uint64_t misses{0};    /// Demanded chunks loaded on demand
+  uint64_t issued{0};    /// Chunks loaded by the prefetcher
+  uint64_t cancelled{0}; /// Pending prefetches dropped as stale
+  uint64_t wasted{0};    /// Warmed chunks left behind without being used
+};
+
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Predictive chunk prefetcher attached to a dimension.
+ *
+ * The tracked viewers positions are extrapolated along their velocity over a
+ * time horizon, and the chunks they will cross are kept in a bounded ring of
+ * pending loads sorted by their time-to-reach. Each tick loads the most urgent
+ * ones into the dimension. Pending loads that are no longer on any predicted
+ * path (e.g. after a direction change) are cancelled.
+ */
+struct ChunkPrefetcher {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::shared_ptr<ChunkPrefetcher> SharedPtr;
+  typedef uint32_t ViewerID_t;
+
+  /**
+   * @brief Function loading a chunk from its backing storage.
+   * It should return nullptr if the chunk does not exist.
+   */
+  typedef std::function<Chunk::SharedPtr(const ChunkCoordinate &)>
+      ChunkSource;
+
+  typedef PrefetchViewer Viewer;
+  typedef PrefetchConfig Config;
+  typedef PrefetchStats Stats;
+
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  explicit ChunkPrefetcher(Dimension::SharedPtr dimension, ChunkSource source,
+                           const Config &config = Config());
+
+  static ChunkPrefetcher::SharedPtr make(Dimension::SharedPtr dimension,
+                                         ChunkSource source,
+                                         const Config &config = Config()) {
+    return std::make_shared<ChunkPrefetcher>(dimension, source, config);
+  }
+
+  /*
+   ----------------------------- Viewer methods -------------------------------
+  */
+public:
+  /**
+   * @brief Add or update a viewer motion state.
+   *
+   * @param id the viewer identifier
+   * @param position the current viewer position
+   * @param velocity the current viewer velocity (in blocks per second)
+   */
+  void track_viewer(ViewerID_t id, const WorldCoordinate &position,
+                    const WorldCoordinate &velocity);
+
+  /**
+   * @brief Stop tracking the given viewer.
+   */
+  void untrack_viewer(ViewerID_t id);
+
+  /*
+   ---------------------------- Prefetch methods ------------------------------
+  */
+public:
+  /**
+   * @brief Recompute the predicted chunks of all the viewers and cancel the
+   * pending prefetches that are not on any predicted path anymore.
+   */
+  void update();
+
+  /**
+   * @brief Issue the most urgent pending prefetches.
+   *
+   * @return the number of chunks loaded into the dimension
+   */
+  size_t tick();
+
+  /**
+   * @brief Demand access to a chunk, loading it on a miss.
+   * This is the access path whose hits and misses are counted.
+   *
+   * @param coordinates the chunk coordinates
+   * @return a pointer to the chunk, nullptr if it does not exist
+   */
+  Chunk::SharedPtr get_chunk(const ChunkCoordinate &coordinates);
+
+  /**
+   * @brief Demand access to the chunk containing the given coordinates.
+   */
+  template <typename C> inline Chunk::SharedPtr get_chunk(const C &coord) {
+    return get_chunk(cvtCoordinate<ChunkCoordinate>(coord));
+  }
+
+  /*
+   --------------------------- Properties methods -----------------------------
+  */
+public:
+  /**
+   * @brief Number of prefetches waiting to be issued.
+   */
+  inline size_t pending() const { return ring.size(); }
+
+  inline const Stats &get_stats() const { return stats; }
+  inline void reset_stats() { stats = Stats(); }
+
+  inline const Config &get_config() const { return config; }
+  inline void set_config(const Config &c) { config = c; }
+
+  /*
+   ---------------------------- Internal methods ------------------------------
+  */
+protected:
+  typedef std::unordered_map<ChunkCoordinate, double, ChunkCoordinateHash,
+                             ChunkCoordinateEqual>
+      PredictionMap;
+
+  /**
+   * @brief Add the chunks predicted for a viewer to the given map, keeping the
+   * lowest time-to-reach for each of them.
+   */
+  void predict(const Viewer &viewer, PredictionMap &out) const;
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  struct Pending {
+    ChunkCoordinate coord;
+    double eta; /// Estimated time before a viewer reaches the chunk
+  };
+
+  Dimension::SharedPtr dimension; /// Dimension being warmed
+  ChunkSource source;             /// Backing storage of the dimension
+  Config config;
+  Stats stats;
+
+  std::unordered_map<ViewerID_t, Viewer> viewers;
+  std::vector<Pending> ring; /// Pending prefetches, most urgent last
+  std::unordered_set<ChunkCoordinate, ChunkCoordinateHash,
+                     ChunkCoordinateEqual>
+      warmed; /// Prefetched chunks not yet demanded
+};
+
+} // namespace solis::world
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef SOLIS_WORLD_RAYCAST_HPP
+#define SOLIS_WORLD_RAYCAST_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the voxel ray traversal, for the
+  raycasts and line-of-sight queries over a dimension.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/world/dimension.hpp"
+#include <unordered_map>
+#include <vector>
+
+namespace solis::world {
+
+/**
+ * @brief Half-line in the world.
+ */
+struct Ray {
+  WorldCoordinate origin;
+  WorldCoordinate direction; /// Not necessarily normalized
+};
+
+/**
+ * @brief Options of a raycast.
+ */
+struct RayOptions {
+  /// The ray stops on the blocks having every flag of `flags` and none of
+  /// `excluded` (see Block::flags_of): by default, any block but air
+  FlagL_t flags{0};
+  FlagL_t excluded{Block::AIR};
+  double max_distance{512}; /// In blocks
+  size_t threads{0}; /// Workers of the batched casts (0 for the hardware one)
+};
+
+/**
+ * @brief Result of a raycast.
+ */
+struct RayHit {
+  bool hit{false};
+  BlockCoordinate block;  /// Block the ray stopped on
+  BlockCoordinate normal; /// Face it entered through (0 if inside it)
+  const Block *state{nullptr};
+  WorldCoordinate position; /// Point where the ray entered the block
+  double distance{0};       /// Distance from the origin to the position
+  uint32_t steps{0};        /// Cells crossed, skipped ones included
+};
+
+/**
+ * @brief Voxel traversal of rays through the loaded chunks of a dimension.
+ *
+ * The rays walk the grid of blocks (Amanatides and Woo's DDA), but cross
+ * the absent chunks and the uniform sections that cannot stop them (air
+ * ones, absent ones) in a single step. Unloaded chunks are seen as empty.
+ *
+ * A caster indexes the chunks loaded when it is built and shares them
+ * between the rays it casts, possibly in parallel: the chunks should not
+ * be modified meanwhile.
+ */
+struct RayCaster {
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  /**
+   * @brief Index the loaded chunks of a dimension. The chunks compressed in
+   * memory are inflated for the caster, without thawing them.
+   */
+  explicit RayCaster(const Dimension &dimension);
+
+  /*
+   ------------------------------ Cast methods --------------------------------
+  */
+public:
+  /**
+   * @brief Cast a ray.
+   */
+  RayHit cast(const Ray &ray, const RayOptions &options = RayOptions()) const;
+
+  /**
+   * @brief Cast rays on a worker pool.
+   * @return the hits, in the order of the rays
+   */
+  std::vector<RayHit> cast(const std::vector<Ray> &rays,
+                           const RayOptions &options = RayOptions()) const;
+
+  /**
+   * @brief Whether no block stops the segment between two points, besides
+   * the block of the target itself.
+   */
+  bool visible(const WorldCoordinate &from, const WorldCoordinate &to,
+               const RayOptions &options = RayOptions()) const;
+
+  /**
+   * @brief Cast a single ray, resolving the chunks through the dimension
+   * (inflating copies of the compressed ones) instead of indexing them all.
+   */
+  static RayHit cast(const Dimension &dimension, const Ray &ray,
+                     const RayOptions &options = RayOptions());
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  std::unordered_map<ChunkCoordinate, Chunk::SharedPtr, ChunkCoordinateHash,
+                     ChunkCoordinateEqual>
+      chunks;
+};
+
+} // namespace solis::world
+
+#endif
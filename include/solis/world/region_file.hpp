@@ -0,0 +1,323 @@
+#ifndef SOLIS_WORLD_REGION_FILE_HPP
+#define SOLIS_WORLD_REGION_FILE_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of a region file (.mca) handle, allowing
+  to read chunk payloads and to save the modified ones incrementally.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/world/coordinates.hpp"
+#include "solis/world/typedef.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace solis::world {
+
+// ============================================================================
+//    Region file constants
+// ============================================================================
+
+constexpr uint32_t SECTOR_SIZE{4096};       /// Size of a region file sector
+constexpr uint32_t REGION_HEADER_SECTORS{2}; /// Locations + timestamps
+constexpr uint16_t REGION_CHUNK_COUNT{
+    REGION_WIDTH_CHUNK * REGION_WIDTH_CHUNK}; /// Number of chunks in a region
+constexpr uint8_t CHUNK_MAX_SECTORS{255};     /// Sector count of a chunk
+constexpr uint8_t CHUNK_PAYLOAD_HEADER{5};    /// Length (4) + compression (1)
+
+/**
+ * @brief Compression schemes of a chunk payload stored in a region file, as
+ * the values of its compression byte.
+ */
+struct CompressionType {
+  enum : uint8_t {
+    GZIP = 1,
+    ZLIB = 2,
+    NONE = 3,
+    LZ4 = 4,
+    /// Zlib with a preset dictionary. Specific to solis: only for private
+    /// caches and transport, never for the files read by the game.
+    ZLIB_DICT = 0x40
+  };
+};
+
+// ============================================================================
+//    Region file elements
+// ============================================================================
+
+/**
+ * @brief Location of a chunk payload in a region file, in sectors.
+ */
+struct ChunkLocation {
+  uint32_t offset{0}; /// First sector of the payload (0 if absent)
+  uint8_t sectors{0}; /// Number of sectors of the payload
+
+  inline bool exists() const { return offset != 0; }
+};
+
+/**
+ * @brief Compressed chunk payload, as stored in a region file.
+ */
+struct ChunkPayload {
+  uint8_t compression{CompressionType::ZLIB}; /// Compression type byte
+  std::string data;                           /// Compressed chunk NBT
+
+  /**
+   * @brief Number of sectors needed to store this payload.
+   */
+  inline uint32_t sector_count() const {
+    return (data.size() + CHUNK_PAYLOAD_HEADER + SECTOR_SIZE - 1) /
+           SECTOR_SIZE;
+  }
+};
+
+/**
+ * @brief Options for the region file write path.
+ */
+struct RegionWriteOptions {
+  /**
+   * Always rewrite a chunk over its own sectors when the new payload fits in
+   * them. This keeps the file compact, but an interrupted in-place rewrite
+   * damages the old payload. Otherwise, modified chunks are written to free
+   * sectors first, and their old sectors are released once the new location
+   * is durable, so that a crash leaves either the old or the new chunk.
+   */
+  bool reuse_in_place{false};
+  /**
+   * Number of sectors a commit may append to the file when no free run fits
+   * a payload. Past it, the chunks fitting in their own sectors are rewritten
+   * in place (without the old-or-new guarantee) rather than growing the file
+   * further. The freed sectors are reused by the next commits, so a file
+   * saved over and over grows by at most this budget.
+   */
+  uint32_t max_growth{256};
+  bool sync{true}; /// Flush to the storage between the commit steps
+};
+
+// ============================================================================
+//    Region file
+// ============================================================================
+
+/**
+ * @brief Handle on a region file (.mca).
+ *
+ * The location and timestamp tables are loaded once at opening, and a bitmap
+ * of the free sectors is built from the location table. Chunks are saved
+ * through a batch of staged payloads which is committed in three durable
+ * steps: the payloads, the timestamp table then the location table. Only
+ * the sectors of the modified chunks and the header are ever written.
+ *
+ * Reads are positional and can be issued concurrently, writes cannot.
+ */
+struct RegionFile {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::shared_ptr<RegionFile> SharedPtr;
+  typedef uint8_t LocalCoord_t; /// Chunk coordinate inside of the region
+
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  /**
+   * @brief Open a region file.
+   *
+   * @param path the path of the region file
+   * @param writable whether to open it for writing (creating it if needed)
+   * @param options the options of the write path
+   */
+  explicit RegionFile(const std::string &path, bool writable = false,
+                      const RegionWriteOptions &options = RegionWriteOptions());
+  ~RegionFile();
+
+  RegionFile(const RegionFile &) = delete;
+  RegionFile &operator=(const RegionFile &) = delete;
+
+  static RegionFile::SharedPtr
+  open(const std::string &path, bool writable = false,
+       const RegionWriteOptions &options = RegionWriteOptions()) {
+    return std::make_shared<RegionFile>(path, writable, options);
+  }
+
+  /**
+   * @brief Get the conventional file name of a region ("r.<x>.<z>.mca").
+   */
+  static std::string filename(const RegionCoordinate &coord);
+
+  /**
+   * @brief Parse the coordinates of a region from its file name.
+   * @return false if the name is not the one of a region file
+   */
+  static bool parse_filename(const std::string &name, RegionCoordinate &coord);
+
+  /*
+   ------------------------------ Header methods ------------------------------
+  */
+public:
+  /**
+   * @brief Index of a chunk in the region header tables.
+   */
+  static inline uint16_t index(LocalCoord_t x, LocalCoord_t z) {
+    return (x % REGION_WIDTH_CHUNK) + (z % REGION_WIDTH_CHUNK) *
+                                          REGION_WIDTH_CHUNK;
+  }
+
+  /**
+   * @brief Index of a chunk in the region header tables.
+   */
+  static inline uint16_t index(const ChunkCoordinate &coord) {
+    return index(coord.x & (REGION_WIDTH_CHUNK - 1),
+                 coord.z & (REGION_WIDTH_CHUNK - 1));
+  }
+
+  /**
+   * @brief Coordinates of the chunk at an index of a region.
+   */
+  static inline ChunkCoordinate chunk_coordinate(const RegionCoordinate &region,
+                                                 uint16_t i) {
+    return ChunkCoordinate(
+        static_cast<ChunkCoordinate_t>(region.x) * REGION_WIDTH_CHUNK +
+            i % REGION_WIDTH_CHUNK,
+        static_cast<ChunkCoordinate_t>(region.z) * REGION_WIDTH_CHUNK +
+            i / REGION_WIDTH_CHUNK);
+  }
+
+  inline bool has_chunk(uint16_t i) const { return locations[i].exists(); }
+  inline const ChunkLocation &get_location(uint16_t i) const {
+    return locations[i];
+  }
+
+  /**
+   * @brief Last modification time of a chunk (in seconds since epoch).
+   */
+  inline uint32_t get_timestamp(uint16_t i) const { return timestamps[i]; }
+
+  /*
+   ------------------------------ Read methods --------------------------------
+  */
+public:
+  /**
+   * @brief Read the compressed payload of a chunk.
+   *
+   * @param i the index of the chunk in the region
+   * @param out the payload to fill
+   * @return false if the chunk is not in the region
+   */
+  bool read_chunk(uint16_t i, ChunkPayload &out) const;
+
+  /*
+   ------------------------------ Write methods -------------------------------
+  */
+public:
+  /**
+   * @brief Stage a chunk payload to be written at the next commit.
+   *
+   * @param i the index of the chunk in the region
+   * @param payload the compressed payload
+   * @param timestamp the modification time (0 for the current time)
+   */
+  void stage_chunk(uint16_t i, ChunkPayload payload, uint32_t timestamp = 0);
+
+  /**
+   * @brief Stage the payload of a chunk of another region file, as it is and
+   * with its timestamp, without decompressing it.
+   *
+   * @param source the region file to copy from
+   * @param from the index of the chunk in the source
+   * @param to the index of the chunk in this region
+   * @param bytes if not null, incremented by the size of the payload
+   * @return false if the chunk is not in the source
+   */
+  bool stage_copy(const RegionFile &source, uint16_t from, uint16_t to,
+                  uint64_t *bytes = nullptr);
+
+  /**
+   * @brief Stage the removal of a chunk from the region.
+   */
+  void stage_removal(uint16_t i);
+
+  /**
+   * @brief Number of staged modifications.
+   */
+  inline size_t staged() const { return batch.size(); }
+
+  /**
+   * @brief Write the staged modifications to the file.
+   */
+  void commit();
+
+  /*
+   --------------------------- Properties methods -----------------------------
+  */
+public:
+  inline const std::string &get_path() const { return path; }
+
+  /**
+   * @brief Number of sectors of the file.
+   */
+  inline uint32_t sector_count() const { return used.size(); }
+
+  /**
+   * @brief Number of free sectors inside of the file.
+   */
+  uint32_t free_sectors() const;
+
+  /*
+   ---------------------------- Internal methods ------------------------------
+  */
+protected:
+  void read_header();
+  void build_free_map();
+
+  /**
+   * @brief Find a run of free sectors (first-fit), growing the file if none
+   * is large enough. The sectors are marked as used.
+   */
+  uint32_t allocate(uint32_t count);
+
+  /**
+   * @brief Number of sectors allocate would append to the file.
+   */
+  uint32_t growth(uint32_t count) const;
+  void mark(uint32_t offset, uint32_t count, bool value);
+
+  void write_at(const void *data, size_t size, uint64_t offset);
+  void read_at(void *data, size_t size, uint64_t offset) const;
+  void flush();
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  struct Staged {
+    uint16_t index;
+    uint32_t timestamp;
+    bool removal;
+    ChunkPayload payload;
+  };
+
+  std::string path;
+  int fd{-1};
+  bool writable;
+  RegionWriteOptions options;
+
+  std::array<ChunkLocation, REGION_CHUNK_COUNT> locations;
+  std::array<uint32_t, REGION_CHUNK_COUNT> timestamps;
+  std::vector<bool> used; /// Sector allocation bitmap
+  std::vector<Staged> batch;
+};
+
+} // namespace solis::world
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef SOLIS_WORLD_SAVER_HPP
+#define SOLIS_WORLD_SAVER_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the incremental saver writing the
+  modified chunks of a dimension back to its region files.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/world/dimension.hpp"
+#include "solis/world/region_file.hpp"
+#include <functional>
+#include <string>
+
+namespace solis::world {
+
+/**
+ * @brief Incremental saver of a dimension.
+ *
+ * Only the chunks reported by Dimension::collect_dirty() are encoded, and each
+ * region file is updated with a single commit, so that the cost of a save is
+ * proportional to what changed since the previous one.
+ */
+struct ChunkSaver {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::shared_ptr<ChunkSaver> SharedPtr;
+
+  /**
+   * @brief Function serializing and compressing a chunk. The section mask
+   * tells which sections were modified since the last save.
+   */
+  typedef std::function<ChunkPayload(const Chunk &, const Chunk::SectionMask &)>
+      ChunkEncoder;
+
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  /**
+   * @param region_dir the directory holding the region files
+   * @param encoder the function encoding the chunks
+   * @param options the options of the region files write path
+   */
+  explicit ChunkSaver(const std::string &region_dir, ChunkEncoder encoder,
+                      const RegionWriteOptions &options = RegionWriteOptions())
+      : region_dir(region_dir), encoder(encoder), options(options) {}
+
+  static ChunkSaver::SharedPtr
+  make(const std::string &region_dir, ChunkEncoder encoder,
+       const RegionWriteOptions &options = RegionWriteOptions()) {
+    return std::make_shared<ChunkSaver>(region_dir, encoder, options);
+  }
+
+  /*
+   ------------------------------- Save methods -------------------------------
+  */
+public:
+  /**
+   * @brief Save the modified chunks of a region with a single commit.
+   *
+   * The chunks without source (e.g. loaded from a native cache, or decoded
+   * without AnvilReadOptions::keep_source) get the one stored in the region
+   * file, if any, so that the encoder patches it instead of dropping the data
+   * the chunks do not model.
+   *
+   * @param region the modified chunks of the region
+   */
+  void save(const DirtyRegion &region) const;
+
+  /**
+   * @brief Save the given modified chunks.
+   *
+   * @param dirty the modified chunks, grouped by region
+   * @return the number of saved chunks
+   */
+  size_t save(const std::vector<DirtyRegion> &dirty) const;
+
+  /**
+   * @brief Save the chunks of the dimension modified since the last save.
+   * The chunks of the regions that failed to be saved are marked as modified
+   * again before the error is propagated.
+   *
+   * @param dimension the dimension to save
+   * @return the number of saved chunks
+   */
+  size_t save(Dimension &dimension) const;
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  std::string region_dir;
+  ChunkEncoder encoder;
+  RegionWriteOptions options;
+};
+
+} // namespace solis::world
+
+#endif
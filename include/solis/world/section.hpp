@@ -0,0 +1,212 @@
+#ifndef SOLIS_WORLD_SECTION_HPP
+#define SOLIS_WORLD_SECTION_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of a chunk section, the 16x16x16 block
+  storage unit of the chunks.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/world/typedef.hpp"
+#include <array>
+#include <vector>
+
+namespace solis::world {
+
+typedef uint16_t PaletteIndex_t; /// Index of a block in a section palette
+
+/**
+ * @brief Box of blocks inside of a section, bounds included.
+ */
+struct SectionBox {
+  InChunkCoord_t x0{0}, y0{0}, z0{0};
+  InChunkCoord_t x1{CHUNK_SIZE - 1}, y1{CHUNK_SIZE - 1}, z1{CHUNK_SIZE - 1};
+
+  /**
+   * @brief Whether the box covers the whole section.
+   */
+  inline bool is_full() const {
+    return (x0 == 0) && (y0 == 0) && (z0 == 0) && (x1 == CHUNK_SIZE - 1) &&
+           (y1 == CHUNK_SIZE - 1) && (z1 == CHUNK_SIZE - 1);
+  }
+};
+
+/**
+ * @brief Cube of 16x16x16 blocks.
+ *
+ * The blocks are stored as a palette of the distinct blocks of the section
+ * and an index in this palette for each block (in YZX order). A uniform
+ * section only holds its palette. A null block stands for air.
+ */
+struct Section {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::shared_ptr<Section> SharedPtr;
+  typedef std::shared_ptr<const Section> ConstSharedPtr;
+  typedef std::vector<const Block *> Palette;
+  typedef std::vector<PaletteIndex_t> Indices;
+  /// One bit per block of the section, in index order
+  typedef std::array<uint64_t, SECTION_VOLUME / 64> BlockMask;
+
+  /*
+   ------------------------------ Constructor ---------------------------------
+  */
+public:
+  /**
+   * @brief Create a uniform section.
+   * @param fill the block filling the section
+   */
+  explicit Section(const Block *fill = nullptr) : palette{fill} {}
+
+  /**
+   * @brief Create a section from its palette and indices.
+   * @param palette the distinct blocks of the section
+   * @param indices the palette index of each block (empty if uniform)
+   */
+  explicit Section(Palette palette, Indices indices);
+
+  static Section::SharedPtr make(const Block *fill = nullptr) {
+    return std::make_shared<Section>(fill);
+  }
+
+  /*
+   ------------------------------ Block methods -------------------------------
+  */
+public:
+  /**
+   * @brief Index of a block in the section.
+   */
+  static inline uint16_t index(InChunkCoord_t x, InChunkCoord_t y,
+                               InChunkCoord_t z) {
+    return (y << 8) | (z << 4) | x;
+  }
+
+  /**
+   * @brief Get the block at the given index.
+   */
+  inline const Block *get_block(uint16_t i) const {
+    return indices.empty() ? palette[0] : palette[indices[i]];
+  }
+
+  /**
+   * @brief Set the block at the given index.
+   * @return true if the block changed
+   */
+  bool set_block(uint16_t i, const Block *block);
+
+  /**
+   * @brief Fill the whole section with a single block.
+   */
+  void fill(const Block *block);
+
+  /**
+   * @brief Fill a box of the section with a single block.
+   */
+  void fill(const Block *block, const SectionBox &box);
+
+  /**
+   * @brief Replace every occurrence of a block by another one, by remapping
+   * the palette. The indices are only rewritten if both blocks are in it.
+   * @return false if the block is not in the palette
+   */
+  bool replace(const Block *from, const Block *to);
+
+  /**
+   * @brief Replace the occurrences of a block inside of a box.
+   * @return false if the block is not in the palette
+   */
+  bool replace(const Block *from, const Block *to, const SectionBox &box);
+
+  /**
+   * @brief Drop the unused palette entries, turning the section uniform if
+   * only one remains.
+   */
+  void compact();
+
+  /**
+   * @brief Whether compact() would leave the section as it is: every palette
+   * entry is used, in their first-use order.
+   */
+  bool is_compact() const;
+
+  /*
+   ------------------------------ Scan methods --------------------------------
+  */
+public:
+  /**
+   * @brief Count the blocks having every flag of `flags` and none of
+   * `excluded` (see Block::flags_of).
+   *
+   * The predicate is evaluated once per palette entry, then mapped over the
+   * indices by a branchless loop.
+   */
+  uint16_t count(FlagL_t flags, FlagL_t excluded = 0) const;
+
+  /**
+   * @brief Whether a block has every flag of `flags` and none of `excluded`.
+   */
+  bool any(FlagL_t flags, FlagL_t excluded = 0) const;
+
+  /**
+   * @brief Mark the blocks having every flag of `flags` and none of
+   * `excluded`.
+   * @return the number of marked blocks
+   */
+  uint16_t match(BlockMask &out, FlagL_t flags, FlagL_t excluded = 0) const;
+
+  /**
+   * @brief Mark the blocks of a given state (nullptr for air).
+   * @return the number of marked blocks
+   */
+  uint16_t match(BlockMask &out, const Block *block) const;
+
+  /*
+   --------------------------- Properties methods -----------------------------
+  */
+public:
+  inline bool is_uniform() const { return indices.empty(); }
+  inline bool is_empty() const {
+    return indices.empty() && (palette[0] == nullptr);
+  }
+
+  inline const Palette &get_palette() const { return palette; }
+  inline const Indices &get_indices() const { return indices; }
+
+  /**
+   * @brief Approximate heap memory of the section, its own object included.
+   */
+  inline size_t memory_usage() const {
+    return sizeof(Section) + palette.capacity() * sizeof(const Block *) +
+           indices.capacity() * sizeof(PaletteIndex_t);
+  }
+
+  /*
+   ---------------------------- Internal methods ------------------------------
+  */
+protected:
+  /**
+   * @brief Palette index of a block, added to the palette (and the section
+   * made non-uniform) if needed.
+   */
+  PaletteIndex_t palette_index(const Block *block);
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  Palette palette; /// Distinct blocks of the section (never empty)
+  Indices indices; /// Palette index of each block, empty if uniform
+};
+
+} // namespace solis::world
+
+#endif
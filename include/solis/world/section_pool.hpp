@@ -0,0 +1,117 @@
+#ifndef SOLIS_WORLD_SECTION_POOL_HPP
+#define SOLIS_WORLD_SECTION_POOL_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the section pool, sharing the
+  sections of identical content between the chunks.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/world/section.hpp"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace solis::world {
+
+/**
+ * @brief Statistics of a section pool.
+ */
+struct SectionPoolStats {
+  size_t lookups{0};     /// Sections given to intern()
+  size_t hits{0};        /// Sections replaced by an existing one
+  size_t unique{0};      /// Distinct sections currently in the pool
+  size_t saved_bytes{0}; /// Memory of the sections dropped on a hit
+};
+
+/**
+ * @brief Hash-consing store of the sections.
+ *
+ * Interning a section returns the pooled section of identical content (same
+ * palette, in the same order, and same indices) if there is one, so that all
+ * the stone or water sections of a world, or the repeated sections of flat
+ * worlds, are stored once. Sections are compared in their compacted form.
+ *
+ * The pool keeps a reference on its sections: their use count is at least
+ * two while a chunk holds them, so that the copy-on-write of the chunks
+ * copies a pooled section before its first modification. The sections only
+ * held by the pool are dropped by purge(), which also runs as the pool grows.
+ * The pool can be used from several threads.
+ */
+struct SectionPool {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::shared_ptr<SectionPool> SharedPtr;
+
+  static SectionPool::SharedPtr make() {
+    return std::make_shared<SectionPool>();
+  }
+
+  /*
+   ------------------------------- Pool methods -------------------------------
+  */
+public:
+  /**
+   * @brief Get the pooled section with the content of a section, adding it
+   * to the pool if there is none.
+   *
+   * @param section the section, which should not be modified afterwards. It
+   * is compacted in place only if the caller holds the single reference on
+   * it, otherwise a compacted copy is pooled
+   * @return the pooled section, read-only as it may be shared
+   */
+  Section::ConstSharedPtr intern(const Section::SharedPtr &section);
+
+  /**
+   * @brief Drop the sections only referenced by the pool.
+   * @return the number of dropped sections
+   */
+  size_t purge();
+
+  /**
+   * @brief Number of distinct sections in the pool.
+   */
+  size_t size() const;
+
+  SectionPoolStats get_stats() const;
+
+  /**
+   * @brief Hash of the content of a section.
+   */
+  static uint64_t hash(const Section &section);
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+protected:
+  static constexpr size_t SHARD_COUNT{16};
+
+  /// Part of the pool, locked on its own
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_multimap<uint64_t, Section::ConstSharedPtr> sections;
+    size_t purge_at{64}; /// Size triggering the next purge
+  };
+
+  /**
+   * @brief Drop the sections of a shard only referenced by the pool.
+   */
+  static size_t purge(Shard &shard);
+
+  std::array<Shard, SHARD_COUNT> shards;
+  std::atomic<size_t> lookups{0}, hits{0}, saved_bytes{0};
+};
+
+} // namespace solis::world
+
+#endif
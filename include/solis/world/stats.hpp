@@ -0,0 +1,136 @@
+#ifndef SOLIS_WORLD_STATS_HPP
+#define SOLIS_WORLD_STATS_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the block statistics scanner, which
+  counts the blocks of a dimension or of its region files.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/resources/registry.hpp"
+#include "solis/world/dimension.hpp"
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace solis::world {
+
+/**
+ * @brief Number of blocks of each type, keyed by block identity (nullptr for
+ * air). Only the stored sections are counted, so the air of absent sections
+ * is not.
+ */
+struct BlockHistogram {
+  /*
+   --------------------------------- Typedef ----------------------------------
+  */
+  typedef std::unordered_map<const Block *, uint64_t> Counts;
+
+  /*
+   ------------------------------ Count methods -------------------------------
+  */
+public:
+  /**
+   * @brief Count the blocks of a section.
+   *
+   * The palette indices are counted, then weighted into the palette blocks,
+   * so the blocks themselves are never resolved.
+   *
+   * @param section the section
+   * @param y the index of the section in its chunk
+   * @param by_y whether to also count by block Y level
+   */
+  void add(const Section &section, SectionIndex y, bool by_y = false);
+
+  /**
+   * @brief Count the blocks of a chunk.
+   */
+  void add(const Chunk &chunk, bool by_y = false);
+
+  /**
+   * @brief Add the counts of another histogram.
+   */
+  void merge(const BlockHistogram &other);
+
+  /*
+   ------------------------------ Query methods -------------------------------
+  */
+public:
+  /**
+   * @brief Number of blocks of a type.
+   */
+  uint64_t count(const Block *block) const;
+
+  /**
+   * @brief Block types sorted by decreasing count.
+   */
+  std::vector<std::pair<const Block *, uint64_t>> sorted() const;
+
+  /*
+   -------------------------------- Properties --------------------------------
+  */
+public:
+  Counts total;                             /// Counts of the whole scan
+  std::map<BlockCoordinate_t, Counts> by_y; /// Counts by Y level, if asked
+  uint64_t chunks{0};                       /// Number of scanned chunks
+  uint64_t sections{0};                     /// Number of scanned sections
+};
+
+/**
+ * @brief Options of a statistics scan.
+ */
+struct StatsOptions {
+  bool by_y{false};  /// Whether to count by block Y level
+  size_t threads{0}; /// Number of workers (0 for the hardware concurrency)
+  /// Chunks to scan (all of them if not set)
+  std::function<bool(const ChunkCoordinate &)> filter;
+};
+
+/**
+ * @brief Parallel scanner of the blocks of a dimension.
+ *
+ * Each worker fills its own histogram, which are merged at the end.
+ */
+struct BlockStats {
+  /**
+   * @brief Count the blocks of the loaded chunks of a dimension, the ones
+   * compressed in memory included (inflated one at a time).
+   *
+   * The dimension must not be modified during the scan: scan a snapshot() of
+   * a live dimension.
+   *
+   * @param dimension the dimension
+   * @param options the scan options
+   * @return the block counts
+   */
+  static BlockHistogram scan(const Dimension &dimension,
+                             const StatsOptions &options = StatsOptions());
+
+  /**
+   * @brief Count the blocks of the chunks stored in a region directory.
+   *
+   * @param region_dir the directory of the region files
+   * @param options the scan options
+   * @param registry the registry interning the block states
+   * @return the block counts
+   */
+  static BlockHistogram
+  scan_directory(const std::string &region_dir,
+                 const StatsOptions &options = StatsOptions(),
+                 BlockRegistry &registry = BlockRegistry::global());
+};
+
+} // namespace solis::world
+
+#endif
@@ -0,0 +1,178 @@
+#ifndef SOLIS_WORLD_TRANSCODER_HPP
+#define SOLIS_WORLD_TRANSCODER_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the region transcoder, re-encoding the
+  chunk payloads of region files with another compression, and measuring the
+  compression settings on existing worlds.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/utils/zdictionary.hpp"
+#include "solis/world/region_file.hpp"
+#include <string>
+#include <vector>
+
+namespace solis::world {
+
+/**
+ * @brief Compression setting of the chunk payloads.
+ */
+struct CodecSetting {
+  uint8_t compression{CompressionType::ZLIB}; /// Compression type
+  uint8_t level{6}; /// Compression level (zlib levels, unused by NONE)
+  ZDictionary::SharedPtr dictionary; /// Preset dictionary (ZLIB_DICT only)
+
+  /**
+   * @brief Readable name of the setting ("zlib-6", "none", ...).
+   */
+  std::string name() const;
+};
+
+/**
+ * @brief Measures of a compression setting on a set of chunks.
+ */
+struct CodecReport {
+  CodecSetting setting;
+  size_t chunks{0};          /// Encoded chunks
+  uint64_t raw_bytes{0};     /// Size of the chunk NBTs
+  uint64_t bytes{0};         /// Size of the compressed payloads
+  uint64_t sectors{0};       /// Region sectors needed by the payloads
+  double encode_seconds{0};  /// Time spent compressing
+  double decode_seconds{0};  /// Time spent decompressing (if measured)
+
+  /**
+   * @brief Compression ratio (raw size over compressed size).
+   */
+  inline double ratio() const {
+    return (bytes == 0) ? 0 : static_cast<double>(raw_bytes) / bytes;
+  }
+
+  /**
+   * @brief Compression throughput, in raw MB/s.
+   */
+  inline double encode_throughput() const {
+    return (encode_seconds == 0) ? 0 : raw_bytes / encode_seconds / 1e6;
+  }
+
+  /**
+   * @brief Decompression throughput, in raw MB/s.
+   */
+  inline double decode_throughput() const {
+    return (decode_seconds == 0) ? 0 : raw_bytes / decode_seconds / 1e6;
+  }
+
+  /**
+   * @brief Add the measures of another report of the same setting.
+   */
+  void merge(const CodecReport &other);
+
+  /**
+   * @brief One-line summary of the report.
+   */
+  std::string summary() const;
+};
+
+/**
+ * @brief Options of a transcoding.
+ */
+struct TranscodeOptions {
+  size_t threads{0}; /// Number of workers (0 for the hardware concurrency)
+  bool measure_decode{false}; /// Also time the decompression of the output
+  size_t max_chunks{0}; /// Chunks per region to benchmark (0 for all of them)
+  /// Preset dictionary of the source ZLIB_DICT payloads
+  ZDictionary::SharedPtr source_dictionary;
+};
+
+/**
+ * @brief Transcoder of the chunk payloads of the region files.
+ *
+ * Every payload is decompressed once, then compressed with the target
+ * setting(s) on a pool of workers. Only the codecs supported by the ZLib
+ * wrapper are available: GZIP, ZLIB, ZLIB_DICT and NONE.
+ */
+struct Transcoder {
+  /*
+   ---------------------------- Transcode methods -----------------------------
+  */
+public:
+  /**
+   * @brief Transcode a region file.
+   *
+   * The new file is written next to the destination then renamed over it, so
+   * the destination can be the source itself. On error, the destination is
+   * left untouched and the new file removed.
+   *
+   * The chunks too large for the target setting are kept as they were, and
+   * counted in the report with their kept payload.
+   *
+   * @param from the path of the source region file
+   * @param to the path of the destination region file
+   * @param target the compression setting of the new payloads
+   * @param report the measures to fill
+   * @param options the transcoding options
+   */
+  static void transcode_file(const std::string &from, const std::string &to,
+                             const CodecSetting &target, CodecReport &report,
+                             const TranscodeOptions &options =
+                                 TranscodeOptions());
+
+  /**
+   * @brief Transcode the region files of a directory, in parallel.
+   *
+   * @param from the source directory
+   * @param to the destination directory (created if needed, can be the same)
+   * @param target the compression setting of the new payloads
+   * @param options the transcoding options
+   * @return the measures of the transcoding
+   */
+  static CodecReport transcode_directory(const std::string &from,
+                                         const std::string &to,
+                                         const CodecSetting &target,
+                                         const TranscodeOptions &options =
+                                             TranscodeOptions());
+
+  /*
+   ---------------------------- Benchmark methods -----------------------------
+  */
+public:
+  /**
+   * @brief Measure several compression settings on the chunks of a region
+   * directory, without writing anything.
+   *
+   * @param dir the directory of the region files
+   * @param settings the settings to measure
+   * @param options the options (max_chunks to only sample the regions)
+   * @return a report per setting, in the same order
+   */
+  static std::vector<CodecReport>
+  benchmark_directory(const std::string &dir,
+                      const std::vector<CodecSetting> &settings,
+                      const TranscodeOptions &options = TranscodeOptions());
+
+  /**
+   * @brief Train a preset dictionary on the chunks of a region directory.
+   *
+   * @param dir the directory of the region files
+   * @param per_region the number of chunks sampled in each region
+   * @param size the maximal size of the dictionary
+   * @param options the options (source_dictionary only)
+   * @return the dictionary
+   */
+  static ZDictionary::SharedPtr
+  train_dictionary(const std::string &dir, size_t per_region = 16,
+                   size_t size = ZDictionary::MAX_SIZE,
+                   const TranscodeOptions &options = TranscodeOptions());
+};
+
+} // namespace solis::world
+
+#endif
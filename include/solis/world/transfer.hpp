@@ -0,0 +1,165 @@
+#ifndef SOLIS_WORLD_TRANSFER_HPP
+#define SOLIS_WORLD_TRANSFER_HPP
+
+/**
+  =================================== SOLIS ===================================
+
+  This file contains the description of the chunk transfers between region
+  files, copying the compressed payloads as they are.
+
+  @author    Meltwin
+  @date      18/10/26
+  @version   0.0.1
+  @copyright Meltwin - 2025
+             Distributed under the MIT Licence
+  =============================================================================
+*/
+
+#include "solis/utils/zdictionary.hpp"
+#include "solis/world/region_file.hpp"
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <string>
+
+namespace solis::world {
+
+/**
+ * @brief Chunk examined by a transfer filter.
+ *
+ * The candidate is built from the region header only: the payload is read
+ * if the filter asks for it, and only inflated if the filter asks for the
+ * chunk NBT, each at most once.
+ */
+struct ChunkCandidate {
+  ChunkCoordinate coord;
+  uint16_t index;     /// Index of the chunk in its region
+  uint32_t timestamp; /// Modification time of the chunk
+  const RegionFile &file;
+
+  /**
+   * @brief Compressed payload, as in the file, read on the first call.
+   */
+  const ChunkPayload &payload() const;
+
+  /**
+   * @brief Uncompressed NBT of the chunk, inflated on the first call.
+   */
+  const std::string &nbt() const;
+
+  inline bool is_read() const { return read.has_value(); }
+  inline bool is_inflated() const { return inflated.has_value(); }
+
+  const ZDictionary *dictionary{nullptr}; /// For ZLIB_DICT payloads
+  mutable std::optional<ChunkPayload> read;
+  mutable std::optional<std::string> inflated;
+};
+
+/**
+ * @brief Selection of the chunks of a transfer: true to keep the chunk.
+ */
+typedef std::function<bool(const ChunkCandidate &)> ChunkFilter;
+
+/**
+ * @brief Chunk kept when both the source and the target hold it.
+ */
+enum class MergeConflict : uint8_t {
+  OVERWRITE, /// The source one
+  KEEP,      /// The target one
+  NEWEST     /// The one with the latest timestamp (the target one if equal)
+};
+
+/**
+ * @brief Options of a transfer.
+ */
+struct TransferOptions {
+  MergeConflict conflict{MergeConflict::OVERWRITE};
+  size_t threads{0}; /// Number of workers (0 for the hardware concurrency)
+  ZDictionary::SharedPtr dictionary; /// For the ZLIB_DICT payloads
+};
+
+/**
+ * @brief Counters of a transfer.
+ */
+struct TransferStats {
+  std::atomic<size_t> regions{0};  /// Region files examined
+  std::atomic<size_t> copied{0};   /// Chunks copied to a target
+  std::atomic<size_t> removed{0};  /// Chunks removed by a trim
+  std::atomic<size_t> skipped{0};  /// Chunks rejected by a filter or conflict
+  std::atomic<size_t> read{0};     /// Payloads the filters read
+  std::atomic<size_t> inflated{0}; /// Payloads the filters looked inside
+  std::atomic<uint64_t> bytes{0};  /// Compressed bytes copied
+};
+
+/**
+ * @brief Raw chunk transfers between region files.
+ *
+ * The payloads move with their compression type byte and their timestamp
+ * (RegionFile::stage_copy), without being decompressed nor compressed again:
+ * a chunk is only read when a merge copies it or a filter reads its payload,
+ * and only inflated when a filter reads its NBT. A trim whose filter only
+ * looks at the coordinates and timestamps reads the headers alone.
+ *
+ * The targets are modified through the staged commit of RegionFile, so that a
+ * crash leaves either the old or the new chunk. The files must not be
+ * written by anyone else meanwhile.
+ */
+struct ChunkTransfer {
+  /*
+   ------------------------------- File methods -------------------------------
+  */
+public:
+  /**
+   * @brief Copy the chunks of a region file into another one (created if
+   * needed).
+   *
+   * @param from the path of the source region file
+   * @param to the path of the target region file
+   * @param stats the counters to fill
+   * @param filter the chunks to copy (all of them if empty)
+   * @param options the transfer options
+   */
+  static void merge_file(const std::string &from, const std::string &to,
+                         TransferStats &stats,
+                         const ChunkFilter &filter = ChunkFilter(),
+                         const TransferOptions &options = TransferOptions());
+
+  /**
+   * @brief Remove the chunks of a region file rejected by a filter. Only the
+   * header of the file is rewritten, and a file left empty is deleted.
+   *
+   * @param path the path of the region file
+   * @param stats the counters to fill
+   * @param filter the chunks to keep
+   * @param options the transfer options
+   */
+  static void trim_file(const std::string &path, TransferStats &stats,
+                        const ChunkFilter &filter,
+                        const TransferOptions &options = TransferOptions());
+
+  /*
+   ---------------------------- Directory methods -----------------------------
+  */
+public:
+  /**
+   * @brief Merge the region files of a directory into another directory, in
+   * parallel.
+   */
+  static void merge_directory(const std::string &from, const std::string &to,
+                              TransferStats &stats,
+                              const ChunkFilter &filter = ChunkFilter(),
+                              const TransferOptions &options =
+                                  TransferOptions());
+
+  /**
+   * @brief Trim the region files of a directory, in parallel.
+   */
+  static void trim_directory(const std::string &dir, TransferStats &stats,
+                             const ChunkFilter &filter,
+                             const TransferOptions &options =
+                                 TransferOptions());
+};
+
+} // namespace solis::world
+
+#endif
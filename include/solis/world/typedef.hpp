@@ -16,6 +16,7 @@
 */
 
 #include "solis/resources/block.hpp"
+#include <cstdint>
 #include <memory>
 
 namespace solis::world {
@@ -26,9 +27,11 @@ namespace solis::world {
 
 typedef uint8_t InChunkCoord_t;     /// Coordinate type inside of a chunk
 typedef double WorldCoordinate_t;   /// Coordinate in the world
+typedef int64_t BlockCoordinate_t;  /// Integer coordinate of a block
 typedef int64_t ChunkCoordinate_t;  /// Coordinate type for the chunks
 typedef int32_t RegionCoordinate_t; /// Coordinate type for the regions
-typedef uint8_t LayerIndex;         /// Y-index integer coordinate
+typedef int16_t LayerIndex;         /// Y-index integer coordinate
+typedef int8_t SectionIndex;        /// Y-index of a section in a chunk
 
 // ============================================================================
 //    World-related constants
@@ -37,6 +40,8 @@ constexpr InChunkCoord_t CHUNK_SIZE{16};  /// Size of a chunk in blocks
 constexpr uint8_t REGION_WIDTH_CHUNK{32}; /// Size of a region in chunk number
 constexpr uint16_t REGION_WIDTH_BLOCK{
     REGION_WIDTH_CHUNK * CHUNK_SIZE}; /// Size of a region in blocks
+constexpr uint16_t SECTION_VOLUME{
+    CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE}; /// Number of blocks in a section
 
 } // namespace solis::world
 
@@ -0,0 +1,280 @@
+#include "solis/nbt/document.hpp"
+#include "solis/nbt/writer.hpp"
+#include <algorithm>
+
+namespace solis::nbt {
+
+/// Maximal nesting of compound and list tags
+constexpr uint16_t MAX_DEPTH{512};
+
+// ============================================================================
+//    Compound methods
+// ============================================================================
+
+Node *Node::get(std::string_view key) const {
+  for (const auto &[k, v] : compound())
+    if (k == key)
+      return v;
+  return nullptr;
+}
+
+void Node::set(std::string_view key, Node *value) {
+  Compound &entries = compound();
+  for (auto &[k, v] : entries)
+    if (k == key) {
+      v = value;
+      return;
+    }
+  entries.emplace_back(key, value);
+}
+
+bool Node::remove(std::string_view key) {
+  Compound &entries = compound();
+  auto it = std::find_if(entries.begin(), entries.end(),
+                         [key](const Entry &e) { return e.first == key; });
+  if (it == entries.end())
+    return false;
+  entries.erase(it);
+  return true;
+}
+
+// ============================================================================
+//    Constructor
+// ============================================================================
+
+Document::Document(size_t initial_size)
+    : arena(initial_size), name(&arena),
+      root_node(make_node(TagType::COMPOUND)) {}
+
+// ============================================================================
+//    Node methods
+// ============================================================================
+
+Node *Document::make_node(TagType type) {
+  // Never destroyed: the arena is released as a whole
+  Node *node = new (arena.allocate(sizeof(Node), alignof(Node))) Node();
+  node->type = type;
+  switch (type) {
+  case TagType::BYTE:
+  case TagType::SHORT:
+  case TagType::INT:
+  case TagType::LONG:
+    node->payload.emplace<int64_t>(0);
+    break;
+  case TagType::FLOAT:
+  case TagType::DOUBLE:
+    node->payload.emplace<double>(0);
+    break;
+  case TagType::STRING:
+    node->payload.emplace<std::pmr::string>(&arena);
+    break;
+  case TagType::BYTE_ARRAY:
+    node->payload.emplace<std::pmr::vector<int8_t>>(&arena);
+    break;
+  case TagType::INT_ARRAY:
+    node->payload.emplace<std::pmr::vector<int32_t>>(&arena);
+    break;
+  case TagType::LONG_ARRAY:
+    node->payload.emplace<std::pmr::vector<int64_t>>(&arena);
+    break;
+  case TagType::LIST:
+    node->payload.emplace<Node::List>(&arena);
+    break;
+  case TagType::COMPOUND:
+    node->payload.emplace<Node::Compound>(&arena);
+    break;
+  case TagType::END:
+    break;
+  }
+  return node;
+}
+
+Node *Document::make_int(TagType type, int64_t value) {
+  Node *node = make_node(type);
+  node->payload.emplace<int64_t>(value);
+  return node;
+}
+
+Node *Document::make_double(TagType type, double value) {
+  Node *node = make_node(type);
+  node->payload.emplace<double>(value);
+  return node;
+}
+
+Node *Document::make_string(std::string_view value) {
+  Node *node = make_node(TagType::STRING);
+  std::get<std::pmr::string>(node->payload).assign(value);
+  return node;
+}
+
+Node *Document::make_list(TagType element_type) {
+  Node *node = make_node(TagType::LIST);
+  node->element_type = element_type;
+  return node;
+}
+
+// ============================================================================
+//    Parsing
+// ============================================================================
+
+template <typename T>
+static void read_array(Reader &r, std::pmr::vector<T> &out) {
+  const std::string_view raw = r.read_raw(r.read<uint32_t>(), sizeof(T));
+  out.resize(raw.size() / sizeof(T));
+  for (size_t i = 0; i < out.size(); i++) {
+    T v;
+    std::memcpy(&v, raw.data() + i * sizeof(T), sizeof(T));
+    out[i] = FROM_BIG_ENDIAN(v);
+  }
+}
+
+static Node *parse_payload(Document &doc, Reader &r, TagType type,
+                           uint16_t depth) {
+  if (depth > MAX_DEPTH)
+    throw NBTError(fmt::format("nesting deeper than {}", MAX_DEPTH));
+
+  Node *node = doc.make_node(type);
+  switch (type) {
+  case TagType::END:
+    break;
+  case TagType::BYTE:
+    node->payload = static_cast<int64_t>(r.read<int8_t>());
+    break;
+  case TagType::SHORT:
+    node->payload = static_cast<int64_t>(r.read<int16_t>());
+    break;
+  case TagType::INT:
+    node->payload = static_cast<int64_t>(r.read<int32_t>());
+    break;
+  case TagType::LONG:
+    node->payload = r.read<int64_t>();
+    break;
+  case TagType::FLOAT:
+    node->payload = static_cast<double>(r.read_float());
+    break;
+  case TagType::DOUBLE:
+    node->payload = r.read_double();
+    break;
+  case TagType::STRING:
+    std::get<std::pmr::string>(node->payload).assign(r.read_string());
+    break;
+  case TagType::BYTE_ARRAY:
+    read_array(r, node->array<int8_t>());
+    break;
+  case TagType::INT_ARRAY:
+    read_array(r, node->array<int32_t>());
+    break;
+  case TagType::LONG_ARRAY:
+    read_array(r, node->array<int64_t>());
+    break;
+  case TagType::LIST: {
+    int32_t count;
+    node->element_type = r.read_list_header(count);
+    // Every element takes at least a byte (END lists are empty)
+    if (static_cast<size_t>(count) > r.remaining())
+      throw NBTError(fmt::format("list of {} elements overflows at {}", count,
+                                 r.position()));
+    Node::List &list = node->list();
+    list.reserve(count);
+    for (int32_t i = 0; i < count; i++)
+      list.push_back(parse_payload(doc, r, node->element_type, depth + 1));
+    break;
+  }
+  case TagType::COMPOUND: {
+    Node::Compound &entries = node->compound();
+    std::string_view key;
+    for (TagType t = r.read_header(key); t != TagType::END;
+         t = r.read_header(key))
+      entries.emplace_back(key, parse_payload(doc, r, t, depth + 1));
+    break;
+  }
+  }
+  return node;
+}
+
+Document::SharedPtr Document::parse(std::string_view nbt) {
+  // The tree takes a few times the size of its encoding
+  auto doc = make(std::max<size_t>(nbt.size() * 4, 4096));
+  Reader r(nbt);
+  std::string_view name;
+  if (r.read_header(name) != TagType::COMPOUND)
+    throw NBTError("NBT root is not a compound");
+  doc->name.assign(name);
+  doc->root_node = parse_payload(*doc, r, TagType::COMPOUND, 0);
+  return doc;
+}
+
+// ============================================================================
+//    Serialize methods
+// ============================================================================
+
+static void write_payload(Writer &w, const Node &node) {
+  switch (node.type) {
+  case TagType::END:
+    break;
+  case TagType::BYTE:
+    w.write(static_cast<int8_t>(node.as_int()));
+    break;
+  case TagType::SHORT:
+    w.write(static_cast<int16_t>(node.as_int()));
+    break;
+  case TagType::INT:
+    w.write(static_cast<int32_t>(node.as_int()));
+    break;
+  case TagType::LONG:
+    w.write(node.as_int());
+    break;
+  case TagType::FLOAT:
+    w.write_float(static_cast<float>(node.as_double()));
+    break;
+  case TagType::DOUBLE:
+    w.write_double(node.as_double());
+    break;
+  case TagType::STRING:
+    w.write_string(node.as_string());
+    break;
+  case TagType::BYTE_ARRAY:
+    w.write_array(node.array<int8_t>().data(), node.array<int8_t>().size());
+    break;
+  case TagType::INT_ARRAY:
+    w.write_array(node.array<int32_t>().data(), node.array<int32_t>().size());
+    break;
+  case TagType::LONG_ARRAY:
+    w.write_array(node.array<int64_t>().data(), node.array<int64_t>().size());
+    break;
+  case TagType::LIST:
+    if (node.list().size() > INT32_MAX)
+      throw NBTError(
+          fmt::format("list of {} elements is too long", node.list().size()));
+    w.write_list_header(node.element_type,
+                        static_cast<int32_t>(node.list().size()));
+    for (const Node *element : node.list()) {
+      if (element->type != node.element_type)
+        throw NBTError(fmt::format("list of type {} holds a tag of type {}",
+                                   node.element_type, element->type));
+      write_payload(w, *element);
+    }
+    break;
+  case TagType::COMPOUND:
+    for (const auto &[key, value] : node.compound()) {
+      w.write_header(value->type, key);
+      write_payload(w, *value);
+    }
+    w.write_end();
+    break;
+  }
+}
+
+void Document::serialize(std::string &out) const {
+  Writer w(out);
+  w.write_header(TagType::COMPOUND, name);
+  write_payload(w, *root_node);
+}
+
+std::string Document::serialize() const {
+  std::string out;
+  serialize(out);
+  return out;
+}
+
+} // namespace solis::nbt
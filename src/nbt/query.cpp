@@ -0,0 +1,253 @@
+#include "solis/nbt/query.hpp"
+#include <algorithm>
+
+namespace solis::nbt {
+
+// ============================================================================
+//    Values
+// ============================================================================
+
+int64_t Value::as_int() const {
+  Reader r(payload);
+  switch (type) {
+  case TagType::BYTE:
+    return r.read<int8_t>();
+  case TagType::SHORT:
+    return r.read<int16_t>();
+  case TagType::INT:
+    return r.read<int32_t>();
+  case TagType::LONG:
+    return r.read<int64_t>();
+  default:
+    throw NBTError(fmt::format("tag of type {} is not an integer", type));
+  }
+}
+
+double Value::as_double() const {
+  Reader r(payload);
+  switch (type) {
+  case TagType::FLOAT:
+    return r.read_float();
+  case TagType::DOUBLE:
+    return r.read_double();
+  default:
+    return static_cast<double>(as_int());
+  }
+}
+
+std::string_view Value::as_string() const {
+  if (type != TagType::STRING)
+    throw NBTError(fmt::format("tag of type {} is not a string", type));
+  Reader r(payload);
+  return r.read_string();
+}
+
+int32_t Value::size() const {
+  Reader r(payload);
+  switch (type) {
+  case TagType::BYTE_ARRAY:
+  case TagType::INT_ARRAY:
+  case TagType::LONG_ARRAY:
+    return r.read<int32_t>();
+  case TagType::LIST: {
+    int32_t count;
+    r.read_list_header(count);
+    return count;
+  }
+  default:
+    throw NBTError(fmt::format("tag of type {} has no size", type));
+  }
+}
+
+// ============================================================================
+//    Path compilation
+// ============================================================================
+
+Query::Query(const std::vector<std::string> &paths) {
+  for (const auto &p : paths)
+    add(p);
+}
+
+size_t Query::add(std::string_view text) {
+  if (paths.size() >= MAX_PATHS)
+    throw NBTError(fmt::format("a query holds at most {} paths", MAX_PATHS));
+
+  Path path;
+  size_t pos = 0;
+  while (pos <= text.size()) {
+    size_t end = text.find('.', pos);
+    if (end == std::string_view::npos)
+      end = text.size();
+    const std::string_view part = text.substr(pos, end - pos);
+    if (part.empty())
+      throw NBTError(fmt::format("empty component in NBT path \"{}\"", text));
+
+    // Key, then its list selectors
+    const size_t bracket = std::min(part.find('['), part.size());
+    if (bracket != 0)
+      path.tokens.push_back(Token{Token::KEY, std::string(part, 0, bracket)});
+    for (size_t b = bracket; b < part.size();) {
+      const size_t close = part.find(']', b);
+      if ((part[b] != '[') || (close == std::string_view::npos))
+        throw NBTError(fmt::format("invalid NBT path \"{}\"", text));
+      const std::string_view index = part.substr(b + 1, close - b - 1);
+      Token token{Token::ALL, {}};
+      if (!index.empty()) {
+        token.index = 0;
+        for (char c : index) {
+          if ((c < '0') || (c > '9'))
+            throw NBTError(fmt::format("invalid NBT path \"{}\"", text));
+          if (token.index > (INT32_MAX - (c - '0')) / 10)
+            throw NBTError(fmt::format("list index out of range in NBT path "
+                                       "\"{}\"",
+                                       text));
+          token.index = token.index * 10 + (c - '0');
+        }
+      }
+      path.unique &= (token.index != Token::ALL);
+      path.tokens.push_back(std::move(token));
+      b = close + 1;
+    }
+    pos = end + 1;
+  }
+  if (path.tokens.empty())
+    throw NBTError(fmt::format("invalid NBT path \"{}\"", text));
+
+  if (path.unique)
+    unique |= static_cast<uint64_t>(1) << paths.size();
+  paths.push_back(std::move(path));
+  return paths.size() - 1;
+}
+
+// ============================================================================
+//    Query methods
+// ============================================================================
+
+/**
+ * @brief Traversal of a buffer by a query. Each call gets the mask of the
+ * paths whose first `depth` tokens matched the current tag.
+ */
+struct QueryRun {
+  const Query &query;
+  const Query::Sink &sink;
+  uint64_t all;        /// Mask of all the paths
+  uint64_t matched{0}; /// Unique paths already matched
+
+  /**
+   * @brief Whether every path matched, when all of them are unique.
+   */
+  inline bool done() const {
+    return (query.unique == all) && (matched == all);
+  }
+
+  /**
+   * @brief Mask of the paths of a mask whose token at a depth satisfies a
+   * predicate.
+   */
+  template <typename F>
+  inline uint64_t select(uint64_t mask, size_t depth, F &&f) const {
+    uint64_t out = 0;
+    for (; mask != 0; mask &= mask - 1) {
+      const size_t p = __builtin_ctzll(mask);
+      const auto &tokens = query.paths[p].tokens;
+      if ((depth < tokens.size()) && f(tokens[depth]))
+        out |= static_cast<uint64_t>(1) << p;
+    }
+    return out;
+  }
+
+  void visit(Reader &r, TagType type, uint64_t mask, size_t depth) {
+    // Paths ending on this tag
+    const char *start = r.data();
+    const uint64_t ends =
+        mask & ~select(mask, depth, [](const Query::Token &) { return true; });
+
+    // Descend with the paths going further, skip otherwise
+    if (type == TagType::COMPOUND) {
+      const uint64_t keys = select(mask, depth, [](const Query::Token &t) {
+        return t.index == Query::Token::KEY;
+      });
+      if (keys != 0)
+        visit_compound(r, keys, depth);
+      else
+        r.skip(type);
+    } else if (type == TagType::LIST) {
+      const uint64_t lists = select(mask, depth, [](const Query::Token &t) {
+        return t.index != Query::Token::KEY;
+      });
+      if (lists != 0)
+        visit_list(r, lists, depth);
+      else
+        r.skip(type);
+    } else
+      r.skip(type);
+
+    if (ends == 0)
+      return;
+    const Value value{type, std::string_view(start, r.data() - start)};
+    for (uint64_t m = ends; m != 0; m &= m - 1)
+      sink(__builtin_ctzll(m), value);
+    matched |= ends & query.unique;
+  }
+
+  void visit_compound(Reader &r, uint64_t mask, size_t depth) {
+    std::string_view name;
+    for (TagType t = r.read_header(name); t != TagType::END;
+         t = r.read_header(name)) {
+      const uint64_t m = select(mask, depth, [name](const Query::Token &k) {
+        return (k.index == Query::Token::KEY) && (k.key == name);
+      });
+      if (m != 0)
+        visit(r, t, m, depth + 1);
+      else
+        r.skip(t);
+      if (done())
+        return;
+    }
+  }
+
+  void visit_list(Reader &r, uint64_t mask, size_t depth) {
+    int32_t count;
+    const TagType t = r.read_list_header(count);
+    for (int32_t i = 0; i < count; i++) {
+      const uint64_t m = select(mask, depth, [i](const Query::Token &k) {
+        return (k.index == Query::Token::ALL) || (k.index == i);
+      });
+      if (m != 0)
+        visit(r, t, m, depth + 1);
+      else
+        r.skip(t);
+      if (done())
+        return;
+    }
+  }
+};
+
+void Query::run(std::string_view nbt, const Sink &sink) const {
+  if (paths.empty())
+    return;
+  Reader r(nbt);
+  std::string_view name;
+  const TagType t = r.read_header(name);
+  if (t != TagType::COMPOUND)
+    throw NBTError("NBT root is not a compound");
+
+  const uint64_t all = (paths.size() == MAX_PATHS)
+                           ? ~static_cast<uint64_t>(0)
+                           : (static_cast<uint64_t>(1) << paths.size()) - 1;
+  QueryRun run{*this, sink, all};
+  run.visit_compound(r, all, 0);
+}
+
+std::optional<Value> Query::find(std::string_view nbt, std::string_view path) {
+  Query query;
+  query.add(path);
+  std::optional<Value> out;
+  query.run(nbt, [&out](size_t, const Value &v) {
+    if (!out)
+      out = v;
+  });
+  return out;
+}
+
+} // namespace solis::nbt
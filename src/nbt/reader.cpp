@@ -0,0 +1,87 @@
+#include "solis/nbt/reader.hpp"
+
+namespace solis::nbt {
+
+/// Maximal nesting of compound and list tags
+constexpr uint16_t MAX_DEPTH{512};
+
+// ============================================================================
+//    Tag skipping
+// ============================================================================
+
+/**
+ * @brief Skip a tag payload, tracking the nesting depth to reject malicious
+ * inputs.
+ */
+static void skip_payload(Reader &r, TagType type, uint16_t depth) {
+  if (depth > MAX_DEPTH)
+    throw NBTError(fmt::format("nesting deeper than {}", MAX_DEPTH));
+
+  switch (type) {
+  case TagType::END:
+    return;
+  case TagType::BYTE:
+    r.read_raw(1, 1);
+    return;
+  case TagType::SHORT:
+    r.read_raw(1, 2);
+    return;
+  case TagType::INT:
+  case TagType::FLOAT:
+    r.read_raw(1, 4);
+    return;
+  case TagType::LONG:
+  case TagType::DOUBLE:
+    r.read_raw(1, 8);
+    return;
+  case TagType::BYTE_ARRAY:
+    r.read_raw(r.read<uint32_t>(), 1);
+    return;
+  case TagType::INT_ARRAY:
+    r.read_raw(r.read<uint32_t>(), 4);
+    return;
+  case TagType::LONG_ARRAY:
+    r.read_raw(r.read<uint32_t>(), 8);
+    return;
+  case TagType::STRING:
+    r.read_string();
+    return;
+  case TagType::LIST: {
+    int32_t count;
+    const TagType t = r.read_list_header(count);
+    switch (t) {
+    case TagType::END:
+      return;
+    case TagType::BYTE:
+      r.read_raw(count, 1);
+      return;
+    case TagType::SHORT:
+      r.read_raw(count, 2);
+      return;
+    case TagType::INT:
+    case TagType::FLOAT:
+      r.read_raw(count, 4);
+      return;
+    case TagType::LONG:
+    case TagType::DOUBLE:
+      r.read_raw(count, 8);
+      return;
+    default:
+      for (int32_t i = 0; i < count; i++)
+        skip_payload(r, t, depth + 1);
+      return;
+    }
+  }
+  case TagType::COMPOUND: {
+    std::string_view name;
+    for (TagType t = r.read_header(name); t != TagType::END;
+         t = r.read_header(name))
+      skip_payload(r, t, depth + 1);
+    return;
+  }
+  }
+}
+
+void Reader::skip(TagType type) { skip_payload(*this, type, 0); }
+
+} // namespace solis::nbt
@@ -1,8 +1,98 @@
 #include "solis/resources/block.hpp"
+#include "solis/resources/vanilla.hpp"
 
 namespace solis {
 
-Block::Block(const char *pkg, const char *name)
-    : package(pkg), resource_name(name) {}
+// ============================================================================
+//    Vanilla flags
+// ============================================================================
 
-} // namespace solis
\ No newline at end of file
+/**
+ * @brief Family of vanilla blocks without an id, known by the suffix of
+ * their names ("oak_button", "white_stained_glass_pane"...).
+ */
+struct BlockFamily {
+  std::string_view suffix;
+  FlagL_t flags;
+};
+
+constexpr FlagL_t DECORATION{Block::TRANSPARENT};
+constexpr FlagL_t SOLID_DECORATION{Block::SOLID | Block::TRANSPARENT};
+
+constexpr BlockFamily FAMILIES[]{
+    {"_button", DECORATION},         {"_pressure_plate", DECORATION},
+    {"_sign", DECORATION},           {"_banner", DECORATION},
+    {"_carpet", DECORATION},         {"_sapling", DECORATION},
+    {"_tulip", DECORATION},          {"_torch", DECORATION},
+    {"_candle", DECORATION},         {"_coral", DECORATION},
+    {"_coral_fan", DECORATION},      {"_door", SOLID_DECORATION},
+    {"_trapdoor", SOLID_DECORATION}, {"_fence", SOLID_DECORATION},
+    {"_fence_gate", SOLID_DECORATION}, {"_pane", SOLID_DECORATION},
+    {"_glass", SOLID_DECORATION},    {"_bed", SOLID_DECORATION},
+    {"_wall", SOLID_DECORATION},     {"_head", SOLID_DECORATION},
+    {"_skull", SOLID_DECORATION},
+    {"_leaves", Block::SOLID | Block::DIFFUSING}};
+
+/**
+ * @brief Flags of a block, without its state.
+ *
+ * The vanilla blocks with an id get their flags from the table of
+ * vanilla.hpp, the other ones from their family. Unknown blocks are solid
+ * and opaque, as most blocks are.
+ */
+static FlagL_t classify_name(const Block &block) {
+  const std::string_view name = block.resource_name;
+  if (std::string_view(block.package) != "minecraft")
+    return Block::SOLID;
+  if (const vanilla::BlockId id = vanilla::find(name); id >= 0)
+    return vanilla::BLOCK_FLAGS[id];
+
+  const std::string_view potted{"potted_"};
+  if (name.substr(0, potted.size()) == potted)
+    return DECORATION;
+  for (const auto &family : FAMILIES)
+    if ((name.size() > family.suffix.size()) &&
+        (name.substr(name.size() - family.suffix.size()) == family.suffix))
+      return family.flags;
+  const std::string_view powder{"_concrete_powder"};
+  if ((name.size() > powder.size()) &&
+      (name.substr(name.size() - powder.size()) == powder))
+    return Block::SOLID | Block::FALLING;
+  return Block::SOLID;
+}
+
+/**
+ * @brief Flags of a block state.
+ */
+static FlagL_t classify(const Block &block) {
+  FlagL_t flags = classify_name(block);
+  if (block.has_property("waterlogged=true"))
+    flags |= Block::WATERLOGGED | Block::WATER;
+  if (block.has_property("lit=false"))
+    flags &= ~Block::HAZARD;
+  return flags;
+}
+
+// ============================================================================
+//    Block methods
+// ============================================================================
+
+Block::Block(const char *pkg, const char *name, const char *props)
+    : package(pkg), resource_name(name), properties(props) {
+  flags = classify(*this);
+}
+
+bool Block::has_property(std::string_view property) const {
+  const std::string_view props = properties;
+  for (size_t begin = 0; begin < props.size();) {
+    size_t end = props.find(',', begin);
+    if (end == std::string_view::npos)
+      end = props.size();
+    if (props.substr(begin, end - begin) == property)
+      return true;
+    begin = end + 1;
+  }
+  return false;
+}
+
+} // namespace solis
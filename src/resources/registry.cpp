@@ -0,0 +1,132 @@
+#include "solis/resources/registry.hpp"
+#include <mutex>
+
+namespace solis {
+
+/// Package of the blocks whose name does not specify one
+constexpr std::string_view DEFAULT_PACKAGE{"minecraft"};
+
+BlockRegistry &BlockRegistry::global() {
+  static BlockRegistry registry;
+  return registry;
+}
+
+const Block *BlockRegistry::get(std::string_view state) {
+  if (const vanilla::BlockId id = vanilla::find(state); id >= 0)
+    return get(id);
+
+  // Vanilla states, resolved by the name of their block
+  if (const size_t p = state.find('[');
+      (p != std::string_view::npos) && (state.back() == ']'))
+    if (const vanilla::BlockId id = vanilla::find(state.substr(0, p));
+        id >= 0)
+      return get(id, state.substr(p + 1, state.size() - p - 2));
+  return intern(state);
+}
+
+const Block *BlockRegistry::get(vanilla::BlockId id) {
+  const Block *block = vanilla_blocks[id].load(std::memory_order_acquire);
+  if (block == nullptr) {
+    std::string state(vanilla::PREFIX);
+    block = intern(state.append(vanilla::BLOCK_NAMES[id]));
+    vanilla_blocks[id].store(block, std::memory_order_release);
+  }
+  return block;
+}
+
+const Block *BlockRegistry::get(vanilla::BlockId id,
+                                std::string_view properties) {
+  if (properties.empty())
+    return get(id);
+  VanillaStates &states = vanilla_states[id];
+  {
+    std::shared_lock lock(states.mutex);
+    if (auto it = states.by_properties.find(properties);
+        it != states.by_properties.end())
+      return it->second;
+  }
+
+  std::string state(vanilla::PREFIX);
+  state.append(vanilla::BLOCK_NAMES[id]).append("[").append(properties);
+  const Block *block = intern(state.append("]"));
+  std::unique_lock lock(states.mutex);
+  states.by_properties.emplace(block->properties, block);
+  return block;
+}
+
+const Block *BlockRegistry::intern(std::string_view state) {
+  if (auto block = find(state); block != nullptr)
+    return block;
+
+  std::unique_lock lock(mutex);
+  if (auto it = index.find(state); it != index.end())
+    return it->second;
+
+  // Split "package:name[properties]"
+  std::string_view name = state, props;
+  if (auto p = state.find('['); p != std::string_view::npos) {
+    name = state.substr(0, p);
+    props = state.substr(p + 1);
+    if (!props.empty() && (props.back() == ']'))
+      props.remove_suffix(1);
+  }
+  std::string_view package = DEFAULT_PACKAGE;
+  if (auto p = name.find(':'); p != std::string_view::npos) {
+    package = name.substr(0, p);
+    name = name.substr(p + 1);
+  }
+
+  // Register the canonical name, and the given one as an alias
+  const Block *block;
+  std::string canonical(package);
+  canonical.append(":").append(name);
+  if (!props.empty())
+    canonical.append("[").append(props).append("]");
+  if (auto it = index.find(canonical); it != index.end())
+    block = it->second;
+  else {
+    const std::string &s_pkg = strings.emplace_back(package);
+    const std::string &s_name = strings.emplace_back(name);
+    const std::string &s_props = strings.emplace_back(props);
+    block =
+        &blocks.emplace_back(s_pkg.c_str(), s_name.c_str(), s_props.c_str());
+    index.emplace(strings.emplace_back(std::move(canonical)), block);
+  }
+  if (index.find(state) == index.end())
+    index.emplace(strings.emplace_back(state), block);
+  return block;
+}
+
+const Block *BlockRegistry::get(std::string_view name,
+                                std::string_view properties) {
+  if (properties.empty())
+    return get(name);
+  if (const vanilla::BlockId id = vanilla::find(name); id >= 0)
+    return get(id, properties);
+  std::string state;
+  state.reserve(name.size() + properties.size() + 2);
+  state.append(name).append("[").append(properties).append("]");
+  return get(state);
+}
+
+const Block *BlockRegistry::find(std::string_view state) const {
+  std::shared_lock lock(mutex);
+  if (auto it = index.find(state); it != index.end())
+    return it->second;
+  return nullptr;
+}
+
+std::string BlockRegistry::full_name(const Block &block) {
+  std::string name(block.package);
+  name.append(":").append(block.resource_name);
+  if (block.properties[0] != '\0')
+    name.append("[").append(block.properties).append("]");
+  return name;
+}
+
+size_t BlockRegistry::size() const {
+  std::shared_lock lock(mutex);
+  return blocks.size();
+}
+
+} // namespace solis
@@ -0,0 +1,100 @@
+#include "solis/utils/files.hpp"
+#include "solis/utils/errors.hpp"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace solis {
+
+FileStamp FileStamp::of(const std::string &path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    if (errno == ENOENT)
+      throw FileNotFoundError(path.c_str());
+    throw FileIOError(fmt::format("cannot stat \"{}\": {}", path,
+                                  std::strerror(errno)));
+  }
+  return FileStamp{static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+                       st.st_mtim.tv_nsec,
+                   static_cast<uint64_t>(st.st_size)};
+}
+
+/**
+ * @brief Flush a file descriptor to the storage.
+ */
+static void sync_fd(int fd, const std::string &path) {
+  if (::fsync(fd) != 0)
+    throw FileIOError(
+        fmt::format("cannot sync \"{}\": {}", path, std::strerror(errno)));
+}
+
+void write_file_atomic(const std::string &path, const std::string &content) {
+  namespace fs = std::filesystem;
+  const fs::path target(path);
+  const fs::path dir =
+      target.has_parent_path() ? target.parent_path() : fs::path(".");
+
+  // A unique temporary file next to the target, so that concurrent writers
+  // never share it
+  std::string tmp = path + ".XXXXXX";
+  const int fd = ::mkstemp(tmp.data());
+  if (fd < 0)
+    throw FileIOError(fmt::format("cannot create \"{}\": {}", tmp,
+                                  std::strerror(errno)));
+  try {
+    // mkstemp creates the file for its owner only: keep the previous mode
+    struct stat st;
+    const mode_t mode = (::stat(path.c_str(), &st) == 0)
+                            ? (st.st_mode & 07777)
+                            : (S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (::fchmod(fd, mode) != 0)
+      throw FileIOError(fmt::format("cannot chmod \"{}\": {}", tmp,
+                                    std::strerror(errno)));
+
+    const char *ptr = content.data();
+    size_t size = content.size();
+    while (size > 0) {
+      const ssize_t n = ::write(fd, ptr, size);
+      if (n < 0) {
+        if (errno == EINTR)
+          continue;
+        throw FileIOError(fmt::format("cannot write \"{}\": {}", tmp,
+                                      std::strerror(errno)));
+      }
+      ptr += n;
+      size -= n;
+    }
+    // The content must be durable before it replaces the previous file
+    sync_fd(fd, tmp);
+  } catch (...) {
+    ::close(fd);
+    ::unlink(tmp.c_str());
+    throw;
+  }
+  ::close(fd);
+
+  if (::rename(tmp.c_str(), path.c_str()) != 0) {
+    const int error = errno;
+    ::unlink(tmp.c_str());
+    throw FileIOError(fmt::format("cannot rename \"{}\": {}", tmp,
+                                  std::strerror(error)));
+  }
+
+  // Then the rename itself
+  const int dir_fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+  if (dir_fd < 0)
+    throw FileIOError(fmt::format("cannot open \"{}\": {}", dir.string(),
+                                  std::strerror(errno)));
+  try {
+    sync_fd(dir_fd, dir.string());
+  } catch (...) {
+    ::close(dir_fd);
+    throw;
+  }
+  ::close(dir_fd);
+}
+
+} // namespace solis
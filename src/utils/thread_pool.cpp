@@ -0,0 +1,91 @@
+#include "solis/utils/thread_pool.hpp"
+#include <algorithm>
+
+namespace solis {
+
+// ============================================================================
+//    Constructor
+// ============================================================================
+
+ThreadPool::ThreadPool(size_t threads) {
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  workers.reserve(threads);
+  for (size_t i = 0; i < threads; i++)
+    workers.emplace_back(&ThreadPool::run, this);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  task_cv.notify_all();
+  for (auto &worker : workers)
+    worker.join();
+}
+
+// ============================================================================
+//    Task methods
+// ============================================================================
+
+void ThreadPool::submit(Task task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push_back(std::move(task));
+    pending++;
+  }
+  task_cv.notify_one();
+}
+
+void ThreadPool::wait() {
+  std::unique_lock<std::mutex> lock(mutex);
+  idle_cv.wait(lock, [this] { return pending == 0; });
+  if (error != nullptr) {
+    std::exception_ptr e = nullptr;
+    std::swap(e, error);
+    std::rethrow_exception(e);
+  }
+}
+
+void ThreadPool::parallel_for(size_t n, const std::function<void(size_t)> &fn,
+                              size_t grain) {
+  grain = std::max<size_t>(grain, 1);
+  for (size_t begin = 0; begin < n; begin += grain) {
+    const size_t end = std::min(n, begin + grain);
+    submit([&fn, begin, end] {
+      for (size_t i = begin; i < end; i++)
+        fn(i);
+    });
+  }
+  wait();
+}
+
+void ThreadPool::run() {
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      task_cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+      if (tasks.empty())
+        return;
+      task = std::move(tasks.front());
+      tasks.pop_front();
+    }
+
+    try {
+      task();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (error == nullptr)
+        error = std::current_exception();
+    }
+    task = nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--pending == 0)
+      idle_cv.notify_all();
+  }
+}
+
+} // namespace solis
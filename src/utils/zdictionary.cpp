@@ -0,0 +1,142 @@
+#include "solis/utils/zdictionary.hpp"
+#include "solis/utils/errors.hpp"
+#include "solis/utils/files.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <zlib.h>
+
+namespace solis {
+
+/// Longest segment taken from a sample
+constexpr size_t MAX_SEGMENT{256};
+
+// ============================================================================
+//    Constructor
+// ============================================================================
+
+ZDictionary::ZDictionary(std::string data) : data(std::move(data)) {
+  // zlib ignores empty dictionaries, the payloads would not reference it
+  if (this->data.empty())
+    throw SolisError("preset dictionaries cannot be empty");
+  // Only the end of the dictionary fits in the window
+  if (this->data.size() > MAX_SIZE)
+    this->data.erase(0, this->data.size() - MAX_SIZE);
+  id = adler32(adler32(0, Z_NULL, 0),
+               reinterpret_cast<const Bytef *>(this->data.data()),
+               this->data.size());
+}
+
+ZDictionary::SharedPtr ZDictionary::load(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    throw FileNotFoundError(path.c_str());
+  return make(std::string((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>()));
+}
+
+void ZDictionary::save(const std::string &path) const {
+  write_file_atomic(path, data);
+}
+
+// ============================================================================
+//    Training
+// ============================================================================
+
+/**
+ * @brief Statistics of a segment content among the samples.
+ */
+struct SegmentStats {
+  uint32_t samples{0}; /// Number of samples holding it
+  uint32_t last{0};    /// Last sample holding it (+1)
+  uint32_t sample{0};  /// First occurrence
+  uint32_t offset{0};
+};
+
+static inline uint64_t hash(const char *p, uint8_t n) {
+  uint64_t h = 14695981039346656037ull;
+  for (uint8_t i = 0; i < n; i++)
+    h = (h ^ static_cast<unsigned char>(p[i])) * 1099511628211ull;
+  return h;
+}
+
+ZDictionary::SharedPtr
+ZDictionary::train(const std::vector<std::string> &samples, size_t size,
+                   uint8_t segment) {
+  size = std::min(size, MAX_SIZE);
+  if (segment == 0)
+    throw SolisError("dictionary segments cannot be empty");
+  if (size == 0)
+    throw SolisError("dictionaries cannot be empty");
+
+  // Number of samples holding each segment
+  std::unordered_map<uint64_t, SegmentStats> stats;
+  for (uint32_t s = 0; s < samples.size(); s++) {
+    const std::string &sample = samples[s];
+    for (size_t p = 0; p + segment <= sample.size(); p++) {
+      SegmentStats &st = stats[hash(sample.data() + p, segment)];
+      if (st.last == s + 1)
+        continue;
+      if (st.samples++ == 0) {
+        st.sample = s;
+        st.offset = p;
+      }
+      st.last = s + 1;
+    }
+  }
+
+  // Candidates: the segments shared by several samples, most common first
+  std::vector<std::pair<uint64_t, const SegmentStats *>> candidates;
+  for (const auto &[h, st] : stats)
+    if (st.samples >= 2)
+      candidates.emplace_back(h, &st);
+  std::sort(candidates.begin(), candidates.end(),
+            [](const auto &a, const auto &b) {
+              return (a.second->samples != b.second->samples)
+                         ? (a.second->samples > b.second->samples)
+                         : (a.first < b.first);
+            });
+
+  // Extend each candidate while the next segments are about as common, and
+  // skip the segments already covered
+  std::unordered_set<uint64_t> covered;
+  std::vector<std::string_view> picked;
+  size_t total = 0;
+  for (const auto &[h, st] : candidates) {
+    if (total >= size)
+      break;
+    if (covered.count(h) != 0)
+      continue;
+    const std::string &sample = samples[st->sample];
+    size_t end = st->offset + segment;
+    while ((end < sample.size()) && (end - st->offset < MAX_SEGMENT)) {
+      const uint64_t next = hash(sample.data() + end + 1 - segment, segment);
+      if ((covered.count(next) != 0) ||
+          (stats.find(next)->second.samples * 2 < st->samples))
+        break;
+      end++;
+    }
+    for (size_t p = st->offset; p + segment <= end; p++)
+      covered.insert(hash(sample.data() + p, segment));
+    picked.emplace_back(sample.data() + st->offset, end - st->offset);
+    total += end - st->offset;
+  }
+
+  // Most common segments last
+  std::string data;
+  data.reserve(total);
+  for (auto it = picked.rbegin(); it != picked.rend(); it++)
+    data.append(*it);
+  if (data.empty())
+    throw SolisError(fmt::format("no segment of {} bytes is shared by the {} "
+                                 "samples, nothing to train a dictionary on",
+                                 segment, samples.size()));
+  if (data.size() > size)
+    data.erase(0, data.size() - size);
+  return make(std::move(data));
+}
+
+} // namespace solis
@@ -60,7 +60,9 @@ unsigned int ZSStream::readBytes() {
   return to_read;
 }
 
-void ZSStream::writeBytes([[maybe_unused]] unsigned int N) { ss << buffer; }
+void ZSStream::writeBytes(unsigned int N) {
+  ss.write(reinterpret_cast<const char *>(buffer), N);
+}
 
 int ZSStream::eos() { return index >= size; }
 
@@ -80,14 +82,20 @@ z_stream ZLib::new_stream() {
 }
 
 void ZLib::uncompress(const ZStream::SharedPtr &s1,
-                      const ZStream::SharedPtr &s2, int8_t format) {
+                      const ZStream::SharedPtr &s2, int8_t format,
+                      std::string_view dictionary) {
   z_stream strm = new_stream();
+  const auto dict = reinterpret_cast<const Bytef *>(dictionary.data());
   try {
     // Open and initialize streams
     int ret = inflateInit2(&strm, format);
     // int ret = inflateInit(&strm);
     if (ret != Z_OK)
       throw ZLibError(ret, strm.msg);
+    // Raw deflate streams do not ask for their dictionary
+    if ((format == FORMAT_DEFLATE) && !dictionary.empty() &&
+        ((ret = inflateSetDictionary(&strm, dict, dictionary.size())) != Z_OK))
+      throw ZLibError(ret, strm.msg);
     s1->open();
     s2->open();
 
@@ -103,6 +111,13 @@ void ZLib::uncompress(const ZStream::SharedPtr &s1,
         strm.avail_out = CHUNK_SIZE;
         strm.next_out = s2->buffer;
         ret = inflate(&strm, Z_NO_FLUSH);
+        if ((ret == Z_NEED_DICT) && !dictionary.empty()) {
+          // Fails with Z_DATA_ERROR if the dictionary ID does not match
+          if ((ret = inflateSetDictionary(&strm, dict, dictionary.size())) !=
+              Z_OK)
+            throw ZLibError(ret, "wrong preset dictionary");
+          ret = inflate(&strm, Z_NO_FLUSH);
+        }
 
         switch (ret) {
         case Z_NEED_DICT:
@@ -121,12 +136,12 @@ void ZLib::uncompress(const ZStream::SharedPtr &s1,
     (void)inflateEnd(&strm);
     s1->close();
     s2->close();
-  } catch (const FileIOError e) {
+  } catch (const FileIOError &e) {
     (void)inflateEnd(&strm);
     s1->close();
     s2->close();
     throw e;
-  } catch (const ZLibError e) {
+  } catch (const ZLibError &e) {
     (void)inflateEnd(&strm);
     s1->close();
     s2->close();
@@ -135,7 +150,8 @@ void ZLib::uncompress(const ZStream::SharedPtr &s1,
 }
 
 void ZLib::compress(const ZStream::SharedPtr &s1, const ZStream::SharedPtr &s2,
-                    const unsigned char level, int8_t format) {
+                    const unsigned char level, int8_t format,
+                    std::string_view dictionary) {
   z_stream strm = new_stream();
   try {
     // Open and initialize streams
@@ -143,6 +159,11 @@ void ZLib::compress(const ZStream::SharedPtr &s1, const ZStream::SharedPtr &s2,
                            Z_DEFAULT_STRATEGY);
     if (ret != Z_OK)
       throw ZLibError(ret, strm.msg);
+    if (!dictionary.empty() &&
+        ((ret = deflateSetDictionary(
+              &strm, reinterpret_cast<const Bytef *>(dictionary.data()),
+              dictionary.size())) != Z_OK))
+      throw ZLibError(ret, strm.msg);
     s1->open();
     s2->open();
 
@@ -178,14 +199,16 @@ void ZLib::compress(const ZStream::SharedPtr &s1, const ZStream::SharedPtr &s2,
     (void)deflateEnd(&strm);
     s1->close();
     s2->close();
-  } catch (const FileIOError e) {
+  } catch (const FileIOError &e) {
     (void)deflateEnd(&strm);
     s1->close();
     s2->close();
-  } catch (const ZLibError e) {
+    throw e;
+  } catch (const ZLibError &e) {
     (void)deflateEnd(&strm);
     s1->close();
     s2->close();
+    throw e;
   }
 }
 
@@ -0,0 +1,658 @@
+#include "solis/world/anvil.hpp"
+#include "solis/nbt/document.hpp"
+#include "solis/nbt/reader.hpp"
+#include "solis/utils/zlib.hpp"
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace solis::world {
+
+using nbt::Document;
+using nbt::Node;
+using nbt::Reader;
+using nbt::TagType;
+
+// ============================================================================
+//    Decompression
+// ============================================================================
+
+/**
+ * @brief Get the dictionary of a ZLIB_DICT payload.
+ */
+static std::string_view get_dictionary(const ZDictionary *dictionary) {
+  if (dictionary == nullptr)
+    throw SolisError("the payload compression needs a preset dictionary");
+  return dictionary->get_data();
+}
+
+std::string Anvil::inflate(const ChunkPayload &payload,
+                           const ZDictionary *dictionary) {
+  switch (payload.compression) {
+  case CompressionType::GZIP:
+    return ZLib::decodeFromString(payload.data, ZLib::FORMAT_GZIP);
+  case CompressionType::ZLIB:
+    return ZLib::decodeFromString(payload.data, ZLib::FORMAT_ZLIB);
+  case CompressionType::ZLIB_DICT:
+    return ZLib::decodeFromString(payload.data, ZLib::FORMAT_ZLIB,
+                                  get_dictionary(dictionary));
+  case CompressionType::NONE:
+    return payload.data;
+  default:
+    throw SolisError(fmt::format("unsupported chunk compression type {}",
+                                 payload.compression));
+  }
+}
+
+// ============================================================================
+//    Decoding context
+// ============================================================================
+
+/**
+ * @brief Section read from the NBT, whose indices are unpacked once the data
+ * version is known.
+ */
+struct RawSection {
+  SectionIndex y{0};
+  Section::Palette palette;
+  std::string_view data;
+  std::string_view sky_light, block_light;
+};
+
+/**
+ * @brief State of a chunk decoding.
+ */
+struct DecodeContext {
+  BlockRegistry &registry;
+  Chunk &chunk;
+  int32_t version{0};
+  std::vector<RawSection> sections;
+  std::vector<std::pair<std::string_view, std::string_view>> properties;
+  std::string state;
+  std::optional<int32_t> y_pos;
+  std::string_view heightmaps[HEIGHTMAP_COUNT];
+  std::shared_ptr<ChunkLight> light;
+};
+
+/**
+ * @brief Decode a block state compound of a palette.
+ */
+static const Block *decode_state(Reader &r, DecodeContext &ctx) {
+  std::string_view name, key, block_name;
+  ctx.properties.clear();
+  for (TagType t = r.read_header(key); t != TagType::END;
+       t = r.read_header(key)) {
+    if ((t == TagType::STRING) && (key == "Name"))
+      block_name = r.read_string();
+    else if ((t == TagType::COMPOUND) && (key == "Properties")) {
+      for (TagType p = r.read_header(name); p != TagType::END;
+           p = r.read_header(name)) {
+        if (p == TagType::STRING)
+          ctx.properties.emplace_back(name, r.read_string());
+        else
+          r.skip(p);
+      }
+    } else
+      r.skip(t);
+  }
+  if (block_name == Anvil::AIR)
+    return nullptr;
+
+  // Properties are sorted by key to get the canonical state name
+  std::sort(ctx.properties.begin(), ctx.properties.end());
+  ctx.state.clear();
+  for (const auto &[k, v] : ctx.properties) {
+    if (!ctx.state.empty())
+      ctx.state.push_back(',');
+    ctx.state.append(k).append("=").append(v);
+  }
+  return ctx.registry.get(block_name, ctx.state);
+}
+
+/**
+ * @brief Decode a palette list.
+ */
+static void decode_palette(Reader &r, DecodeContext &ctx,
+                           Section::Palette &out) {
+  int32_t count;
+  const TagType t = r.read_list_header(count);
+  if (t != TagType::COMPOUND) {
+    for (int32_t i = 0; i < count; i++)
+      r.skip(t);
+    return;
+  }
+  out.reserve(std::min<size_t>(count, r.remaining()));
+  for (int32_t i = 0; i < count; i++)
+    out.push_back(decode_state(r, ctx));
+}
+
+/**
+ * @brief Decode the "block_states" compound of a section (1.18+).
+ */
+static void decode_block_states(Reader &r, DecodeContext &ctx,
+                                RawSection &s) {
+  std::string_view key;
+  for (TagType t = r.read_header(key); t != TagType::END;
+       t = r.read_header(key)) {
+    if ((t == TagType::LIST) && (key == "palette"))
+      decode_palette(r, ctx, s.palette);
+    else if ((t == TagType::LONG_ARRAY) && (key == "data"))
+      s.data = r.read_raw(r.read<uint32_t>(), sizeof(int64_t));
+    else
+      r.skip(t);
+  }
+}
+
+/**
+ * @brief Decode a nibble array of light levels.
+ */
+static void decode_light(std::string_view data, LightArray &out) {
+  if (data.size() != LightArray::BYTES)
+    return;
+  uint8_t levels[SECTION_VOLUME];
+  for (uint16_t i = 0; i < SECTION_VOLUME; i++)
+    levels[i] = (static_cast<uint8_t>(data[i >> 1]) >> ((i & 1) << 2)) & 0xF;
+  out = LightArray::pack(levels);
+}
+
+/**
+ * @brief Decode a section compound.
+ */
+static void decode_section(Reader &r, DecodeContext &ctx) {
+  RawSection s;
+  std::string_view key;
+  for (TagType t = r.read_header(key); t != TagType::END;
+       t = r.read_header(key)) {
+    if ((t == TagType::BYTE) && (key == "Y"))
+      s.y = r.read<int8_t>();
+    else if ((t == TagType::COMPOUND) && (key == "block_states"))
+      decode_block_states(r, ctx, s);
+    else if ((t == TagType::LIST) && (key == "Palette"))
+      decode_palette(r, ctx, s.palette);
+    else if ((t == TagType::LONG_ARRAY) && (key == "BlockStates"))
+      s.data = r.read_raw(r.read<uint32_t>(), sizeof(int64_t));
+    else if ((t == TagType::BYTE_ARRAY) && (key == "SkyLight"))
+      s.sky_light = r.read_raw(r.read<uint32_t>(), 1);
+    else if ((t == TagType::BYTE_ARRAY) && (key == "BlockLight"))
+      s.block_light = r.read_raw(r.read<uint32_t>(), 1);
+    else
+      r.skip(t);
+  }
+
+  if (!s.sky_light.empty() || !s.block_light.empty()) {
+    if (ctx.light == nullptr)
+      ctx.light = std::make_shared<ChunkLight>();
+    SectionLight &light = (*ctx.light)[s.y];
+    decode_light(s.sky_light, light.sky);
+    decode_light(s.block_light, light.block);
+  }
+  if (!s.palette.empty())
+    ctx.sections.push_back(std::move(s));
+}
+
+/**
+ * @brief Decode the "Heightmaps" compound, keeping the packed arrays.
+ */
+static void decode_heightmaps(Reader &r, DecodeContext &ctx) {
+  std::string_view key;
+  for (TagType t = r.read_header(key); t != TagType::END;
+       t = r.read_header(key)) {
+    if (t != TagType::LONG_ARRAY) {
+      r.skip(t);
+      continue;
+    }
+    const std::string_view data = r.read_raw(r.read<uint32_t>(), 8);
+    for (uint8_t h = 0; h < HEIGHTMAP_COUNT; h++)
+      if (key == Heightmaps::NAMES[h])
+        ctx.heightmaps[h] = data;
+  }
+}
+
+/**
+ * @brief Unpack a heightmap, guessing its number of bits from its size.
+ * @return false if the size matches no number of bits
+ */
+static bool unpack_heightmap(std::string_view data, bool span,
+                             LayerIndex min_y, Heightmaps::Heights &out) {
+  constexpr size_t COLUMNS{CHUNK_SIZE * CHUNK_SIZE};
+  const size_t n_longs = data.size() / sizeof(int64_t);
+  uint8_t bits = 0;
+  for (uint8_t b = 1; (b <= 16) && (bits == 0); b++) {
+    const size_t per_long = 64 / b;
+    const size_t needed = span ? (COLUMNS * b + 63) / 64
+                               : (COLUMNS + per_long - 1) / per_long;
+    if (needed == n_longs)
+      bits = b;
+  }
+  if (bits == 0)
+    return false;
+
+  uint16_t values[COLUMNS];
+  Anvil::unpack(data, bits, span, COLUMNS, values);
+  for (size_t i = 0; i < COLUMNS; i++)
+    out[i] = min_y + values[i];
+  return true;
+}
+
+/**
+ * @brief Decode the root compound (or the "Level" compound before 1.18).
+ */
+static void decode_level(Reader &r, DecodeContext &ctx) {
+  std::string_view key;
+  for (TagType t = r.read_header(key); t != TagType::END;
+       t = r.read_header(key)) {
+    if ((t == TagType::INT) && (key == "DataVersion"))
+      ctx.version = r.read<int32_t>();
+    else if ((t == TagType::INT) && (key == "xPos"))
+      ctx.chunk.coord.x = r.read<int32_t>();
+    else if ((t == TagType::INT) && (key == "zPos"))
+      ctx.chunk.coord.z = r.read<int32_t>();
+    else if ((t == TagType::INT) && (key == "yPos"))
+      ctx.y_pos = r.read<int32_t>();
+    else if ((t == TagType::COMPOUND) && (key == "Heightmaps"))
+      decode_heightmaps(r, ctx);
+    else if ((t == TagType::COMPOUND) && (key == "Level"))
+      decode_level(r, ctx);
+    else if ((t == TagType::LIST) &&
+             ((key == "sections") || (key == "Sections"))) {
+      int32_t count;
+      const TagType e = r.read_list_header(count);
+      for (int32_t i = 0; i < count; i++) {
+        if (e == TagType::COMPOUND)
+          decode_section(r, ctx);
+        else
+          r.skip(e);
+      }
+    } else
+      r.skip(t);
+  }
+}
+
+// ============================================================================
+//    Decode instructions
+// ============================================================================
+
+Chunk::SharedPtr Anvil::decode(std::string_view nbt, BlockRegistry &registry,
+                               SectionPool *pool,
+                               const AnvilReadOptions &options) {
+  auto chunk = std::make_shared<Chunk>();
+  DecodeContext ctx{registry, *chunk, 0, {}, {}, {}, {}, {}, nullptr};
+
+  Reader r(nbt);
+  std::string_view name;
+  if (r.read_header(name) != TagType::COMPOUND)
+    throw NBTError("chunk root is not a compound");
+  decode_level(r, ctx);
+
+  const bool span = ctx.version < DATA_VERSION_NO_SPAN;
+  for (auto &s : ctx.sections) {
+    Section::SharedPtr section;
+    if ((s.palette.size() == 1) || s.data.empty()) {
+      if (s.palette[0] == nullptr)
+        continue;
+      section = Section::make(s.palette[0]);
+    } else {
+      Section::Indices indices;
+      unpack(s.data, bits_for(s.palette.size()), span, indices);
+      for (auto i : indices)
+        if (i >= s.palette.size())
+          throw NBTError(fmt::format("palette index {} out of {} entries", i,
+                                     s.palette.size()));
+      section = std::make_shared<Section>(std::move(s.palette),
+                                          std::move(indices));
+    }
+    chunk->emplace(s.y, (pool != nullptr) ? pool->intern(section) : section);
+  }
+
+  // Heightmaps, relative to the bottom of the world
+  chunk->set_min_section(
+      ctx.y_pos ? *ctx.y_pos
+                : ((ctx.version >= DATA_VERSION_NEGATIVE_Y) ? -4 : 0));
+  if (std::all_of(std::begin(ctx.heightmaps), std::end(ctx.heightmaps),
+                  [](std::string_view h) { return !h.empty(); })) {
+    auto heightmaps = std::make_shared<Heightmaps>();
+    heightmaps->min_y = chunk->get_min_section() * CHUNK_SIZE;
+    bool valid = true;
+    for (uint8_t h = 0; h < HEIGHTMAP_COUNT; h++)
+      valid &= unpack_heightmap(ctx.heightmaps[h], span, heightmaps->min_y,
+                                heightmaps->heights[h]);
+    if (valid)
+      chunk->set_heightmaps(heightmaps);
+  }
+  chunk->set_light(std::move(ctx.light));
+  if (options.keep_source)
+    chunk->set_source(std::make_shared<const std::string>(nbt));
+  return chunk;
+}
+
+Chunk::SharedPtr Anvil::read(const RegionFile &file, uint16_t index,
+                             BlockRegistry &registry, SectionPool *pool,
+                             const AnvilReadOptions &options) {
+  ChunkPayload payload;
+  if (!file.read_chunk(index, payload))
+    return nullptr;
+  return decode(inflate(payload), registry, pool, options);
+}
+
+// ============================================================================
+//    Encode instructions
+// ============================================================================
+
+/**
+ * @brief Encode a block state compound of a palette.
+ */
+static Node *encode_state(Document &doc, const Block *block) {
+  Node *state = doc.make_node(TagType::COMPOUND);
+  if (block == nullptr) {
+    state->set("Name", doc.make_string(Anvil::AIR));
+    return state;
+  }
+  state->set("Name", doc.make_string(fmt::format("{}:{}", block->package,
+                                                 block->resource_name)));
+
+  const std::string_view props = block->properties;
+  if (!props.empty()) {
+    Node *properties = doc.make_node(TagType::COMPOUND);
+    for (size_t begin = 0; begin < props.size();) {
+      size_t end = props.find(',', begin);
+      if (end == std::string_view::npos)
+        end = props.size();
+      const std::string_view kv = props.substr(begin, end - begin);
+      const size_t eq = kv.find('=');
+      properties->set(kv.substr(0, eq),
+                      doc.make_string((eq == std::string_view::npos)
+                                          ? std::string_view()
+                                          : kv.substr(eq + 1)));
+      begin = end + 1;
+    }
+    state->set("Properties", properties);
+  }
+  return state;
+}
+
+/**
+ * @brief Encode the "block_states" compound of a section.
+ */
+static Node *encode_block_states(Document &doc, const Section *section) {
+  Node *states = doc.make_node(TagType::COMPOUND);
+  Node *palette = doc.make_list(TagType::COMPOUND);
+  states->set("palette", palette);
+  if ((section == nullptr) || section->is_uniform()) {
+    palette->list().push_back(encode_state(
+        doc, (section == nullptr) ? nullptr : section->get_block(0)));
+    return states;
+  }
+
+  for (const Block *block : section->get_palette())
+    palette->list().push_back(encode_state(doc, block));
+  const std::vector<int64_t> data =
+      Anvil::pack(section->get_indices().data(), SECTION_VOLUME,
+                  Anvil::bits_for(section->get_palette().size()));
+  states->set("data", doc.make_array(data.data(), data.size()));
+  return states;
+}
+
+/**
+ * @brief Encode a light array as a byte array tag.
+ */
+static Node *encode_light(Document &doc, const LightArray &light) {
+  if (light.is_uniform()) {
+    const std::vector<int8_t> levels(LightArray::BYTES,
+                                     static_cast<int8_t>(light.get(0) * 0x11));
+    return doc.make_array(levels.data(), levels.size());
+  }
+  return doc.make_array(
+      reinterpret_cast<const int8_t *>(light.get_data().data()),
+      LightArray::BYTES);
+}
+
+/**
+ * @brief Encode the heightmaps in the "Heightmaps" compound.
+ *
+ * @param bottom the Y-index of the lowest section of the world
+ */
+static void encode_heightmaps(Document &doc, Node &out,
+                              const Heightmaps &heightmaps,
+                              SectionIndex bottom,
+                              const AnvilWriteOptions &options) {
+  constexpr size_t COLUMNS{CHUNK_SIZE * CHUNK_SIZE};
+  const LayerIndex min_y = bottom * CHUNK_SIZE;
+  const LayerIndex range = (options.max_section - bottom + 1) * CHUNK_SIZE;
+  uint8_t bits = 1;
+  while ((1 << bits) < range + 1)
+    bits++;
+
+  uint16_t values[COLUMNS];
+  for (uint8_t h = 0; h < HEIGHTMAP_COUNT; h++) {
+    for (size_t i = 0; i < COLUMNS; i++)
+      values[i] = std::clamp<LayerIndex>(heightmaps.heights[h][i] - min_y, 0,
+                                         range);
+    const std::vector<int64_t> data = Anvil::pack(values, COLUMNS, bits);
+    out.set(Heightmaps::NAMES[h], doc.make_array(data.data(), data.size()));
+  }
+  // Derived from the blocks but not maintained: rebuilt by the game
+  out.remove("MOTION_BLOCKING_NO_LEAVES");
+}
+
+/**
+ * @brief Get an entry of a compound, replacing it if absent or of another
+ * type (lists are created as lists of compounds).
+ */
+static Node &child(Document &doc, Node &parent, std::string_view key,
+                   TagType type) {
+  Node *node = parent.get(key);
+  if ((node == nullptr) || (node->type != type)) {
+    node = (type == TagType::LIST) ? doc.make_list(TagType::COMPOUND)
+                                   : doc.make_node(type);
+    parent.set(key, node);
+  }
+  return *node;
+}
+
+/**
+ * @brief Y-index of a section compound, INT64_MIN if it has none.
+ */
+static int64_t section_y(const Node *section) {
+  const Node *y = section->get("Y");
+  return ((y != nullptr) && (y->type == TagType::BYTE)) ? y->as_int()
+                                                        : INT64_MIN;
+}
+
+/**
+ * @brief Create the document of a chunk with no source.
+ */
+static Document::SharedPtr new_chunk(const AnvilWriteOptions &options) {
+  auto doc = Document::make();
+  Node &root = doc->root();
+  root.set("DataVersion", doc->make_int(TagType::INT, options.data_version));
+  root.set("xPos", doc->make_int(TagType::INT, 0));
+  root.set("zPos", doc->make_int(TagType::INT, 0));
+  root.set("yPos", doc->make_int(TagType::INT, options.min_section));
+  root.set("Status", doc->make_string("minecraft:full"));
+  root.set("sections", doc->make_list(TagType::COMPOUND));
+  root.set("Heightmaps", doc->make_node(TagType::COMPOUND));
+  return doc;
+}
+
+std::string Anvil::encode(const Chunk &chunk,
+                          const AnvilWriteOptions &options) {
+  const Chunk::Source &source = chunk.get_source();
+  Document::SharedPtr doc =
+      (source != nullptr) ? Document::parse(*source) : new_chunk(options);
+  Node &root = doc->root();
+  if (root.get("Level") != nullptr)
+    throw SolisError(fmt::format("chunk ({}, {}) is in the layout older than "
+                                 "1.18, which cannot be patched",
+                                 chunk.coord.x, chunk.coord.z));
+  root.set("xPos", doc->make_int(TagType::INT, chunk.coord.x));
+  root.set("zPos", doc->make_int(TagType::INT, chunk.coord.z));
+  const Node *y_pos = root.get("yPos");
+  const SectionIndex bottom = ((y_pos != nullptr) &&
+                               (y_pos->type == TagType::INT))
+                                  ? y_pos->as_int()
+                                  : options.min_section;
+
+  // Sections of the source, by Y-index
+  Node &sections = child(*doc, root, "sections", TagType::LIST);
+  if (sections.list().empty())
+    sections.element_type = TagType::COMPOUND;
+  if (sections.element_type != TagType::COMPOUND)
+    throw NBTError("chunk sections are not compounds");
+  std::map<SectionIndex, Node *> by_y;
+  for (Node *section : sections.list())
+    if (const int64_t y = section_y(section); y != INT64_MIN)
+      by_y.emplace(y, section);
+
+  // New sections holding blocks or light, in the world range
+  const ChunkLight::SharedPtr &light = chunk.get_light();
+  auto add_section = [&doc, &sections, &by_y, bottom,
+                      &options](SectionIndex y) {
+    if ((y < bottom) || (y > options.max_section) || (by_y.count(y) > 0))
+      return;
+    Node *section = doc->make_node(TagType::COMPOUND);
+    section->set("Y", doc->make_int(TagType::BYTE, y));
+    sections.list().push_back(section);
+    by_y.emplace(y, section);
+  };
+  for (const auto &entry : chunk)
+    add_section(entry.first);
+  if (light != nullptr)
+    for (const auto &entry : *light)
+      add_section(entry.first);
+
+  // Only the block states and the light of the sections are replaced
+  for (const auto &[y, section] : by_y) {
+    const Section *blocks = chunk.get_section(y).get();
+    if ((blocks != nullptr) || (section->get("block_states") != nullptr) ||
+        ((y >= bottom) && (y <= options.max_section)))
+      section->set("block_states", encode_block_states(*doc, blocks));
+
+    const SectionLight *levels = nullptr;
+    if (light != nullptr)
+      if (auto it = light->find(y); it != light->end())
+        levels = &it->second;
+    if (levels != nullptr) {
+      section->set("BlockLight", encode_light(*doc, levels->block));
+      section->set("SkyLight", encode_light(*doc, levels->sky));
+    } else {
+      section->remove("BlockLight");
+      section->remove("SkyLight");
+    }
+  }
+  std::stable_sort(sections.list().begin(), sections.list().end(),
+                   [](const Node *a, const Node *b) {
+                     return section_y(a) < section_y(b);
+                   });
+
+  Heightmaps::SharedPtr heightmaps = chunk.get_cached_heightmaps();
+  if ((heightmaps == nullptr) || (heightmaps->min_y != bottom * CHUNK_SIZE))
+    heightmaps = chunk.build_heightmaps(bottom * CHUNK_SIZE);
+  encode_heightmaps(*doc, child(*doc, root, "Heightmaps", TagType::COMPOUND),
+                    *heightmaps, bottom, options);
+
+  if ((light == nullptr) || (root.get("isLightOn") == nullptr))
+    root.set("isLightOn", doc->make_int(TagType::BYTE, light != nullptr));
+  return doc->serialize();
+}
+
+ChunkPayload Anvil::deflate(const Chunk &chunk,
+                            const AnvilWriteOptions &options) {
+  return compress(encode(chunk, options), options.compression);
+}
+
+ChunkPayload Anvil::compress(const std::string &nbt, uint8_t compression,
+                             uint8_t level, const ZDictionary *dictionary) {
+  ChunkPayload payload;
+  payload.compression = compression;
+  switch (compression) {
+  case CompressionType::GZIP:
+    payload.data = ZLib::encodeFromString(nbt, level, ZLib::FORMAT_GZIP);
+    break;
+  case CompressionType::ZLIB:
+    payload.data = ZLib::encodeFromString(nbt, level, ZLib::FORMAT_ZLIB);
+    break;
+  case CompressionType::ZLIB_DICT:
+    payload.data = ZLib::encodeFromString(nbt, level, ZLib::FORMAT_ZLIB,
+                                          get_dictionary(dictionary));
+    break;
+  case CompressionType::NONE:
+    payload.data = nbt;
+    break;
+  default:
+    throw SolisError(
+        fmt::format("unsupported chunk compression type {}", compression));
+  }
+  return payload;
+}
+
+// ============================================================================
+//    Block indices packing
+// ============================================================================
+
+uint8_t Anvil::bits_for(size_t palette_size) {
+  uint8_t bits = 0;
+  while ((static_cast<size_t>(1) << bits) < palette_size)
+    bits++;
+  return std::max(bits, MIN_BITS);
+}
+
+void Anvil::unpack(std::string_view data, uint8_t bits, bool span,
+                   Section::Indices &out) {
+  out.assign(SECTION_VOLUME, 0);
+  unpack(data, bits, span, SECTION_VOLUME, out.data());
+}
+
+void Anvil::unpack(std::string_view data, uint8_t bits, bool span,
+                   size_t count, uint16_t *out) {
+  const size_t n_longs = data.size() / sizeof(uint64_t);
+  auto word = [&data](size_t i) {
+    uint64_t w;
+    std::memcpy(&w, data.data() + i * sizeof(w), sizeof(w));
+    return FROM_BIG_ENDIAN(w);
+  };
+  const uint64_t mask = (static_cast<uint64_t>(1) << bits) - 1;
+
+  if (!span) {
+    const uint8_t per_long = 64 / bits;
+    if (n_longs * per_long < count)
+      throw NBTError(fmt::format("{} longs cannot hold {} values of {} bits",
+                                 n_longs, count, bits));
+    for (size_t l = 0, i = 0; i < count; l++) {
+      uint64_t w = word(l);
+      for (uint8_t k = 0; (k < per_long) && (i < count); k++, i++) {
+        out[i] = static_cast<uint16_t>(w & mask);
+        w >>= bits;
+      }
+    }
+    return;
+  }
+
+  if (n_longs * 64 < count * bits)
+    throw NBTError(fmt::format("{} longs cannot hold {} values of {} bits",
+                               n_longs, count, bits));
+  for (size_t i = 0; i < count; i++) {
+    const size_t bit = i * bits;
+    const size_t l = bit / 64;
+    const uint8_t offset = bit % 64;
+    uint64_t v = word(l) >> offset;
+    if (offset + bits > 64)
+      v |= word(l + 1) << (64 - offset);
+    out[i] = static_cast<uint16_t>(v & mask);
+  }
+}
+
+std::vector<int64_t> Anvil::pack(const uint16_t *values, size_t count,
+                                 uint8_t bits) {
+  const uint8_t per_long = 64 / bits;
+  std::vector<int64_t> out((count + per_long - 1) / per_long, 0);
+  for (size_t i = 0; i < count; i++) {
+    const uint64_t v = values[i] & ((static_cast<uint64_t>(1) << bits) - 1);
+    out[i / per_long] |= static_cast<int64_t>(v << ((i % per_long) * bits));
+  }
+  return out;
+}
+
+} // namespace solis::world
@@ -0,0 +1,196 @@
+#include "solis/world/block_index.hpp"
+#include "solis/utils/binary.hpp"
+#include "solis/utils/files.hpp"
+#include "solis/utils/static.hpp"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+
+namespace solis::world {
+
+constexpr char INDEX_MAGIC[4]{'S', 'L', 'S', 'I'};
+constexpr uint16_t INDEX_VERSION{1};
+
+std::string BlockIndex::filename(const std::string &dim) {
+  std::string name = dim;
+  std::replace(name.begin(), name.end(), ':', '.');
+  return "solis." + name + ".blocks";
+}
+
+// ============================================================================
+//    Index methods
+// ============================================================================
+
+void BlockIndex::add_section(ChunkEntry &entry, const SectionKey &key,
+                             std::vector<const Block *> palette) {
+  palette.erase(std::remove(palette.begin(), palette.end(), nullptr),
+                palette.end());
+  if (palette.empty())
+    return;
+  for (const Block *block : palette)
+    blocks[block].insert(key);
+  entry.sections.emplace(key.y, std::move(palette));
+}
+
+void BlockIndex::add_chunk(const Chunk &chunk, uint32_t timestamp) {
+  remove_chunk(chunk.coord);
+  ChunkEntry &entry = chunks[chunk.coord];
+  entry.timestamp = (timestamp != 0)
+                        ? timestamp
+                        : static_cast<uint32_t>(std::time(nullptr));
+  for (const auto &[y, section] : chunk)
+    if (section != nullptr)
+      add_section(entry, SectionKey{chunk.coord, y}, section->get_palette());
+}
+
+void BlockIndex::remove_chunk(const ChunkCoordinate &coord) {
+  auto it = chunks.find(coord);
+  if (it == chunks.end())
+    return;
+  for (const auto &[y, palette] : it->second.sections)
+    for (const Block *block : palette) {
+      auto b = blocks.find(block);
+      b->second.erase(SectionKey{coord, y});
+      if (b->second.empty())
+        blocks.erase(b);
+    }
+  chunks.erase(it);
+}
+
+std::vector<ChunkCoordinate>
+BlockIndex::validate(const DimensionManifest &dimension) {
+  for (auto it = chunks.begin(); it != chunks.end();) {
+    const uint32_t saved = dimension.get_timestamp(it->first);
+    if ((saved != 0) && (saved <= it->second.timestamp)) {
+      ++it;
+      continue;
+    }
+    const ChunkCoordinate coord = (it++)->first;
+    remove_chunk(coord);
+  }
+
+  std::vector<ChunkCoordinate> missing;
+  for (const ChunkStamp &c : dimension.modified_since(0))
+    if (!has_chunk(c.coord))
+      missing.push_back(c.coord);
+  return missing;
+}
+
+// ============================================================================
+//    Query methods
+// ============================================================================
+
+const BlockIndex::SectionSet &BlockIndex::find(const Block *block) const {
+  static const SectionSet EMPTY;
+  if (auto it = blocks.find(block); it != blocks.end())
+    return it->second;
+  return EMPTY;
+}
+
+std::vector<ChunkCoordinate>
+BlockIndex::find_chunks(const Block *block) const {
+  std::vector<ChunkCoordinate> out;
+  for (const SectionKey &key : find(block))
+    if (out.empty() || (out.back().x != key.coord.x) ||
+        (out.back().z != key.coord.z))
+      out.push_back(key.coord);
+  return out;
+}
+
+// ============================================================================
+//    Index I/O
+// ============================================================================
+
+bool BlockIndex::load(const std::string &path, BlockRegistry &registry) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    return false;
+  const std::string data((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+
+  BinaryCursor c{data};
+  char magic[4];
+  uint16_t version;
+  uint8_t big_endian;
+  uint32_t n_blocks, n_chunks;
+  if (!c.read(magic) || (std::memcmp(magic, INDEX_MAGIC, 4) != 0) ||
+      !c.read(version) || (version != INDEX_VERSION) ||
+      !c.read(big_endian) || (big_endian != SOLIS_BIG_ENDIAN) ||
+      !c.read(n_blocks))
+    return false;
+
+  // Block states by name, then the palettes of the sections of each chunk
+  std::vector<const Block *> states;
+  for (uint32_t b = 0; b < n_blocks; b++) {
+    std::string name;
+    if (!c.read_string(name))
+      return false;
+    states.push_back(registry.get(name));
+  }
+
+  BlockIndex loaded;
+  if (!c.read(n_chunks))
+    return false;
+  for (uint32_t i = 0; i < n_chunks; i++) {
+    ChunkCoordinate coord;
+    uint32_t timestamp;
+    uint16_t n_sections;
+    if (!c.read(coord.x) || !c.read(coord.z) || !c.read(timestamp) ||
+        !c.read(n_sections))
+      return false;
+    ChunkEntry &entry = loaded.chunks[coord];
+    entry.timestamp = timestamp;
+    for (uint16_t s = 0; s < n_sections; s++) {
+      SectionIndex y;
+      uint16_t n;
+      if (!c.read(y) || !c.read(n))
+        return false;
+      std::vector<const Block *> palette(n);
+      for (auto &block : palette) {
+        uint32_t id;
+        if (!c.read(id) || (id >= states.size()))
+          return false;
+        block = states[id];
+      }
+      loaded.add_section(entry, SectionKey{coord, y}, std::move(palette));
+    }
+  }
+  chunks.swap(loaded.chunks);
+  blocks.swap(loaded.blocks);
+  return true;
+}
+
+void BlockIndex::save(const std::string &path) const {
+  std::string out;
+  out.append(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+  append(out, INDEX_VERSION);
+  append(out, static_cast<uint8_t>(SOLIS_BIG_ENDIAN));
+
+  std::unordered_map<const Block *, uint32_t> ids;
+  append(out, static_cast<uint32_t>(blocks.size()));
+  for (const auto &[block, sections] : blocks) {
+    const std::string name = BlockRegistry::full_name(*block);
+    ids.emplace(block, static_cast<uint32_t>(ids.size()));
+    append(out, static_cast<uint16_t>(name.size()));
+    out.append(name);
+  }
+
+  append(out, static_cast<uint32_t>(chunks.size()));
+  for (const auto &[coord, entry] : chunks) {
+    append(out, coord.x);
+    append(out, coord.z);
+    append(out, entry.timestamp);
+    append(out, static_cast<uint16_t>(entry.sections.size()));
+    for (const auto &[y, palette] : entry.sections) {
+      append(out, y);
+      append(out, static_cast<uint16_t>(palette.size()));
+      for (const Block *block : palette)
+        append(out, ids.at(block));
+    }
+  }
+  write_file_atomic(path, out);
+}
+
+} // namespace solis::world
@@ -0,0 +1,233 @@
+#include "solis/world/chunk.hpp"
+#include "solis/utils/common.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace solis::world {
+
+// ============================================================================
+//    Block methods
+// ============================================================================
+
+const Block *Chunk::get_block(InChunkCoord_t x, LayerIndex y,
+                              InChunkCoord_t z) const {
+  if (auto it = find(section_of(y)); it != end())
+    return it->second->get_block(
+        Section::index(x, floor_mod<LayerIndex>(y, CHUNK_SIZE), z));
+  return nullptr;
+}
+
+bool Chunk::set_block(InChunkCoord_t x, LayerIndex y, InChunkCoord_t z,
+                      const Block *block) {
+  const SectionIndex sy = section_of(y);
+  auto it = find(sy);
+  if (it == end()) {
+    if (block == nullptr)
+      return false;
+    it = emplace(sy, Section::make()).first;
+  }
+
+  const uint16_t i =
+      Section::index(x, floor_mod<LayerIndex>(y, CHUNK_SIZE), z);
+  const Block *old = it->second->get_block(i);
+  if (old == block)
+    return false;
+  detach(it->second)->set_block(i, block);
+  mark_dirty(sy);
+  if (!stale_heightmaps)
+    update_heightmaps(x, y, z, block);
+  if (observer != nullptr)
+    observer->on_block_changed(*this, x, y, z, old, block);
+  return true;
+}
+
+void Chunk::set_section(SectionIndex y, Section::ConstSharedPtr section) {
+  if (section == nullptr)
+    erase(y);
+  else
+    (*this)[y] = section;
+  stale_heightmaps = true;
+  mark_dirty(y);
+  if (observer != nullptr)
+    observer->on_section_changed(*this, y);
+}
+
+Section::ConstSharedPtr Chunk::get_section(SectionIndex y) const {
+  if (auto it = find(y); it != end())
+    return it->second;
+  return nullptr;
+}
+
+Section::SharedPtr Chunk::edit_section(SectionIndex y) {
+  auto it = find(y);
+  if (it == end())
+    it = emplace(y, Section::make()).first;
+  auto section = detach(it->second);
+  stale_heightmaps = true;
+  mark_dirty(y);
+  if (observer != nullptr)
+    observer->on_section_changed(*this, y);
+  return section;
+}
+
+// ============================================================================
+//    Heightmap methods
+// ============================================================================
+
+Heightmaps::SharedPtr Chunk::build_heightmaps(LayerIndex bottom) const {
+  auto h = std::make_shared<Heightmaps>();
+  h->clear(bottom);
+
+  // Scan the columns from the top section, until every column is found
+  constexpr uint16_t COLUMNS{CHUNK_SIZE * CHUNK_SIZE};
+  std::bitset<HEIGHTMAP_COUNT * COLUMNS> found;
+  std::vector<uint8_t> masks;
+  for (auto it = rbegin(); (it != rend()) && !found.all(); ++it) {
+    const LayerIndex base = it->first * CHUNK_SIZE;
+    if (base + CHUNK_SIZE <= bottom)
+      break; // Below the world
+    if (it->second == nullptr)
+      continue;
+    const Section &section = *it->second;
+    uint8_t any = 0;
+    masks.clear();
+    for (const Block *block : section.get_palette()) {
+      masks.push_back(Heightmaps::classify(block));
+      any |= masks.back();
+    }
+    if (any == 0)
+      continue;
+
+    for (uint8_t t = 0; t < HEIGHTMAP_COUNT; t++) {
+      const uint8_t bit = 1 << t;
+      if ((any & bit) == 0)
+        continue;
+      for (uint16_t col = 0; col < COLUMNS; col++) {
+        if (found.test(t * COLUMNS + col))
+          continue;
+        for (int8_t ly = CHUNK_SIZE - 1; (ly >= 0) && (base + ly >= bottom);
+             ly--) {
+          const uint16_t i = (ly << 8) | col;
+          const uint8_t m =
+              section.is_uniform() ? masks[0] : masks[section.get_indices()[i]];
+          if (m & bit) {
+            h->heights[t][col] = base + ly + 1;
+            found.set(t * COLUMNS + col);
+            break;
+          }
+        }
+      }
+    }
+  }
+  return h;
+}
+
+const Heightmaps &Chunk::get_heightmaps() {
+  if (stale_heightmaps || (heightmaps == nullptr)) {
+    heightmaps = build_heightmaps();
+    stale_heightmaps = false;
+  }
+  return *heightmaps;
+}
+
+LayerIndex Chunk::find_height(HeightmapType type, InChunkCoord_t x,
+                              InChunkCoord_t z, LayerIndex below,
+                              LayerIndex min_y) const {
+  const uint8_t bit = 1 << type;
+  for (auto it = std::make_reverse_iterator(upper_bound(section_of(below - 1)));
+       it != rend(); ++it) {
+    const LayerIndex base = it->first * CHUNK_SIZE;
+    const LayerIndex top =
+        std::min<LayerIndex>(below - 1, base + CHUNK_SIZE - 1);
+    if (top < min_y)
+      break;
+    if (it->second == nullptr)
+      continue;
+    const Section &section = *it->second;
+    if (section.is_uniform()) {
+      if (Heightmaps::classify(section.get_block(0)) & bit)
+        return top + 1;
+      continue;
+    }
+    for (LayerIndex y = top; (y >= base) && (y >= min_y); y--) {
+      const Block *block = section.get_block(Section::index(x, y - base, z));
+      if (Heightmaps::classify(block) & bit)
+        return y + 1;
+    }
+  }
+  return min_y;
+}
+
+void Chunk::update_heightmaps(InChunkCoord_t x, LayerIndex y, InChunkCoord_t z,
+                              const Block *block) {
+  if (!is_sole_owner(heightmaps))
+    heightmaps = std::make_shared<Heightmaps>(*heightmaps);
+  const uint8_t mask = Heightmaps::classify(block);
+  for (uint8_t t = 0; t < HEIGHTMAP_COUNT; t++) {
+    const HeightmapType type = static_cast<HeightmapType>(t);
+    const LayerIndex height = heightmaps->get(type, x, z);
+    if (mask & (1 << t)) {
+      if (y + 1 > height)
+        heightmaps->set(type, x, z, y + 1);
+    } else if (y + 1 == height)
+      heightmaps->set(type, x, z,
+                      find_height(type, x, z, y, heightmaps->min_y));
+  }
+}
+
+// ============================================================================
+//    Snapshot methods
+// ============================================================================
+
+Chunk::SharedPtr Chunk::snapshot() const {
+  auto snap = std::make_shared<Chunk>();
+  static_cast<std::map<SectionIndex, Section::ConstSharedPtr> &>(*snap) =
+      *this;
+  snap->coord = coord;
+  snap->light = light;
+  snap->heightmaps = heightmaps;
+  snap->stale_heightmaps = stale_heightmaps;
+  snap->min_section = min_section;
+  snap->source = source;
+  return snap;
+}
+
+Section::SharedPtr Chunk::detach(Section::ConstSharedPtr &section) {
+  // Single owner: the section is only const for the readers of the chunk
+  if (is_sole_owner(section))
+    return std::const_pointer_cast<Section>(section);
+  auto copy = std::make_shared<Section>(*section);
+  section = copy;
+  return copy;
+}
+
+Region::SharedPtr Region::snapshot() const {
+  auto snap = std::make_shared<Region>();
+  snap->coord = coord;
+  snap->reserve(size());
+  for (const auto &chunk : *this)
+    snap->push_back(chunk->snapshot());
+  return snap;
+}
+
+// ============================================================================
+//    Dirty methods
+// ============================================================================
+
+void Chunk::mark_dirty(SectionIndex y) {
+  const bool was_clean = dirty.none();
+  revision++;
+  dirty.set(static_cast<uint8_t>(y));
+  if (was_clean && (observer != nullptr))
+    observer->on_chunk_dirty(*this);
+}
+
+void Chunk::mark_dirty(const SectionMask &sections) {
+  const bool was_clean = dirty.none();
+  revision++;
+  dirty |= sections;
+  if (was_clean && dirty.any() && (observer != nullptr))
+    observer->on_chunk_dirty(*this);
+}
+
+} // namespace solis::world
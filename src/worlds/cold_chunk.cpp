@@ -0,0 +1,156 @@
+#include "solis/world/cold_chunk.hpp"
+#include "solis/utils/errors.hpp"
+#include "solis/utils/zlib.hpp"
+#include <cstring>
+
+namespace solis::world {
+
+// ============================================================================
+//    Serialization
+// ============================================================================
+//
+//  [uint16_t count] then for each owned section:
+//    [int8_t y] [uint16_t palette size] [const Block * x size]
+//    [uint8_t uniform] [PaletteIndex_t x 4096, if not uniform]
+//  [uint16_t count] then for each light entry:
+//    [int8_t y] [sky array] [block array]
+//  with an array being [uint8_t uniform] [level, or the packed bytes]
+
+template <typename T> static inline void put(std::string &out, T v) {
+  out.append(reinterpret_cast<const char *>(&v), sizeof(T));
+}
+
+/**
+ * @brief Cursor over an inflated buffer.
+ */
+struct ColdReader {
+  const std::string &data;
+  size_t pos{0};
+
+  template <typename T> inline T get() {
+    T v;
+    take(&v, sizeof(T));
+    return v;
+  }
+
+  inline void take(void *out, size_t n) {
+    if (pos + n > data.size())
+      throw SolisError("truncated cold chunk");
+    std::memcpy(out, data.data() + pos, n);
+    pos += n;
+  }
+};
+
+static void put_light(std::string &out, const LightArray &light) {
+  put<uint8_t>(out, light.is_uniform());
+  if (light.is_uniform())
+    put<uint8_t>(out, light.get(0));
+  else
+    out.append(reinterpret_cast<const char *>(light.get_data().data()),
+               LightArray::BYTES);
+}
+
+static LightArray get_light(ColdReader &r) {
+  if (r.get<uint8_t>() != 0)
+    return LightArray(r.get<uint8_t>());
+  uint8_t packed[LightArray::BYTES], levels[SECTION_VOLUME];
+  r.take(packed, LightArray::BYTES);
+  for (uint16_t b = 0; b < LightArray::BYTES; b++) {
+    levels[2 * b] = packed[b] & 0xF;
+    levels[2 * b + 1] = packed[b] >> 4;
+  }
+  return LightArray::pack(levels);
+}
+
+// ============================================================================
+//    Constructor
+// ============================================================================
+
+ColdChunk::SharedPtr ColdChunk::compress(const Chunk &chunk, uint8_t level) {
+  auto cold = std::make_shared<ColdChunk>();
+  cold->coord = chunk.coord;
+  cold->heightmaps = chunk.get_cached_heightmaps();
+  cold->source = chunk.get_source();
+  cold->min_section = chunk.get_min_section();
+
+  std::string raw;
+  std::vector<const std::pair<const SectionIndex, Section::ConstSharedPtr> *>
+      owned;
+  for (const auto &entry : chunk) {
+    if (entry.second.use_count() > 1)
+      cold->shared.emplace_back(entry.first, entry.second);
+    else
+      owned.push_back(&entry);
+  }
+  put<uint16_t>(raw, owned.size());
+  for (const auto *entry : owned) {
+    const Section &section = *entry->second;
+    put<int8_t>(raw, entry->first);
+    put<uint16_t>(raw, section.get_palette().size());
+    for (const Block *block : section.get_palette())
+      put<const Block *>(raw, block);
+    put<uint8_t>(raw, section.is_uniform());
+    if (!section.is_uniform())
+      raw.append(reinterpret_cast<const char *>(section.get_indices().data()),
+                 SECTION_VOLUME * sizeof(PaletteIndex_t));
+  }
+
+  if (const auto &light = chunk.get_light(); light != nullptr) {
+    cold->has_light = true;
+    put<uint16_t>(raw, light->size());
+    for (const auto &[y, l] : *light) {
+      put<int8_t>(raw, y);
+      put_light(raw, l.sky);
+      put_light(raw, l.block);
+    }
+  }
+
+  cold->raw_size = raw.size();
+  cold->data = ZLib::encodeFromString(raw, level, ZLib::FORMAT_DEFLATE);
+  cold->data.shrink_to_fit();
+  cold->shared.shrink_to_fit();
+  return cold;
+}
+
+Chunk::SharedPtr ColdChunk::inflate() const {
+  const std::string raw = ZLib::decodeFromString(data, ZLib::FORMAT_DEFLATE);
+  if (raw.size() != raw_size)
+    throw SolisError(fmt::format("cold chunk inflated to {} bytes instead "
+                                 "of {}",
+                                 raw.size(), raw_size));
+  ColdReader r{raw};
+
+  auto chunk = std::make_shared<Chunk>();
+  chunk->coord = coord;
+  for (const auto &[y, section] : shared)
+    chunk->emplace(y, section);
+  for (uint16_t count = r.get<uint16_t>(); count > 0; count--) {
+    const SectionIndex y = r.get<int8_t>();
+    Section::Palette palette(r.get<uint16_t>());
+    r.take(palette.data(), palette.size() * sizeof(const Block *));
+    Section::Indices indices;
+    if (r.get<uint8_t>() == 0) {
+      indices.resize(SECTION_VOLUME);
+      r.take(indices.data(), SECTION_VOLUME * sizeof(PaletteIndex_t));
+    }
+    chunk->emplace(y, std::make_shared<Section>(std::move(palette),
+                                                std::move(indices)));
+  }
+
+  if (has_light) {
+    auto light = std::make_shared<ChunkLight>();
+    for (uint16_t count = r.get<uint16_t>(); count > 0; count--) {
+      const SectionIndex y = r.get<int8_t>();
+      SectionLight &l = (*light)[y];
+      l.sky = get_light(r);
+      l.block = get_light(r);
+    }
+    chunk->set_light(std::move(light));
+  }
+  chunk->set_min_section(min_section);
+  chunk->set_heightmaps(heightmaps);
+  chunk->set_source(source);
+  return chunk;
+}
+
+} // namespace solis::world
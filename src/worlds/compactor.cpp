@@ -0,0 +1,160 @@
+#include "solis/world/compactor.hpp"
+#include "solis/utils/errors.hpp"
+#include "solis/utils/files.hpp"
+#include "solis/utils/static.hpp"
+#include "solis/utils/thread_pool.hpp"
+#include "solis/world/anvil.hpp"
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <filesystem>
+
+namespace solis::world {
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+//    Chunk order
+// ============================================================================
+
+/**
+ * @brief Interleave the bits of the local coordinates of a chunk.
+ */
+static inline uint16_t morton(uint16_t i) {
+  uint16_t code = 0;
+  for (uint8_t b = 0; (1 << b) < REGION_WIDTH_CHUNK; b++) {
+    code |= ((i % REGION_WIDTH_CHUNK) >> b & 1) << (2 * b);
+    code |= ((i / REGION_WIDTH_CHUNK) >> b & 1) << (2 * b + 1);
+  }
+  return code;
+}
+
+const std::array<uint16_t, REGION_CHUNK_COUNT> &RegionCompactor::z_order() {
+  static const std::array<uint16_t, REGION_CHUNK_COUNT> order = [] {
+    std::array<uint16_t, REGION_CHUNK_COUNT> o;
+    for (uint16_t i = 0; i < REGION_CHUNK_COUNT; i++)
+      o[i] = i;
+    std::sort(o.begin(), o.end(),
+              [](uint16_t a, uint16_t b) { return morton(a) < morton(b); });
+    return o;
+  }();
+  return order;
+}
+
+// ============================================================================
+//    Compaction methods
+// ============================================================================
+
+/**
+ * @brief Recompress a payload, keeping the original one if the new one is
+ * not an improvement.
+ * @return true if the payload was replaced
+ */
+static bool recompress(ChunkPayload &payload, const CompactOptions &options) {
+  ChunkPayload out =
+      Anvil::compress(Anvil::inflate(payload), options.compression,
+                      options.level);
+  if ((out.sector_count() > CHUNK_MAX_SECTORS) ||
+      ((out.compression == payload.compression) &&
+       (out.data.size() >= payload.data.size())))
+    return false;
+  payload = std::move(out);
+  return true;
+}
+
+template <typename T> static inline void store(char *out, T v) {
+  v = TO_BIG_ENDIAN<T>(v);
+  std::memcpy(out, &v, sizeof(T));
+}
+
+bool RegionCompactor::compact_file(const std::string &path,
+                                   CompactStats &stats,
+                                   const CompactOptions &options) {
+  stats.regions++;
+  const FileStamp stamp = FileStamp::of(path);
+  std::array<ChunkPayload, REGION_CHUNK_COUNT> payloads;
+  std::array<uint32_t, REGION_CHUNK_COUNT> timestamps{};
+  std::bitset<REGION_CHUNK_COUNT> present;
+  bool in_place = true;
+  uint32_t next = REGION_HEADER_SECTORS;
+  size_t count = 0, recompressed = 0;
+  try {
+    RegionFile file(path);
+    for (const uint16_t i : z_order()) {
+      if (!file.read_chunk(i, payloads[i]))
+        continue;
+      present.set(i);
+      timestamps[i] = file.get_timestamp(i);
+      if (options.recompress)
+        recompressed += recompress(payloads[i], options);
+
+      // Whether the chunk already is at its compacted location
+      const ChunkLocation &loc = file.get_location(i);
+      const uint32_t sectors = payloads[i].sector_count();
+      in_place &= (loc.offset == next) && (loc.sectors == sectors);
+      next += sectors;
+      count++;
+    }
+  } catch (const SolisError &) {
+    stats.skipped++;
+    return false;
+  }
+  if (in_place && (recompressed == 0) && !options.force &&
+      (stamp.size == static_cast<uint64_t>(next) * SECTOR_SIZE))
+    return false;
+
+  if (options.on_read)
+    options.on_read(path);
+
+  // Header, then the payloads in Z-order
+  std::string out(static_cast<size_t>(next) * SECTOR_SIZE, '\0');
+  uint32_t offset = REGION_HEADER_SECTORS;
+  for (const uint16_t i : z_order()) {
+    if (!present.test(i))
+      continue;
+    const ChunkPayload &payload = payloads[i];
+    const uint32_t sectors = payload.sector_count();
+    char *at = out.data() + static_cast<size_t>(offset) * SECTOR_SIZE;
+    store<uint32_t>(at, payload.data.size() + 1);
+    at[4] = static_cast<char>(payload.compression);
+    std::memcpy(at + CHUNK_PAYLOAD_HEADER, payload.data.data(),
+                payload.data.size());
+    store<uint32_t>(out.data() + i * sizeof(uint32_t),
+                    offset << 8 | sectors);
+    store<uint32_t>(out.data() + SECTOR_SIZE + i * sizeof(uint32_t),
+                    timestamps[i]);
+    offset += sectors;
+  }
+
+  // Do not replace a file which changed in the meantime
+  if (FileStamp::of(path) != stamp) {
+    stats.skipped++;
+    return false;
+  }
+  write_file_atomic(path, out);
+
+  stats.rewritten++;
+  stats.chunks += count;
+  stats.recompressed += recompressed;
+  stats.bytes_before += stamp.size;
+  stats.bytes_after += out.size();
+  return true;
+}
+
+void RegionCompactor::compact_directory(const std::string &dir,
+                                        CompactStats &stats,
+                                        const CompactOptions &options) {
+  ThreadPool pool(options.threads);
+  for (const auto &entry : fs::directory_iterator(dir)) {
+    RegionCoordinate coord;
+    if (!entry.is_regular_file() ||
+        !RegionFile::parse_filename(entry.path().filename().string(), coord))
+      continue;
+    pool.submit([path = entry.path().string(), &stats, &options] {
+      compact_file(path, stats, options);
+    });
+  }
+  pool.wait();
+}
+
+} // namespace solis::world
@@ -0,0 +1,198 @@
+#include "solis/world/diff.hpp"
+#include "solis/utils/thread_pool.hpp"
+#include "solis/world/anvil.hpp"
+#include <filesystem>
+#include <map>
+#include <mutex>
+
+namespace solis::world {
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+//    Chunk comparison
+// ============================================================================
+
+bool WorldDiff::diff_sections(const Section *from, const Section *to,
+                              SectionDiff &out) {
+  if ((from != nullptr) && from->is_empty())
+    from = nullptr;
+  if ((to != nullptr) && to->is_empty())
+    to = nullptr;
+  if (from == to)
+    return false;
+  if ((from != nullptr) && (to != nullptr) &&
+      (from->get_palette() == to->get_palette()) &&
+      (from->get_indices() == to->get_indices()))
+    return false;
+
+  // The new copy is uniform: only give the filling block
+  out.changes.clear();
+  if ((to == nullptr) || to->is_uniform()) {
+    out.fill = (to == nullptr) ? nullptr : to->get_block(0);
+    if ((from != nullptr) && from->is_uniform() &&
+        (from->get_block(0) == out.fill))
+      return false;
+    out.kind = (from == nullptr)  ? DiffKind::ADDED
+               : (to == nullptr) ? DiffKind::REMOVED
+                                 : DiffKind::FILLED;
+    return true;
+  }
+
+  // Block-level comparison
+  out.kind = (from == nullptr) ? DiffKind::ADDED : DiffKind::CHANGED;
+  out.fill = nullptr;
+  for (uint16_t i = 0; i < SECTION_VOLUME; i++) {
+    const Block *a = (from == nullptr) ? nullptr : from->get_block(i);
+    const Block *b = to->get_block(i);
+    if (a != b)
+      out.changes.push_back(BlockChange{i, a, b});
+  }
+  return !out.changes.empty();
+}
+
+bool WorldDiff::diff_chunks(const Chunk &from, const Chunk &to,
+                            ChunkDiff &out) {
+  out.sections.clear();
+  SectionDiff section;
+  auto a = from.begin(), b = to.begin();
+  while ((a != from.end()) || (b != to.end())) {
+    const Section *sa = nullptr, *sb = nullptr;
+    if ((b == to.end()) || ((a != from.end()) && (a->first < b->first))) {
+      section.y = a->first;
+      sa = (a++)->second.get();
+    } else if ((a == from.end()) || (b->first < a->first)) {
+      section.y = b->first;
+      sb = (b++)->second.get();
+    } else {
+      section.y = a->first;
+      sa = (a++)->second.get();
+      sb = (b++)->second.get();
+    }
+    if (diff_sections(sa, sb, section))
+      out.sections.push_back(std::move(section));
+  }
+  return !out.sections.empty();
+}
+
+// ============================================================================
+//    Region comparison
+// ============================================================================
+
+/**
+ * @brief Shared state of a directory diff.
+ */
+struct DiffContext {
+  const WorldDiff::Sink &sink;
+  DiffStats &stats;
+  const DiffOptions &options;
+  BlockRegistry &registry;
+  ThreadPool &pool;
+  std::mutex sink_mutex;
+
+  void emit(const ChunkDiff &diff) {
+    stats.different++;
+    std::lock_guard<std::mutex> lock(sink_mutex);
+    sink(diff);
+  }
+};
+
+/**
+ * @brief Read, then decode if needed, a chunk present in both copies.
+ */
+static void diff_chunk(DiffContext &ctx, const RegionFile &from,
+                       const RegionFile &to, const ChunkCoordinate &coord,
+                       uint16_t i) {
+  ChunkPayload a, b;
+  ctx.stats.read++;
+  if (!from.read_chunk(i, a) || !to.read_chunk(i, b))
+    return;
+  if ((a.compression == b.compression) && (a.data == b.data))
+    return;
+
+  ctx.stats.decoded++;
+  const auto chunk_a = Anvil::decode(Anvil::inflate(a), ctx.registry);
+  const auto chunk_b = Anvil::decode(Anvil::inflate(b), ctx.registry);
+  ChunkDiff diff{coord, DiffKind::CHANGED, {}};
+  if (WorldDiff::diff_chunks(*chunk_a, *chunk_b, diff))
+    ctx.emit(diff);
+}
+
+/**
+ * @brief Compare the headers of a region in both copies, queuing the
+ * candidate chunks.
+ */
+static void diff_region(DiffContext &ctx, const RegionCoordinate &coord,
+                        const std::string &path_from,
+                        const std::string &path_to) {
+  ctx.stats.regions++;
+  RegionFile::SharedPtr from, to;
+  if (!path_from.empty())
+    from = RegionFile::open(path_from);
+  if (!path_to.empty())
+    to = RegionFile::open(path_to);
+
+  for (uint16_t i = 0; i < REGION_CHUNK_COUNT; i++) {
+    const bool in_from = (from != nullptr) && from->has_chunk(i);
+    const bool in_to = (to != nullptr) && to->has_chunk(i);
+    const ChunkCoordinate chunk = RegionFile::chunk_coordinate(coord, i);
+    if (in_from != in_to) {
+      ctx.emit(ChunkDiff{chunk, in_to ? DiffKind::ADDED : DiffKind::REMOVED,
+                         {}});
+      continue;
+    }
+    if (!in_from)
+      continue;
+
+    ctx.stats.compared++;
+    if (ctx.options.trust_timestamps &&
+        (from->get_timestamp(i) == to->get_timestamp(i)) &&
+        (from->get_location(i).sectors == to->get_location(i).sectors))
+      continue;
+    ctx.pool.submit([&ctx, from, to, chunk, i] {
+      diff_chunk(ctx, *from, *to, chunk, i);
+    });
+  }
+}
+
+/**
+ * @brief List the region files of a directory.
+ */
+static void list_regions(
+    const std::string &dir, bool is_from,
+    std::map<std::pair<RegionCoordinate_t, RegionCoordinate_t>,
+             std::pair<std::string, std::string>> &out) {
+  if (!fs::is_directory(dir))
+    return;
+  for (const auto &entry : fs::directory_iterator(dir)) {
+    RegionCoordinate coord;
+    if (!entry.is_regular_file() ||
+        !RegionFile::parse_filename(entry.path().filename().string(), coord))
+      continue;
+    auto &paths = out[{coord.x, coord.z}];
+    (is_from ? paths.first : paths.second) = entry.path().string();
+  }
+}
+
+void WorldDiff::diff_directories(const std::string &from,
+                                 const std::string &to, const Sink &sink,
+                                 DiffStats &stats, const DiffOptions &options,
+                                 BlockRegistry &registry) {
+  std::map<std::pair<RegionCoordinate_t, RegionCoordinate_t>,
+           std::pair<std::string, std::string>>
+      regions;
+  list_regions(from, true, regions);
+  list_regions(to, false, regions);
+
+  ThreadPool pool(options.threads);
+  DiffContext ctx{sink, stats, options, registry, pool, {}};
+  for (const auto &[key, paths] : regions) {
+    const RegionCoordinate coord(key.first, key.second);
+    pool.submit([&ctx, coord, &paths = paths] {
+      diff_region(ctx, coord, paths.first, paths.second);
+    });
+  }
+  pool.wait();
+}
+
+} // namespace solis::world
@@ -1,8 +1,20 @@
 #include "solis/world/dimension.hpp"
+#include "solis/utils/common.hpp"
+#include "solis/utils/thread_pool.hpp"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
 
 namespace solis::world {
 
+/**
+ * @brief Current time, as recorded by Chunk::touch.
+ */
+static inline int64_t now_ticks() {
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
 // ============================================================================
 //    Constructor
 // ============================================================================
@@ -10,6 +22,12 @@ namespace solis::world {
 Dimension::Dimension(DimType_t type, const char *name)
     : name(name), world_type(type) {}
 
+Dimension::~Dimension() {
+  for (auto &region : regions)
+    for (auto &chunk : *region)
+      chunk->set_observer(nullptr);
+}
+
 // ============================================================================
 //    Region methods
 // ============================================================================
@@ -41,7 +59,7 @@ bool Dimension::is_region_loaded(const RegionCoordinate &coordinates) const {
 // ============================================================================
 
 Chunk::SharedPtr
-Dimension::get_chunk(const ChunkCoordinate &coordinates) const {
+Dimension::find_chunk(const ChunkCoordinate &coordinates) const {
   auto region = get_region(coordinates);
   if (region == nullptr)
     return nullptr;
@@ -55,27 +73,514 @@ Dimension::get_chunk(const ChunkCoordinate &coordinates) const {
   return nullptr;
 }
 
+Chunk::SharedPtr Dimension::get_chunk(const ChunkCoordinate &coordinates) {
+  if (auto chunk = find_chunk(coordinates); chunk != nullptr) {
+    chunk->touch(now_ticks());
+    return chunk;
+  }
+  return thaw(coordinates);
+}
+
+Chunk::SharedPtr
+Dimension::get_chunk(const ChunkCoordinate &coordinates) const {
+  if (auto chunk = find_chunk(coordinates); chunk != nullptr) {
+    chunk->touch(now_ticks());
+    return chunk;
+  }
+  if (auto it = cold.find(coordinates); it != cold.end())
+    return it->second->inflate();
+  return nullptr;
+}
+
 bool Dimension::is_chunk_loaded(const ChunkCoordinate &coordinates) const {
+  return (cold.count(coordinates) > 0) || (find_chunk(coordinates) != nullptr);
+}
+
+// ============================================================================
+//    Data loading into the dimension
+// ============================================================================
+
+void Dimension::add_chunk(const Chunk::SharedPtr chunk) {
+  if (is_chunk_loaded<ChunkCoordinate>(chunk))
+    return;
+
+  auto region = get_region(chunk->coord);
+  if (region == nullptr) {
+    region = std::make_shared<Region>();
+    region->coord = cvtCoordinate<RegionCoordinate>(chunk->coord);
+    regions.push_back(region);
+  }
+  region->push_back(chunk);
+  chunk->set_observer(this);
+  chunk->touch(now_ticks());
+  if (block_index != nullptr)
+    block_index->add_chunk(*chunk);
+  if (chunk->is_dirty())
+    on_chunk_dirty(*chunk);
+}
+
+// ============================================================================
+//    Cold chunks
+// ============================================================================
+
+size_t Dimension::compress_idle(const ColdOptions &options) {
+  const int64_t limit =
+      now_ticks() -
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          options.idle)
+          .count();
+  size_t compressed = 0;
+  for (auto &region : regions) {
+    auto idle = [this, limit, &options](Chunk::SharedPtr &chunk) {
+      if (!is_sole_owner(chunk) || chunk->is_dirty() ||
+          (chunk->get_last_access() > limit))
+        return false;
+      cold[chunk->coord] = ColdChunk::compress(*chunk, options.level);
+      chunk->set_observer(nullptr);
+      return true;
+    };
+    const auto it = std::remove_if(region->begin(), region->end(), idle);
+    compressed += std::distance(it, region->end());
+    region->erase(it, region->end());
+  }
+  return compressed;
+}
+
+size_t Dimension::cold_memory() const {
+  size_t total = 0;
+  for (const auto &[coord, chunk] : cold)
+    total += chunk->memory_usage();
+  return total;
+}
+
+Chunk::SharedPtr Dimension::thaw(const ChunkCoordinate &coordinates) {
+  auto it = cold.find(coordinates);
+  if (it == cold.end())
+    return nullptr;
   auto region = get_region(coordinates);
   if (region == nullptr)
+    return nullptr;
+
+  auto chunk = it->second->inflate();
+  cold.erase(it);
+  chunk->set_observer(this);
+  chunk->touch(now_ticks());
+  region->push_back(chunk);
+  return chunk;
+}
+
+// ============================================================================
+//    Block methods
+// ============================================================================
+
+const Block *Dimension::get_block(const BlockCoordinate &coordinates) const {
+  auto chunk = get_chunk(coordinates);
+  if (chunk == nullptr)
+    return nullptr;
+  return chunk->get_block(
+      floor_mod<BlockCoordinate_t>(coordinates.x, CHUNK_SIZE), coordinates.y,
+      floor_mod<BlockCoordinate_t>(coordinates.z, CHUNK_SIZE));
+}
+
+bool Dimension::set_block(const BlockCoordinate &coordinates,
+                          const Block *block) {
+  auto chunk = get_chunk(coordinates);
+  if (chunk == nullptr)
     return false;
-  if (auto it = std::find_if(region->begin(), region->end(),
-                             [&coordinates](const Chunk::SharedPtr c) {
-                               return (c->coord.x == coordinates.x) &&
-                                      (c->coord.z == coordinates.z);
-                             });
-      it != region->end())
-    return true;
-  return false;
+  return chunk->set_block(
+      floor_mod<BlockCoordinate_t>(coordinates.x, CHUNK_SIZE), coordinates.y,
+      floor_mod<BlockCoordinate_t>(coordinates.z, CHUNK_SIZE), block);
 }
 
 // ============================================================================
-//    Data loading into the dimension
+//    Bulk methods
 // ============================================================================
 
-void Dimension::add_chunk(const Chunk::SharedPtr chunk) {
-  if (!is_chunk_loaded<ChunkCoordinate>(chunk))
+/**
+ * @brief Box with its bounds in order.
+ */
+static BlockBox normalized(const BlockBox &box) {
+  return BlockBox{BlockCoordinate(std::min(box.min.x, box.max.x),
+                                  std::min(box.min.y, box.max.y),
+                                  std::min(box.min.z, box.max.z)),
+                  BlockCoordinate(std::max(box.min.x, box.max.x),
+                                  std::max(box.min.y, box.max.y),
+                                  std::max(box.min.z, box.max.z))};
+}
+
+/**
+ * @brief Y-indices of the sections intersecting a box, as [first, last].
+ */
+static std::pair<int, int> section_range(const BlockBox &box) {
+  constexpr BlockCoordinate_t LOW{std::numeric_limits<SectionIndex>::min()};
+  constexpr BlockCoordinate_t HIGH{std::numeric_limits<SectionIndex>::max()};
+  return {static_cast<int>(std::clamp(
+              floor_div<BlockCoordinate_t>(box.min.y, CHUNK_SIZE), LOW, HIGH)),
+          static_cast<int>(std::clamp(
+              floor_div<BlockCoordinate_t>(box.max.y, CHUNK_SIZE), LOW, HIGH))};
+}
+
+/**
+ * @brief Part of a box inside of a section.
+ * @return false if they do not intersect
+ */
+static bool clip(const BlockBox &box, const ChunkCoordinate &chunk,
+                 SectionIndex y, SectionBox &out) {
+  auto axis = [](BlockCoordinate_t lo, BlockCoordinate_t hi,
+                 BlockCoordinate_t base, InChunkCoord_t &a, InChunkCoord_t &b) {
+    lo = std::max(lo, base) - base;
+    hi = std::min<BlockCoordinate_t>(hi, base + CHUNK_SIZE - 1) - base;
+    a = static_cast<InChunkCoord_t>(lo);
+    b = static_cast<InChunkCoord_t>(hi);
+    return lo <= hi;
+  };
+  return axis(box.min.x, box.max.x, chunk.x * CHUNK_SIZE, out.x0, out.x1) &&
+         axis(box.min.y, box.max.y, y * CHUNK_SIZE, out.y0, out.y1) &&
+         axis(box.min.z, box.max.z, chunk.z * CHUNK_SIZE, out.z0, out.z1);
+}
+
+std::vector<Chunk::SharedPtr> Dimension::chunks_in(const BlockBox &box) {
+  const ChunkCoordinate lo = cvtCoordinate<ChunkCoordinate>(box.min);
+  const ChunkCoordinate hi = cvtCoordinate<ChunkCoordinate>(box.max);
+  auto inside = [&lo, &hi](const ChunkCoordinate &c) {
+    return (c.x >= lo.x) && (c.x <= hi.x) && (c.z >= lo.z) && (c.z <= hi.z);
+  };
+
+  std::vector<ChunkCoordinate> frozen;
+  for (const auto &[coord, chunk] : cold)
+    if (inside(coord))
+      frozen.push_back(coord);
+  for (const ChunkCoordinate &coord : frozen)
+    thaw(coord);
+
+  std::vector<Chunk::SharedPtr> out;
+  for (const auto &region : regions)
+    for (const auto &chunk : *region)
+      if (inside(chunk->coord))
+        out.push_back(chunk);
+  return out;
+}
+
+size_t Dimension::fill(const BlockBox &box, const Block *block,
+                       const BulkOptions &options) {
+  const BlockBox b = normalized(box);
+  const auto [first, last] = section_range(b);
+  const auto chunks = chunks_in(b);
+
+  std::atomic<size_t> modified{0};
+  ThreadPool pool(options.threads);
+  pool.parallel_for(chunks.size(), [&](size_t c) {
+    Chunk &chunk = *chunks[c];
+    for (int y = first; y <= last; y++) {
+      SectionBox sb;
+      if (!clip(b, chunk.coord, y, sb))
+        continue;
+      const auto section = chunk.get_section(y);
+      if ((section == nullptr) ? (block == nullptr)
+                               : (section->is_uniform() &&
+                                  (section->get_block(0) == block)))
+        continue;
+      if (sb.is_full())
+        chunk.set_section(y, Section::make(block));
+      else
+        chunk.edit_section(y)->fill(block, sb);
+      modified++;
+    }
+  });
+  return modified;
+}
+
+size_t Dimension::replace(const BlockBox &box, const Block *from,
+                          const Block *to, const BulkOptions &options) {
+  if (from == to)
+    return 0;
+  const BlockBox b = normalized(box);
+  const auto [first, last] = section_range(b);
+  const auto chunks = chunks_in(b);
+
+  std::atomic<size_t> modified{0};
+  ThreadPool pool(options.threads);
+  pool.parallel_for(chunks.size(), [&](size_t c) {
+    Chunk &chunk = *chunks[c];
+    for (int y = first; y <= last; y++) {
+      SectionBox sb;
+      if (!clip(b, chunk.coord, y, sb))
+        continue;
+      // Absent sections hold air only
+      const auto section = chunk.get_section(y);
+      if ((section == nullptr) && (from != nullptr))
+        continue;
+      if (section == nullptr) {
+        if (sb.is_full())
+          chunk.set_section(y, Section::make(to));
+        else
+          chunk.edit_section(y)->replace(from, to, sb);
+      } else {
+        const auto &palette = section->get_palette();
+        if (std::find(palette.begin(), palette.end(), from) == palette.end())
+          continue;
+        chunk.edit_section(y)->replace(from, to, sb);
+      }
+      modified++;
+    }
+  });
+  return modified;
+}
+
+size_t Dimension::copy(const BlockBox &box, const BlockCoordinate &destination,
+                       const BulkOptions &options) {
+  const BlockBox src = normalized(box);
+  const BlockCoordinate offset(destination.x - src.min.x,
+                               destination.y - src.min.y,
+                               destination.z - src.min.z);
+  const BlockBox dst{destination,
+                     BlockCoordinate(src.max.x + offset.x,
+                                     src.max.y + offset.y,
+                                     src.max.z + offset.z)};
+  const bool aligned = (floor_mod<BlockCoordinate_t>(offset.x, CHUNK_SIZE) ==
+                        0) &&
+                       (floor_mod<BlockCoordinate_t>(offset.y, CHUNK_SIZE) ==
+                        0) &&
+                       (floor_mod<BlockCoordinate_t>(offset.z, CHUNK_SIZE) ==
+                        0);
+
+  // Snapshots of the sources, so that overlapping boxes read the old blocks
+  std::unordered_map<ChunkCoordinate, Chunk::SharedPtr, ChunkCoordinateHash,
+                     ChunkCoordinateEqual>
+      sources;
+  for (const auto &chunk : chunks_in(src))
+    sources.emplace(chunk->coord, chunk->snapshot());
+  auto source = [&sources](const ChunkCoordinate &coord) -> const Chunk * {
+    auto it = sources.find(coord);
+    return (it == sources.end()) ? nullptr : it->second.get();
+  };
+
+  const auto [first, last] = section_range(dst);
+  const auto chunks = chunks_in(dst);
+  std::atomic<size_t> modified{0};
+  ThreadPool pool(options.threads);
+  pool.parallel_for(chunks.size(), [&](size_t c) {
+    Chunk &chunk = *chunks[c];
+    for (int y = first; y <= last; y++) {
+      SectionBox sb;
+      if (!clip(dst, chunk.coord, y, sb))
+        continue;
+
+      // Whole sections are shared, when the offset keeps them aligned
+      if (aligned && sb.is_full()) {
+        const Chunk *from = source(ChunkCoordinate(
+            chunk.coord.x - offset.x / CHUNK_SIZE,
+            chunk.coord.z - offset.z / CHUNK_SIZE));
+        if (from == nullptr)
+          continue;
+        auto section = from->get_section(y - offset.y / CHUNK_SIZE);
+        if (section == chunk.get_section(y))
+          continue;
+        chunk.set_section(y, section);
+        modified++;
+        continue;
+      }
+
+      Section::SharedPtr target;
+      const Chunk *from = nullptr;
+      for (InChunkCoord_t ly = sb.y0; ly <= sb.y1; ly++)
+        for (InChunkCoord_t lz = sb.z0; lz <= sb.z1; lz++)
+          for (InChunkCoord_t lx = sb.x0; lx <= sb.x1; lx++) {
+            const BlockCoordinate at(chunk.coord.x * CHUNK_SIZE + lx - offset.x,
+                                     y * CHUNK_SIZE + ly - offset.y,
+                                     chunk.coord.z * CHUNK_SIZE + lz -
+                                         offset.z);
+            const ChunkCoordinate cc = cvtCoordinate<ChunkCoordinate>(at);
+            if ((from == nullptr) || (from->coord.x != cc.x) ||
+                (from->coord.z != cc.z))
+              from = source(cc);
+            if (from == nullptr)
+              continue;
+            const Block *block = from->get_block(
+                floor_mod<BlockCoordinate_t>(at.x, CHUNK_SIZE), at.y,
+                floor_mod<BlockCoordinate_t>(at.z, CHUNK_SIZE));
+            const uint16_t i = Section::index(lx, ly, lz);
+            if (target == nullptr) {
+              const auto current = chunk.get_section(y);
+              if (((current == nullptr) ? nullptr : current->get_block(i)) ==
+                  block)
+                continue;
+              target = chunk.edit_section(y);
+            }
+            target->set_block(i, block);
+          }
+      if (target != nullptr)
+        modified++;
+    }
+  });
+  return modified;
+}
+
+// ============================================================================
+//    Block index
+// ============================================================================
+
+void Dimension::set_block_index(BlockIndex::SharedPtr index) {
+  {
+    std::lock_guard<std::mutex> lock(dirty_mutex);
+    unindexed.clear();
+  }
+  block_index = std::move(index);
+  if (block_index == nullptr)
     return;
+  for (const auto &region : regions)
+    for (const auto &chunk : *region)
+      block_index->add_chunk(*chunk);
+  for (const auto &[coord, chunk] : cold)
+    if (!block_index->has_chunk(coord))
+      block_index->add_chunk(*chunk->inflate());
+}
+
+const BlockIndex::SharedPtr &Dimension::get_block_index() {
+  if (block_index == nullptr)
+    return block_index;
+  std::lock_guard<std::mutex> lock(dirty_mutex);
+
+  // Dirty chunks stay listed, as they are only notified of their first edit,
+  // but are indexed again only if edited since
+  for (auto it = unindexed.begin(); it != unindexed.end();) {
+    auto chunk = find_chunk(it->first);
+    if (chunk == nullptr) {
+      // Saved and compressed since its last edit
+      if (auto c = cold.find(it->first); c != cold.end())
+        block_index->add_chunk(*c->second->inflate());
+      it = unindexed.erase(it);
+      continue;
+    }
+    if (chunk->get_revision() != it->second) {
+      block_index->add_chunk(*chunk);
+      it->second = chunk->get_revision();
+    }
+    it = chunk->is_dirty() ? std::next(it) : unindexed.erase(it);
+  }
+  return block_index;
+}
+
+std::vector<BlockCoordinate> Dimension::find_blocks(const Block *block) {
+  std::vector<BlockCoordinate> out;
+  if (block == nullptr)
+    return out;
+  auto scan = [&out, block](const Chunk &chunk, SectionIndex y,
+                            const Section &section) {
+    Section::BlockMask mask;
+    if (section.match(mask, block) == 0)
+      return;
+    for (uint16_t w = 0; w < mask.size(); w++)
+      for (uint64_t bits = mask[w]; bits != 0; bits &= bits - 1) {
+        const uint16_t i = w * 64 + __builtin_ctzll(bits);
+        out.emplace_back(chunk.coord.x * CHUNK_SIZE + i % CHUNK_SIZE,
+                         y * CHUNK_SIZE + i / (CHUNK_SIZE * CHUNK_SIZE),
+                         chunk.coord.z * CHUNK_SIZE +
+                             (i / CHUNK_SIZE) % CHUNK_SIZE);
+      }
+  };
+
+  if (get_block_index() == nullptr) {
+    auto scan_chunk = [&scan](const Chunk &chunk) {
+      for (const auto &[y, section] : chunk)
+        if (section != nullptr)
+          scan(chunk, y, *section);
+    };
+    for (const auto &region : regions)
+      for (const auto &chunk : *region)
+        scan_chunk(*chunk);
+    for (const auto &[coord, chunk] : cold)
+      scan_chunk(*chunk->inflate());
+    return out;
+  }
+  for (const SectionKey &key : block_index->find(block)) {
+    if (!is_chunk_loaded(key.coord))
+      continue;
+    auto chunk = get_chunk(key.coord);
+    if (auto section = chunk->get_section(key.y); section != nullptr)
+      scan(*chunk, key.y, *section);
+  }
+  return out;
+}
+
+// ============================================================================
+//    Journal
+// ============================================================================
+
+void Dimension::on_block_changed(Chunk &chunk, InChunkCoord_t x, LayerIndex y,
+                                 InChunkCoord_t z, const Block *old,
+                                 const Block *block) {
+  if (journal != nullptr)
+    journal->record_block(
+        chunk.coord, Chunk::section_of(y),
+        Section::index(x, floor_mod<LayerIndex>(y, CHUNK_SIZE), z), old,
+        block);
+}
+
+void Dimension::on_section_changed(Chunk &chunk, SectionIndex y) {
+  if (journal != nullptr)
+    journal->record_section(chunk.coord, y);
+}
+
+// ============================================================================
+//    Dirty tracking
+// ============================================================================
+
+std::vector<DirtyRegion> Dimension::collect_dirty() {
+  decltype(dirty) collected;
+  {
+    std::lock_guard<std::mutex> lock(dirty_mutex);
+    collected.swap(dirty);
+  }
+
+  std::vector<DirtyRegion> out;
+  out.reserve(collected.size());
+  for (const auto &[rcoord, chunks] : collected) {
+    DirtyRegion region{rcoord, {}};
+    region.chunks.reserve(chunks.size());
+    for (const auto &ccoord : chunks) {
+      auto chunk = get_chunk(ccoord);
+      if ((chunk == nullptr) || !chunk->is_dirty())
+        continue;
+      region.chunks.push_back(
+          DirtyChunk{chunk->snapshot(), chunk->get_dirty_sections()});
+      chunk->clear_dirty();
+    }
+    if (!region.chunks.empty())
+      out.push_back(std::move(region));
+  }
+  return out;
+}
+
+void Dimension::restore_dirty(const DirtyRegion &region) {
+  for (const auto &d : region.chunks)
+    if (auto chunk = get_chunk(d.chunk->coord); chunk != nullptr)
+      chunk->mark_dirty(d.sections);
+}
+
+Dimension::SharedPtr Dimension::snapshot() const {
+  auto snap = std::make_shared<Dimension>(world_type, name);
+  snap->regions.reserve(regions.size());
+  for (const auto &region : regions)
+    snap->regions.push_back(region->snapshot());
+  snap->cold = cold;
+  return snap;
+}
+
+size_t Dimension::dirty_count() const {
+  std::lock_guard<std::mutex> lock(dirty_mutex);
+  size_t n = 0;
+  for (const auto &[rcoord, chunks] : dirty)
+    n += chunks.size();
+  return n;
+}
+
+void Dimension::on_chunk_dirty(Chunk &chunk) {
+  std::lock_guard<std::mutex> lock(dirty_mutex);
+  dirty[cvtCoordinate<RegionCoordinate>(chunk.coord)].insert(chunk.coord);
+  // Revision 0 is never indexed: the chunk is edited
+  if (block_index != nullptr)
+    unindexed.try_emplace(chunk.coord, 0);
 }
 
 } // namespace solis::world
\ No newline at end of file
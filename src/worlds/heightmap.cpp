@@ -0,0 +1,24 @@
+#include "solis/world/heightmap.hpp"
+
+namespace solis::world {
+
+uint8_t Heightmaps::classify(const Block *block) {
+  const FlagL_t flags = Block::flags_of(block);
+  if (has_flag(flags, Block::AIR))
+    return 0;
+
+  uint8_t mask = 1 << HeightmapType::WORLD_SURFACE;
+  if ((flags & (Block::SOLID | Block::LIQUID)) != 0)
+    mask |= 1 << HeightmapType::MOTION_BLOCKING;
+  if (has_flag(flags, Block::SOLID))
+    mask |= 1 << HeightmapType::OCEAN_FLOOR;
+  return mask;
+}
+
+void Heightmaps::clear(LayerIndex bottom) {
+  min_y = bottom;
+  for (auto &h : heights)
+    h.fill(bottom);
+}
+
+} // namespace solis::world
@@ -0,0 +1,177 @@
+#include "solis/world/journal.hpp"
+#include <thread>
+
+namespace solis::world {
+
+/// Words of a slot: coordinates of the chunk, packed kind, section Y-index and
+/// block index, then the previous and new blocks
+constexpr uint8_t WORD_X{0}, WORD_Z{1}, WORD_INFO{2}, WORD_OLD{3},
+    WORD_BLOCK{4};
+
+// ============================================================================
+//    Constructor
+// ============================================================================
+
+ChangeJournal::ChangeJournal(size_t capacity) {
+  size_t size = 1;
+  while (size < capacity)
+    size <<= 1;
+  mask = size - 1;
+  slots = std::make_unique<Slot[]>(size);
+}
+
+// ============================================================================
+//    Record methods
+// ============================================================================
+
+uint64_t ChangeJournal::record(const uint64_t (&words)[5]) {
+  const uint64_t seq = next.fetch_add(1, std::memory_order_relaxed);
+  Slot &slot = slots[seq & mask];
+
+  // Lock the slot, unless a writer lapping this one already took it
+  const uint64_t writing = 2 * seq + 1;
+  uint64_t stamp = slot.stamp.load(std::memory_order_relaxed);
+  do {
+    if (stamp >= writing)
+      return seq;
+    if (stamp & 1) {
+      std::this_thread::yield();
+      stamp = slot.stamp.load(std::memory_order_relaxed);
+      continue;
+    }
+  } while (!slot.stamp.compare_exchange_weak(stamp, writing,
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed));
+  std::atomic_thread_fence(std::memory_order_release);
+
+  for (uint8_t w = 0; w < 5; w++)
+    slot.words[w].store(words[w], std::memory_order_relaxed);
+  slot.stamp.store(writing + 1, std::memory_order_release);
+  return seq;
+}
+
+uint64_t ChangeJournal::record_block(const ChunkCoordinate &coord,
+                                     SectionIndex y, uint16_t index,
+                                     const Block *old, const Block *block) {
+  const uint64_t info = ChangeEvent::BLOCK |
+                        (static_cast<uint64_t>(static_cast<uint8_t>(y)) << 8) |
+                        (static_cast<uint64_t>(index) << 16);
+  const uint64_t words[5]{static_cast<uint64_t>(coord.x),
+                          static_cast<uint64_t>(coord.z), info,
+                          reinterpret_cast<uintptr_t>(old),
+                          reinterpret_cast<uintptr_t>(block)};
+  return record(words);
+}
+
+uint64_t ChangeJournal::record_section(const ChunkCoordinate &coord,
+                                       SectionIndex y) {
+  const uint64_t info = ChangeEvent::SECTION |
+                        (static_cast<uint64_t>(static_cast<uint8_t>(y)) << 8);
+  const uint64_t words[5]{static_cast<uint64_t>(coord.x),
+                          static_cast<uint64_t>(coord.z), info, 0, 0};
+  return record(words);
+}
+
+// ============================================================================
+//    Read methods
+// ============================================================================
+
+ChangeJournal::ReadStatus ChangeJournal::read(uint64_t sequence,
+                                              ChangeEvent &out) const {
+  const Slot &slot = slots[sequence & mask];
+  const uint64_t published = 2 * sequence + 2;
+  const uint64_t before = slot.stamp.load(std::memory_order_acquire);
+  if (before < published)
+    return PENDING;
+  if (before > published)
+    return OVERWRITTEN;
+
+  uint64_t words[5];
+  for (uint8_t w = 0; w < 5; w++)
+    words[w] = slot.words[w].load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (slot.stamp.load(std::memory_order_relaxed) != before)
+    return OVERWRITTEN;
+
+  out.sequence = sequence;
+  out.coord = ChunkCoordinate(static_cast<ChunkCoordinate_t>(words[WORD_X]),
+                              static_cast<ChunkCoordinate_t>(words[WORD_Z]));
+  out.kind = static_cast<ChangeEvent::Kind>(words[WORD_INFO] & 0xFF);
+  out.y = static_cast<SectionIndex>(
+      static_cast<uint8_t>((words[WORD_INFO] >> 8) & 0xFF));
+  out.index = static_cast<uint16_t>(words[WORD_INFO] >> 16);
+  out.old = reinterpret_cast<const Block *>(
+      static_cast<uintptr_t>(words[WORD_OLD]));
+  out.block = reinterpret_cast<const Block *>(
+      static_cast<uintptr_t>(words[WORD_BLOCK]));
+  return READ;
+}
+
+ChangeSubscription ChangeJournal::subscribe() const {
+  return ChangeSubscription(this, head());
+}
+
+// ============================================================================
+//    Subscriptions
+// ============================================================================
+
+size_t ChangeSubscription::poll(const Sink &sink, size_t max) {
+  size_t n = 0;
+  ChangeEvent event;
+  while (n < max) {
+    const uint64_t head = journal->head();
+    if (cursor >= head)
+      break;
+
+    // Skip at once the events which can no longer be in the ring
+    if (head - cursor > journal->capacity()) {
+      lost += head - journal->capacity() - cursor;
+      cursor = head - journal->capacity();
+    }
+
+    const auto status = journal->read(cursor, event);
+    if (status == ChangeJournal::PENDING)
+      break;
+    cursor++;
+    if (status == ChangeJournal::OVERWRITTEN) {
+      lost++;
+      continue;
+    }
+    sink(event);
+    n++;
+  }
+  return n;
+}
+
+size_t ChangeSubscription::poll_sections(const SectionSink &sink, size_t max) {
+  SectionChange change;
+  auto flush = [&change, &sink]() {
+    if (change.events != 0)
+      sink(change);
+    change = SectionChange();
+  };
+
+  const size_t n = poll(
+      [&change, &flush](const ChangeEvent &e) {
+        if ((change.events != 0) &&
+            ((e.coord.x != change.coord.x) || (e.coord.z != change.coord.z) ||
+             (e.y != change.y)))
+          flush();
+        if (change.events == 0) {
+          change.coord = e.coord;
+          change.y = e.y;
+          change.first = e.sequence;
+        }
+        change.last = e.sequence;
+        change.events++;
+        if (e.kind == ChangeEvent::SECTION)
+          change.whole = true;
+        else
+          change.blocks[e.index / 64] |= uint64_t{1} << (e.index % 64);
+      },
+      max);
+  flush();
+  return n;
+}
+
+} // namespace solis::world
@@ -0,0 +1,70 @@
+#include "solis/world/light.hpp"
+#include <algorithm>
+
+namespace solis::world {
+
+// ============================================================================
+//    Light array
+// ============================================================================
+
+LightArray LightArray::pack(const uint8_t *levels) {
+  if (std::all_of(levels, levels + SECTION_VOLUME,
+                  [levels](uint8_t l) { return l == levels[0]; }))
+    return LightArray(levels[0]);
+
+  LightArray out;
+  out.data.resize(BYTES);
+  for (uint16_t b = 0; b < BYTES; b++)
+    out.data[b] = (levels[2 * b] & 0xF) | ((levels[2 * b + 1] & 0xF) << 4);
+  return out;
+}
+
+void LightArray::unpack(uint8_t *levels) const {
+  if (data.empty()) {
+    std::fill(levels, levels + SECTION_VOLUME, uniform);
+    return;
+  }
+  for (uint16_t b = 0; b < BYTES; b++) {
+    levels[2 * b] = data[b] & 0xF;
+    levels[2 * b + 1] = data[b] >> 4;
+  }
+}
+
+void LightArray::set(uint16_t i, uint8_t level) {
+  if (data.empty()) {
+    if (level == uniform)
+      return;
+    data.assign(BYTES, static_cast<uint8_t>(uniform | (uniform << 4)));
+  }
+  const uint8_t shift = (i & 1) << 2;
+  data[i >> 1] = (data[i >> 1] & ~(0xF << shift)) | ((level & 0xF) << shift);
+}
+
+bool LightArray::operator==(const LightArray &other) const {
+  if (data.empty() && other.data.empty())
+    return uniform == other.uniform;
+  if (!data.empty() && !other.data.empty())
+    return data == other.data;
+  for (uint16_t i = 0; i < SECTION_VOLUME; i++)
+    if (get(i) != other.get(i))
+      return false;
+  return true;
+}
+
+// ============================================================================
+//    Chunk light
+// ============================================================================
+
+uint8_t ChunkLight::get_sky(SectionIndex y, uint16_t i) const {
+  if (auto it = find(y); it != end())
+    return it->second.sky.get(i);
+  return (empty() || (y > rbegin()->first)) ? MAX_LIGHT : 0;
+}
+
+uint8_t ChunkLight::get_block(SectionIndex y, uint16_t i) const {
+  if (auto it = find(y); it != end())
+    return it->second.block.get(i);
+  return 0;
+}
+
+} // namespace solis::world
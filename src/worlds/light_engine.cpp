@@ -0,0 +1,473 @@
+#include "solis/world/light_engine.hpp"
+#include "solis/utils/thread_pool.hpp"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+
+namespace solis::world {
+
+// ============================================================================
+//    Light model
+// ============================================================================
+
+/// Light emitted by the vanilla light sources
+constexpr std::pair<std::string_view, uint8_t> VANILLA_EMISSION[]{
+    {"beacon", 15},           {"campfire", 15},
+    {"conduit", 15},          {"end_gateway", 15},
+    {"end_portal", 15},       {"fire", 15},
+    {"glowstone", 15},        {"jack_o_lantern", 15},
+    {"lantern", 15},          {"lava", 15},
+    {"ochre_froglight", 15},  {"pearlescent_froglight", 15},
+    {"redstone_lamp", 15},    {"sea_lantern", 15},
+    {"shroomlight", 15},      {"verdant_froglight", 15},
+    {"end_rod", 14},          {"torch", 14},
+    {"wall_torch", 14},       {"nether_portal", 11},
+    {"crying_obsidian", 10},  {"soul_campfire", 10},
+    {"soul_fire", 10},        {"soul_lantern", 10},
+    {"soul_torch", 10},       {"soul_wall_torch", 10},
+    {"glow_lichen", 7},       {"redstone_torch", 7},
+    {"redstone_wall_torch", 7}, {"amethyst_cluster", 5},
+    {"magma_block", 3},       {"brewing_stand", 1}};
+
+LightInfo LightModel::get(const Block *block) const {
+  if (block == nullptr)
+    return LightInfo{0, 0};
+
+  const std::string_view name = block->resource_name;
+  LightInfo info;
+  for (const auto &[source, level] : VANILLA_EMISSION)
+    if (name == source)
+      info.emission = level;
+  if (block->has_property("lit=false"))
+    info.emission = 0;
+
+  if (has_flag(block->flags, Block::TRANSPARENT))
+    info.opacity = 0;
+  else if (has_flag(block->flags, Block::DIFFUSING))
+    info.opacity = 1;
+  return info;
+}
+
+const LightModel &LightModel::vanilla() {
+  static const LightModel model;
+  return model;
+}
+
+LightInfo LightEngine::get_info(const Block *block) {
+  {
+    std::shared_lock<std::shared_mutex> lock(cache_mutex);
+    if (auto it = cache.find(block); it != cache.end())
+      return it->second;
+  }
+  const LightInfo info = model.get(block);
+  std::unique_lock<std::shared_mutex> lock(cache_mutex);
+  cache.emplace(block, info);
+  return info;
+}
+
+// ============================================================================
+//    Propagation
+// ============================================================================
+
+namespace {
+
+constexpr uint16_t LAYER{CHUNK_SIZE * CHUNK_SIZE};
+
+/**
+ * @brief Horizontal neighbours of a chunk, in the order -X, +X, -Z, +Z.
+ */
+enum Side : uint8_t { WEST = 0, EAST = 1, NORTH = 2, SOUTH = 3 };
+
+/**
+ * @brief Dense light of a chunk during its relight, one byte per block over
+ * the sections of the relight range.
+ */
+struct Workspace {
+  std::vector<uint8_t> opacity, sky, block;
+  std::vector<uint32_t> sky_queue, block_queue;
+
+  inline void resize(size_t volume) {
+    opacity.resize(volume);
+    sky.resize(volume);
+    block.resize(volume);
+  }
+};
+
+/**
+ * @brief Shared state of a relight.
+ */
+struct LightJob {
+  LightEngine &engine;
+  SectionIndex lo{0}, hi{-1}; /// Sections of the relight range
+  std::vector<Chunk *> chunks;
+  std::vector<std::array<int64_t, 4>> in_set; /// Neighbours in the set
+  std::vector<std::array<ChunkLight::SharedPtr, 4>> fixed; /// Other ones
+  std::vector<ChunkLight::SharedPtr> previous, current;
+
+  inline uint16_t sections() const { return hi - lo + 1; }
+  inline size_t volume() const {
+    return static_cast<size_t>(sections()) * SECTION_VOLUME;
+  }
+};
+
+/**
+ * @brief Breadth-first propagation of the queued light levels.
+ */
+static void propagate(uint8_t *light, const uint8_t *opacity,
+                      std::vector<uint32_t> &queue, size_t volume) {
+  auto visit = [&](uint32_t n, uint8_t level) {
+    const uint8_t op = opacity[n];
+    if (op >= MAX_LIGHT)
+      return;
+    const uint8_t cost = std::max<uint8_t>(1, op);
+    if ((level > cost) && (level - cost > light[n])) {
+      light[n] = level - cost;
+      queue.push_back(n);
+    }
+  };
+
+  for (size_t q = 0; q < queue.size(); q++) {
+    const uint32_t p = queue[q];
+    const uint8_t level = light[p];
+    if (level <= 1)
+      continue;
+    const uint8_t x = p & 0xF, z = (p >> 4) & 0xF;
+    if (x > 0)
+      visit(p - 1, level);
+    if (x < CHUNK_SIZE - 1)
+      visit(p + 1, level);
+    if (z > 0)
+      visit(p - CHUNK_SIZE, level);
+    if (z < CHUNK_SIZE - 1)
+      visit(p + CHUNK_SIZE, level);
+    if (p >= LAYER)
+      visit(p - LAYER, level);
+    if (p + LAYER < volume)
+      visit(p + LAYER, level);
+  }
+  queue.clear();
+}
+
+/**
+ * @brief Fill the opacity of the blocks of a chunk, and optionally queue its
+ * light sources.
+ */
+static void load_blocks(LightJob &job, const Chunk &chunk, Workspace &ws,
+                        bool sources) {
+  std::vector<LightInfo> infos;
+  for (uint16_t k = 0; k < job.sections(); k++) {
+    uint8_t *opacity = ws.opacity.data() + k * SECTION_VOLUME;
+    const auto it = chunk.find(job.lo + k);
+    if ((it == chunk.end()) || (it->second == nullptr) ||
+        it->second->is_empty()) {
+      std::memset(opacity, 0, SECTION_VOLUME);
+      continue;
+    }
+
+    // Resolve the palette once, then map the indices
+    const Section &section = *it->second;
+    infos.clear();
+    bool emits = false;
+    for (const Block *block : section.get_palette()) {
+      infos.push_back(job.engine.get_info(block));
+      emits |= infos.back().emission > 0;
+    }
+    if (section.is_uniform())
+      std::memset(opacity, infos[0].opacity, SECTION_VOLUME);
+    else {
+      const PaletteIndex_t *indices = section.get_indices().data();
+      for (uint16_t i = 0; i < SECTION_VOLUME; i++)
+        opacity[i] = infos[indices[i]].opacity;
+    }
+
+    if (!sources || !emits)
+      continue;
+    for (uint16_t i = 0; i < SECTION_VOLUME; i++) {
+      const uint8_t emission =
+          infos[section.is_uniform() ? 0 : section.get_indices()[i]].emission;
+      const uint32_t p = k * SECTION_VOLUME + i;
+      if (emission > ws.block[p]) {
+        ws.block[p] = emission;
+        ws.block_queue.push_back(p);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Light a chunk on its own: sky columns and light sources.
+ */
+static void light_alone(LightJob &job, size_t c, Workspace &ws) {
+  const size_t volume = job.volume();
+  ws.resize(volume);
+  std::fill(ws.block.begin(), ws.block.end(), 0);
+  load_blocks(job, *job.chunks[c], ws, true);
+
+  // Sky light going straight down from the top of the range
+  const uint8_t *opacity = ws.opacity.data();
+  uint8_t *sky = ws.sky.data();
+  for (uint16_t col = 0; col < LAYER; col++) {
+    uint8_t level = MAX_LIGHT;
+    for (size_t p = volume - LAYER + col; p < volume; p -= LAYER) {
+      level = (opacity[p] >= level) ? 0 : level - opacity[p];
+      sky[p] = level;
+      if (p < LAYER)
+        break;
+    }
+  }
+
+  // Spread it sideways and below the overhangs
+  for (uint32_t p = 0; p < volume; p++) {
+    const uint8_t level = sky[p];
+    if (level <= 1)
+      continue;
+    const uint8_t x = p & 0xF, z = (p >> 4) & 0xF;
+    auto darker = [&](uint32_t n) {
+      return (opacity[n] < MAX_LIGHT) &&
+             (sky[n] + std::max<uint8_t>(1, opacity[n]) < level);
+    };
+    if (((x > 0) && darker(p - 1)) || ((x < CHUNK_SIZE - 1) && darker(p + 1)) ||
+        ((z > 0) && darker(p - CHUNK_SIZE)) ||
+        ((z < CHUNK_SIZE - 1) && darker(p + CHUNK_SIZE)) ||
+        ((p >= LAYER) && darker(p - LAYER)))
+      ws.sky_queue.push_back(p);
+  }
+
+  propagate(ws.sky.data(), opacity, ws.sky_queue, volume);
+  propagate(ws.block.data(), opacity, ws.block_queue, volume);
+}
+
+/**
+ * @brief Queue the light entering a chunk from one of its neighbours.
+ */
+static void pull_side(LightJob &job, const ChunkLight &neighbour, Side side,
+                      Workspace &ws) {
+  for (uint16_t k = 0; k < job.sections(); k++) {
+    const SectionIndex y = job.lo + k;
+    const auto it = neighbour.find(y);
+    const SectionLight *light = (it == neighbour.end()) ? nullptr : &it->second;
+    const uint8_t sky_default = neighbour.get_sky(y, 0);
+
+    for (uint16_t a = 0; a < LAYER; a++) {
+      // a = (local y, position along the side)
+      const uint8_t ly = a >> 4, t = a & 0xF;
+      uint8_t x, z, nx, nz;
+      switch (side) {
+      case WEST:
+        x = 0, nx = CHUNK_SIZE - 1, z = nz = t;
+        break;
+      case EAST:
+        x = CHUNK_SIZE - 1, nx = 0, z = nz = t;
+        break;
+      case NORTH:
+        z = 0, nz = CHUNK_SIZE - 1, x = nx = t;
+        break;
+      default:
+        z = CHUNK_SIZE - 1, nz = 0, x = nx = t;
+        break;
+      }
+      const uint16_t n = Section::index(nx, ly, nz);
+      const uint32_t p = k * SECTION_VOLUME + Section::index(x, ly, z);
+      const uint8_t op = ws.opacity[p];
+      if (op >= MAX_LIGHT)
+        continue;
+      const uint8_t cost = std::max<uint8_t>(1, op);
+
+      const uint8_t sky = (light == nullptr) ? sky_default : light->sky.get(n);
+      if ((sky > cost) && (sky - cost > ws.sky[p])) {
+        ws.sky[p] = sky - cost;
+        ws.sky_queue.push_back(p);
+      }
+      const uint8_t block = (light == nullptr) ? 0 : light->block.get(n);
+      if ((block > cost) && (block - cost > ws.block[p])) {
+        ws.block[p] = block - cost;
+        ws.block_queue.push_back(p);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Spread the light of the neighbours of a chunk into it.
+ * @return whether the light of the chunk changed
+ */
+static bool light_borders(LightJob &job, size_t c, Workspace &ws) {
+  const size_t volume = job.volume();
+  ws.resize(volume);
+  load_blocks(job, *job.chunks[c], ws, false);
+  const ChunkLight &own = *job.previous[c];
+  for (uint16_t k = 0; k < job.sections(); k++) {
+    const SectionLight &light = own.at(job.lo + k);
+    light.sky.unpack(ws.sky.data() + k * SECTION_VOLUME);
+    light.block.unpack(ws.block.data() + k * SECTION_VOLUME);
+  }
+
+  for (uint8_t s = 0; s < 4; s++) {
+    const int64_t n = job.in_set[c][s];
+    const ChunkLight *light = (n >= 0) ? job.previous[n].get()
+                                       : job.fixed[c][s].get();
+    if (light != nullptr)
+      pull_side(job, *light, static_cast<Side>(s), ws);
+  }
+  if (ws.sky_queue.empty() && ws.block_queue.empty())
+    return false;
+  propagate(ws.sky.data(), ws.opacity.data(), ws.sky_queue, volume);
+  propagate(ws.block.data(), ws.opacity.data(), ws.block_queue, volume);
+  return true;
+}
+
+/**
+ * @brief Pack the dense light of a chunk.
+ */
+static ChunkLight::SharedPtr pack(const LightJob &job, const Workspace &ws) {
+  auto light = std::make_shared<ChunkLight>();
+  for (uint16_t k = 0; k < job.sections(); k++) {
+    SectionLight &section = (*light)[job.lo + k];
+    section.sky = LightArray::pack(ws.sky.data() + k * SECTION_VOLUME);
+    section.block = LightArray::pack(ws.block.data() + k * SECTION_VOLUME);
+  }
+  return light;
+}
+
+} // namespace
+
+// ============================================================================
+//    Light methods
+// ============================================================================
+
+void LightEngine::relight(const std::vector<Chunk *> &chunks,
+                          const Dimension *dimension) {
+  LightJob job{*this, 0, -1, chunks, {}, {}, {}, {}};
+  const size_t n = chunks.size();
+  if (n == 0)
+    return;
+
+  // Range of the relight: up to one section above the highest block
+  bool any = false;
+  for (const Chunk *chunk : chunks) {
+    for (const auto &[y, section] : *chunk) {
+      if ((section == nullptr) || section->is_empty())
+        continue;
+      job.lo = any ? std::min(job.lo, y) : y;
+      job.hi = any ? std::max<SectionIndex>(job.hi, y) : y;
+      any = true;
+    }
+  }
+  if (any && job.hi < INT8_MAX)
+    job.hi++;
+
+  // Neighbours, in the set or fixed
+  std::unordered_map<ChunkCoordinate, int64_t, ChunkCoordinateHash,
+                     ChunkCoordinateEqual>
+      index;
+  for (size_t c = 0; c < n; c++)
+    index.emplace(chunks[c]->coord, c);
+  job.in_set.assign(n, {-1, -1, -1, -1});
+  job.fixed.resize(n);
+  for (size_t c = 0; c < n; c++) {
+    const ChunkCoordinate &cc = chunks[c]->coord;
+    const ChunkCoordinate sides[4]{ChunkCoordinate(cc.x - 1, cc.z),
+                                   ChunkCoordinate(cc.x + 1, cc.z),
+                                   ChunkCoordinate(cc.x, cc.z - 1),
+                                   ChunkCoordinate(cc.x, cc.z + 1)};
+    for (uint8_t s = 0; s < 4; s++) {
+      if (auto it = index.find(sides[s]); it != index.end())
+        job.in_set[c][s] = it->second;
+      else if (dimension != nullptr)
+        if (auto chunk = dimension->get_chunk(sides[s]); chunk != nullptr)
+          job.fixed[c][s] = chunk->get_light();
+    }
+  }
+
+  // Each chunk on its own, then the rounds of border exchanges
+  ThreadPool pool(options.threads);
+  job.current.resize(n);
+  if (any) {
+    pool.parallel_for(n, [&job](size_t c) {
+      thread_local Workspace ws;
+      light_alone(job, c, ws);
+      job.current[c] = pack(job, ws);
+    });
+
+    std::vector<char> active(n, 1), changed(n, 0);
+    for (uint8_t round = 0; round < options.max_rounds; round++) {
+      job.previous = job.current;
+      std::fill(changed.begin(), changed.end(), 0);
+      pool.parallel_for(n, [&](size_t c) {
+        if (!active[c])
+          return;
+        thread_local Workspace ws;
+        if (!light_borders(job, c, ws))
+          return;
+        auto light = pack(job, ws);
+        for (const auto &[y, section] : *light)
+          if (section != job.previous[c]->at(y)) {
+            job.current[c] = light;
+            changed[c] = 1;
+            break;
+          }
+      });
+
+      // Next round: the chunks next to a changed one
+      bool any_change = false;
+      for (size_t c = 0; c < n; c++) {
+        active[c] = 0;
+        for (uint8_t s = 0; s < 4; s++)
+          if ((job.in_set[c][s] >= 0) && changed[job.in_set[c][s]])
+            active[c] = 1;
+        any_change |= changed[c];
+      }
+      if (!any_change)
+        break;
+    }
+  } else {
+    for (size_t c = 0; c < n; c++)
+      job.current[c] = std::make_shared<ChunkLight>();
+  }
+
+  // Commit the light, marking the sections whose light changed
+  for (size_t c = 0; c < n; c++) {
+    Chunk &chunk = *chunks[c];
+    const ChunkLight::SharedPtr &old = chunk.get_light();
+    for (const auto &[y, section] : *job.current[c]) {
+      const SectionLight *before = nullptr;
+      if (old != nullptr)
+        if (auto it = old->find(y); it != old->end())
+          before = &it->second;
+      const SectionLight implicit{
+          LightArray((old == nullptr) ? MAX_LIGHT : old->get_sky(y, 0)),
+          LightArray(0)};
+      if (section != ((before == nullptr) ? implicit : *before))
+        chunk.mark_dirty(y);
+    }
+    chunk.set_light(job.current[c]);
+  }
+}
+
+void LightEngine::relight(Dimension &dimension,
+                          const std::vector<ChunkCoordinate> &chunks) {
+  std::vector<Chunk *> loaded;
+  std::vector<Chunk::SharedPtr> holders;
+  for (const auto &coord : chunks)
+    if (auto chunk = dimension.get_chunk(coord); chunk != nullptr) {
+      loaded.push_back(chunk.get());
+      holders.push_back(chunk);
+    }
+  relight(loaded, &dimension);
+}
+
+void LightEngine::relight_area(Dimension &dimension, const BlockCoordinate &min,
+                               const BlockCoordinate &max) {
+  const ChunkCoordinate lo = cvtCoordinate<ChunkCoordinate>(min);
+  const ChunkCoordinate hi = cvtCoordinate<ChunkCoordinate>(max);
+  std::vector<ChunkCoordinate> chunks;
+  for (ChunkCoordinate_t x = lo.x - 1; x <= hi.x + 1; x++)
+    for (ChunkCoordinate_t z = lo.z - 1; z <= hi.z + 1; z++)
+      chunks.emplace_back(x, z);
+  relight(dimension, chunks);
+}
+
+void LightEngine::relight(Chunk &chunk) { relight({&chunk}, nullptr); }
+
+} // namespace solis::world
@@ -0,0 +1,113 @@
+#include "solis/world/loader.hpp"
+#include "solis/world/anvil.hpp"
+#include <filesystem>
+
+namespace solis {
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+//    World methods
+// ============================================================================
+
+bool WorldLoader::load_world(const char *world_name) {
+  if (!fs::is_directory(world_name))
+    return false;
+
+  std::lock_guard<std::mutex> lock(files_mutex);
+  files.clear();
+  path = world_name;
+
+  // Only the region files which changed since the last run are scanned
+  const std::string manifest_path =
+      (fs::path(path) / world::WorldManifest::FILENAME).string();
+  const bool loaded = manifest.load(manifest_path);
+  if ((manifest.refresh(path) > 0) || !loaded)
+    manifest.save(manifest_path);
+  return true;
+}
+
+size_t WorldLoader::refresh() {
+  std::lock_guard<std::mutex> lock(files_mutex);
+  const size_t scanned = manifest.refresh(path);
+  if (scanned > 0) {
+    // The opened files hold the headers read before
+    files.clear();
+    manifest.save((fs::path(path) / world::WorldManifest::FILENAME).string());
+  }
+  return scanned;
+}
+
+// ============================================================================
+//    Chunk methods
+// ============================================================================
+
+world::RegionFile::SharedPtr
+WorldLoader::get_region_file(const std::string &dim,
+                             const world::RegionCoordinate &coord) {
+  auto d = manifest.get_dimension(dim);
+  if ((d == nullptr) || (d->get_region(coord) == nullptr))
+    return nullptr;
+
+  const std::string file = (fs::path(path) / d->directory /
+                            world::RegionFile::filename(coord))
+                               .string();
+  std::lock_guard<std::mutex> lock(files_mutex);
+  if (auto it = files.find(file); it != files.end())
+    return it->second;
+  auto region = world::RegionFile::open(file);
+  files.emplace(file, region);
+  return region;
+}
+
+uint32_t
+WorldLoader::get_chunk_timestamp(const std::string &dim,
+                                 const world::ChunkCoordinate &coord) const {
+  auto d = manifest.get_dimension(dim);
+  return (d != nullptr) ? d->get_timestamp(coord) : 0;
+}
+
+world::DimensionManifest::ModifiedRange
+WorldLoader::modified_since(const std::string &dim, uint32_t since) const {
+  static const world::DimensionManifest EMPTY;
+  auto d = manifest.get_dimension(dim);
+  return ((d != nullptr) ? *d : EMPTY).modified_since(since);
+}
+
+world::Chunk::SharedPtr
+WorldLoader::load_chunk(const std::string &dim,
+                        const world::ChunkCoordinate &coord) {
+  if (!is_chunk_on_disk(dim, coord))
+    return nullptr;
+  auto file = get_region_file(
+      dim, world::cvtCoordinate<world::RegionCoordinate>(coord));
+  if (file == nullptr)
+    return nullptr;
+  return world::Anvil::read(*file, world::RegionFile::index(coord),
+                            BlockRegistry::global(), &sections);
+}
+
+// ============================================================================
+//    Block index
+// ============================================================================
+
+size_t WorldLoader::update_block_index(const std::string &dim,
+                                       world::BlockIndex &index) {
+  auto d = manifest.get_dimension(dim);
+  if (d == nullptr)
+    return 0;
+  const auto missing = index.validate(*d);
+  for (const world::ChunkCoordinate &coord : missing) {
+    auto file = get_region_file(
+        dim, world::cvtCoordinate<world::RegionCoordinate>(coord));
+    if (file == nullptr)
+      continue;
+    auto chunk = world::Anvil::read(*file, world::RegionFile::index(coord),
+                                    BlockRegistry::global());
+    if (chunk != nullptr)
+      index.add_chunk(*chunk, d->get_timestamp(coord));
+  }
+  return missing.size();
+}
+
+} // namespace solis
@@ -0,0 +1,297 @@
+#include "solis/world/manifest.hpp"
+#include "solis/utils/binary.hpp"
+#include "solis/utils/errors.hpp"
+#include "solis/utils/files.hpp"
+#include "solis/utils/static.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace solis::world {
+
+namespace fs = std::filesystem;
+
+constexpr char MANIFEST_MAGIC[4]{'S', 'L', 'S', 'M'};
+constexpr uint16_t MANIFEST_VERSION{1};
+
+/// Region directories of the vanilla dimensions
+constexpr std::pair<const char *, const char *> VANILLA_DIMENSIONS[]{
+    {"overworld", "region"},
+    {"the_nether", "DIM-1/region"},
+    {"the_end", "DIM1/region"}};
+
+// ============================================================================
+//    Region manifest
+// ============================================================================
+
+uint16_t RegionManifest::chunk_count() const {
+  uint16_t n = 0;
+  for (auto w : presence)
+    n += __builtin_popcountll(w);
+  return n;
+}
+
+RegionManifest RegionManifest::scan(const RegionFile &file,
+                                    const RegionCoordinate &coord,
+                                    const FileStamp &stamp) {
+  RegionManifest m;
+  m.coord = coord;
+  m.mtime = stamp.mtime;
+  m.size = stamp.size;
+  for (uint16_t i = 0; i < REGION_CHUNK_COUNT; i++) {
+    if (!file.has_chunk(i))
+      continue;
+    m.presence[i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+    m.sectors[i] = file.get_location(i).sectors;
+    m.timestamps[i] = file.get_timestamp(i);
+  }
+  return m;
+}
+
+RegionManifest RegionManifest::scan(const std::string &path,
+                                    const RegionCoordinate &coord) {
+  // The stamp comes first: a save landing in between changes it, so that the
+  // header is read again rather than recorded under the newer stamp
+  constexpr uint8_t ATTEMPTS{4};
+  FileStamp stamp = FileStamp::of(path);
+  for (uint8_t a = 0;; a++) {
+    RegionManifest m = scan(RegionFile(path), coord, stamp);
+    const FileStamp after = FileStamp::of(path);
+    if (after == stamp)
+      return m;
+    if (a + 1 == ATTEMPTS) {
+      // Still being written: left outdated, to be scanned on next refresh
+      m.mtime = 0;
+      m.size = 0;
+      return m;
+    }
+    stamp = after;
+  }
+}
+
+// ============================================================================
+//    Dimension manifest
+// ============================================================================
+
+const RegionManifest *
+DimensionManifest::get_region(const RegionCoordinate &coord) const {
+  if (auto it = regions.find({coord.x, coord.z}); it != regions.end())
+    return &it->second;
+  return nullptr;
+}
+
+bool DimensionManifest::has_chunk(const ChunkCoordinate &coord) const {
+  auto region = get_region(cvtCoordinate<RegionCoordinate>(coord));
+  return (region != nullptr) && region->has_chunk(RegionFile::index(coord));
+}
+
+uint32_t DimensionManifest::get_timestamp(const ChunkCoordinate &coord) const {
+  auto region = get_region(cvtCoordinate<RegionCoordinate>(coord));
+  const uint16_t i = RegionFile::index(coord);
+  return ((region != nullptr) && region->has_chunk(i))
+             ? region->timestamps[i]
+             : 0;
+}
+
+// ============================================================================
+//    Modified chunks
+// ============================================================================
+
+DimensionManifest::ModifiedIterator::ModifiedIterator(
+    RegionMap::const_iterator region, RegionMap::const_iterator last,
+    uint32_t since)
+    : region(region), last(last), since(since) {
+  settle();
+}
+
+ChunkStamp DimensionManifest::ModifiedIterator::operator*() const {
+  const RegionManifest &m = region->second;
+  return ChunkStamp{RegionFile::chunk_coordinate(m.coord, index),
+                    m.timestamps[index]};
+}
+
+DimensionManifest::ModifiedIterator &
+DimensionManifest::ModifiedIterator::operator++() {
+  index++;
+  settle();
+  return *this;
+}
+
+void DimensionManifest::ModifiedIterator::settle() {
+  for (; region != last; ++region, index = 0) {
+    const RegionManifest &m = region->second;
+    for (; index < REGION_CHUNK_COUNT; index++)
+      if (m.has_chunk(index) && (m.timestamps[index] >= since))
+        return;
+  }
+  // The end iterator of every range
+  index = 0;
+}
+
+// ============================================================================
+//    Manifest I/O
+// ============================================================================
+
+bool WorldManifest::load(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    return false;
+  const std::string data((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+
+  BinaryCursor c{data};
+  char magic[4];
+  uint16_t version;
+  uint8_t big_endian;
+  uint32_t n_dims;
+  if (!c.read(magic) || (std::memcmp(magic, MANIFEST_MAGIC, 4) != 0) ||
+      !c.read(version) || (version != MANIFEST_VERSION) ||
+      !c.read(big_endian) || (big_endian != SOLIS_BIG_ENDIAN) ||
+      !c.read(n_dims))
+    return false;
+
+  std::unordered_map<std::string, DimensionManifest> loaded;
+  for (uint32_t d = 0; d < n_dims; d++) {
+    std::string name;
+    DimensionManifest dim;
+    uint32_t n_regions;
+    if (!c.read_string(name) || !c.read_string(dim.directory) ||
+        !c.read(n_regions))
+      return false;
+    for (uint32_t r = 0; r < n_regions; r++) {
+      RegionManifest m;
+      if (!c.read(m.coord.x) || !c.read(m.coord.z) || !c.read(m.mtime) ||
+          !c.read(m.size) || !c.read(m.presence) || !c.read(m.sectors) ||
+          !c.read(m.timestamps))
+        return false;
+      dim.regions.emplace(std::make_pair(m.coord.x, m.coord.z), m);
+    }
+    loaded.emplace(name, std::move(dim));
+  }
+  dimensions.swap(loaded);
+  return true;
+}
+
+void WorldManifest::save(const std::string &path) const {
+  std::string out;
+  out.append(MANIFEST_MAGIC, sizeof(MANIFEST_MAGIC));
+  append(out, MANIFEST_VERSION);
+  append(out, static_cast<uint8_t>(SOLIS_BIG_ENDIAN));
+  append(out, static_cast<uint32_t>(dimensions.size()));
+  for (const auto &[name, dim] : dimensions) {
+    append_string(out, name);
+    append_string(out, dim.directory);
+    append(out, static_cast<uint32_t>(dim.regions.size()));
+    for (const auto &[key, m] : dim.regions) {
+      append(out, m.coord.x);
+      append(out, m.coord.z);
+      append(out, m.mtime);
+      append(out, m.size);
+      append(out, m.presence);
+      append(out, m.sectors);
+      append(out, m.timestamps);
+    }
+  }
+  write_file_atomic(path, out);
+}
+
+// ============================================================================
+//    Refresh
+// ============================================================================
+
+/**
+ * @brief Bring the manifest of a dimension up-to-date with its directory.
+ * @return the number of scanned region files
+ */
+static size_t refresh_dimension(const fs::path &dir, DimensionManifest &dim) {
+  size_t scanned = 0;
+  DimensionManifest::RegionMap regions;
+  for (const auto &entry : fs::directory_iterator(dir)) {
+    RegionCoordinate coord;
+    const std::string name = entry.path().filename().string();
+    if (!entry.is_regular_file() || !RegionFile::parse_filename(name, coord))
+      continue;
+
+    // Keep the summaries of the unchanged files
+    const std::string path = entry.path().string();
+    const FileStamp stamp = FileStamp::of(path);
+    if (auto it = dim.regions.find({coord.x, coord.z});
+        (it != dim.regions.end()) &&
+        (FileStamp{it->second.mtime, it->second.size} == stamp)) {
+      regions.emplace(it->first, it->second);
+      continue;
+    }
+
+    RegionManifest m;
+    try {
+      m = RegionManifest::scan(path, coord);
+    } catch (const FileIOError &) {
+      // Empty or truncated region file: no chunk in it
+      m.coord = coord;
+      m.mtime = stamp.mtime;
+      m.size = stamp.size;
+    }
+    regions.emplace(std::make_pair(coord.x, coord.z), m);
+    scanned++;
+  }
+  dim.regions.swap(regions);
+  return scanned;
+}
+
+size_t WorldManifest::refresh(const std::string &world_dir) {
+  // Vanilla dimensions, then the custom ones (dimensions/<ns>/<name>/region)
+  std::vector<std::pair<std::string, std::string>> dirs;
+  for (const auto &[name, dir] : VANILLA_DIMENSIONS)
+    dirs.emplace_back(name, dir);
+  const fs::path custom = fs::path(world_dir) / "dimensions";
+  if (fs::is_directory(custom)) {
+    for (const auto &ns : fs::directory_iterator(custom)) {
+      if (!ns.is_directory())
+        continue;
+      for (const auto &d : fs::directory_iterator(ns.path()))
+        if (d.is_directory())
+          dirs.emplace_back(ns.path().filename().string() + ":" +
+                                d.path().filename().string(),
+                            (fs::path("dimensions") /
+                             ns.path().filename() / d.path().filename() /
+                             "region")
+                                .string());
+    }
+  }
+
+  size_t scanned = 0;
+  std::unordered_map<std::string, DimensionManifest> refreshed;
+  for (const auto &[name, dir] : dirs) {
+    const fs::path path = fs::path(world_dir) / dir;
+    if (!fs::is_directory(path))
+      continue;
+    DimensionManifest dim;
+    if (auto it = dimensions.find(name); it != dimensions.end())
+      dim = std::move(it->second);
+    dim.directory = dir;
+    scanned += refresh_dimension(path, dim);
+    refreshed.emplace(name, std::move(dim));
+  }
+  dimensions.swap(refreshed);
+  return scanned;
+}
+
+// ============================================================================
+//    Query methods
+// ============================================================================
+
+const DimensionManifest *
+WorldManifest::get_dimension(const std::string &name) const {
+  if (auto it = dimensions.find(name); it != dimensions.end())
+    return &it->second;
+  return nullptr;
+}
+
+bool WorldManifest::has_chunk(const std::string &dim,
+                              const ChunkCoordinate &coord) const {
+  auto d = get_dimension(dim);
+  return (d != nullptr) && d->has_chunk(coord);
+}
+
+} // namespace solis::world
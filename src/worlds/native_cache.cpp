@@ -0,0 +1,412 @@
+#include "solis/world/native_cache.hpp"
+#include "solis/utils/binary.hpp"
+#include "solis/utils/errors.hpp"
+#include "solis/utils/files.hpp"
+#include "solis/utils/static.hpp"
+#include "solis/world/anvil.hpp"
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace solis::world {
+
+using namespace native;
+
+// ============================================================================
+//    Helpers
+// ============================================================================
+
+static inline void align(std::string &out) {
+  out.resize((out.size() + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT, '\0');
+}
+
+/**
+ * @brief Append a light array to a record, unless it is uniform.
+ * @return its offset in the record, 0 if uniform
+ */
+static uint32_t append_light(std::string &out, size_t start,
+                             const LightArray &light) {
+  if (light.is_uniform())
+    return 0;
+  align(out);
+  const uint32_t offset = out.size() - start;
+  out.append(reinterpret_cast<const char *>(light.get_data().data()),
+             LightArray::BYTES);
+  return offset;
+}
+
+/**
+ * @brief Read a light array of a record.
+ */
+static LightArray read_light(const char *record, uint32_t offset,
+                             uint8_t uniform) {
+  if (offset == 0)
+    return LightArray(uniform);
+  uint8_t levels[SECTION_VOLUME];
+  auto packed = reinterpret_cast<const uint8_t *>(record + offset);
+  for (uint16_t b = 0; b < LightArray::BYTES; b++) {
+    levels[2 * b] = packed[b] & 0xF;
+    levels[2 * b + 1] = packed[b] >> 4;
+  }
+  return LightArray::pack(levels);
+}
+
+/**
+ * @brief Whether a range of a record is inside of it and aligned for T.
+ */
+template <typename T>
+static inline bool fits(size_t size, uint64_t offset, uint64_t count) {
+  return (offset % alignof(T) == 0) && (offset + count * sizeof(T) <= size);
+}
+
+// ============================================================================
+//    Views
+// ============================================================================
+
+Chunk::SharedPtr NativeChunkView::to_chunk(BlockRegistry &registry,
+                                           SectionPool *pool) const {
+  auto chunk = std::make_shared<Chunk>();
+  chunk->coord = coord();
+  chunk->set_min_section(header().min_section);
+  for (uint16_t k = 0; k < section_count(); k++) {
+    const NativeSectionView s = section(k);
+    Section::Palette palette(s.palette_size());
+    for (uint16_t p = 0; p < s.palette_size(); p++) {
+      const std::string_view name = s.palette(p);
+      palette[p] = name.empty() ? nullptr : registry.get(name);
+    }
+    Section::Indices indices;
+    if (!s.is_uniform())
+      indices.assign(s.indices(), s.indices() + SECTION_VOLUME);
+    auto section =
+        std::make_shared<Section>(std::move(palette), std::move(indices));
+    chunk->emplace(s.y(),
+                   (pool != nullptr) ? pool->intern(section) : section);
+  }
+
+  const ChunkHeader &ch = header();
+  if (ch.lights != 0) {
+    auto light = std::make_shared<ChunkLight>();
+    auto lights =
+        reinterpret_cast<const LightHeader *>(record + ch.light_offset);
+    for (uint16_t k = 0; k < ch.lights; k++) {
+      SectionLight &l = (*light)[lights[k].y];
+      l.sky = read_light(record, lights[k].sky_offset, lights[k].sky);
+      l.block = read_light(record, lights[k].block_offset, lights[k].block);
+    }
+    chunk->set_light(std::move(light));
+  }
+  if (ch.heightmaps_offset != 0) {
+    auto heightmaps = std::make_shared<Heightmaps>();
+    auto hh = reinterpret_cast<const HeightmapsHeader *>(
+        record + ch.heightmaps_offset);
+    heightmaps->min_y = static_cast<LayerIndex>(hh->min_y);
+    std::memcpy(heightmaps->heights, hh + 1, sizeof(heightmaps->heights));
+    chunk->set_heightmaps(std::move(heightmaps));
+  }
+  return chunk;
+}
+
+bool NativeChunkView::is_valid(size_t size) const {
+  if ((size < sizeof(ChunkHeader)) || (header().size != size))
+    return false;
+  const ChunkHeader &ch = header();
+  if (!fits<SectionHeader>(size, sizeof(ChunkHeader), ch.sections))
+    return false;
+
+  for (uint16_t k = 0; k < ch.sections; k++) {
+    const SectionHeader &sh = *section(k).header;
+    if ((sh.palette_size == 0) ||
+        !fits<uint32_t>(size, sh.palette_offset, sh.palette_size))
+      return false;
+    auto ends = reinterpret_cast<const uint32_t *>(record + sh.palette_offset);
+    for (uint16_t p = 1; p < sh.palette_size; p++)
+      if (ends[p] < ends[p - 1])
+        return false;
+    if (!fits<char>(size, sh.names_offset, ends[sh.palette_size - 1]))
+      return false;
+
+    if (sh.indices_offset == 0)
+      continue;
+    if (!fits<PaletteIndex_t>(size, sh.indices_offset, SECTION_VOLUME))
+      return false;
+    auto indices =
+        reinterpret_cast<const PaletteIndex_t *>(record + sh.indices_offset);
+    for (uint16_t i = 0; i < SECTION_VOLUME; i++)
+      if (indices[i] >= sh.palette_size)
+        return false;
+  }
+
+  if (!fits<LightHeader>(size, ch.light_offset, ch.lights))
+    return false;
+  auto lights = reinterpret_cast<const LightHeader *>(record + ch.light_offset);
+  auto light_fits = [size](uint32_t offset) {
+    return (offset == 0) || fits<char>(size, offset, LightArray::BYTES);
+  };
+  for (uint16_t k = 0; k < ch.lights; k++)
+    if (!light_fits(lights[k].sky_offset) ||
+        !light_fits(lights[k].block_offset))
+      return false;
+
+  constexpr size_t HEIGHTS{HEIGHTMAP_COUNT * CHUNK_SIZE * CHUNK_SIZE};
+  const uint64_t heights = ch.heightmaps_offset + sizeof(HeightmapsHeader);
+  return (ch.heightmaps_offset == 0) ||
+         (fits<HeightmapsHeader>(size, ch.heightmaps_offset, 1) &&
+          fits<LayerIndex>(size, heights, HEIGHTS));
+}
+
+// ============================================================================
+//    Constructor
+// ============================================================================
+
+NativeRegionCache::NativeRegionCache(const std::string &path) : path(path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    if (errno == ENOENT)
+      throw FileNotFoundError(path.c_str());
+    throw FileIOError(fmt::format("cannot open \"{}\": {}", path,
+                                  std::strerror(errno)));
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw FileIOError(std::strerror(errno));
+  }
+  size = st.st_size;
+  if (size < sizeof(FileHeader) + sizeof(FileTrailer)) {
+    ::close(fd);
+    throw FileIOError(fmt::format("\"{}\" is not a chunk cache", path));
+  }
+  void *map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED)
+    throw FileIOError(fmt::format("cannot map \"{}\": {}", path,
+                                  std::strerror(errno)));
+  base = static_cast<const char *>(map);
+
+  // Validate the layout
+  header = reinterpret_cast<const FileHeader *>(base);
+  auto trailer = reinterpret_cast<const FileTrailer *>(
+      base + size - sizeof(FileTrailer));
+  const bool valid =
+      (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0) &&
+      (std::memcmp(trailer->magic, MAGIC, sizeof(MAGIC)) == 0) &&
+      (header->version == VERSION) &&
+      (header->big_endian == SOLIS_BIG_ENDIAN) &&
+      (trailer->index_offset % ALIGNMENT == 0) &&
+      (trailer->index_offset + REGION_CHUNK_COUNT * sizeof(IndexEntry) <=
+       size - sizeof(FileTrailer));
+  if (!valid) {
+    munmap(const_cast<char *>(base), size);
+    throw FileIOError(fmt::format("\"{}\" is not a valid chunk cache", path));
+  }
+  index = reinterpret_cast<const IndexEntry *>(base + trailer->index_offset);
+}
+
+NativeRegionCache::~NativeRegionCache() {
+  if (base != nullptr)
+    munmap(const_cast<char *>(base), size);
+}
+
+std::string NativeRegionCache::filename(const RegionCoordinate &coord) {
+  return fmt::format("r.{}.{}.slc", coord.x, coord.z);
+}
+
+// ============================================================================
+//    Chunk methods
+// ============================================================================
+
+NativeChunkView NativeRegionCache::chunk(uint16_t i) const {
+  const IndexEntry &entry = index[i];
+  const NativeChunkView view{base + entry.offset};
+  const uint64_t index_offset = reinterpret_cast<const char *>(index) - base;
+  if ((entry.offset < sizeof(FileHeader)) ||
+      (entry.offset % ALIGNMENT != 0) ||
+      (entry.offset + entry.size > index_offset) ||
+      !view.is_valid(entry.size))
+    throw FileIOError(
+        fmt::format("damaged chunk record {} in \"{}\"", i, path));
+  return view;
+}
+
+Chunk::SharedPtr NativeRegionCache::load_chunk(uint16_t i,
+                                               BlockRegistry &registry) const {
+  if (!has_chunk(i))
+    return nullptr;
+  return chunk(i).to_chunk(registry);
+}
+
+// ============================================================================
+//    Build methods
+// ============================================================================
+
+bool NativeRegionCache::is_fresh(const std::string &region_path) const {
+  return FileStamp{header->source_mtime, header->source_size} ==
+         FileStamp::of(region_path);
+}
+
+void NativeRegionCache::append_record(std::string &out, const Chunk &chunk) {
+  align(out);
+  const size_t start = out.size();
+
+  uint16_t count = 0;
+  for (const auto &[y, section] : chunk)
+    count += (section != nullptr);
+  ChunkHeader ch{chunk.coord.x, chunk.coord.z, 0, count, 0, 0, 0,
+                 chunk.get_min_section(), {}};
+  append(out, ch);
+  const size_t headers = out.size();
+  out.resize(headers + count * sizeof(SectionHeader), '\0');
+
+  uint16_t k = 0;
+  std::string names;
+  for (const auto &[y, section] : chunk) {
+    if (section == nullptr)
+      continue;
+    const Section::Palette &palette = section->get_palette();
+    SectionHeader sh{y, 0, static_cast<uint16_t>(palette.size()), 0, 0, 0};
+
+    // Palette end offsets, then names
+    names.clear();
+    align(out);
+    sh.palette_offset = out.size() - start;
+    for (const Block *block : palette) {
+      if (block != nullptr)
+        names.append(BlockRegistry::full_name(*block));
+      append(out, static_cast<uint32_t>(names.size()));
+    }
+    sh.names_offset = out.size() - start;
+    out.append(names);
+
+    // Block indices
+    if (!section->is_uniform()) {
+      align(out);
+      sh.indices_offset = out.size() - start;
+      out.append(reinterpret_cast<const char *>(
+                     section->get_indices().data()),
+                 SECTION_VOLUME * sizeof(PaletteIndex_t));
+    }
+    std::memcpy(out.data() + headers + (k++) * sizeof(SectionHeader), &sh,
+                sizeof(sh));
+  }
+
+  // Light of the sections, headers first
+  if (const auto &light = chunk.get_light(); light != nullptr) {
+    align(out);
+    ch.lights = light->size();
+    ch.light_offset = out.size() - start;
+    const size_t lights = out.size();
+    out.resize(lights + ch.lights * sizeof(LightHeader), '\0');
+    k = 0;
+    for (const auto &[y, l] : *light) {
+      LightHeader lh{y, 0, l.sky.get(0), l.block.get(0), 0, 0, 0};
+      lh.sky_offset = append_light(out, start, l.sky);
+      lh.block_offset = append_light(out, start, l.block);
+      std::memcpy(out.data() + lights + (k++) * sizeof(LightHeader), &lh,
+                  sizeof(lh));
+    }
+  }
+
+  // Heightmaps, if they are up-to-date
+  if (const auto heightmaps = chunk.get_cached_heightmaps();
+      heightmaps != nullptr) {
+    align(out);
+    ch.heightmaps_offset = out.size() - start;
+    append(out, HeightmapsHeader{heightmaps->min_y, 0});
+    out.append(reinterpret_cast<const char *>(heightmaps->heights),
+               sizeof(heightmaps->heights));
+  }
+
+  align(out);
+  ch.size = out.size() - start;
+  std::memcpy(out.data() + start, &ch, sizeof(ch));
+}
+
+bool NativeRegionCache::refresh(const std::string &region_path,
+                                const std::string &cache_path) {
+  const FileStamp stamp = FileStamp::of(region_path);
+
+  // Reuse the records of the chunks which did not change
+  std::unique_ptr<NativeRegionCache> previous;
+  if (std::filesystem::exists(cache_path)) {
+    try {
+      previous = std::make_unique<NativeRegionCache>(cache_path);
+    } catch (const FileIOError &) {
+      // Invalid or outdated cache format: rebuild it from scratch
+    }
+  }
+  if ((previous != nullptr) && previous->is_fresh(region_path))
+    return false;
+
+  RegionFile region(region_path);
+  std::string out;
+  FileHeader fh{{}, VERSION, SOLIS_BIG_ENDIAN, 0, stamp.mtime, stamp.size};
+  std::memcpy(fh.magic, MAGIC, sizeof(MAGIC));
+  append(out, fh);
+
+  std::array<IndexEntry, REGION_CHUNK_COUNT> entries{};
+  uint32_t count = 0;
+  for (uint16_t i = 0; i < REGION_CHUNK_COUNT; i++) {
+    if (!region.has_chunk(i))
+      continue;
+    const uint32_t timestamp = region.get_timestamp(i);
+
+    align(out);
+    const size_t offset = out.size();
+    bool reused = false;
+    if ((previous != nullptr) && previous->has_chunk(i) &&
+        (previous->get_timestamp(i) == timestamp)) {
+      try {
+        const NativeChunkView view = previous->chunk(i);
+        out.append(view.record, view.header().size);
+        reused = true;
+      } catch (const FileIOError &) {
+        // Damaged record: decode the chunk again
+      }
+    }
+    if (!reused) {
+      auto chunk = Anvil::read(region, i);
+      if (chunk == nullptr)
+        continue;
+      append_record(out, *chunk);
+    }
+    entries[i] = IndexEntry{offset, static_cast<uint32_t>(out.size() - offset),
+                            timestamp};
+    count++;
+  }
+
+  align(out);
+  FileTrailer ft{out.size(), count, {}};
+  std::memcpy(ft.magic, MAGIC, sizeof(MAGIC));
+  out.append(reinterpret_cast<const char *>(entries.data()),
+             entries.size() * sizeof(IndexEntry));
+  append(out, ft);
+  previous.reset();
+
+  write_file_atomic(cache_path, out);
+  return true;
+}
+
+size_t NativeRegionCache::refresh_directory(const std::string &region_dir,
+                                            const std::string &cache_dir) {
+  namespace fs = std::filesystem;
+  fs::create_directories(cache_dir);
+
+  size_t rebuilt = 0;
+  for (const auto &entry : fs::directory_iterator(region_dir)) {
+    if (!entry.is_regular_file() || (entry.path().extension() != ".mca"))
+      continue;
+    const fs::path cache =
+        fs::path(cache_dir) / entry.path().filename().replace_extension(".slc");
+    rebuilt += refresh(entry.path().string(), cache.string());
+  }
+  return rebuilt;
+}
+
+} // namespace solis::world
@@ -0,0 +1,141 @@
+#include "solis/world/prefetcher.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace solis::world {
+
+/// Minimal speed (in blocks per second) for a viewer to be considered moving
+constexpr double MIN_SPEED{1e-3};
+/// Maximal number of path samples per viewer
+constexpr size_t MAX_SAMPLES{1024};
+
+// ============================================================================
+//    Constructor
+// ============================================================================
+
+ChunkPrefetcher::ChunkPrefetcher(Dimension::SharedPtr dimension,
+                                 ChunkSource source, const Config &config)
+    : dimension(dimension), source(source), config(config) {}
+
+// ============================================================================
+//    Viewer methods
+// ============================================================================
+
+void ChunkPrefetcher::track_viewer(ViewerID_t id,
+                                   const WorldCoordinate &position,
+                                   const WorldCoordinate &velocity) {
+  viewers[id] = Viewer{position, velocity};
+}
+
+void ChunkPrefetcher::untrack_viewer(ViewerID_t id) { viewers.erase(id); }
+
+// ============================================================================
+//    Prefetch methods
+// ============================================================================
+
+void ChunkPrefetcher::predict(const Viewer &viewer, PredictionMap &out) const {
+  const double speed = std::hypot(viewer.velocity.x, viewer.velocity.z);
+  const int64_t r = config.radius;
+
+  // Sample the path every half chunk so that no crossed chunk is skipped
+  double dt = config.horizon;
+  size_t samples = 1;
+  if (speed > MIN_SPEED) {
+    dt = CHUNK_SIZE / (2.0 * speed);
+    samples = std::min(MAX_SAMPLES,
+                       static_cast<size_t>(config.horizon / dt) + 1);
+  }
+  // Lateral chunks are reached later than the ones on the path
+  const double lateral = CHUNK_SIZE / std::max(speed, 1.0);
+
+  for (size_t i = 0; i < samples; i++) {
+    const double t = i * dt;
+    const WorldCoordinate p(viewer.position.x + viewer.velocity.x * t,
+                            viewer.position.y,
+                            viewer.position.z + viewer.velocity.z * t);
+    const ChunkCoordinate c = cvtCoordinate<ChunkCoordinate>(p);
+
+    for (int64_t dx = -r; dx <= r; dx++) {
+      for (int64_t dz = -r; dz <= r; dz++) {
+        const double eta =
+            t + std::max(std::abs(dx), std::abs(dz)) * lateral;
+        const ChunkCoordinate n(c.x + dx, c.z + dz);
+        if (auto it = out.find(n); it == out.end())
+          out.emplace(n, eta);
+        else if (eta < it->second)
+          it->second = eta;
+      }
+    }
+  }
+}
+
+void ChunkPrefetcher::update() {
+  PredictionMap predicted;
+  for (const auto &[id, viewer] : viewers)
+    predict(viewer, predicted);
+
+  // Cancel the pending loads that are not on any predicted path anymore
+  for (const auto &p : ring)
+    if (predicted.find(p.coord) == predicted.end())
+      stats.cancelled++;
+
+  // Warmed chunks that are not on a path will most likely never be demanded
+  for (auto it = warmed.begin(); it != warmed.end();) {
+    if (predicted.find(*it) == predicted.end()) {
+      stats.wasted++;
+      it = warmed.erase(it);
+    } else
+      it++;
+  }
+
+  // Rebuild the ring with the chunks still to be loaded, most urgent last
+  ring.clear();
+  for (const auto &[coord, eta] : predicted)
+    if (!dimension->is_chunk_loaded(coord))
+      ring.push_back(Pending{coord, eta});
+  std::sort(ring.begin(), ring.end(),
+            [](const Pending &a, const Pending &b) { return a.eta > b.eta; });
+  if (ring.size() > config.capacity)
+    ring.erase(ring.begin(), ring.end() - config.capacity);
+}
+
+size_t ChunkPrefetcher::tick() {
+  size_t loaded = 0;
+  while (!ring.empty() && loaded < config.loads_per_tick) {
+    const ChunkCoordinate coord = ring.back().coord;
+    ring.pop_back();
+    if (dimension->is_chunk_loaded(coord))
+      continue;
+
+    if (auto chunk = source(coord); chunk != nullptr) {
+      dimension->add_chunk(chunk);
+      warmed.insert(coord);
+      stats.issued++;
+      loaded++;
+    }
+  }
+  return loaded;
+}
+
+Chunk::SharedPtr ChunkPrefetcher::get_chunk(const ChunkCoordinate &coord) {
+  if (auto chunk = dimension->get_chunk(coord); chunk != nullptr) {
+    if (warmed.erase(coord) > 0)
+      stats.hits++;
+    return chunk;
+  }
+
+  // Not warmed in time: load it on demand
+  stats.misses++;
+  ring.erase(std::remove_if(ring.begin(), ring.end(),
+                            [&coord](const Pending &p) {
+                              return (p.coord.x == coord.x) &&
+                                     (p.coord.z == coord.z);
+                            }),
+             ring.end());
+  auto chunk = source(coord);
+  if (chunk != nullptr)
+    dimension->add_chunk(chunk);
+  return chunk;
+}
+
+} // namespace solis::world
@@ -0,0 +1,248 @@
+#include "solis/world/raycast.hpp"
+#include "solis/utils/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace solis::world {
+
+constexpr double INF{std::numeric_limits<double>::infinity()};
+
+/// Bounds of the cells without limit along an axis (the chunk columns)
+constexpr BlockCoordinate_t UNBOUNDED{std::numeric_limits<int32_t>::max()};
+
+// ============================================================================
+//    Traversal
+// ============================================================================
+
+/**
+ * @brief State of a ray walking the grid of blocks.
+ */
+struct RayWalk {
+  double o[3];               /// Origin
+  double d[3];               /// Normalized direction
+  BlockCoordinate_t cell[3]; /// Current block
+  double t_max[3];           /// Distance to the next boundary of each axis
+  double t_delta[3];         /// Distance between two boundaries of an axis
+  double t{0};               /// Distance to the entry of the current block
+  int8_t normal[3]{0, 0, 0}; /// Face the current block was entered through
+
+  /**
+   * @brief Distance to the next boundary of an axis, from the current block.
+   */
+  inline double boundary(uint8_t k) const {
+    if (d[k] == 0)
+      return INF;
+    return (static_cast<double>(cell[k] + (d[k] > 0)) - o[k]) / d[k];
+  }
+
+  /**
+   * @brief Step to the next block.
+   */
+  inline void step() {
+    const uint8_t k = (t_max[0] < t_max[1])
+                          ? ((t_max[0] < t_max[2]) ? 0 : 2)
+                          : ((t_max[1] < t_max[2]) ? 1 : 2);
+    t = t_max[k];
+    cell[k] += (d[k] > 0) ? 1 : -1;
+    t_max[k] += t_delta[k];
+    normal[0] = normal[1] = normal[2] = 0;
+    normal[k] = (d[k] > 0) ? -1 : 1;
+  }
+
+  /**
+   * @brief Leave a box of blocks (bounds included) in a single step, to the
+   * block right after it.
+   * @return false if the ray never leaves it
+   */
+  bool leave(const BlockCoordinate_t (&lo)[3],
+             const BlockCoordinate_t (&hi)[3]) {
+    uint8_t k = 3;
+    double exit = INF;
+    for (uint8_t a = 0; a < 3; a++) {
+      if (d[a] == 0)
+        continue;
+      const double bound = static_cast<double>((d[a] > 0) ? hi[a] + 1 : lo[a]);
+      const double ta = (bound - o[a]) / d[a];
+      if (ta < exit) {
+        exit = ta;
+        k = a;
+      }
+    }
+    if (k == 3)
+      return false;
+
+    t = std::max(t, exit);
+    for (uint8_t a = 0; a < 3; a++) {
+      if (a == k)
+        cell[a] = (d[a] > 0) ? hi[a] + 1 : lo[a] - 1;
+      else
+        cell[a] = std::clamp(
+            static_cast<BlockCoordinate_t>(std::floor(o[a] + d[a] * t)), lo[a],
+            hi[a]);
+      t_max[a] = boundary(a);
+      normal[a] = 0;
+    }
+    normal[k] = (d[k] > 0) ? -1 : 1;
+    return true;
+  }
+};
+
+/**
+ * @brief Cast a ray, getting the chunks through a resolver (called once per
+ * crossed chunk).
+ */
+template <typename Resolver>
+static RayHit trace(const Ray &ray, const RayOptions &options,
+                    Resolver &&resolve) {
+  RayHit out;
+  const double len =
+      std::sqrt(ray.direction.x * ray.direction.x +
+                ray.direction.y * ray.direction.y +
+                ray.direction.z * ray.direction.z);
+  if (!(len > 0))
+    return out;
+
+  RayWalk w;
+  w.o[0] = ray.origin.x;
+  w.o[1] = ray.origin.y;
+  w.o[2] = ray.origin.z;
+  w.d[0] = ray.direction.x / len;
+  w.d[1] = ray.direction.y / len;
+  w.d[2] = ray.direction.z / len;
+  for (uint8_t k = 0; k < 3; k++) {
+    w.cell[k] = static_cast<BlockCoordinate_t>(std::floor(w.o[k]));
+    w.t_max[k] = w.boundary(k);
+    w.t_delta[k] = (w.d[k] == 0) ? INF : std::abs(1 / w.d[k]);
+  }
+
+  const Chunk *chunk = nullptr;
+  ChunkCoordinate chunk_coord;
+  bool resolved = false;
+  for (; w.t <= options.max_distance; out.steps++) {
+    const ChunkCoordinate cc(
+        floor_div<BlockCoordinate_t>(w.cell[0], CHUNK_SIZE),
+        floor_div<BlockCoordinate_t>(w.cell[2], CHUNK_SIZE));
+    if (!resolved || (cc.x != chunk_coord.x) || (cc.z != chunk_coord.z)) {
+      chunk = resolve(cc);
+      chunk_coord = cc;
+      resolved = true;
+    }
+
+    // Absent chunk: leave its column
+    if (chunk == nullptr) {
+      const BlockCoordinate_t lo[3]{cc.x * CHUNK_SIZE, -UNBOUNDED,
+                                    cc.z * CHUNK_SIZE};
+      const BlockCoordinate_t hi[3]{lo[0] + CHUNK_SIZE - 1, UNBOUNDED,
+                                    lo[2] + CHUNK_SIZE - 1};
+      if (!w.leave(lo, hi))
+        break;
+      continue;
+    }
+
+    // Absent or uniform section which cannot stop the ray: leave it
+    const BlockCoordinate_t sy =
+        floor_div<BlockCoordinate_t>(w.cell[1], CHUNK_SIZE);
+    const Section *section = nullptr;
+    if ((sy >= std::numeric_limits<SectionIndex>::min()) &&
+        (sy <= std::numeric_limits<SectionIndex>::max()))
+      if (auto it = chunk->find(static_cast<SectionIndex>(sy));
+          it != chunk->end())
+        section = it->second.get();
+
+    const Block *block;
+    if ((section == nullptr) || section->is_uniform()) {
+      block = (section == nullptr) ? nullptr : section->get_block(0);
+      const FlagL_t f = Block::flags_of(block);
+      if (!has_flag(f, options.flags) || ((f & options.excluded) != 0)) {
+        const BlockCoordinate_t lo[3]{cc.x * CHUNK_SIZE, sy * CHUNK_SIZE,
+                                      cc.z * CHUNK_SIZE};
+        const BlockCoordinate_t hi[3]{lo[0] + CHUNK_SIZE - 1,
+                                      lo[1] + CHUNK_SIZE - 1,
+                                      lo[2] + CHUNK_SIZE - 1};
+        if (!w.leave(lo, hi))
+          break;
+        continue;
+      }
+    } else
+      block = section->get_block(Section::index(
+          static_cast<InChunkCoord_t>(w.cell[0] - cc.x * CHUNK_SIZE),
+          static_cast<InChunkCoord_t>(w.cell[1] - sy * CHUNK_SIZE),
+          static_cast<InChunkCoord_t>(w.cell[2] - cc.z * CHUNK_SIZE)));
+
+    const FlagL_t f = Block::flags_of(block);
+    if (has_flag(f, options.flags) && ((f & options.excluded) == 0)) {
+      out.hit = true;
+      out.block = BlockCoordinate(w.cell[0], w.cell[1], w.cell[2]);
+      out.normal = BlockCoordinate(w.normal[0], w.normal[1], w.normal[2]);
+      out.state = block;
+      out.distance = w.t;
+      out.position = WorldCoordinate(w.o[0] + w.d[0] * w.t,
+                                     w.o[1] + w.d[1] * w.t,
+                                     w.o[2] + w.d[2] * w.t);
+      return out;
+    }
+    w.step();
+  }
+  return out;
+}
+
+// ============================================================================
+//    Constructor
+// ============================================================================
+
+RayCaster::RayCaster(const Dimension &dimension) {
+  for (const auto &region : dimension.get_regions())
+    for (const auto &chunk : *region)
+      chunks.emplace(chunk->coord, chunk);
+  for (const auto &[coord, chunk] : dimension.get_cold_chunks())
+    chunks.emplace(coord, chunk->inflate());
+}
+
+// ============================================================================
+//    Cast methods
+// ============================================================================
+
+RayHit RayCaster::cast(const Ray &ray, const RayOptions &options) const {
+  return trace(ray, options, [this](const ChunkCoordinate &coord) {
+    auto it = chunks.find(coord);
+    return (it == chunks.end()) ? nullptr : it->second.get();
+  });
+}
+
+std::vector<RayHit> RayCaster::cast(const std::vector<Ray> &rays,
+                                    const RayOptions &options) const {
+  std::vector<RayHit> out(rays.size());
+  ThreadPool pool(options.threads);
+  pool.parallel_for(
+      rays.size(), [&](size_t i) { out[i] = cast(rays[i], options); }, 64);
+  return out;
+}
+
+bool RayCaster::visible(const WorldCoordinate &from, const WorldCoordinate &to,
+                        const RayOptions &options) const {
+  const Ray ray{from, WorldCoordinate(to.x - from.x, to.y - from.y,
+                                      to.z - from.z)};
+  RayOptions segment = options;
+  segment.max_distance =
+      std::sqrt(ray.direction.x * ray.direction.x +
+                ray.direction.y * ray.direction.y +
+                ray.direction.z * ray.direction.z);
+  const RayHit hit = cast(ray, segment);
+  return !hit.hit ||
+         ((hit.block.x == static_cast<BlockCoordinate_t>(std::floor(to.x))) &&
+          (hit.block.y == static_cast<BlockCoordinate_t>(std::floor(to.y))) &&
+          (hit.block.z == static_cast<BlockCoordinate_t>(std::floor(to.z))));
+}
+
+RayHit RayCaster::cast(const Dimension &dimension, const Ray &ray,
+                       const RayOptions &options) {
+  Chunk::SharedPtr held;
+  return trace(ray, options,
+               [&dimension, &held](const ChunkCoordinate &coord) {
+                 held = dimension.get_chunk(coord);
+                 return held.get();
+               });
+}
+
+} // namespace solis::world
@@ -0,0 +1,352 @@
+#include "solis/world/region_file.hpp"
+#include "solis/utils/errors.hpp"
+#include "solis/utils/static.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace solis::world {
+
+/// Flag of the compression byte telling the payload is in an external file
+constexpr uint8_t EXTERNAL_PAYLOAD_FLAG{0x80};
+
+// ============================================================================
+//    Constructor
+// ============================================================================
+
+RegionFile::RegionFile(const std::string &path, bool writable,
+                       const RegionWriteOptions &options)
+    : path(path), writable(writable), options(options) {
+  fd = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+  if (fd < 0) {
+    if (errno == ENOENT)
+      throw FileNotFoundError(path.c_str());
+    throw FileIOError(fmt::format("cannot open \"{}\": {}", path,
+                                  std::strerror(errno)));
+  }
+
+  try {
+    read_header();
+    build_free_map();
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+}
+
+RegionFile::~RegionFile() {
+  if (fd >= 0)
+    ::close(fd);
+}
+
+std::string RegionFile::filename(const RegionCoordinate &coord) {
+  return fmt::format("r.{}.{}.mca", coord.x, coord.z);
+}
+
+bool RegionFile::parse_filename(const std::string &name,
+                                RegionCoordinate &coord) {
+  int n = 0;
+  return (std::sscanf(name.c_str(), "r.%d.%d.mca%n", &coord.x, &coord.z, &n) ==
+          2) &&
+         (static_cast<size_t>(n) == name.size());
+}
+
+// ============================================================================
+//    Header methods
+// ============================================================================
+
+void RegionFile::read_header() {
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+    throw FileIOError(std::strerror(errno));
+
+  // New (or truncated) region file: write an empty header
+  if (static_cast<uint64_t>(st.st_size) < REGION_HEADER_SECTORS * SECTOR_SIZE) {
+    if (!writable)
+      throw FileIOError(fmt::format("\"{}\" is not a region file", path));
+    locations.fill(ChunkLocation());
+    timestamps.fill(0);
+    const std::string empty(REGION_HEADER_SECTORS * SECTOR_SIZE, '\0');
+    write_at(empty.data(), empty.size(), 0);
+    return;
+  }
+
+  uint32_t table[REGION_CHUNK_COUNT];
+  read_at(table, SECTOR_SIZE, 0);
+  for (uint16_t i = 0; i < REGION_CHUNK_COUNT; i++) {
+    const uint32_t v = FROM_BIG_ENDIAN(table[i]);
+    locations[i].offset = v >> 8;
+    locations[i].sectors = v & 0xFF;
+  }
+  read_at(table, SECTOR_SIZE, SECTOR_SIZE);
+  for (uint16_t i = 0; i < REGION_CHUNK_COUNT; i++)
+    timestamps[i] = FROM_BIG_ENDIAN(table[i]);
+}
+
+void RegionFile::build_free_map() {
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+    throw FileIOError(std::strerror(errno));
+
+  used.assign((st.st_size + SECTOR_SIZE - 1) / SECTOR_SIZE, false);
+  mark(0, REGION_HEADER_SECTORS, true);
+  for (auto &loc : locations) {
+    // Drop the entries pointing in the header or out of the file
+    if (loc.exists() && ((loc.offset < REGION_HEADER_SECTORS) ||
+                         (loc.offset + loc.sectors > used.size()))) {
+      loc = ChunkLocation();
+      continue;
+    }
+    mark(loc.offset, loc.sectors, true);
+  }
+}
+
+uint32_t RegionFile::free_sectors() const {
+  uint32_t n = 0;
+  for (bool u : used)
+    n += !u;
+  return n;
+}
+
+// ============================================================================
+//    Read methods
+// ============================================================================
+
+bool RegionFile::read_chunk(uint16_t i, ChunkPayload &out) const {
+  const ChunkLocation &loc = locations[i];
+  if (!loc.exists())
+    return false;
+
+  unsigned char header[CHUNK_PAYLOAD_HEADER];
+  const uint64_t start = static_cast<uint64_t>(loc.offset) * SECTOR_SIZE;
+  read_at(header, CHUNK_PAYLOAD_HEADER, start);
+
+  uint32_t length;
+  std::memcpy(&length, header, sizeof(length));
+  length = FROM_BIG_ENDIAN(length);
+  if ((length == 0) ||
+      (static_cast<uint64_t>(length) + 4 >
+       static_cast<uint64_t>(loc.sectors) * SECTOR_SIZE))
+    throw FileIOError(
+        fmt::format("corrupted chunk {} in \"{}\" (length {})", i, path,
+                    length));
+  if (header[4] & EXTERNAL_PAYLOAD_FLAG)
+    throw FileIOError(fmt::format(
+        "chunk {} in \"{}\" is stored in an external file", i, path));
+
+  out.compression = header[4];
+  out.data.resize(length - 1);
+  read_at(out.data.data(), out.data.size(), start + CHUNK_PAYLOAD_HEADER);
+  return true;
+}
+
+// ============================================================================
+//    Write methods
+// ============================================================================
+
+void RegionFile::stage_chunk(uint16_t i, ChunkPayload payload,
+                             uint32_t timestamp) {
+  if (payload.sector_count() > CHUNK_MAX_SECTORS)
+    throw FileIOError(fmt::format(
+        "chunk {} payload is too large for \"{}\" ({} bytes)", i, path,
+        payload.data.size()));
+  if (timestamp == 0)
+    timestamp = static_cast<uint32_t>(std::time(nullptr));
+  batch.push_back(Staged{i, timestamp, false, std::move(payload)});
+}
+
+bool RegionFile::stage_copy(const RegionFile &source, uint16_t from,
+                            uint16_t to, uint64_t *bytes) {
+  ChunkPayload payload;
+  if (!source.read_chunk(from, payload))
+    return false;
+  if (bytes != nullptr)
+    *bytes += payload.data.size();
+  stage_chunk(to, std::move(payload), source.get_timestamp(from));
+  return true;
+}
+
+void RegionFile::stage_removal(uint16_t i) {
+  batch.push_back(Staged{i, 0, true, ChunkPayload()});
+}
+
+void RegionFile::commit() {
+  if (batch.empty())
+    return;
+  if (!writable)
+    throw FileIOError(fmt::format("\"{}\" is opened read-only", path));
+
+  // Only keep the last modification of each chunk
+  std::array<int32_t, REGION_CHUNK_COUNT> last;
+  last.fill(-1);
+  for (size_t b = 0; b < batch.size(); b++)
+    last[batch[b].index] = b;
+
+  struct Move {
+    const Staged *staged;
+    ChunkLocation from, to;
+  };
+  std::vector<Move> moves;
+  moves.reserve(batch.size());
+
+  // 1. Allocate the sectors. The old ones stay reserved until the new
+  //    locations are durable, so that nothing live is overwritten, unless
+  //    the growth budget of the commit is spent.
+  const uint64_t limit = static_cast<uint64_t>(used.size()) +
+                         options.max_growth;
+  for (size_t b = 0; b < batch.size(); b++) {
+    const Staged &s = batch[b];
+    if (last[s.index] != static_cast<int32_t>(b))
+      continue;
+    Move m{&s, locations[s.index], ChunkLocation()};
+    if (!s.removal) {
+      const uint32_t n = s.payload.sector_count();
+      const bool fits = m.from.exists() && (n <= m.from.sectors);
+      if (fits && (options.reuse_in_place ||
+                   (used.size() + static_cast<uint64_t>(growth(n)) > limit)))
+        m.to = ChunkLocation{m.from.offset, static_cast<uint8_t>(n)};
+      else
+        m.to = ChunkLocation{allocate(n), static_cast<uint8_t>(n)};
+    }
+    moves.push_back(m);
+  }
+
+  // 2. Write the payloads in their sectors
+  std::string buffer;
+  for (const Move &m : moves) {
+    if (m.staged->removal)
+      continue;
+    const ChunkPayload &p = m.staged->payload;
+    buffer.assign(static_cast<size_t>(m.to.sectors) * SECTOR_SIZE, '\0');
+    const uint32_t length = TO_BIG_ENDIAN<uint32_t>(p.data.size() + 1);
+    std::memcpy(buffer.data(), &length, sizeof(length));
+    buffer[4] = static_cast<char>(p.compression);
+    std::memcpy(buffer.data() + CHUNK_PAYLOAD_HEADER, p.data.data(),
+                p.data.size());
+    write_at(buffer.data(), buffer.size(),
+             static_cast<uint64_t>(m.to.offset) * SECTOR_SIZE);
+  }
+  flush();
+
+  // 3. Update the timestamps first, so that a crash can only make a chunk
+  //    look modified, never the opposite
+  uint32_t table[REGION_CHUNK_COUNT];
+  for (const Move &m : moves)
+    timestamps[m.staged->index] = m.staged->timestamp;
+  for (uint16_t i = 0; i < REGION_CHUNK_COUNT; i++)
+    table[i] = TO_BIG_ENDIAN<uint32_t>(timestamps[i]);
+  write_at(table, SECTOR_SIZE, SECTOR_SIZE);
+  flush();
+
+  // 4. Switch the locations to the new payloads
+  for (const Move &m : moves)
+    locations[m.staged->index] = m.to;
+  for (uint16_t i = 0; i < REGION_CHUNK_COUNT; i++)
+    table[i] = TO_BIG_ENDIAN<uint32_t>((locations[i].offset << 8) |
+                                       locations[i].sectors);
+  write_at(table, SECTOR_SIZE, 0);
+  flush();
+
+  // 5. Release the sectors which are not referenced anymore
+  for (const Move &m : moves) {
+    if (!m.from.exists())
+      continue;
+    if (m.from.offset == m.to.offset)
+      mark(m.to.offset + m.to.sectors, m.from.sectors - m.to.sectors, false);
+    else
+      mark(m.from.offset, m.from.sectors, false);
+  }
+  uint32_t end = used.size();
+  while ((end > REGION_HEADER_SECTORS) && !used[end - 1])
+    end--;
+  if (end < used.size()) {
+    if (ftruncate(fd, static_cast<off_t>(end) * SECTOR_SIZE) != 0)
+      throw FileIOError(std::strerror(errno));
+    used.resize(end);
+  }
+
+  batch.clear();
+}
+
+// ============================================================================
+//    Internal methods
+// ============================================================================
+
+uint32_t RegionFile::allocate(uint32_t count) {
+  uint32_t run = 0;
+  for (uint32_t s = REGION_HEADER_SECTORS; s < used.size(); s++) {
+    run = used[s] ? 0 : run + 1;
+    if (run == count) {
+      mark(s + 1 - count, count, true);
+      return s + 1 - count;
+    }
+  }
+
+  // Extend the file, reusing the free sectors at its end
+  const uint32_t offset = used.size() - run;
+  used.resize(offset + count, false);
+  mark(offset, count, true);
+  return offset;
+}
+
+uint32_t RegionFile::growth(uint32_t count) const {
+  uint32_t run = 0;
+  for (uint32_t s = REGION_HEADER_SECTORS; s < used.size(); s++) {
+    run = used[s] ? 0 : run + 1;
+    if (run == count)
+      return 0;
+  }
+  return count - run;
+}
+
+void RegionFile::mark(uint32_t offset, uint32_t count, bool value) {
+  for (uint32_t s = offset; (s < offset + count) && (s < used.size()); s++)
+    used[s] = value;
+}
+
+void RegionFile::write_at(const void *data, size_t size, uint64_t offset) {
+  const char *ptr = static_cast<const char *>(data);
+  while (size > 0) {
+    const ssize_t n = ::pwrite(fd, ptr, size, static_cast<off_t>(offset));
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      throw FileIOError(fmt::format("cannot write \"{}\": {}", path,
+                                    std::strerror(errno)));
+    }
+    ptr += n;
+    size -= n;
+    offset += n;
+  }
+}
+
+void RegionFile::read_at(void *data, size_t size, uint64_t offset) const {
+  char *ptr = static_cast<char *>(data);
+  while (size > 0) {
+    const ssize_t n = ::pread(fd, ptr, size, static_cast<off_t>(offset));
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      throw FileIOError(fmt::format("cannot read \"{}\": {}", path,
+                                    std::strerror(errno)));
+    }
+    if (n == 0)
+      throw FileIOError(fmt::format("unexpected end of \"{}\"", path));
+    ptr += n;
+    size -= n;
+    offset += n;
+  }
+}
+
+void RegionFile::flush() {
+  if (options.sync && (::fsync(fd) != 0))
+    throw FileIOError(
+        fmt::format("cannot sync \"{}\": {}", path, std::strerror(errno)));
+}
+
+} // namespace solis::world
@@ -0,0 +1,56 @@
+#include "solis/world/saver.hpp"
+#include "solis/world/anvil.hpp"
+#include <exception>
+#include <filesystem>
+
+namespace solis::world {
+
+void ChunkSaver::save(const DirtyRegion &region) const {
+  const auto path =
+      std::filesystem::path(region_dir) / RegionFile::filename(region.coord);
+  RegionFile file(path.string(), true, options);
+  for (const auto &d : region.chunks) {
+    const uint16_t i = RegionFile::index(d.chunk->coord);
+    Chunk::SharedPtr chunk = d.chunk;
+
+    // Patch the chunk on the disk when the chunk was not decoded from it
+    ChunkPayload payload;
+    if ((chunk->get_source() == nullptr) && file.read_chunk(i, payload)) {
+      chunk = chunk->snapshot();
+      chunk->set_source(
+          std::make_shared<const std::string>(Anvil::inflate(payload)));
+    }
+    file.stage_chunk(i, encoder(*chunk, d.sections));
+  }
+  file.commit();
+}
+
+size_t ChunkSaver::save(const std::vector<DirtyRegion> &dirty) const {
+  size_t saved = 0;
+  for (const auto &region : dirty) {
+    save(region);
+    saved += region.chunks.size();
+  }
+  return saved;
+}
+
+size_t ChunkSaver::save(Dimension &dimension) const {
+  size_t saved = 0;
+  std::exception_ptr error;
+  for (const auto &region : dimension.collect_dirty()) {
+    try {
+      save(region);
+      saved += region.chunks.size();
+    } catch (...) {
+      // Keep the chunks of the failed region for the next save
+      dimension.restore_dirty(region);
+      if (!error)
+        error = std::current_exception();
+    }
+  }
+  if (error)
+    std::rethrow_exception(error);
+  return saved;
+}
+
+} // namespace solis::world
@@ -0,0 +1,263 @@
+#include "solis/world/section.hpp"
+#include <algorithm>
+
+namespace solis::world {
+
+// ============================================================================
+//    Constructor
+// ============================================================================
+
+Section::Section(Palette palette, Indices indices)
+    : palette(std::move(palette)), indices(std::move(indices)) {
+  if (this->palette.empty())
+    this->palette.push_back(nullptr);
+  if (!this->indices.empty())
+    this->indices.resize(SECTION_VOLUME, 0);
+}
+
+// ============================================================================
+//    Block methods
+// ============================================================================
+
+bool Section::set_block(uint16_t i, const Block *block) {
+  if (get_block(i) == block)
+    return false;
+
+  auto it = std::find(palette.begin(), palette.end(), block);
+  if (it == palette.end()) {
+    // Stale entries can only pile up to the section volume
+    if (palette.size() >= SECTION_VOLUME) {
+      compact();
+      // Still full: each entry is used by a single block, so the entry of
+      // the replaced block can be reused
+      if (palette.size() >= SECTION_VOLUME) {
+        palette[indices[i]] = block;
+        return true;
+      }
+    }
+    it = palette.insert(palette.end(), block);
+  }
+
+  if (indices.empty())
+    indices.assign(SECTION_VOLUME, 0);
+  indices[i] = static_cast<PaletteIndex_t>(it - palette.begin());
+  return true;
+}
+
+void Section::fill(const Block *block) {
+  palette.assign(1, block);
+  Indices().swap(indices);
+}
+
+PaletteIndex_t Section::palette_index(const Block *block) {
+  auto it = std::find(palette.begin(), palette.end(), block);
+  if (it != palette.end())
+    return static_cast<PaletteIndex_t>(it - palette.begin());
+  // When still full, the palette grows past the section volume: the entries
+  // the caller leaves unused are dropped by the next compaction
+  if (palette.size() >= SECTION_VOLUME)
+    compact();
+  if (indices.empty())
+    indices.assign(SECTION_VOLUME, 0);
+  palette.push_back(block);
+  return static_cast<PaletteIndex_t>(palette.size() - 1);
+}
+
+void Section::fill(const Block *block, const SectionBox &box) {
+  if (box.is_full() || (indices.empty() && (palette[0] == block))) {
+    fill(block);
+    return;
+  }
+  const PaletteIndex_t p = palette_index(block);
+  for (InChunkCoord_t y = box.y0; y <= box.y1; y++)
+    for (InChunkCoord_t z = box.z0; z <= box.z1; z++) {
+      PaletteIndex_t *row = indices.data() + index(0, y, z);
+      std::fill(row + box.x0, row + box.x1 + 1, p);
+    }
+}
+
+bool Section::replace(const Block *from, const Block *to) {
+  auto f = std::find(palette.begin(), palette.end(), from);
+  if ((f == palette.end()) || (from == to))
+    return false;
+  auto t = std::find(palette.begin(), palette.end(), to);
+  if (t == palette.end()) {
+    *f = to;
+    return true;
+  }
+
+  // Both are in the palette: the entry of `from` becomes stale
+  const PaletteIndex_t pf = static_cast<PaletteIndex_t>(f - palette.begin());
+  const PaletteIndex_t pt = static_cast<PaletteIndex_t>(t - palette.begin());
+  for (auto &i : indices)
+    i = (i == pf) ? pt : i;
+  return true;
+}
+
+bool Section::replace(const Block *from, const Block *to,
+                      const SectionBox &box) {
+  if (box.is_full())
+    return replace(from, to);
+  if ((from == to) ||
+      (std::find(palette.begin(), palette.end(), from) == palette.end()))
+    return false;
+  // Adding `to` may compact the palette first
+  const PaletteIndex_t pt = palette_index(to);
+  auto f = std::find(palette.begin(), palette.end(), from);
+  if (f == palette.end())
+    return false;
+  const PaletteIndex_t pf = static_cast<PaletteIndex_t>(f - palette.begin());
+  for (InChunkCoord_t y = box.y0; y <= box.y1; y++)
+    for (InChunkCoord_t z = box.z0; z <= box.z1; z++) {
+      PaletteIndex_t *row = indices.data() + index(0, y, z);
+      for (InChunkCoord_t x = box.x0; x <= box.x1; x++)
+        row[x] = (row[x] == pf) ? pt : row[x];
+    }
+  return true;
+}
+
+void Section::compact() {
+  if (indices.empty()) {
+    palette.resize(1);
+    return;
+  }
+
+  // Remap the used entries in their first-use order
+  constexpr PaletteIndex_t UNUSED{static_cast<PaletteIndex_t>(-1)};
+  std::vector<PaletteIndex_t> remap(palette.size(), UNUSED);
+  Palette used;
+  for (auto &i : indices) {
+    if (remap[i] == UNUSED) {
+      remap[i] = used.size();
+      used.push_back(palette[i]);
+    }
+    i = remap[i];
+  }
+
+  palette.swap(used);
+  if (palette.size() == 1)
+    Indices().swap(indices);
+}
+
+bool Section::is_compact() const {
+  if (indices.empty())
+    return palette.size() == 1;
+  size_t next = 0;
+  for (const auto i : indices) {
+    if (i > next)
+      return false;
+    if (i == next)
+      next++;
+  }
+  return (next == palette.size()) && (next > 1);
+}
+
+// ============================================================================
+//    Scan methods
+// ============================================================================
+
+/**
+ * @brief Buffer of the current thread for the hits of a palette, one byte
+ * per entry. Palettes may exceed the section volume (see palette_index).
+ */
+static uint8_t *hit_buffer(size_t size) {
+  thread_local std::vector<uint8_t> hits;
+  if (hits.size() < size)
+    hits.resize(size);
+  return hits.data();
+}
+
+/**
+ * @brief Evaluate a flag predicate over a palette, one byte (0 or 1) per
+ * entry.
+ * @return the number of matching entries
+ */
+static size_t match_palette(const Section::Palette &palette, FlagL_t flags,
+                            FlagL_t excluded, uint8_t *hits) {
+  size_t n = 0;
+  for (size_t p = 0; p < palette.size(); p++) {
+    const FlagL_t f = Block::flags_of(palette[p]);
+    hits[p] = has_flag(f, flags) && ((f & excluded) == 0);
+    n += hits[p];
+  }
+  return n;
+}
+
+uint16_t Section::count(FlagL_t flags, FlagL_t excluded) const {
+  uint8_t *hits = hit_buffer(palette.size());
+  const size_t n = match_palette(palette, flags, excluded, hits);
+  if (indices.empty() || (n == palette.size()))
+    return (n == 0) ? 0 : SECTION_VOLUME;
+  if (n == 0)
+    return 0;
+
+  // Gather and sum, without branches so that it vectorizes
+  uint32_t total = 0;
+  const PaletteIndex_t *idx = indices.data();
+  for (uint16_t i = 0; i < SECTION_VOLUME; i++)
+    total += hits[idx[i]];
+  return static_cast<uint16_t>(total);
+}
+
+bool Section::any(FlagL_t flags, FlagL_t excluded) const {
+  uint8_t *hits = hit_buffer(palette.size());
+  const size_t n = match_palette(palette, flags, excluded, hits);
+  if (indices.empty() || (n == 0) || (n == palette.size()))
+    return n != 0;
+
+  // Stale palette entries may match without being used
+  const PaletteIndex_t *idx = indices.data();
+  for (uint16_t w = 0; w < SECTION_VOLUME; w += 64) {
+    uint8_t hit = 0;
+    for (uint8_t b = 0; b < 64; b++)
+      hit |= hits[idx[w + b]];
+    if (hit != 0)
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Mark the blocks whose palette entry is a hit.
+ * @return the number of marked blocks
+ */
+static uint16_t pack_hits(const Section::Indices &indices, size_t palette_size,
+                          const uint8_t *hits, size_t n,
+                          Section::BlockMask &out) {
+  if (indices.empty() || (n == 0) || (n == palette_size)) {
+    const bool all = (n != 0);
+    out.fill(all ? ~static_cast<uint64_t>(0) : 0);
+    return all ? SECTION_VOLUME : 0;
+  }
+
+  // Pack 64 blocks per word, without branches so that it vectorizes
+  uint32_t total = 0;
+  const PaletteIndex_t *idx = indices.data();
+  for (size_t w = 0; w < out.size(); w++) {
+    uint64_t bits = 0;
+    for (uint8_t b = 0; b < 64; b++)
+      bits |= static_cast<uint64_t>(hits[idx[w * 64 + b]]) << b;
+    out[w] = bits;
+    total += __builtin_popcountll(bits);
+  }
+  return static_cast<uint16_t>(total);
+}
+
+uint16_t Section::match(BlockMask &out, FlagL_t flags,
+                        FlagL_t excluded) const {
+  uint8_t *hits = hit_buffer(palette.size());
+  const size_t n = match_palette(palette, flags, excluded, hits);
+  return pack_hits(indices, palette.size(), hits, n, out);
+}
+
+uint16_t Section::match(BlockMask &out, const Block *block) const {
+  uint8_t *hits = hit_buffer(palette.size());
+  size_t n = 0;
+  for (size_t p = 0; p < palette.size(); p++) {
+    hits[p] = (palette[p] == block);
+    n += hits[p];
+  }
+  return pack_hits(indices, palette.size(), hits, n, out);
+}
+
+} // namespace solis::world
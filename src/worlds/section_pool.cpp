@@ -0,0 +1,118 @@
+#include "solis/world/section_pool.hpp"
+#include "solis/utils/common.hpp"
+#include <algorithm>
+
+namespace solis::world {
+
+// ============================================================================
+//    Hashing
+// ============================================================================
+
+/**
+ * @brief Mix a word into a hash.
+ */
+static inline uint64_t mix(uint64_t h, uint64_t v) {
+  h ^= v + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2);
+  return h * 0xff51afd7ed558ccd;
+}
+
+uint64_t SectionPool::hash(const Section &section) {
+  const Section::Palette &palette = section.get_palette();
+  const Section::Indices &indices = section.get_indices();
+  uint64_t h = mix(0, palette.size());
+  for (const Block *block : palette)
+    h = mix(h, reinterpret_cast<uintptr_t>(block));
+  if (indices.empty())
+    return h;
+
+  // Four indices per word
+  const PaletteIndex_t *idx = indices.data();
+  for (size_t i = 0; i < indices.size(); i += 4) {
+    uint64_t word = 0;
+    for (uint8_t k = 0; k < 4; k++)
+      word |= static_cast<uint64_t>(idx[i + k]) << (16 * k);
+    h = mix(h, word);
+  }
+  return h;
+}
+
+// ============================================================================
+//    Pool methods
+// ============================================================================
+
+Section::ConstSharedPtr
+SectionPool::intern(const Section::SharedPtr &section) {
+  if (section == nullptr)
+    return nullptr;
+  lookups++;
+
+  // Sections differing by their unused palette entries share a canonical form.
+  // A section held by others (e.g. read by a snapshot) is compacted as a copy
+  Section::SharedPtr candidate;
+  if (section->is_compact())
+    candidate = section;
+  else {
+    candidate = is_sole_owner(section) ? section
+                                       : std::make_shared<Section>(*section);
+    candidate->compact();
+  }
+
+  const uint64_t h = hash(*candidate);
+  Shard &shard = shards[h % SHARD_COUNT];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto [first, last] = shard.sections.equal_range(h);
+  for (auto it = first; it != last; it++) {
+    if (it->second == candidate)
+      return candidate;
+    if ((it->second->get_palette() == candidate->get_palette()) &&
+        (it->second->get_indices() == candidate->get_indices())) {
+      hits++;
+      saved_bytes += section->memory_usage();
+      return it->second;
+    }
+  }
+
+  // Amortize the purges over the insertions
+  if (shard.sections.size() >= shard.purge_at) {
+    purge(shard);
+    shard.purge_at = std::max<size_t>(64, shard.sections.size() * 2);
+  }
+  shard.sections.emplace(h, candidate);
+  return candidate;
+}
+
+size_t SectionPool::purge(Shard &shard) {
+  size_t dropped = 0;
+  for (auto it = shard.sections.begin(); it != shard.sections.end();) {
+    if (it->second.use_count() == 1) {
+      it = shard.sections.erase(it);
+      dropped++;
+    } else
+      it++;
+  }
+  return dropped;
+}
+
+size_t SectionPool::purge() {
+  size_t dropped = 0;
+  for (Shard &shard : shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    dropped += purge(shard);
+  }
+  return dropped;
+}
+
+size_t SectionPool::size() const {
+  size_t n = 0;
+  for (const Shard &shard : shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    n += shard.sections.size();
+  }
+  return n;
+}
+
+SectionPoolStats SectionPool::get_stats() const {
+  return SectionPoolStats{lookups, hits, size(), saved_bytes};
+}
+
+} // namespace solis::world
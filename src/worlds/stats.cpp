@@ -0,0 +1,158 @@
+#include "solis/world/stats.hpp"
+#include "solis/utils/thread_pool.hpp"
+#include "solis/world/anvil.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+
+namespace solis::world {
+
+// ============================================================================
+//    Histogram
+// ============================================================================
+
+void BlockHistogram::add(const Section &section, SectionIndex y, bool by_y) {
+  const Section::Palette &palette = section.get_palette();
+  const Section::Indices &indices = section.get_indices();
+  const BlockCoordinate_t y0 = static_cast<BlockCoordinate_t>(y) * CHUNK_SIZE;
+  sections++;
+
+  if (section.is_uniform()) {
+    total[palette[0]] += SECTION_VOLUME;
+    if (by_y)
+      for (InChunkCoord_t l = 0; l < CHUNK_SIZE; l++)
+        this->by_y[y0 + l][palette[0]] += CHUNK_SIZE * CHUNK_SIZE;
+    return;
+  }
+
+  // Count the indices of each layer, then weight the palette entries
+  constexpr uint16_t LAYER = CHUNK_SIZE * CHUNK_SIZE;
+  thread_local std::vector<uint32_t> counts;
+  const size_t n = palette.size();
+  const uint8_t layers = by_y ? CHUNK_SIZE : 1;
+  counts.assign(n * layers, 0);
+  if (by_y) {
+    for (uint16_t i = 0; i < SECTION_VOLUME; i++)
+      counts[(i / LAYER) * n + indices[i]]++;
+  } else {
+    for (uint16_t i = 0; i < SECTION_VOLUME; i++)
+      counts[indices[i]]++;
+  }
+
+  for (uint8_t l = 0; l < layers; l++) {
+    Counts *layer = by_y ? &this->by_y[y0 + l] : nullptr;
+    for (size_t p = 0; p < n; p++) {
+      const uint32_t c = counts[l * n + p];
+      if (c == 0)
+        continue;
+      total[palette[p]] += c;
+      if (layer != nullptr)
+        (*layer)[palette[p]] += c;
+    }
+  }
+}
+
+void BlockHistogram::add(const Chunk &chunk, bool by_y) {
+  chunks++;
+  for (const auto &[y, section] : chunk)
+    if (section != nullptr)
+      add(*section, y, by_y);
+}
+
+void BlockHistogram::merge(const BlockHistogram &other) {
+  for (const auto &[block, n] : other.total)
+    total[block] += n;
+  for (const auto &[y, counts] : other.by_y) {
+    Counts &layer = by_y[y];
+    for (const auto &[block, n] : counts)
+      layer[block] += n;
+  }
+  chunks += other.chunks;
+  sections += other.sections;
+}
+
+uint64_t BlockHistogram::count(const Block *block) const {
+  if (auto it = total.find(block); it != total.end())
+    return it->second;
+  return 0;
+}
+
+std::vector<std::pair<const Block *, uint64_t>> BlockHistogram::sorted() const {
+  std::vector<std::pair<const Block *, uint64_t>> out(total.begin(),
+                                                      total.end());
+  std::sort(out.begin(), out.end(),
+            [](const auto &a, const auto &b) { return a.second > b.second; });
+  return out;
+}
+
+// ============================================================================
+//    Scanners
+// ============================================================================
+
+BlockHistogram BlockStats::scan(const Dimension &dimension,
+                                const StatsOptions &options) {
+  std::vector<const Chunk *> chunks;
+  for (const auto &region : dimension.get_regions())
+    for (const auto &chunk : *region)
+      if (!options.filter || options.filter(chunk->coord))
+        chunks.push_back(chunk.get());
+  std::vector<const ColdChunk *> cold;
+  for (const auto &[coord, chunk] : dimension.get_cold_chunks())
+    if (!options.filter || options.filter(coord))
+      cold.push_back(chunk.get());
+
+  // One histogram per task, merged once the task is done
+  ThreadPool pool(options.threads);
+  BlockHistogram result;
+  std::mutex result_mutex;
+  const size_t tasks =
+      std::min(chunks.size() + cold.size(), pool.size() * 4);
+  for (size_t t = 0; t < tasks; t++) {
+    pool.submit([&, t] {
+      BlockHistogram local;
+      for (size_t i = t; i < chunks.size(); i += tasks)
+        local.add(*chunks[i], options.by_y);
+      // The compressed chunks are inflated one at a time, and not thawed
+      for (size_t i = t; i < cold.size(); i += tasks)
+        local.add(*cold[i]->inflate(), options.by_y);
+      std::lock_guard<std::mutex> lock(result_mutex);
+      result.merge(local);
+    });
+  }
+  pool.wait();
+  return result;
+}
+
+BlockHistogram BlockStats::scan_directory(const std::string &region_dir,
+                                          const StatsOptions &options,
+                                          BlockRegistry &registry) {
+  namespace fs = std::filesystem;
+
+  ThreadPool pool(options.threads);
+  BlockHistogram result;
+  std::mutex result_mutex;
+  for (const auto &entry : fs::directory_iterator(region_dir)) {
+    RegionCoordinate coord;
+    if (!entry.is_regular_file() ||
+        !RegionFile::parse_filename(entry.path().filename().string(), coord))
+      continue;
+    pool.submit([&, coord, path = entry.path().string()] {
+      RegionFile file(path);
+      BlockHistogram local;
+      for (uint16_t i = 0; i < REGION_CHUNK_COUNT; i++) {
+        if (!file.has_chunk(i) ||
+            (options.filter &&
+             !options.filter(RegionFile::chunk_coordinate(coord, i))))
+          continue;
+        if (auto chunk = Anvil::read(file, i, registry); chunk != nullptr)
+          local.add(*chunk, options.by_y);
+      }
+      std::lock_guard<std::mutex> lock(result_mutex);
+      result.merge(local);
+    });
+  }
+  pool.wait();
+  return result;
+}
+
+} // namespace solis::world
@@ -0,0 +1,234 @@
+#include "solis/world/transcoder.hpp"
+#include "solis/utils/errors.hpp"
+#include "solis/utils/thread_pool.hpp"
+#include "solis/world/anvil.hpp"
+#include "solis/world/compactor.hpp"
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+
+namespace solis::world {
+
+namespace fs = std::filesystem;
+typedef std::chrono::steady_clock Clock;
+
+// ============================================================================
+//    Reports
+// ============================================================================
+
+std::string CodecSetting::name() const {
+  switch (compression) {
+  case CompressionType::GZIP:
+    return fmt::format("gzip-{}", level);
+  case CompressionType::ZLIB:
+    return fmt::format("zlib-{}", level);
+  case CompressionType::ZLIB_DICT:
+    return fmt::format("zlib-dict-{}", level);
+  case CompressionType::NONE:
+    return "none";
+  case CompressionType::LZ4:
+    return "lz4";
+  default:
+    return fmt::format("unknown({})", compression);
+  }
+}
+
+void CodecReport::merge(const CodecReport &other) {
+  chunks += other.chunks;
+  raw_bytes += other.raw_bytes;
+  bytes += other.bytes;
+  sectors += other.sectors;
+  encode_seconds += other.encode_seconds;
+  decode_seconds += other.decode_seconds;
+}
+
+std::string CodecReport::summary() const {
+  return fmt::format("{:<12} {:>8} chunks  ratio {:6.2f}  {:>10} sectors  "
+                     "encode {:8.1f} MB/s  decode {:8.1f} MB/s",
+                     setting.name(), chunks, ratio(), sectors,
+                     encode_throughput(), decode_throughput());
+}
+
+/**
+ * @brief Compress a chunk NBT with a setting, measuring it.
+ */
+static ChunkPayload encode(const std::string &nbt, const CodecSetting &setting,
+                           bool measure_decode, CodecReport &report) {
+  const auto t0 = Clock::now();
+  ChunkPayload payload = Anvil::compress(nbt, setting.compression,
+                                         setting.level,
+                                         setting.dictionary.get());
+  const auto t1 = Clock::now();
+  report.encode_seconds += std::chrono::duration<double>(t1 - t0).count();
+  if (measure_decode) {
+    (void)Anvil::inflate(payload, setting.dictionary.get());
+    report.decode_seconds +=
+        std::chrono::duration<double>(Clock::now() - t1).count();
+  }
+  report.chunks++;
+  report.raw_bytes += nbt.size();
+  report.bytes += payload.data.size();
+  report.sectors += payload.sector_count();
+  return payload;
+}
+
+/**
+ * @brief Reject the settings the ZLib wrapper cannot encode.
+ */
+static void check_setting(const CodecSetting &setting) {
+  const bool dict = (setting.compression == CompressionType::ZLIB_DICT) &&
+                    (setting.dictionary != nullptr);
+  if ((setting.compression != CompressionType::GZIP) &&
+      (setting.compression != CompressionType::ZLIB) &&
+      (setting.compression != CompressionType::NONE) && !dict)
+    throw SolisError(
+        fmt::format("unsupported transcoding target {}", setting.name()));
+}
+
+/**
+ * @brief List the region files of a directory.
+ */
+static std::vector<fs::path> list_regions(const std::string &dir) {
+  std::vector<fs::path> paths;
+  for (const auto &entry : fs::directory_iterator(dir)) {
+    RegionCoordinate coord;
+    if (entry.is_regular_file() &&
+        RegionFile::parse_filename(entry.path().filename().string(), coord))
+      paths.push_back(entry.path());
+  }
+  return paths;
+}
+
+// ============================================================================
+//    Transcode methods
+// ============================================================================
+
+void Transcoder::transcode_file(const std::string &from, const std::string &to,
+                                const CodecSetting &target,
+                                CodecReport &report,
+                                const TranscodeOptions &options) {
+  check_setting(target);
+  RegionFile source(from);
+  const std::string tmp = to + ".tmp";
+  fs::remove(tmp);
+  try {
+    {
+      RegionFile out(tmp, true);
+      for (const uint16_t i : RegionCompactor::z_order()) {
+        ChunkPayload payload;
+        if (!source.read_chunk(i, payload))
+          continue;
+        CodecReport measured{target};
+        ChunkPayload encoded =
+            encode(Anvil::inflate(payload, options.source_dictionary.get()),
+                   target, options.measure_decode, measured);
+        // Keep the chunks too large for the new setting as they were
+        if (encoded.sector_count() > CHUNK_MAX_SECTORS) {
+          encoded = std::move(payload);
+          measured.bytes = encoded.data.size();
+          measured.sectors = encoded.sector_count();
+        }
+        report.merge(measured);
+        out.stage_chunk(i, std::move(encoded), source.get_timestamp(i));
+      }
+      out.commit();
+    }
+    fs::rename(tmp, to);
+  } catch (...) {
+    std::error_code ignored;
+    fs::remove(tmp, ignored);
+    throw;
+  }
+}
+
+CodecReport Transcoder::transcode_directory(const std::string &from,
+                                            const std::string &to,
+                                            const CodecSetting &target,
+                                            const TranscodeOptions &options) {
+  check_setting(target);
+  fs::create_directories(to);
+
+  std::mutex mutex;
+  CodecReport total{target};
+  ThreadPool pool(options.threads);
+  for (const fs::path &path : list_regions(from)) {
+    pool.submit([&, path] {
+      CodecReport report{target};
+      transcode_file(path.string(), (fs::path(to) / path.filename()).string(),
+                     target, report, options);
+      std::lock_guard<std::mutex> lock(mutex);
+      total.merge(report);
+    });
+  }
+  pool.wait();
+  return total;
+}
+
+// ============================================================================
+//    Benchmark methods
+// ============================================================================
+
+std::vector<CodecReport>
+Transcoder::benchmark_directory(const std::string &dir,
+                                const std::vector<CodecSetting> &settings,
+                                const TranscodeOptions &options) {
+  for (const CodecSetting &setting : settings)
+    check_setting(setting);
+
+  std::mutex mutex;
+  std::vector<CodecReport> totals;
+  for (const CodecSetting &setting : settings)
+    totals.push_back(CodecReport{setting});
+
+  ThreadPool pool(options.threads);
+  for (const fs::path &path : list_regions(dir)) {
+    pool.submit([&, path] {
+      std::vector<CodecReport> reports;
+      for (const CodecSetting &setting : settings)
+        reports.push_back(CodecReport{setting});
+
+      RegionFile file(path.string());
+      size_t sampled = 0;
+      for (uint16_t i = 0; i < REGION_CHUNK_COUNT; i++) {
+        ChunkPayload payload;
+        if ((options.max_chunks != 0) && (sampled >= options.max_chunks))
+          break;
+        if (!file.read_chunk(i, payload))
+          continue;
+        const std::string nbt =
+            Anvil::inflate(payload, options.source_dictionary.get());
+        for (size_t s = 0; s < settings.size(); s++)
+          encode(nbt, settings[s], options.measure_decode, reports[s]);
+        sampled++;
+      }
+
+      std::lock_guard<std::mutex> lock(mutex);
+      for (size_t s = 0; s < settings.size(); s++)
+        totals[s].merge(reports[s]);
+    });
+  }
+  pool.wait();
+  return totals;
+}
+
+ZDictionary::SharedPtr
+Transcoder::train_dictionary(const std::string &dir, size_t per_region,
+                             size_t size, const TranscodeOptions &options) {
+  std::vector<std::string> samples;
+  for (const fs::path &path : list_regions(dir)) {
+    RegionFile file(path.string());
+    size_t sampled = 0;
+    for (uint16_t i = 0; (i < REGION_CHUNK_COUNT) && (sampled < per_region);
+         i++) {
+      ChunkPayload payload;
+      if (!file.read_chunk(i, payload))
+        continue;
+      samples.push_back(
+          Anvil::inflate(payload, options.source_dictionary.get()));
+      sampled++;
+    }
+  }
+  return ZDictionary::train(samples, size);
+}
+
+} // namespace solis::world
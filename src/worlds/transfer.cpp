@@ -0,0 +1,176 @@
+#include "solis/world/transfer.hpp"
+#include "solis/utils/errors.hpp"
+#include "solis/utils/thread_pool.hpp"
+#include "solis/world/anvil.hpp"
+#include <filesystem>
+
+namespace solis::world {
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+//    Candidates
+// ============================================================================
+
+const ChunkPayload &ChunkCandidate::payload() const {
+  if (!read) {
+    read.emplace();
+    if (!file.read_chunk(index, *read))
+      throw FileIOError(fmt::format("chunk {} vanished from \"{}\"", index,
+                                    file.get_path()));
+  }
+  return *read;
+}
+
+const std::string &ChunkCandidate::nbt() const {
+  if (!inflated)
+    inflated = Anvil::inflate(payload(), dictionary);
+  return *inflated;
+}
+
+/**
+ * @brief Coordinates of a region from the name of its file.
+ */
+static RegionCoordinate region_of(const std::string &path) {
+  RegionCoordinate coord;
+  if (!RegionFile::parse_filename(fs::path(path).filename().string(), coord))
+    throw SolisError(fmt::format("\"{}\" is not a region file name", path));
+  return coord;
+}
+
+/**
+ * @brief Run a filter on a chunk.
+ *
+ * @param payload filled with the payload, if the filter read it
+ * @return true if the chunk is kept
+ */
+static bool accept(const ChunkFilter &filter, const RegionCoordinate &region,
+                   const RegionFile &file, uint16_t i,
+                   std::optional<ChunkPayload> &payload, TransferStats &stats,
+                   const TransferOptions &options) {
+  if (!filter)
+    return true;
+  ChunkCandidate candidate{RegionFile::chunk_coordinate(region, i),
+                           i,
+                           file.get_timestamp(i),
+                           file,
+                           options.dictionary.get(),
+                           {},
+                           {}};
+  const bool keep = filter(candidate);
+  if (candidate.is_read())
+    stats.read++;
+  if (candidate.is_inflated())
+    stats.inflated++;
+  payload = std::move(candidate.read);
+  return keep;
+}
+
+// ============================================================================
+//    File methods
+// ============================================================================
+
+void ChunkTransfer::merge_file(const std::string &from, const std::string &to,
+                               TransferStats &stats, const ChunkFilter &filter,
+                               const TransferOptions &options) {
+  stats.regions++;
+  const RegionCoordinate region = region_of(from);
+  RegionFile source(from);
+  RegionFile target(to, true);
+  for (uint16_t i = 0; i < REGION_CHUNK_COUNT; i++) {
+    if (!source.has_chunk(i))
+      continue;
+    const uint32_t timestamp = source.get_timestamp(i);
+    if (target.has_chunk(i) &&
+        ((options.conflict == MergeConflict::KEEP) ||
+         ((options.conflict == MergeConflict::NEWEST) &&
+          (target.get_timestamp(i) >= timestamp)))) {
+      stats.skipped++;
+      continue;
+    }
+
+    std::optional<ChunkPayload> payload;
+    if (!accept(filter, region, source, i, payload, stats, options)) {
+      stats.skipped++;
+      continue;
+    }
+    // Payloads the filter already read are not read again
+    uint64_t bytes = 0;
+    if (payload) {
+      bytes = payload->data.size();
+      target.stage_chunk(i, std::move(*payload), timestamp);
+    } else if (!target.stage_copy(source, i, i, &bytes))
+      continue;
+    stats.copied++;
+    stats.bytes += bytes;
+  }
+  target.commit();
+}
+
+void ChunkTransfer::trim_file(const std::string &path, TransferStats &stats,
+                              const ChunkFilter &filter,
+                              const TransferOptions &options) {
+  stats.regions++;
+  const RegionCoordinate region = region_of(path);
+  size_t kept = 0;
+  {
+    RegionFile file(path, true);
+    for (uint16_t i = 0; i < REGION_CHUNK_COUNT; i++) {
+      if (!file.has_chunk(i))
+        continue;
+      std::optional<ChunkPayload> payload;
+      if (accept(filter, region, file, i, payload, stats, options))
+        kept++;
+      else {
+        file.stage_removal(i);
+        stats.removed++;
+      }
+    }
+    file.commit();
+  }
+  if (kept == 0)
+    fs::remove(path);
+}
+
+// ============================================================================
+//    Directory methods
+// ============================================================================
+
+void ChunkTransfer::merge_directory(const std::string &from,
+                                    const std::string &to,
+                                    TransferStats &stats,
+                                    const ChunkFilter &filter,
+                                    const TransferOptions &options) {
+  fs::create_directories(to);
+  ThreadPool pool(options.threads);
+  for (const auto &entry : fs::directory_iterator(from)) {
+    RegionCoordinate coord;
+    if (!entry.is_regular_file() ||
+        !RegionFile::parse_filename(entry.path().filename().string(), coord))
+      continue;
+    pool.submit([path = entry.path(), &to, &stats, &filter, &options] {
+      merge_file(path.string(), (fs::path(to) / path.filename()).string(),
+                 stats, filter, options);
+    });
+  }
+  pool.wait();
+}
+
+void ChunkTransfer::trim_directory(const std::string &dir,
+                                   TransferStats &stats,
+                                   const ChunkFilter &filter,
+                                   const TransferOptions &options) {
+  ThreadPool pool(options.threads);
+  for (const auto &entry : fs::directory_iterator(dir)) {
+    RegionCoordinate coord;
+    if (!entry.is_regular_file() ||
+        !RegionFile::parse_filename(entry.path().filename().string(), coord))
+      continue;
+    pool.submit([path = entry.path().string(), &stats, &filter, &options] {
+      trim_file(path, stats, filter, options);
+    });
+  }
+  pool.wait();
+}
+
+} // namespace solis::world
@@ -0,0 +1,190 @@
+#include "solis/nbt/document.hpp"
+#include "solis/world/anvil.hpp"
+#include "solis/world/saver.hpp"
+#include <cstdio>
+#include <doctest.h>
+
+using namespace solis;
+using namespace solis::world;
+using nbt::Document;
+using nbt::Node;
+using nbt::TagType;
+
+/**
+ * @brief Section compound holding a single block state.
+ */
+static Node *uniform_section(Document &doc, int8_t y, std::string_view name) {
+  Node *state = doc.make_node(TagType::COMPOUND);
+  state->set("Name", doc.make_string(name));
+  Node *palette = doc.make_list(TagType::COMPOUND);
+  palette->list().push_back(state);
+  Node *states = doc.make_node(TagType::COMPOUND);
+  states->set("palette", palette);
+
+  Node *section = doc.make_node(TagType::COMPOUND);
+  section->set("Y", doc.make_int(TagType::BYTE, y));
+  section->set("block_states", states);
+  Node *biomes = doc.make_node(TagType::COMPOUND);
+  Node *biome_palette = doc.make_list(TagType::STRING);
+  biome_palette->list().push_back(doc.make_string("minecraft:desert"));
+  biomes->set("palette", biome_palette);
+  section->set("biomes", biomes);
+  return section;
+}
+
+/**
+ * @brief Chunk NBT as written by the game, with the data solis does not
+ * model.
+ */
+static std::string game_chunk() {
+  Document doc;
+  Node &root = doc.root();
+  root.set("DataVersion", doc.make_int(TagType::INT, 3465));
+  root.set("xPos", doc.make_int(TagType::INT, 5));
+  root.set("zPos", doc.make_int(TagType::INT, -7));
+  root.set("yPos", doc.make_int(TagType::INT, -4));
+  root.set("Status", doc.make_string("minecraft:features"));
+  root.set("InhabitedTime", doc.make_int(TagType::LONG, 1234));
+  root.set("LastUpdate", doc.make_int(TagType::LONG, 5678));
+
+  Node *chest = doc.make_node(TagType::COMPOUND);
+  chest->set("id", doc.make_string("minecraft:chest"));
+  Node *block_entities = doc.make_list(TagType::COMPOUND);
+  block_entities->list().push_back(chest);
+  root.set("block_entities", block_entities);
+  root.set("PostProcessing", doc.make_list(TagType::LIST));
+  root.set("structures", doc.make_node(TagType::COMPOUND));
+
+  Node *sections = doc.make_list(TagType::COMPOUND);
+  Node *below = doc.make_node(TagType::COMPOUND);
+  below->set("Y", doc.make_int(TagType::BYTE, -5));
+  const std::vector<int8_t> sky(LightArray::BYTES, 0x77);
+  below->set("SkyLight", doc.make_array(sky.data(), sky.size()));
+  sections->list().push_back(below);
+  sections->list().push_back(uniform_section(doc, 0, "minecraft:stone"));
+  sections->list().push_back(uniform_section(doc, 25, "minecraft:dirt"));
+  root.set("sections", sections);
+
+  Node *heightmaps = doc.make_node(TagType::COMPOUND);
+  const std::vector<int64_t> zeros(37, 0);
+  heightmaps->set("WORLD_SURFACE_WG",
+                  doc.make_array(zeros.data(), zeros.size()));
+  root.set("Heightmaps", heightmaps);
+  return doc.serialize();
+}
+
+static const Node *find_section(const Node &root, int8_t y) {
+  for (const Node *section : root.get("sections")->list())
+    if (section->get("Y")->as_int() == y)
+      return section;
+  return nullptr;
+}
+
+/**
+ * @brief Decoder options keeping the chunk NBT.
+ */
+static AnvilReadOptions keep_source() {
+  AnvilReadOptions options;
+  options.keep_source = true;
+  return options;
+}
+
+TEST_CASE("anvil: sources are only kept on demand") {
+  CHECK(Anvil::decode(game_chunk())->get_source() == nullptr);
+  auto chunk = Anvil::decode(game_chunk(), BlockRegistry::global(), nullptr,
+                             keep_source());
+  REQUIRE(chunk->get_source() != nullptr);
+  CHECK(*chunk->get_source() == game_chunk());
+}
+
+TEST_CASE("anvil: encoding patches the source chunk") {
+  auto &registry = BlockRegistry::global();
+  auto chunk = Anvil::decode(game_chunk(), registry, nullptr, keep_source());
+  REQUIRE(chunk->get_source() != nullptr);
+  REQUIRE(chunk->get_section(25) != nullptr);
+  chunk->set_block(1, 2, 3, registry.get("minecraft:glass"));
+  chunk->set_block(4, -60, 5, registry.get("minecraft:gold_block"));
+
+  auto doc = Document::parse(Anvil::encode(*chunk));
+  const Node &root = doc->root();
+  CHECK(root.get("Status")->as_string() == "minecraft:features");
+  CHECK(root.get("InhabitedTime")->as_int() == 1234);
+  CHECK(root.get("LastUpdate")->as_int() == 5678);
+  CHECK(root.get("block_entities")->list().size() == 1);
+  CHECK(root.get("PostProcessing") != nullptr);
+  CHECK(root.get("structures") != nullptr);
+  CHECK(root.get("Heightmaps")->get("WORLD_SURFACE_WG") != nullptr);
+  CHECK(root.get("Heightmaps")->get("MOTION_BLOCKING") != nullptr);
+
+  // Sections out of the world range and their other tags are kept
+  const Node *below = find_section(root, -5);
+  REQUIRE(below != nullptr);
+  CHECK(below->get("block_states") == nullptr);
+  const Node *above = find_section(root, 25);
+  REQUIRE(above != nullptr);
+  CHECK(above->get("biomes") != nullptr);
+  const Node *edited = find_section(root, 0);
+  REQUIRE(edited != nullptr);
+  CHECK(edited->get("biomes")->get("palette")->list()[0]->as_string() ==
+        "minecraft:desert");
+  REQUIRE(find_section(root, -4) != nullptr);
+
+  auto decoded = Anvil::decode(doc->serialize());
+  CHECK(decoded->coord.x == 5);
+  CHECK(decoded->coord.z == -7);
+  CHECK(decoded->get_block(1, 2, 3) == registry.get("minecraft:glass"));
+  CHECK(decoded->get_block(0, 0, 0) == registry.get("minecraft:stone"));
+  CHECK(decoded->get_block(4, -60, 5) ==
+        registry.get("minecraft:gold_block"));
+  CHECK(decoded->get_block(0, 400, 0) == registry.get("minecraft:dirt"));
+  REQUIRE(decoded->get_light() != nullptr);
+  CHECK(decoded->get_light()->at(-5).sky.get(0) == 7);
+}
+
+TEST_CASE("anvil: chunks without source are written as full chunks") {
+  auto chunk = std::make_shared<Chunk>();
+  chunk->coord = ChunkCoordinate(1, 2);
+  chunk->set_block(0, 10, 0, BlockRegistry::global().get("minecraft:stone"));
+
+  auto doc = Document::parse(Anvil::encode(*chunk));
+  const Node &root = doc->root();
+  CHECK(root.get("Status")->as_string() == "minecraft:full");
+  CHECK(root.get("yPos")->as_int() == -4);
+  CHECK(root.get("isLightOn")->as_int() == 0);
+  REQUIRE(find_section(root, 0) != nullptr);
+}
+
+TEST_CASE("anvil: the saver patches the chunk stored in the region") {
+  const std::string dir = "/tmp";
+  auto chunk = Anvil::decode(game_chunk(), BlockRegistry::global(), nullptr,
+                             keep_source());
+  const RegionCoordinate region(0, -1);
+  const std::string path = dir + "/" + RegionFile::filename(region);
+  std::remove(path.c_str());
+  {
+    RegionFile file(path, true);
+    file.stage_chunk(RegionFile::index(chunk->coord),
+                     Anvil::compress(*chunk->get_source(),
+                                     CompressionType::ZLIB));
+    file.commit();
+  }
+
+  // A chunk rebuilt without its source (e.g. from a native cache)
+  auto rebuilt = chunk->snapshot();
+  rebuilt->set_source(nullptr);
+  rebuilt->set_block(0, 0, 0, BlockRegistry::global().get("minecraft:glass"));
+  ChunkSaver saver(dir, [](const Chunk &c, const Chunk::SectionMask &) {
+    return Anvil::deflate(c);
+  });
+  saver.save(DirtyRegion{region, {DirtyChunk{rebuilt, {}}}});
+
+  auto saved = Anvil::read(RegionFile(path), RegionFile::index(chunk->coord),
+                           BlockRegistry::global(), nullptr, keep_source());
+  REQUIRE(saved != nullptr);
+  auto doc = Document::parse(*saved->get_source());
+  CHECK(doc->root().get("Status")->as_string() == "minecraft:features");
+  CHECK(doc->root().get("block_entities")->list().size() == 1);
+  CHECK(saved->get_block(0, 0, 0) ==
+        BlockRegistry::global().get("minecraft:glass"));
+  std::remove(path.c_str());
+}
@@ -0,0 +1,43 @@
+#include "solis/resources/registry.hpp"
+#include <doctest.h>
+
+using namespace solis;
+
+static FlagL_t flags(std::string_view state) {
+  return BlockRegistry::global().get(state)->flags;
+}
+
+TEST_CASE("block: vanilla blocks get their flags from the table") {
+  for (const char *plant : {"minecraft:allium", "minecraft:cornflower",
+                            "minecraft:sunflower", "minecraft:oxeye_daisy",
+                            "minecraft:nether_wart", "minecraft:melon_stem",
+                            "minecraft:light", "minecraft:structure_void"}) {
+    CHECK_FALSE(has_flag(flags(plant), Block::SOLID));
+    CHECK(has_flag(flags(plant), Block::TRANSPARENT));
+  }
+  CHECK(has_flag(flags("minecraft:mushroom_stem"), Block::SOLID));
+  CHECK(has_flag(flags("minecraft:end_portal_frame"), Block::SOLID));
+  CHECK_FALSE(has_flag(flags("minecraft:water_cauldron"), Block::WATER));
+  CHECK_FALSE(has_flag(flags("minecraft:bubble_coral_block"), Block::WATER));
+  CHECK(flags("minecraft:stone") == Block::SOLID);
+  CHECK(has_flag(flags("minecraft:water"), Block::WATER | Block::DIFFUSING));
+  CHECK(has_flag(flags("minecraft:lava"), Block::LAVA | Block::HAZARD));
+  CHECK(has_flag(flags("minecraft:oak_leaves"), Block::DIFFUSING));
+  CHECK(has_flag(flags("minecraft:air"), Block::AIR | Block::REPLACEABLE));
+}
+
+TEST_CASE("block: states and unknown blocks") {
+  CHECK(has_flag(flags("minecraft:oak_stairs[waterlogged=true]"),
+                 Block::SOLID | Block::WATERLOGGED | Block::WATER));
+  CHECK(has_flag(flags("minecraft:campfire[lit=true]"), Block::HAZARD));
+  CHECK_FALSE(has_flag(flags("minecraft:campfire[lit=false]"), Block::HAZARD));
+
+  CHECK(flags("minecraft:oak_button[face=wall]") == Block::TRANSPARENT);
+  CHECK(flags("minecraft:white_stained_glass_pane") ==
+        (Block::SOLID | Block::TRANSPARENT));
+  CHECK(flags("minecraft:potted_allium") == Block::TRANSPARENT);
+  CHECK(flags("minecraft:red_concrete_powder") ==
+        (Block::SOLID | Block::FALLING));
+  CHECK(flags("minecraft:polished_andesite_stairs") == Block::SOLID);
+  CHECK(flags("somemod:water_flower") == Block::SOLID);
+}
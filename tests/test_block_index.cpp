@@ -0,0 +1,125 @@
+#include "solis/world/block_index.hpp"
+#include "solis/world/dimension.hpp"
+#include <algorithm>
+#include <doctest.h>
+#include <filesystem>
+
+using namespace solis;
+using namespace solis::world;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Chunk with a block at its bottom corner.
+ */
+static Chunk::SharedPtr chunk_with(const ChunkCoordinate &coord,
+                                   const Block *block) {
+  auto chunk = std::make_shared<Chunk>();
+  chunk->coord = coord;
+  chunk->set_block(0, 0, 0, block);
+  chunk->clear_dirty();
+  return chunk;
+}
+
+TEST_CASE("block index: edits are found, and indexed again only once") {
+  auto &registry = BlockRegistry::global();
+  const Block *stone = registry.get("minecraft:stone");
+  const Block *glass = registry.get("minecraft:glass");
+  Dimension dim(Dimension::OVERWORLD, "overworld");
+  dim.add_chunk(chunk_with(ChunkCoordinate(0, 0), stone));
+  dim.add_chunk(chunk_with(ChunkCoordinate(1, 0), stone));
+  dim.set_block_index(BlockIndex::make());
+  CHECK(dim.find_blocks(glass).empty());
+
+  CHECK(dim.set_block(BlockCoordinate(1, 2, 3), glass));
+  CHECK(dim.find_blocks(glass).size() == 1);
+  // Later edits of the still dirty chunk are found too
+  CHECK(dim.set_block(BlockCoordinate(4, 5, 6), glass));
+  CHECK(dim.find_blocks(glass).size() == 2);
+
+  // Queries without edit in between do not index the chunk again
+  const ChunkCoordinate coord(0, 0);
+  auto index = dim.get_block_index();
+  index->remove_chunk(coord);
+  CHECK_FALSE(dim.get_block_index()->has_chunk(coord));
+  CHECK(dim.set_block(BlockCoordinate(7, 8, 9), stone));
+  CHECK(dim.get_block_index()->has_chunk(coord));
+  CHECK(dim.find_blocks(stone).size() == 3);
+
+  // Saved chunks are dropped from the pending ones, then edited again
+  dim.collect_dirty();
+  CHECK(dim.find_blocks(glass).size() == 2);
+  CHECK(dim.set_block(BlockCoordinate(1, 2, 3), nullptr));
+  CHECK(dim.find_blocks(glass).size() == 1);
+}
+
+static bool same_sections(const BlockIndex::SectionSet &a,
+                          const BlockIndex::SectionSet &b) {
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                    [](const SectionKey &k, const SectionKey &l) {
+                      return !(k < l) && !(l < k);
+                    });
+}
+
+TEST_CASE("block index: files round-trip") {
+  auto &registry = BlockRegistry::global();
+  const Block *stone = registry.get("minecraft:stone");
+  const Block *glass = registry.get("minecraft:glass");
+  BlockIndex index;
+  auto chunk = chunk_with(ChunkCoordinate(-3, 7), stone);
+  chunk->set_block(0, 40, 0, glass);
+  index.add_chunk(*chunk, 1000);
+  index.add_chunk(*chunk_with(ChunkCoordinate(5, -2), glass), 2000);
+
+  const std::string path =
+      (fs::temp_directory_path() / "solis_test_block_index.blocks").string();
+  index.save(path);
+  BlockIndex loaded;
+  REQUIRE(loaded.load(path));
+  CHECK(loaded.chunk_count() == 2);
+  CHECK(same_sections(loaded.find(stone), index.find(stone)));
+  CHECK(same_sections(loaded.find(glass), index.find(glass)));
+  CHECK(loaded.find(glass).size() == 2);
+  CHECK(loaded.find_chunks(stone).size() == 1);
+
+  // Truncated files are rejected, and leave the index untouched
+  fs::resize_file(path, fs::file_size(path) - 3);
+  CHECK_FALSE(loaded.load(path));
+  CHECK(loaded.chunk_count() == 2);
+  fs::remove(path);
+  CHECK_FALSE(loaded.load(path));
+}
+
+TEST_CASE("block index: validation drops the chunks saved since indexed") {
+  const fs::path dir = fs::temp_directory_path() / "solis_test_index_world";
+  fs::remove_all(dir);
+  fs::create_directories(dir / "region");
+  {
+    // Chunks 0 and 1 saved at 100, chunk 2 at 300
+    RegionFile file(
+        (dir / "region" / RegionFile::filename(RegionCoordinate(0, 0)))
+            .string(),
+        true);
+    for (const auto &[i, timestamp] :
+         {std::pair<uint16_t, uint32_t>{0, 100}, {1, 100}, {2, 300}})
+      file.stage_chunk(i, ChunkPayload{CompressionType::ZLIB, "payload"},
+                       timestamp);
+    file.commit();
+  }
+  WorldManifest manifest;
+  REQUIRE(manifest.refresh(dir.string()) == 1);
+
+  const Block *stone = BlockRegistry::global().get("minecraft:stone");
+  BlockIndex index;
+  index.add_chunk(*chunk_with(ChunkCoordinate(0, 0), stone), 200);
+  index.add_chunk(*chunk_with(ChunkCoordinate(2, 0), stone), 200);
+  index.add_chunk(*chunk_with(ChunkCoordinate(9, 9), stone), 200);
+
+  const auto missing = index.validate(*manifest.get_dimension("overworld"));
+  CHECK(index.has_chunk(ChunkCoordinate(0, 0)));
+  CHECK_FALSE(index.has_chunk(ChunkCoordinate(2, 0)));
+  CHECK_FALSE(index.has_chunk(ChunkCoordinate(9, 9)));
+  CHECK(index.find_chunks(stone).size() == 1);
+  REQUIRE(missing.size() == 2);
+  CHECK(missing[0].x + missing[1].x == 3);
+  fs::remove_all(dir);
+}
@@ -0,0 +1,69 @@
+#include "solis/world/anvil.hpp"
+#include "solis/world/chunk.hpp"
+#include "solis/world/section_pool.hpp"
+#include <doctest.h>
+
+using namespace solis;
+using namespace solis::world;
+
+TEST_CASE("chunk: heightmaps reach the bottom of the world") {
+  const Block *stone = BlockRegistry::global().get("minecraft:stone");
+  auto chunk = std::make_shared<Chunk>();
+  chunk->set_block(0, 40, 0, stone);
+  CHECK(chunk->get_height(WORLD_SURFACE, 0, 0) == 41);
+  CHECK(chunk->get_height(WORLD_SURFACE, 1, 0) == -64);
+
+  // Below the lowest section present when the heightmaps were built
+  chunk->set_block(1, -60, 0, stone);
+  CHECK(chunk->get_height(WORLD_SURFACE, 1, 0) == -59);
+  chunk->set_block(1, -60, 0, nullptr);
+  CHECK(chunk->get_height(WORLD_SURFACE, 1, 0) == -64);
+  chunk->set_block(2, -61, 0, stone);
+
+  auto decoded = Anvil::decode(Anvil::encode(*chunk));
+  CHECK(decoded->get_min_section() == -4);
+  REQUIRE(decoded->get_cached_heightmaps() != nullptr);
+  CHECK(decoded->get_height(WORLD_SURFACE, 0, 0) == 41);
+  CHECK(decoded->get_height(WORLD_SURFACE, 1, 0) == -64);
+  CHECK(decoded->get_height(WORLD_SURFACE, 2, 0) == -60);
+}
+
+TEST_CASE("chunk: the bottom of the world follows the chunk") {
+  const Block *stone = BlockRegistry::global().get("minecraft:stone");
+  auto chunk = std::make_shared<Chunk>();
+  chunk->set_min_section(0);
+  chunk->set_block(0, 10, 0, stone);
+  CHECK(chunk->get_height(WORLD_SURFACE, 1, 1) == 0);
+
+  AnvilWriteOptions options;
+  options.min_section = 0;
+  options.max_section = 15;
+  auto decoded = Anvil::decode(Anvil::encode(*chunk, options));
+  CHECK(decoded->get_min_section() == 0);
+  CHECK(decoded->get_height(WORLD_SURFACE, 0, 0) == 11);
+  CHECK(decoded->get_height(WORLD_SURFACE, 1, 1) == 0);
+}
+
+// The sections can only be written through edit_section
+static_assert(
+    std::is_same_v<decltype(std::declval<const Chunk &>().get_section(0)),
+                   Section::ConstSharedPtr>);
+static_assert(std::is_same_v<Chunk::mapped_type, Section::ConstSharedPtr>);
+
+TEST_CASE("chunk: edits never reach the pooled sections") {
+  auto &registry = BlockRegistry::global();
+  SectionPool pool;
+  auto a = std::make_shared<Chunk>();
+  auto b = std::make_shared<Chunk>();
+  const Block *stone = registry.get("minecraft:stone");
+  a->set_section(0, pool.intern(Section::make(stone)));
+  b->set_section(0, pool.intern(Section::make(stone)));
+  REQUIRE(a->get_section(0) == b->get_section(0));
+
+  a->set_block(0, 0, 0, registry.get("minecraft:glass"));
+  a->edit_section(0)->set_block(1, registry.get("minecraft:dirt"));
+  CHECK(a->get_section(0) != b->get_section(0));
+  CHECK(b->get_block(0, 0, 0) == stone);
+  CHECK(b->get_section(0)->is_uniform());
+  CHECK(a->get_block(0, 0, 0) == registry.get("minecraft:glass"));
+}
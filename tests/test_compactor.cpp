@@ -0,0 +1,181 @@
+#include "solis/utils/files.hpp"
+#include "solis/world/anvil.hpp"
+#include "solis/world/compactor.hpp"
+#include <algorithm>
+#include <doctest.h>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+
+using namespace solis;
+using namespace solis::world;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Region file removed at the end of the test.
+ */
+struct TempCompactRegion {
+  fs::path dir;
+  std::string path;
+
+  explicit TempCompactRegion(const char *name)
+      : dir(fs::temp_directory_path() / (std::string("solis_test_") + name)),
+        path((dir / RegionFile::filename(RegionCoordinate(0, 0))).string()) {
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+  }
+  ~TempCompactRegion() { fs::remove_all(dir); }
+};
+
+/**
+ * @brief Uncompressed payload of a chunk, spanning some sectors.
+ */
+static ChunkPayload payload(uint16_t i, size_t size) {
+  std::string data;
+  while (data.size() < size)
+    data += fmt::format("chunk {} at {};", i, data.size());
+  return ChunkPayload{CompressionType::NONE, data};
+}
+
+/// Chunks of the fragmented file, with their payload sizes
+static const std::vector<std::pair<uint16_t, size_t>> CHUNKS{
+    {1023, 300}, {33, 9000}, {2, 100}, {32, 5000}, {1, 200}, {0, 100}};
+
+/**
+ * @brief Region file whose chunks are out of order, with holes.
+ */
+static void save_fragmented(const std::string &path) {
+  RegionFile file(path, true);
+  for (const auto &[i, size] : CHUNKS)
+    file.stage_chunk(i, payload(i, size), 100 + i);
+  file.stage_chunk(500, payload(500, 9000));
+  file.commit();
+  // The first chunks grow and move to the end of the file, 500 leaves a hole
+  file.stage_removal(500);
+  file.stage_chunk(1023, payload(1023, 6000), 100 + 1023);
+  file.stage_chunk(33, payload(33, 10000), 100 + 33);
+  file.commit();
+}
+
+TEST_CASE("compactor: chunks are stored contiguously in Z-order") {
+  const auto &order = RegionCompactor::z_order();
+  CHECK(std::vector<uint16_t>(order.begin(), order.begin() + 8) ==
+        std::vector<uint16_t>{0, 1, 32, 33, 2, 3, 34, 35});
+  auto sorted = order;
+  std::sort(sorted.begin(), sorted.end());
+  for (uint16_t i = 0; i < REGION_CHUNK_COUNT; i++)
+    REQUIRE(sorted[i] == i);
+
+  TempCompactRegion tmp("compactor_order");
+  save_fragmented(tmp.path);
+  const uint64_t before = fs::file_size(tmp.path);
+  CompactStats stats;
+  REQUIRE(RegionCompactor::compact_file(tmp.path, stats));
+  CHECK(stats.regions == 1);
+  CHECK(stats.rewritten == 1);
+  CHECK(stats.chunks == CHUNKS.size());
+  CHECK(stats.bytes_before == before);
+  CHECK(stats.bytes_after == fs::file_size(tmp.path));
+  CHECK(stats.bytes_after < before);
+
+  RegionFile file(tmp.path);
+  uint32_t next = REGION_HEADER_SECTORS;
+  size_t count = 0;
+  for (const uint16_t i : order) {
+    if (!file.has_chunk(i))
+      continue;
+    count++;
+    CHECK(file.get_location(i).offset == next);
+    next += file.get_location(i).sectors;
+  }
+  CHECK(count == CHUNKS.size());
+  CHECK(fs::file_size(tmp.path) == static_cast<uint64_t>(next) * SECTOR_SIZE);
+
+  // The payloads and timestamps are kept
+  for (const auto &[i, size] : CHUNKS) {
+    ChunkPayload read;
+    REQUIRE(file.read_chunk(i, read));
+    const size_t grown = (i == 1023) ? 6000 : (i == 33) ? 10000 : size;
+    CHECK(read.data == payload(i, grown).data);
+    CHECK(file.get_timestamp(i) == 100u + i);
+  }
+}
+
+TEST_CASE("compactor: compact files are left in place") {
+  TempCompactRegion tmp("compactor_in_place");
+  save_fragmented(tmp.path);
+  CompactStats stats;
+  REQUIRE(RegionCompactor::compact_file(tmp.path, stats));
+  const FileStamp stamp = FileStamp::of(tmp.path);
+
+  CHECK_FALSE(RegionCompactor::compact_file(tmp.path, stats));
+  CHECK(FileStamp::of(tmp.path) == stamp);
+  CHECK(stats.regions == 2);
+  CHECK(stats.rewritten == 1);
+  CHECK(stats.skipped == 0);
+
+  CompactOptions options;
+  options.force = true;
+  CHECK(RegionCompactor::compact_file(tmp.path, stats, options));
+  CHECK(fs::file_size(tmp.path) == stamp.size);
+
+  // Trailing sectors are removed
+  std::ofstream(tmp.path, std::ios::app) << std::string(SECTOR_SIZE, 'x');
+  CHECK(RegionCompactor::compact_file(tmp.path, stats));
+  CHECK(fs::file_size(tmp.path) == stamp.size);
+
+  // Recompressed payloads are rewritten
+  options.force = false;
+  options.recompress = true;
+  CHECK(RegionCompactor::compact_file(tmp.path, stats, options));
+  CHECK(stats.recompressed == CHUNKS.size());
+  CHECK(fs::file_size(tmp.path) < stamp.size);
+  ChunkPayload read;
+  REQUIRE(RegionFile(tmp.path).read_chunk(2, read));
+  CHECK(read.compression == CompressionType::ZLIB);
+  CHECK(Anvil::inflate(read) == payload(2, 100).data);
+}
+
+TEST_CASE("compactor: files modified or unreadable are skipped") {
+  TempCompactRegion tmp("compactor_skip");
+  save_fragmented(tmp.path);
+
+  // A chunk saved while the file is compacted is not lost
+  CompactOptions options;
+  options.on_read = [](const std::string &path) {
+    RegionFile file(path, true);
+    file.stage_chunk(700, payload(700, 100));
+    file.commit();
+  };
+  CompactStats stats;
+  CHECK_FALSE(RegionCompactor::compact_file(tmp.path, stats, options));
+  CHECK(stats.skipped == 1);
+  CHECK(stats.rewritten == 0);
+  RegionFile file(tmp.path);
+  CHECK(file.has_chunk(700));
+  CHECK(file.get_location(1023).offset != REGION_HEADER_SECTORS);
+
+  // Corrupted chunk
+  {
+    std::fstream out(tmp.path, std::ios::in | std::ios::out | std::ios::binary);
+    out.seekp(static_cast<std::streamoff>(file.get_location(2).offset) *
+              SECTOR_SIZE);
+    out.write("\0\0\0\0", 4);
+  }
+  const FileStamp stamp = FileStamp::of(tmp.path);
+  CHECK_FALSE(RegionCompactor::compact_file(tmp.path, stats));
+  CHECK(stats.skipped == 2);
+  CHECK(FileStamp::of(tmp.path) == stamp);
+
+  // The other files of a directory are still compacted
+  save_fragmented((tmp.dir / RegionFile::filename(RegionCoordinate(1, 0)))
+                      .string());
+  std::ofstream(tmp.dir / "r.2.0.mca.bak") << "not a region";
+  CompactStats all;
+  options.on_read = nullptr;
+  options.threads = 2;
+  RegionCompactor::compact_directory(tmp.dir.string(), all, options);
+  CHECK(all.regions == 2);
+  CHECK(all.skipped == 1);
+  CHECK(all.rewritten == 1);
+}
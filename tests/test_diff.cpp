@@ -0,0 +1,204 @@
+#include "solis/world/anvil.hpp"
+#include "solis/world/diff.hpp"
+#include <algorithm>
+#include <doctest.h>
+#include <filesystem>
+
+using namespace solis;
+using namespace solis::world;
+namespace fs = std::filesystem;
+
+TEST_CASE("diff: sections are compared block by block or by their fill") {
+  auto &registry = BlockRegistry::global();
+  const Block *stone = registry.get("minecraft:stone");
+  const Block *dirt = registry.get("minecraft:dirt");
+  SectionDiff out;
+
+  Section a, b;
+  CHECK_FALSE(WorldDiff::diff_sections(nullptr, nullptr, out));
+  CHECK_FALSE(WorldDiff::diff_sections(&a, nullptr, out));
+  a.set_block(5, stone);
+  a.set_block(300, dirt);
+  b.set_block(5, stone);
+  b.set_block(300, dirt);
+  CHECK_FALSE(WorldDiff::diff_sections(&a, &b, out));
+
+  // Changes are listed by increasing index
+  b.set_block(300, stone);
+  b.set_block(2, dirt);
+  REQUIRE(WorldDiff::diff_sections(&a, &b, out));
+  CHECK(out.kind == DiffKind::CHANGED);
+  CHECK(out.fill == nullptr);
+  REQUIRE(out.changes.size() == 2);
+  CHECK(out.changes[0].index == 2);
+  CHECK(out.changes[0].from == nullptr);
+  CHECK(out.changes[0].to == dirt);
+  CHECK(out.changes[1].index == 300);
+  CHECK(out.changes[1].from == dirt);
+  CHECK(out.changes[1].to == stone);
+
+  // Sections appearing are compared against air
+  REQUIRE(WorldDiff::diff_sections(nullptr, &a, out));
+  CHECK(out.kind == DiffKind::ADDED);
+  CHECK(out.changes.size() == 2);
+
+  // Uniform sections only give their fill
+  Section filled;
+  filled.fill(stone);
+  REQUIRE(WorldDiff::diff_sections(&a, &filled, out));
+  CHECK(out.kind == DiffKind::FILLED);
+  CHECK(out.fill == stone);
+  CHECK(out.changes.empty());
+  REQUIRE(WorldDiff::diff_sections(nullptr, &filled, out));
+  CHECK(out.kind == DiffKind::ADDED);
+  CHECK(out.fill == stone);
+  CHECK(out.changes.empty());
+  REQUIRE(WorldDiff::diff_sections(&a, nullptr, out));
+  CHECK(out.kind == DiffKind::REMOVED);
+  CHECK(out.fill == nullptr);
+  Section refilled;
+  refilled.fill(dirt);
+  refilled.fill(stone);
+  CHECK_FALSE(WorldDiff::diff_sections(&refilled, &filled, out));
+}
+
+TEST_CASE("diff: chunks are compared section by section") {
+  auto &registry = BlockRegistry::global();
+  const Block *stone = registry.get("minecraft:stone");
+  Chunk from, to;
+  from.set_block(0, 0, 0, stone);
+  from.set_block(0, 40, 0, stone);
+  to.set_block(0, 0, 0, stone);
+  to.set_block(1, 0, 0, stone);
+  to.set_block(0, 20, 0, stone);
+  to.set_block(0, -64, 0, stone);
+
+  ChunkDiff out;
+  REQUIRE(WorldDiff::diff_chunks(from, to, out));
+  REQUIRE(out.sections.size() == 4);
+  CHECK(out.sections[0].y == -4);
+  CHECK(out.sections[0].kind == DiffKind::ADDED);
+  CHECK(out.sections[1].y == 0);
+  CHECK(out.sections[1].kind == DiffKind::CHANGED);
+  REQUIRE(out.sections[1].changes.size() == 1);
+  CHECK(out.sections[1].changes[0].index == Section::index(1, 0, 0));
+  CHECK(out.sections[2].y == 1);
+  CHECK(out.sections[2].kind == DiffKind::ADDED);
+  CHECK(out.sections[3].y == 2);
+  CHECK(out.sections[3].kind == DiffKind::REMOVED);
+  CHECK_FALSE(WorldDiff::diff_chunks(to, to, out));
+  CHECK(out.sections.empty());
+}
+
+/**
+ * @brief Old and new copies of a region directory, removed at the end.
+ */
+struct TempCopies {
+  fs::path from, to;
+
+  TempCopies()
+      : from(fs::temp_directory_path() / "solis_test_diff_from"),
+        to(fs::temp_directory_path() / "solis_test_diff_to") {
+    for (const auto &dir : {from, to}) {
+      fs::remove_all(dir);
+      fs::create_directories(dir);
+    }
+  }
+  ~TempCopies() {
+    fs::remove_all(from);
+    fs::remove_all(to);
+  }
+
+  /**
+   * @brief Write a region file with chunks holding a block at a height, and
+   * their timestamps.
+   */
+  static void save(const fs::path &dir, const RegionCoordinate &coord,
+                   const std::vector<std::tuple<uint16_t, LayerIndex,
+                                                uint32_t>> &chunks) {
+    RegionFile file((dir / RegionFile::filename(coord)).string(), true);
+    const Block *stone = BlockRegistry::global().get("minecraft:stone");
+    for (const auto &[i, y, timestamp] : chunks) {
+      Chunk chunk;
+      chunk.coord = RegionFile::chunk_coordinate(coord, i);
+      chunk.set_block(0, y, 0, stone);
+      file.stage_chunk(i, Anvil::deflate(chunk), timestamp);
+    }
+    file.commit();
+  }
+};
+
+TEST_CASE("diff: only the chunks changed since the region headers are read") {
+  TempCopies tmp;
+  const RegionCoordinate origin(0, 0);
+  // 0: untouched, 1: rewritten as is, 2: edited without timestamp update,
+  // 3: edited, 4: removed, 5: added
+  TempCopies::save(tmp.from, origin,
+                   {{0, 0, 100}, {1, 0, 100}, {2, 0, 100}, {3, 0, 100},
+                    {4, 0, 100}});
+  TempCopies::save(tmp.to, origin,
+                   {{0, 0, 100}, {1, 0, 200}, {2, 1, 100}, {3, 20, 200},
+                    {5, 0, 200}});
+  TempCopies::save(tmp.from, RegionCoordinate(-1, 0), {{0, 0, 100}});
+  TempCopies::save(tmp.to, RegionCoordinate(1, 0), {{0, 0, 100}});
+  // Not a region file
+  fs::copy_file(tmp.from / RegionFile::filename(origin),
+                tmp.to / "r.0.0.mca.bak");
+
+  auto run = [&tmp](const DiffOptions &options, DiffStats &stats) {
+    std::vector<ChunkDiff> diffs;
+    WorldDiff::diff_directories(
+        tmp.from.string(), tmp.to.string(),
+        [&diffs](const ChunkDiff &diff) { diffs.push_back(diff); }, stats,
+        options);
+    std::sort(diffs.begin(), diffs.end(),
+              [](const ChunkDiff &a, const ChunkDiff &b) {
+                return std::make_pair(a.coord.x, a.coord.z) <
+                       std::make_pair(b.coord.x, b.coord.z);
+              });
+    return diffs;
+  };
+
+  DiffOptions options;
+  options.threads = 2;
+  DiffStats stats;
+  auto diffs = run(options, stats);
+  CHECK(stats.regions == 3);
+  CHECK(stats.compared == 4);
+  CHECK(stats.read == 2);
+  CHECK(stats.decoded == 1);
+  CHECK(stats.different == 5);
+  REQUIRE(diffs.size() == 5);
+  CHECK(diffs[0].coord.x == -32);
+  CHECK(diffs[0].kind == DiffKind::REMOVED);
+  CHECK(diffs[1].coord.x == 3);
+  CHECK(diffs[1].kind == DiffKind::CHANGED);
+  REQUIRE(diffs[1].sections.size() == 2);
+  CHECK(diffs[1].sections[0].kind == DiffKind::REMOVED);
+  CHECK(diffs[1].sections[1].y == 1);
+  CHECK(diffs[1].sections[1].kind == DiffKind::ADDED);
+  REQUIRE(diffs[1].sections[1].changes.size() == 1);
+  CHECK(diffs[1].sections[1].changes[0].index == Section::index(0, 4, 0));
+  CHECK(diffs[2].coord.x == 4);
+  CHECK(diffs[2].kind == DiffKind::REMOVED);
+  CHECK(diffs[2].sections.empty());
+  CHECK(diffs[3].coord.x == 5);
+  CHECK(diffs[3].kind == DiffKind::ADDED);
+  CHECK(diffs[4].coord.x == 32);
+  CHECK(diffs[4].kind == DiffKind::ADDED);
+
+  // Without the timestamps, every common chunk is read
+  options.trust_timestamps = false;
+  DiffStats full;
+  diffs = run(options, full);
+  CHECK(full.compared == 4);
+  CHECK(full.read == 4);
+  CHECK(full.decoded == 2);
+  REQUIRE(diffs.size() == 6);
+  CHECK(diffs[1].coord.x == 2);
+  REQUIRE(diffs[1].sections.size() == 1);
+  CHECK(diffs[1].sections[0].kind == DiffKind::CHANGED);
+  REQUIRE(diffs[1].sections[0].changes.size() == 2);
+  CHECK(diffs[1].sections[0].changes[0].to == nullptr);
+  CHECK(diffs[1].sections[0].changes[1].from == nullptr);
+}
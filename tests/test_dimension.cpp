@@ -0,0 +1,271 @@
+#include "solis/world/dimension.hpp"
+#include "solis/world/raycast.hpp"
+#include "solis/world/stats.hpp"
+#include <doctest.h>
+#include <random>
+#include <thread>
+
+using namespace solis;
+using namespace solis::world;
+
+/**
+ * @brief Dimension of 2x2 chunks, with a stone block at the bottom corner of
+ * each chunk.
+ */
+static Dimension::SharedPtr small_dimension() {
+  auto dim = std::make_shared<Dimension>(Dimension::OVERWORLD, "overworld");
+  const Block *stone = BlockRegistry::global().get("minecraft:stone");
+  for (ChunkCoordinate_t x = 0; x < 2; x++)
+    for (ChunkCoordinate_t z = 0; z < 2; z++) {
+      auto chunk = std::make_shared<Chunk>();
+      chunk->coord = ChunkCoordinate(x, z);
+      chunk->set_block(0, 0, 0, stone);
+      chunk->clear_dirty();
+      dim->add_chunk(chunk);
+    }
+  return dim;
+}
+
+/**
+ * @brief Compress every chunk of a dimension in memory.
+ */
+static size_t freeze(Dimension &dim) {
+  ColdOptions options;
+  options.idle = std::chrono::milliseconds(0);
+  return dim.compress_idle(options);
+}
+
+TEST_CASE("dimension: const readers do not thaw the cold chunks") {
+  auto dim = small_dimension();
+  REQUIRE(freeze(*dim) == 4);
+  const Dimension &readonly = *dim;
+  const Block *stone = BlockRegistry::global().get("minecraft:stone");
+
+  std::vector<std::thread> readers;
+  std::atomic<int> found{0};
+  for (int t = 0; t < 4; t++)
+    readers.emplace_back([&readonly, &found, stone]() {
+      for (int i = 0; i < 16; i++)
+        found += readonly.get_block(BlockCoordinate(16 * (i % 2), 0,
+                                                    16 * (i / 2 % 2))) ==
+                 stone;
+    });
+  for (auto &reader : readers)
+    reader.join();
+  CHECK(found == 64);
+  CHECK(dim->cold_count() == 4);
+  CHECK(readonly.is_chunk_loaded(ChunkCoordinate(1, 1)));
+
+  // The non-const access brings the chunk back into its region
+  auto chunk = dim->get_chunk(ChunkCoordinate(1, 1));
+  REQUIRE(chunk != nullptr);
+  CHECK(dim->cold_count() == 3);
+  CHECK(chunk == dim->get_chunk(ChunkCoordinate(1, 1)));
+  CHECK(dim->set_block(BlockCoordinate(16, 1, 16), stone));
+  CHECK(dim->dirty_count() == 1);
+}
+
+TEST_CASE("dimension: scans and ray casts see the cold chunks") {
+  auto dim = small_dimension();
+  REQUIRE(freeze(*dim) == 4);
+  const Block *stone = BlockRegistry::global().get("minecraft:stone");
+
+  CHECK(BlockStats::scan(*dim).count(stone) == 4);
+  CHECK(RayCaster(*dim).cast(Ray{WorldCoordinate(16.5, 10, 16.5),
+                                 WorldCoordinate(0, -1, 0)})
+            .state == stone);
+  CHECK(RayCaster::cast(*dim, Ray{WorldCoordinate(0.5, 10, 16.5),
+                                  WorldCoordinate(0, -1, 0)})
+            .state == stone);
+  CHECK(dim->cold_count() == 4);
+
+  // Without index, the cold chunks are scanned in place
+  CHECK(dim->find_blocks(stone).size() == 4);
+  CHECK(dim->cold_count() == 4);
+}
+
+TEST_CASE("dimension: air is never found, with or without index") {
+  auto dim = small_dimension();
+  const Block *stone = BlockRegistry::global().get("minecraft:stone");
+  CHECK(dim->find_blocks(nullptr).empty());
+  CHECK(dim->find_blocks(stone).size() == 4);
+
+  dim->set_block_index(BlockIndex::make());
+  CHECK(dim->find_blocks(nullptr).empty());
+  CHECK(dim->find_blocks(stone).size() == 4);
+}
+
+/**
+ * @brief Blocks of the random dimensions, air included.
+ */
+static std::vector<const Block *> bulk_blocks() {
+  auto &registry = BlockRegistry::global();
+  return {nullptr, registry.get("minecraft:stone"),
+          registry.get("minecraft:dirt"), registry.get("minecraft:glass")};
+}
+
+/**
+ * @brief Dimension of 3x3 chunks whose sections -1 to 2 are random.
+ */
+static Dimension::SharedPtr random_dimension(uint32_t seed) {
+  std::mt19937 rng(seed);
+  const auto blocks = bulk_blocks();
+  auto dim = std::make_shared<Dimension>(Dimension::OVERWORLD, "overworld");
+  for (ChunkCoordinate_t x = 0; x < 3; x++)
+    for (ChunkCoordinate_t z = 0; z < 3; z++) {
+      auto chunk = std::make_shared<Chunk>();
+      chunk->coord = ChunkCoordinate(x, z);
+      for (SectionIndex y = -1; y <= 2; y++)
+        if (rng() % 4 == 0)
+          chunk->set_section(y, Section::make(blocks[rng() % blocks.size()]));
+        else if (rng() % 2 == 0)
+          for (uint16_t i = 0; i < SECTION_VOLUME; i++)
+            chunk->set_block(i % CHUNK_SIZE, y * CHUNK_SIZE + i / 256,
+                             (i / CHUNK_SIZE) % CHUNK_SIZE,
+                             blocks[rng() % blocks.size()]);
+      dim->add_chunk(chunk);
+    }
+  return dim;
+}
+
+/**
+ * @brief Random box around the 3x3 chunks, partly out of them.
+ */
+static BlockBox random_box(std::mt19937 &rng) {
+  auto coord = [&rng](int lo, int span) {
+    return static_cast<BlockCoordinate_t>(lo + rng() % span);
+  };
+  // Unordered corners on purpose
+  return BlockBox{BlockCoordinate(coord(-8, 64), coord(-24, 80), coord(-8, 64)),
+                  BlockCoordinate(coord(-8, 64), coord(-24, 80),
+                                  coord(-8, 64))};
+}
+
+/**
+ * @brief Call a function on each block of a box, bounds in any order.
+ */
+template <typename F> static void for_each_block(const BlockBox &box, F f) {
+  for (auto x = std::min(box.min.x, box.max.x);
+       x <= std::max(box.min.x, box.max.x); x++)
+    for (auto y = std::min(box.min.y, box.max.y);
+         y <= std::max(box.min.y, box.max.y); y++)
+      for (auto z = std::min(box.min.z, box.max.z);
+           z <= std::max(box.min.z, box.max.z); z++)
+        f(BlockCoordinate(x, y, z));
+}
+
+static bool same_blocks(const Dimension &a, const Dimension &b) {
+  bool same = true;
+  for_each_block(BlockBox{BlockCoordinate(0, -40, 0),
+                          BlockCoordinate(47, 88, 47)},
+                 [&](const BlockCoordinate &c) {
+                   same = same && (a.get_block(c) == b.get_block(c));
+                 });
+  return same;
+}
+
+TEST_CASE("dimension: bulk edits match per-block edits") {
+  std::mt19937 rng(48);
+  const auto blocks = bulk_blocks();
+  for (uint32_t round = 0; round < 24; round++) {
+    auto bulk = random_dimension(round);
+    auto naive = random_dimension(round);
+    const BlockBox box = random_box(rng);
+
+    switch (round % 3) {
+    case 0: {
+      const Block *block = blocks[rng() % blocks.size()];
+      bulk->fill(box, block);
+      for_each_block(box, [&](const BlockCoordinate &c) {
+        naive->set_block(c, block);
+      });
+      break;
+    }
+    case 1: {
+      const Block *from = blocks[rng() % blocks.size()];
+      const Block *to = blocks[rng() % blocks.size()];
+      bulk->replace(box, from, to);
+      for_each_block(box, [&](const BlockCoordinate &c) {
+        if (naive->is_chunk_loaded(c) && (naive->get_block(c) == from))
+          naive->set_block(c, to);
+      });
+      break;
+    }
+    default: {
+      // Aligned offsets share the sections, the others copy the blocks
+      const BlockCoordinate_t step = (round % 2 == 0) ? CHUNK_SIZE : 1;
+      const BlockCoordinate destination(
+          std::min(box.min.x, box.max.x) + step * (rng() % 3),
+          std::min(box.min.y, box.max.y) - step * (rng() % 2),
+          std::min(box.min.z, box.max.z) + step * (rng() % 3));
+      bulk->copy(box, destination);
+
+      const BlockCoordinate origin(std::min(box.min.x, box.max.x),
+                                   std::min(box.min.y, box.max.y),
+                                   std::min(box.min.z, box.max.z));
+      std::vector<std::pair<BlockCoordinate, const Block *>> copied;
+      for_each_block(box, [&](const BlockCoordinate &c) {
+        if (naive->is_chunk_loaded(c))
+          copied.emplace_back(
+              BlockCoordinate(c.x - origin.x + destination.x,
+                              c.y - origin.y + destination.y,
+                              c.z - origin.z + destination.z),
+              naive->get_block(c));
+      });
+      for (const auto &[c, block] : copied)
+        naive->set_block(c, block);
+    }
+    }
+    CHECK(same_blocks(*bulk, *naive));
+  }
+}
+
+/**
+ * @brief Blocks of the sections -1 to 2 of a chunk, in order.
+ */
+static std::vector<const Block *> blocks_of(const Chunk &chunk) {
+  std::vector<const Block *> out;
+  for (LayerIndex y = -CHUNK_SIZE; y < 3 * CHUNK_SIZE; y++)
+    for (InChunkCoord_t x = 0; x < CHUNK_SIZE; x++)
+      for (InChunkCoord_t z = 0; z < CHUNK_SIZE; z++)
+        out.push_back(chunk.get_block(x, y, z));
+  return out;
+}
+
+TEST_CASE("dimension: edits after a collection leave the snapshots as taken") {
+  auto dim = random_dimension(29);
+  const auto blocks = bulk_blocks();
+  const auto collected = dim->collect_dirty();
+  const auto snapshot = dim->snapshot();
+  REQUIRE(collected.size() == 1);
+  std::vector<std::vector<const Block *>> expected;
+  for (const auto &d : collected.front().chunks)
+    expected.push_back(blocks_of(*d.chunk));
+
+  // The snapshots are read by another thread while the chunks are edited
+  std::atomic<bool> done{false};
+  std::atomic<size_t> changed{0};
+  std::thread saver([&]() {
+    do
+      for (size_t c = 0; c < expected.size(); c++)
+        changed += blocks_of(*collected.front().chunks[c].chunk) !=
+                   expected[c];
+    while (!done);
+  });
+  std::mt19937 rng(30);
+  for (int n = 0; n < 20000; n++)
+    dim->set_block(BlockCoordinate(rng() % 48, rng() % 64 - 16, rng() % 48),
+                   blocks[rng() % blocks.size()]);
+  dim->fill(BlockBox{BlockCoordinate(0, -16, 0), BlockCoordinate(47, 47, 47)},
+            blocks[1]);
+  done = true;
+  saver.join();
+  CHECK(changed == 0);
+
+  for (size_t c = 0; c < expected.size(); c++)
+    CHECK(blocks_of(*collected.front().chunks[c].chunk) == expected[c]);
+  for (const auto &d : collected.front().chunks)
+    CHECK(blocks_of(*snapshot->get_chunk(d.chunk->coord)) ==
+          blocks_of(*d.chunk));
+  CHECK(dim->get_block(BlockCoordinate(5, 5, 5)) == blocks[1]);
+}
@@ -0,0 +1,38 @@
+#include "solis/nbt/document.hpp"
+#include <doctest.h>
+
+using namespace solis;
+using namespace solis::nbt;
+
+TEST_CASE("document: empty lists keep their element type") {
+  Document doc;
+  doc.root().set("empty", doc.make_list(TagType::COMPOUND));
+  doc.root().set("untyped", doc.make_list(TagType::END));
+  const std::string nbt = doc.serialize();
+
+  // Root header (3 bytes), then the header of the first list (8 bytes)
+  REQUIRE(nbt.size() > 11);
+  CHECK(static_cast<TagType>(nbt[11]) == TagType::COMPOUND);
+
+  auto parsed = Document::parse(nbt);
+  CHECK(parsed->root().get("empty")->element_type == TagType::COMPOUND);
+  CHECK(parsed->root().get("untyped")->element_type == TagType::END);
+  CHECK(parsed->serialize() == nbt);
+}
+
+TEST_CASE("document: lists larger than their data are rejected") {
+  // Root compound holding an END list of INT32_MAX elements
+  const std::string untyped("\x0a\x00\x00\x09\x00\x01l\x00\x7f\xff\xff\xff\x00",
+                            13);
+  CHECK_THROWS_AS(Document::parse(untyped), NBTError);
+
+  // Same with a typed list, whose elements would each take a byte at least
+  std::string typed = untyped;
+  typed[7] = static_cast<char>(TagType::COMPOUND);
+  CHECK_THROWS_AS(Document::parse(typed), NBTError);
+
+  // An empty END list stays valid
+  std::string empty = untyped;
+  empty.replace(8, 4, std::string(4, '\0'));
+  CHECK_NOTHROW(Document::parse(empty));
+}
@@ -0,0 +1,48 @@
+#include "solis/utils/files.hpp"
+#include <doctest.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+using namespace solis;
+namespace fs = std::filesystem;
+
+static std::string read_file(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+}
+
+TEST_CASE("files: concurrent atomic writes never mix their content") {
+  const fs::path dir = fs::temp_directory_path() / "solis_test_files";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  const std::string path = (dir / "target").string();
+  write_file_atomic(path, "first");
+  ::chmod(path.c_str(), 0640);
+
+  // Each writer writes its own byte many times over
+  std::vector<std::thread> writers;
+  for (char c = 'a'; c < 'e'; c++)
+    writers.emplace_back([&path, c]() {
+      for (int i = 0; i < 50; i++)
+        write_file_atomic(path, std::string(100000, c));
+    });
+  for (auto &writer : writers)
+    writer.join();
+
+  const std::string content = read_file(path);
+  REQUIRE(content.size() == 100000);
+  CHECK(content.find_first_not_of(content[0]) == std::string::npos);
+
+  // No temporary file is left behind, and the mode is kept
+  CHECK(std::distance(fs::directory_iterator(dir), fs::directory_iterator()) ==
+        1);
+  struct stat st;
+  REQUIRE(::stat(path.c_str(), &st) == 0);
+  CHECK((st.st_mode & 07777) == 0640);
+  fs::remove_all(dir);
+}
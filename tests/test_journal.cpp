@@ -0,0 +1,186 @@
+#include "solis/world/dimension.hpp"
+#include "solis/world/journal.hpp"
+#include <atomic>
+#include <doctest.h>
+#include <thread>
+
+using namespace solis;
+using namespace solis::world;
+
+/**
+ * @brief Fake block address, only compared and never dereferenced.
+ */
+static const Block *fake_block(uint64_t k) {
+  return reinterpret_cast<const Block *>(static_cast<uintptr_t>(k * 16 + 8));
+}
+
+TEST_CASE("journal: concurrent events are neither torn nor out of order") {
+  constexpr int PRODUCERS = 4;
+  constexpr uint64_t EVENTS = 200000;
+  auto journal = ChangeJournal::make(1024);
+  auto subscription = journal->subscribe();
+
+  // Every word of an event derives from the producer and its counter
+  std::atomic<int> running{PRODUCERS};
+  std::vector<std::thread> producers;
+  for (int p = 0; p < PRODUCERS; p++)
+    producers.emplace_back([&journal, &running, p]() {
+      for (uint64_t k = 0; k < EVENTS; k++)
+        journal->record_block(ChunkCoordinate(p, ChunkCoordinate_t(k)),
+                              static_cast<SectionIndex>(k % 24 - 4),
+                              static_cast<uint16_t>(k % SECTION_VOLUME),
+                              fake_block(k), fake_block(k + 1));
+      running--;
+    });
+
+  uint64_t received = 0, torn = 0, unordered = 0;
+  uint64_t last_sequence = 0;
+  int64_t last[PRODUCERS];
+  std::fill(std::begin(last), std::end(last), -1);
+  auto check = [&](const ChangeEvent &e) {
+    const uint64_t k = static_cast<uint64_t>(e.coord.z);
+    if ((e.kind != ChangeEvent::BLOCK) || (e.coord.x < 0) ||
+        (e.coord.x >= PRODUCERS) ||
+        (e.y != static_cast<SectionIndex>(k % 24 - 4)) ||
+        (e.index != k % SECTION_VOLUME) || (e.old != fake_block(k)) ||
+        (e.block != fake_block(k + 1))) {
+      torn++;
+      return;
+    }
+    if (((received > 0) && (e.sequence <= last_sequence)) ||
+        (e.coord.z <= last[e.coord.x]))
+      unordered++;
+    last_sequence = e.sequence;
+    last[e.coord.x] = e.coord.z;
+    received++;
+  };
+  while (running > 0)
+    subscription.poll(check);
+  for (auto &producer : producers)
+    producer.join();
+  subscription.poll(check);
+
+  CHECK(torn == 0);
+  CHECK(unordered == 0);
+  CHECK(received > 0);
+  CHECK(received + subscription.get_lost() == PRODUCERS * EVENTS);
+  CHECK(subscription.get_cursor() == journal->head());
+}
+
+/**
+ * @brief Read all the published events of a subscription.
+ */
+static std::vector<ChangeEvent> drain(ChangeSubscription &subscription) {
+  std::vector<ChangeEvent> events;
+  subscription.poll([&events](const ChangeEvent &e) { events.push_back(e); });
+  return events;
+}
+
+/**
+ * @brief Dimension of 2x1 chunks recording into a journal, with a stone
+ * block at the bottom corner of each chunk.
+ */
+static Dimension::SharedPtr journaled_dimension(ChangeJournal::SharedPtr j) {
+  auto dim = std::make_shared<Dimension>(Dimension::OVERWORLD, "overworld");
+  const Block *stone = BlockRegistry::global().get("minecraft:stone");
+  for (ChunkCoordinate_t x = 0; x < 2; x++) {
+    auto chunk = std::make_shared<Chunk>();
+    chunk->coord = ChunkCoordinate(x, 0);
+    chunk->set_block(0, 0, 0, stone);
+    dim->add_chunk(chunk);
+  }
+  dim->set_journal(std::move(j));
+  return dim;
+}
+
+TEST_CASE("journal: dimension edits are recorded, no-op writes are not") {
+  auto &registry = BlockRegistry::global();
+  const Block *stone = registry.get("minecraft:stone");
+  const Block *glass = registry.get("minecraft:glass");
+  auto journal = ChangeJournal::make(256);
+  auto dim = journaled_dimension(journal);
+  auto subscription = journal->subscribe();
+
+  // Blocks, through the dimension and the chunk
+  CHECK(dim->set_block(BlockCoordinate(17, 2, 3), glass));
+  CHECK_FALSE(dim->set_block(BlockCoordinate(17, 2, 3), glass));
+  CHECK_FALSE(dim->set_block(BlockCoordinate(0, 0, 0), stone));
+  auto chunk = dim->get_chunk(ChunkCoordinate(0, 0));
+  CHECK(chunk->set_block(4, 5, 6, glass));
+  CHECK_FALSE(chunk->set_block(4, 5, 6, glass));
+  auto events = drain(subscription);
+  REQUIRE(events.size() == 2);
+  CHECK(events[0].kind == ChangeEvent::BLOCK);
+  CHECK(events[0].coord.x == 1);
+  CHECK(events[0].y == 0);
+  CHECK(events[0].index == Section::index(1, 2, 3));
+  CHECK(events[0].old == nullptr);
+  CHECK(events[0].block == glass);
+  CHECK(events[1].coord.x == 0);
+  CHECK(events[1].index == Section::index(4, 5, 6));
+  CHECK(events[0].sequence < events[1].sequence);
+
+  // Sections handed out for edition
+  chunk->edit_section(-1);
+  events = drain(subscription);
+  REQUIRE(events.size() == 1);
+  CHECK(events[0].kind == ChangeEvent::SECTION);
+  CHECK(events[0].y == -1);
+
+  // Bulk edits: one event per edited section, none when nothing changes
+  const BlockBox sections{BlockCoordinate(0, 16, 0),
+                          BlockCoordinate(31, 47, 15)};
+  CHECK(dim->fill(sections, stone) == 4);
+  CHECK(drain(subscription).size() == 4);
+  CHECK(dim->fill(sections, stone) == 0);
+  CHECK(dim->replace(sections, glass, stone) == 0);
+  CHECK(drain(subscription).empty());
+
+  CHECK(dim->replace(BlockBox{BlockCoordinate(0, 16, 0),
+                              BlockCoordinate(3, 16, 3)},
+                     stone, glass) == 1);
+  events = drain(subscription);
+  REQUIRE(events.size() == 1);
+  CHECK(events[0].kind == ChangeEvent::SECTION);
+  CHECK(events[0].y == 1);
+
+  CHECK(dim->copy(BlockBox{BlockCoordinate(0, 16, 0),
+                           BlockCoordinate(3, 16, 3)},
+                  BlockCoordinate(20, 40, 4)) > 0);
+  events = drain(subscription);
+  REQUIRE_FALSE(events.empty());
+  for (const ChangeEvent &e : events)
+    CHECK(((e.coord.x == 1) && (e.coord.z == 0) && (e.y == 2)));
+  CHECK(dim->get_block(BlockCoordinate(20, 40, 4)) == glass);
+  CHECK(subscription.get_lost() == 0);
+}
+
+TEST_CASE("journal: consecutive events of a section are merged") {
+  const Block *glass = BlockRegistry::global().get("minecraft:glass");
+  auto journal = ChangeJournal::make(256);
+  auto dim = journaled_dimension(journal);
+  auto subscription = journal->subscribe();
+
+  dim->set_block(BlockCoordinate(1, 0, 0), glass);
+  dim->set_block(BlockCoordinate(2, 0, 0), glass);
+  dim->set_block(BlockCoordinate(2, 16, 0), glass);
+  dim->get_chunk(ChunkCoordinate(0, 0))->edit_section(1);
+  dim->set_block(BlockCoordinate(3, 0, 0), glass);
+
+  std::vector<SectionChange> changes;
+  CHECK(subscription.poll_sections([&changes](const SectionChange &c) {
+    changes.push_back(c);
+  }) == 5);
+  REQUIRE(changes.size() == 3);
+  CHECK(changes[0].y == 0);
+  CHECK(changes[0].events == 2);
+  CHECK_FALSE(changes[0].whole);
+  CHECK(changes[0].blocks[0] == ((uint64_t{1} << 1) | (uint64_t{1} << 2)));
+  CHECK(changes[0].last == changes[0].first + 1);
+  CHECK(changes[1].y == 1);
+  CHECK(changes[1].events == 2);
+  CHECK(changes[1].whole);
+  CHECK(changes[2].y == 0);
+  CHECK(changes[2].events == 1);
+  CHECK(changes[2].blocks[0] == (uint64_t{1} << 3));
+}
@@ -0,0 +1,245 @@
+#include "solis/world/light_engine.hpp"
+#include <algorithm>
+#include <doctest.h>
+#include <random>
+
+using namespace solis;
+using namespace solis::world;
+
+constexpr ChunkCoordinate_t SIDE{3};         /// Chunks along X and Z
+constexpr BlockCoordinate_t WIDTH{SIDE * CHUNK_SIZE}; /// Blocks along X and Z
+constexpr SectionIndex BOTTOM{-1}, TOP{2};    /// Sections holding blocks
+
+/**
+ * @brief Dimension of 3x3 chunks: rough ground, slabs floating over it
+ * across the chunk borders, leaves, glass and light sources.
+ */
+static Dimension::SharedPtr terrain(uint32_t seed) {
+  auto &registry = BlockRegistry::global();
+  const Block *stone = registry.get("minecraft:stone");
+  const Block *leaves = registry.get("minecraft:oak_leaves");
+  const Block *glass = registry.get("minecraft:glass");
+  const Block *sources[2]{registry.get("minecraft:glowstone"),
+                          registry.get("minecraft:torch")};
+  std::mt19937 rng(seed);
+  auto dim = std::make_shared<Dimension>(Dimension::OVERWORLD, "overworld");
+  for (ChunkCoordinate_t x = 0; x < SIDE; x++)
+    for (ChunkCoordinate_t z = 0; z < SIDE; z++) {
+      auto chunk = std::make_shared<Chunk>();
+      chunk->coord = ChunkCoordinate(x, z);
+      dim->add_chunk(chunk);
+    }
+
+  auto box = [&dim](BlockCoordinate_t x0, BlockCoordinate_t y0,
+                    BlockCoordinate_t z0, BlockCoordinate_t w,
+                    BlockCoordinate_t h, BlockCoordinate_t d,
+                    const Block *block) {
+    dim->fill(BlockBox{BlockCoordinate(x0, y0, z0),
+                       BlockCoordinate(std::min(x0 + w, WIDTH) - 1, y0 + h - 1,
+                                       std::min(z0 + d, WIDTH) - 1)},
+              block);
+  };
+  // Ground, with pits
+  box(0, BOTTOM * 16, 0, WIDTH, 10, WIDTH, stone);
+  for (int n = 0; n < 12; n++)
+    box(rng() % WIDTH, -8, rng() % WIDTH, 1 + rng() % 4, 2, 1 + rng() % 4,
+        nullptr);
+  // Overhangs and canopies, some astride two chunks
+  for (int n = 0; n < 10; n++)
+    box(rng() % WIDTH, 4 + rng() % 30, rng() % WIDTH, 4 + rng() % 16, 1,
+        4 + rng() % 16, (n % 3 == 0) ? leaves : stone);
+  for (int n = 0; n < 6; n++)
+    box(rng() % WIDTH, rng() % 40, rng() % WIDTH, 2, 2, 2, glass);
+  // Light sources, under the overhangs or in the open
+  for (int n = 0; n < 24; n++)
+    dim->set_block(BlockCoordinate(rng() % WIDTH, -6 + rng() % 40,
+                                   rng() % WIDTH),
+                   sources[n % 2]);
+  return dim;
+}
+
+/**
+ * @brief Reference light over the relight range: sky columns then a single
+ * breadth-first propagation over the whole dimension, ignoring the chunks.
+ */
+struct NaiveLight {
+  BlockCoordinate_t bottom, height;
+  std::vector<uint8_t> opacity, sky, block;
+
+  inline size_t at(BlockCoordinate_t x, BlockCoordinate_t y,
+                   BlockCoordinate_t z) const {
+    return (static_cast<size_t>(y - bottom) * WIDTH + z) * WIDTH + x;
+  }
+
+  NaiveLight(const Dimension &dim, LightEngine &engine, SectionIndex lo,
+             SectionIndex hi)
+      : bottom(lo * CHUNK_SIZE), height((hi - lo + 1) * CHUNK_SIZE) {
+    const size_t volume = static_cast<size_t>(height) * WIDTH * WIDTH;
+    opacity.resize(volume);
+    sky.assign(volume, 0);
+    block.assign(volume, 0);
+    std::vector<uint32_t> sky_queue, block_queue;
+    for (BlockCoordinate_t y = bottom; y < bottom + height; y++)
+      for (BlockCoordinate_t z = 0; z < WIDTH; z++)
+        for (BlockCoordinate_t x = 0; x < WIDTH; x++) {
+          const LightInfo info =
+              engine.get_info(dim.get_block(BlockCoordinate(x, y, z)));
+          opacity[at(x, y, z)] = info.opacity;
+          if (info.emission > 0) {
+            block[at(x, y, z)] = info.emission;
+            block_queue.push_back(at(x, y, z));
+          }
+        }
+
+    for (BlockCoordinate_t z = 0; z < WIDTH; z++)
+      for (BlockCoordinate_t x = 0; x < WIDTH; x++) {
+        uint8_t level = MAX_LIGHT;
+        for (BlockCoordinate_t y = bottom + height - 1; y >= bottom; y--) {
+          const size_t p = at(x, y, z);
+          level = (opacity[p] >= level) ? 0 : level - opacity[p];
+          sky[p] = level;
+          sky_queue.push_back(p);
+        }
+      }
+    propagate(sky, sky_queue);
+    propagate(block, block_queue);
+  }
+
+  void propagate(std::vector<uint8_t> &light, std::vector<uint32_t> &queue) {
+    const size_t layer = static_cast<size_t>(WIDTH) * WIDTH;
+    for (size_t q = 0; q < queue.size(); q++) {
+      const uint32_t p = queue[q];
+      const BlockCoordinate_t x = p % WIDTH, z = (p / WIDTH) % WIDTH;
+      auto visit = [&](size_t n) {
+        if (opacity[n] >= MAX_LIGHT)
+          return;
+        const uint8_t cost = std::max<uint8_t>(1, opacity[n]);
+        if ((light[p] > cost) && (light[p] - cost > light[n])) {
+          light[n] = light[p] - cost;
+          queue.push_back(n);
+        }
+      };
+      if (x > 0)
+        visit(p - 1);
+      if (x < WIDTH - 1)
+        visit(p + 1);
+      if (z > 0)
+        visit(p - WIDTH);
+      if (z < WIDTH - 1)
+        visit(p + WIDTH);
+      if (p >= layer)
+        visit(p - layer);
+      if (p + layer < light.size())
+        visit(p + layer);
+    }
+  }
+};
+
+/**
+ * @brief Relight every chunk of the dimension.
+ */
+static void relight(Dimension &dim, LightEngine &engine) {
+  std::vector<ChunkCoordinate> coords;
+  for (ChunkCoordinate_t x = 0; x < SIDE; x++)
+    for (ChunkCoordinate_t z = 0; z < SIDE; z++)
+      coords.emplace_back(x, z);
+  engine.relight(dim, coords);
+}
+
+/**
+ * @brief Count of the cells whose light differs from the reference.
+ */
+static std::pair<size_t, size_t> mismatches(const Dimension &dim,
+                                            const NaiveLight &naive) {
+  std::pair<size_t, size_t> out{0, 0};
+  for (BlockCoordinate_t y = naive.bottom; y < naive.bottom + naive.height;
+       y++)
+    for (BlockCoordinate_t z = 0; z < WIDTH; z++)
+      for (BlockCoordinate_t x = 0; x < WIDTH; x++) {
+        const auto light =
+            dim.get_chunk(BlockCoordinate(x, y, z))->get_light();
+        const SectionIndex sy = Chunk::section_of(y);
+        const uint16_t i = Section::index(
+            x % CHUNK_SIZE, floor_mod<LayerIndex>(y, CHUNK_SIZE),
+            z % CHUNK_SIZE);
+        const size_t p = naive.at(x, y, z);
+        out.first += light->get_sky(sy, i) != naive.sky[p];
+        out.second += light->get_block(sy, i) != naive.block[p];
+      }
+  return out;
+}
+
+TEST_CASE("light engine: batched light matches a global propagation") {
+  for (uint32_t seed = 0; seed < 4; seed++) {
+    auto dim = terrain(seed);
+    LightEngine engine;
+    relight(*dim, engine);
+
+    // The relight range ends one section above the highest block
+    const NaiveLight naive(*dim, engine, BOTTOM, TOP + 1);
+    const auto [sky, block] = mismatches(*dim, naive);
+    CHECK(sky == 0);
+    CHECK(block == 0);
+
+    // Cells lit sideways, neither dark nor under the open sky
+    size_t shaded = 0, lit = 0;
+    for (size_t p = 0; p < naive.sky.size(); p++) {
+      shaded += (naive.sky[p] > 0) && (naive.sky[p] < MAX_LIGHT) &&
+                (naive.opacity[p] == 0);
+      lit += naive.block[p] > 0;
+    }
+    CHECK(shaded > 1000);
+    CHECK(lit > 1000);
+  }
+}
+
+TEST_CASE("light engine: light reaches under a roof across a chunk border") {
+  auto &registry = BlockRegistry::global();
+  const Block *stone = registry.get("minecraft:stone");
+  Dimension dim(Dimension::OVERWORLD, "overworld");
+  for (ChunkCoordinate_t x = 0; x < SIDE; x++)
+    for (ChunkCoordinate_t z = 0; z < SIDE; z++) {
+      auto chunk = std::make_shared<Chunk>();
+      chunk->coord = ChunkCoordinate(x, z);
+      dim.add_chunk(chunk);
+    }
+  // Roof over the border between the chunks (0, 1) and (1, 1), a torch
+  // under it, close to the border
+  dim.fill(BlockBox{BlockCoordinate(0, 0, 0),
+                    BlockCoordinate(WIDTH - 1, 3, WIDTH - 1)},
+           stone);
+  dim.fill(BlockBox{BlockCoordinate(8, 20, 16), BlockCoordinate(31, 20, 31)},
+           stone);
+  dim.set_block(BlockCoordinate(14, 4, 24), registry.get("minecraft:torch"));
+  LightEngine engine;
+  relight(dim, engine);
+
+  auto sky = [&dim](BlockCoordinate_t x, BlockCoordinate_t y,
+                    BlockCoordinate_t z) {
+    return dim.get_chunk(BlockCoordinate(x, y, z))
+        ->get_light()
+        ->get_sky(Chunk::section_of(y),
+                  Section::index(x % CHUNK_SIZE, y % CHUNK_SIZE,
+                                 z % CHUNK_SIZE));
+  };
+  auto block = [&dim](BlockCoordinate_t x, BlockCoordinate_t y,
+                      BlockCoordinate_t z) {
+    return dim.get_chunk(BlockCoordinate(x, y, z))
+        ->get_light()
+        ->get_block(Chunk::section_of(y),
+                    Section::index(x % CHUNK_SIZE, y % CHUNK_SIZE,
+                                   z % CHUNK_SIZE));
+  };
+  const uint8_t torch =
+      engine.get_info(registry.get("minecraft:torch")).emission;
+  CHECK(sky(20, 25, 24) == MAX_LIGHT);
+  // Under the roof, 5 steps from the open cell past its west edge
+  CHECK(sky(12, 19, 24) == MAX_LIGHT - 5);
+  CHECK(sky(20, 19, 24) < MAX_LIGHT - 5);
+  CHECK(sky(20, 19, 24) > 0);
+  CHECK(block(14, 4, 24) == torch);
+  CHECK(block(17, 4, 24) == torch - 3);
+
+  const NaiveLight naive(dim, engine, 0, 2);
+  CHECK(mismatches(dim, naive) == std::pair<size_t, size_t>{0, 0});
+}
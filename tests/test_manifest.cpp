@@ -0,0 +1,116 @@
+#include "solis/world/manifest.hpp"
+#include <algorithm>
+#include <doctest.h>
+#include <filesystem>
+
+using namespace solis;
+using namespace solis::world;
+namespace fs = std::filesystem;
+
+/**
+ * @brief World directory removed at the end of the test.
+ */
+struct TempWorld {
+  fs::path dir;
+
+  explicit TempWorld(const char *name)
+      : dir(fs::temp_directory_path() / (std::string("solis_test_") + name)) {
+    fs::remove_all(dir);
+    fs::create_directories(dir / "region");
+  }
+  ~TempWorld() { fs::remove_all(dir); }
+
+  std::string region(const RegionCoordinate &coord) const {
+    return (dir / "region" / RegionFile::filename(coord)).string();
+  }
+};
+
+/**
+ * @brief Stage chunks in a region file.
+ */
+static void save_chunks(const std::string &path,
+                        const std::vector<std::pair<uint16_t, uint32_t>> &c) {
+  RegionFile file(path, true);
+  for (const auto &[i, timestamp] : c)
+    file.stage_chunk(i, ChunkPayload{CompressionType::ZLIB, "payload"},
+                     timestamp);
+  file.commit();
+}
+
+TEST_CASE("manifest: summaries carry the stamp of the scanned header") {
+  TempWorld world("manifest_stamp");
+  const RegionCoordinate coord(0, 0);
+  save_chunks(world.region(coord), {{3, 100}});
+
+  WorldManifest manifest;
+  CHECK(manifest.refresh(world.dir.string()) == 1);
+  const RegionManifest *m =
+      manifest.get_dimension("overworld")->get_region(coord);
+  REQUIRE(m != nullptr);
+  const FileStamp stamp = FileStamp::of(world.region(coord));
+  CHECK(m->mtime == stamp.mtime);
+  CHECK(m->size == stamp.size);
+  CHECK(m->has_chunk(3));
+
+  // Unchanged files are not scanned again, saved ones are
+  CHECK(manifest.refresh(world.dir.string()) == 0);
+  save_chunks(world.region(coord), {{4, 200}});
+  CHECK(manifest.refresh(world.dir.string()) == 1);
+  m = manifest.get_dimension("overworld")->get_region(coord);
+  CHECK(m->has_chunk(4));
+  CHECK(m->size == FileStamp::of(world.region(coord)).size);
+}
+
+TEST_CASE("manifest: modified chunks are listed across the regions") {
+  TempWorld world("manifest_modified");
+  const RegionCoordinate a(-1, 2), b(0, 0), c(3, -1);
+  save_chunks(world.region(a), {{7, 200}, {8, 400}});
+  save_chunks(world.region(b), {{0, 100}, {5, 300}, {1023, 500}});
+  save_chunks(world.region(c), {{1, 50}});
+  WorldManifest manifest;
+  REQUIRE(manifest.refresh(world.dir.string()) == 3);
+
+  auto list = [&manifest](uint32_t since) {
+    std::vector<std::pair<ChunkCoordinate, uint32_t>> out;
+    const DimensionManifest &dim = *manifest.get_dimension("overworld");
+    for (const ChunkStamp &stamp : dim.modified_since(since))
+      out.emplace_back(stamp.coord, stamp.timestamp);
+    return out;
+  };
+  auto chunk = [](const RegionCoordinate &region, uint16_t i) {
+    return RegionFile::chunk_coordinate(region, i);
+  };
+  auto same = [](const std::vector<std::pair<ChunkCoordinate, uint32_t>> &l,
+                 const std::vector<std::pair<ChunkCoordinate, uint32_t>> &r) {
+    return std::equal(l.begin(), l.end(), r.begin(), r.end(),
+                      [](const auto &x, const auto &y) {
+                        return (x.first.x == y.first.x) &&
+                               (x.first.z == y.first.z) &&
+                               (x.second == y.second);
+                      });
+  };
+
+  // At or after the time, by region then by index
+  CHECK(same(list(300),
+             {{chunk(a, 8), 400}, {chunk(b, 5), 300}, {chunk(b, 1023), 500}}));
+  CHECK(same(list(401), {{chunk(b, 1023), 500}}));
+  CHECK(list(0).size() == 6);
+  CHECK(list(501).empty());
+
+  // Iterators reaching the end compare equal to the end of the range
+  const DimensionManifest &dim = *manifest.get_dimension("overworld");
+  const auto range = dim.modified_since(450);
+  CHECK(range.end() == range.end());
+  auto it = range.begin();
+  REQUIRE(it != range.end());
+  CHECK((*it++).timestamp == 500);
+  CHECK(it == range.end());
+  CHECK(dim.modified_since(1000).begin() == dim.modified_since(1000).end());
+  const DimensionManifest empty;
+  CHECK(empty.modified_since(0).begin() == empty.modified_since(0).end());
+
+  // Newly saved chunks show up after a refresh
+  save_chunks(world.region(c), {{2, 600}});
+  REQUIRE(manifest.refresh(world.dir.string()) == 1);
+  CHECK(same(list(450), {{chunk(b, 1023), 500}, {chunk(c, 2), 600}}));
+}
@@ -0,0 +1,122 @@
+#include "solis/utils/errors.hpp"
+#include "solis/world/anvil.hpp"
+#include "solis/world/native_cache.hpp"
+#include <cstdio>
+#include <cstring>
+#include <doctest.h>
+
+using namespace solis;
+using namespace solis::world;
+
+/**
+ * @brief Chunk with two sections, light and up-to-date heightmaps.
+ */
+static Chunk::SharedPtr lit_chunk() {
+  auto &registry = BlockRegistry::global();
+  auto chunk = std::make_shared<Chunk>();
+  chunk->coord = ChunkCoordinate(3, -2);
+  chunk->set_section(-1, Section::make(registry.get("minecraft:stone")));
+  chunk->set_block(1, 2, 3, registry.get("minecraft:oak_log[axis=y]"));
+  chunk->set_block(4, 5, 6, registry.get("minecraft:glass"));
+
+  auto light = std::make_shared<ChunkLight>();
+  SectionLight &l = (*light)[0];
+  l.block.fill(3);
+  for (uint16_t i = 0; i < SECTION_VOLUME; i += 7)
+    l.sky.set(i, i % 16);
+  (*light)[-1].sky.fill(0);
+  chunk->set_light(std::move(light));
+  chunk->get_heightmaps();
+  return chunk;
+}
+
+static void check_same(const Chunk &a, const Chunk &b) {
+  CHECK(a.coord.x == b.coord.x);
+  CHECK(a.coord.z == b.coord.z);
+  REQUIRE(a.size() == b.size());
+  for (const auto &[y, section] : a)
+    for (uint16_t i = 0; i < SECTION_VOLUME; i++)
+      REQUIRE(section->get_block(i) == b.get_section(y)->get_block(i));
+
+  REQUIRE(b.get_light() != nullptr);
+  CHECK(*a.get_light() == *b.get_light());
+  REQUIRE(b.get_cached_heightmaps() != nullptr);
+  CHECK(a.get_cached_heightmaps()->min_y == b.get_cached_heightmaps()->min_y);
+  for (uint8_t h = 0; h < HEIGHTMAP_COUNT; h++)
+    CHECK(a.get_cached_heightmaps()->heights[h] ==
+          b.get_cached_heightmaps()->heights[h]);
+}
+
+TEST_CASE("native cache: records keep the light and heightmaps") {
+  auto chunk = lit_chunk();
+  std::string record;
+  NativeRegionCache::append_record(record, *chunk);
+  const NativeChunkView view{record.data()};
+  REQUIRE(view.is_valid(record.size()));
+  check_same(*chunk, *view.to_chunk());
+}
+
+TEST_CASE("native cache: damaged records are rejected") {
+  auto chunk = lit_chunk();
+  std::string record;
+  NativeRegionCache::append_record(record, *chunk);
+  const auto &ch =
+      *reinterpret_cast<const native::ChunkHeader *>(record.data());
+  const size_t first = sizeof(native::ChunkHeader);
+
+  CHECK_FALSE(NativeChunkView{record.data()}.is_valid(record.size() - 8));
+
+  auto damaged = [&](auto &&damage) {
+    std::string copy = record;
+    damage(copy.data());
+    return !NativeChunkView{copy.data()}.is_valid(copy.size());
+  };
+  CHECK(damaged([&](char *r) {
+    reinterpret_cast<native::ChunkHeader *>(r)->sections = 1000;
+  }));
+  CHECK(damaged([&](char *r) {
+    reinterpret_cast<native::SectionHeader *>(r + first)->palette_size = 60000;
+  }));
+  CHECK(damaged([&](char *r) {
+    reinterpret_cast<native::SectionHeader *>(r + first)->names_offset =
+        0xFFFFFF00;
+  }));
+  CHECK(damaged([&](char *r) {
+    auto sh = reinterpret_cast<native::SectionHeader *>(r + first + 16);
+    REQUIRE(sh->indices_offset != 0);
+    reinterpret_cast<PaletteIndex_t *>(r + sh->indices_offset)[9] = 500;
+  }));
+  CHECK(damaged([&](char *r) {
+    reinterpret_cast<native::LightHeader *>(r + ch.light_offset)->sky_offset =
+        ch.size - 8;
+  }));
+  CHECK(damaged([&](char *r) {
+    reinterpret_cast<native::ChunkHeader *>(r)->heightmaps_offset =
+        ch.size - 8;
+  }));
+}
+
+TEST_CASE("native cache: warm restart from a region file") {
+  const std::string region_path = "/tmp/solis_test_native.mca";
+  const std::string cache_path = "/tmp/solis_test_native.slc";
+  std::remove(region_path.c_str());
+  std::remove(cache_path.c_str());
+
+  auto chunk = lit_chunk();
+  const uint16_t i = RegionFile::index(chunk->coord);
+  {
+    RegionFile region(region_path, true);
+    region.stage_chunk(i, Anvil::deflate(*chunk));
+    region.commit();
+  }
+  CHECK(NativeRegionCache::refresh(region_path, cache_path));
+  CHECK_FALSE(NativeRegionCache::refresh(region_path, cache_path));
+  {
+    NativeRegionCache cache(cache_path);
+    auto loaded = cache.load_chunk(i);
+    REQUIRE(loaded != nullptr);
+    check_same(*Anvil::read(RegionFile(region_path), i), *loaded);
+  }
+  std::remove(region_path.c_str());
+  std::remove(cache_path.c_str());
+}
@@ -0,0 +1,132 @@
+#include "solis/world/prefetcher.hpp"
+#include <doctest.h>
+
+using namespace solis;
+using namespace solis::world;
+
+/**
+ * @brief Dimension warmed by a prefetcher, from a storage holding every chunk.
+ */
+struct PrefetchFixture {
+  Dimension::SharedPtr dim;
+  ChunkPrefetcher::SharedPtr prefetcher;
+  size_t loads{0}; /// Chunks read from the storage
+
+  explicit PrefetchFixture(uint8_t radius, size_t loads_per_tick = 16) {
+    dim = std::make_shared<Dimension>(Dimension::OVERWORLD, "overworld");
+    PrefetchConfig config;
+    config.radius = radius;
+    config.loads_per_tick = loads_per_tick;
+    prefetcher = ChunkPrefetcher::make(
+        dim,
+        [this](const ChunkCoordinate &coord) {
+          loads++;
+          auto chunk = std::make_shared<Chunk>();
+          chunk->coord = coord;
+          return chunk;
+        },
+        config);
+  }
+
+  inline bool loaded(ChunkCoordinate_t x, ChunkCoordinate_t z) const {
+    return dim->is_chunk_loaded(ChunkCoordinate(x, z));
+  }
+};
+
+/// One chunk per second along +X, from the middle of the chunk (0, 0)
+static const WorldCoordinate START(8, 64, 8), EAST(16, 0, 0), WEST(-16, 0, 0);
+
+TEST_CASE("prefetcher: chunks on the path are loaded by urgency") {
+  PrefetchFixture f(0, 2);
+  f.prefetcher->track_viewer(1, START, EAST);
+  f.prefetcher->update();
+  // Four seconds ahead: the chunks 0 to 4 along X
+  CHECK(f.prefetcher->pending() == 5);
+
+  CHECK(f.prefetcher->tick() == 2);
+  CHECK(f.loaded(0, 0));
+  CHECK(f.loaded(1, 0));
+  CHECK_FALSE(f.loaded(2, 0));
+  CHECK(f.prefetcher->tick() == 2);
+  CHECK(f.prefetcher->tick() == 1);
+  CHECK(f.loaded(4, 0));
+  CHECK_FALSE(f.loaded(5, 0));
+  CHECK_FALSE(f.loaded(0, 1));
+  CHECK(f.prefetcher->pending() == 0);
+  CHECK(f.prefetcher->get_stats().issued == 5);
+
+  // The radius widens the path
+  PrefetchFixture wide(1);
+  wide.prefetcher->track_viewer(1, START, EAST);
+  wide.prefetcher->update();
+  CHECK(wide.prefetcher->pending() == 7 * 3);
+  wide.prefetcher->tick();
+  CHECK(wide.loaded(-1, -1));
+  CHECK(wide.loaded(0, 1));
+
+  // Still viewers only warm their surroundings
+  wide.prefetcher->track_viewer(1, START, WorldCoordinate(0, 0, 0));
+  wide.prefetcher->update();
+  CHECK(wide.prefetcher->pending() == 0);
+}
+
+TEST_CASE("prefetcher: a direction change cancels the stale prefetches") {
+  PrefetchFixture f(0, 1);
+  f.prefetcher->track_viewer(1, START, EAST);
+  f.prefetcher->update();
+  CHECK(f.prefetcher->tick() == 1);
+  REQUIRE(f.prefetcher->pending() == 4);
+
+  // Turning back: the chunks 1 to 4 are off the path, 0 is still on it
+  f.prefetcher->track_viewer(1, START, WEST);
+  f.prefetcher->update();
+  const PrefetchStats &stats = f.prefetcher->get_stats();
+  CHECK(stats.cancelled == 4);
+  CHECK(stats.wasted == 0);
+  CHECK(f.prefetcher->pending() == 4);
+  while (f.prefetcher->tick() > 0)
+    ;
+  CHECK(f.loaded(-4, 0));
+  CHECK_FALSE(f.loaded(1, 0));
+  CHECK(f.loads == 5);
+
+  // Untracked viewers leave nothing pending
+  f.prefetcher->track_viewer(1, START, EAST);
+  f.prefetcher->update();
+  CHECK(f.prefetcher->pending() == 4);
+  f.prefetcher->untrack_viewer(1);
+  f.prefetcher->update();
+  CHECK(f.prefetcher->pending() == 0);
+  CHECK(stats.cancelled == 8);
+}
+
+TEST_CASE("prefetcher: demands count the hits, misses and wasted loads") {
+  PrefetchFixture f(0);
+  f.prefetcher->track_viewer(1, START, EAST);
+  f.prefetcher->update();
+  // Demanded before being warmed: loaded once, and no longer pending
+  CHECK(f.prefetcher->get_chunk(ChunkCoordinate(3, 0)) != nullptr);
+  CHECK(f.prefetcher->pending() == 4);
+  CHECK(f.prefetcher->tick() == 4);
+  CHECK(f.loads == 5);
+
+  CHECK(f.prefetcher->get_chunk(ChunkCoordinate(0, 0)) != nullptr);
+  CHECK(f.prefetcher->get_chunk(ChunkCoordinate(1, 0)) != nullptr);
+  // Chunks only count once
+  CHECK(f.prefetcher->get_chunk(ChunkCoordinate(1, 0)) != nullptr);
+  CHECK(f.prefetcher->get_chunk(WorldCoordinate(40, 64, 8)) != nullptr);
+  const PrefetchStats &stats = f.prefetcher->get_stats();
+  CHECK(stats.hits == 3);
+  CHECK(stats.misses == 1);
+  CHECK(stats.issued == 4);
+
+  // Leaving before reaching the chunk 4 wastes it
+  f.prefetcher->track_viewer(1, WorldCoordinate(8, 64, 800), EAST);
+  f.prefetcher->update();
+  CHECK(stats.wasted == 1);
+  CHECK(f.prefetcher->get_chunk(ChunkCoordinate(4, 0)) != nullptr);
+  CHECK(stats.hits == 3);
+
+  f.prefetcher->reset_stats();
+  CHECK(f.prefetcher->get_stats().misses == 0);
+}
@@ -0,0 +1,43 @@
+#include "solis/nbt/document.hpp"
+#include "solis/nbt/query.hpp"
+#include "solis/utils/errors.hpp"
+#include <doctest.h>
+
+using namespace solis;
+using namespace solis::nbt;
+
+TEST_CASE("query: paths are compiled") {
+  Query query;
+  CHECK(query.add("Status") == 0);
+  CHECK(query.add("sections[].block_states.palette") == 1);
+  CHECK(query.add("a[2147483647]") == 2);
+
+  Document doc;
+  Node *list = doc.make_list(TagType::INT);
+  for (int64_t i = 0; i < 3; i++)
+    list->list().push_back(doc.make_int(TagType::INT, 10 * i));
+  doc.root().set("list", list);
+  doc.root().set("Status", doc.make_string("minecraft:full"));
+
+  Query run;
+  run.add("list[2]");
+  run.add("Status");
+  int64_t element = 0;
+  std::string status;
+  run.run(doc.serialize(), [&](size_t path, const Value &value) {
+    if (path == 0)
+      element = value.as_int();
+    else
+      status = value.as_string();
+  });
+  CHECK(element == 20);
+  CHECK(status == "minecraft:full");
+}
+
+TEST_CASE("query: invalid paths are rejected") {
+  Query query;
+  for (const char *path : {"", "a..b", ".a", "a.", "a[", "a[x]",
+                           "a[2147483648]", "a[99999999999999999999]"})
+    CHECK_THROWS_AS(query.add(path), NBTError);
+  CHECK(query.size() == 0);
+}
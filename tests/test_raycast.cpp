@@ -0,0 +1,121 @@
+#include "solis/world/raycast.hpp"
+#include <cmath>
+#include <doctest.h>
+#include <random>
+
+using namespace solis;
+using namespace solis::world;
+
+/**
+ * @brief Dimension of 12x12 chunks mixing absent, uniform and sparse
+ * sections, with a few absent chunks.
+ */
+static Dimension::SharedPtr sparse_dimension() {
+  auto &registry = BlockRegistry::global();
+  const Block *blocks[3]{registry.get("minecraft:stone"),
+                         registry.get("minecraft:glass"),
+                         registry.get("minecraft:dirt")};
+  std::mt19937 rng(49);
+  auto dim = std::make_shared<Dimension>(Dimension::OVERWORLD, "overworld");
+  for (ChunkCoordinate_t x = 0; x < 12; x++)
+    for (ChunkCoordinate_t z = 0; z < 12; z++) {
+      if (rng() % 10 == 0)
+        continue;
+      auto chunk = std::make_shared<Chunk>();
+      chunk->coord = ChunkCoordinate(x, z);
+      for (SectionIndex y = -1; y <= 3; y++)
+        switch (rng() % 5) {
+        case 0:
+          chunk->set_section(y, Section::make(blocks[rng() % 3]));
+          break;
+        case 1:
+          chunk->set_section(y, Section::make(nullptr));
+          break;
+        case 2:
+          for (int n = 0; n < 24; n++)
+            chunk->set_block(rng() % CHUNK_SIZE, y * CHUNK_SIZE + rng() % 16,
+                             rng() % CHUNK_SIZE, blocks[rng() % 3]);
+          break;
+        default:
+          break;
+        }
+      dim->add_chunk(chunk);
+    }
+  return dim;
+}
+
+/**
+ * @brief Reference traversal, stepping block by block through get_block.
+ */
+static RayHit naive_cast(const Dimension &dim, const Ray &ray,
+                         const RayOptions &options) {
+  RayHit out;
+  const double len = std::sqrt(ray.direction.x * ray.direction.x +
+                               ray.direction.y * ray.direction.y +
+                               ray.direction.z * ray.direction.z);
+  const double o[3]{ray.origin.x, ray.origin.y, ray.origin.z};
+  const double d[3]{ray.direction.x / len, ray.direction.y / len,
+                    ray.direction.z / len};
+  BlockCoordinate_t cell[3];
+  double t_max[3], t_delta[3];
+  for (uint8_t k = 0; k < 3; k++) {
+    cell[k] = static_cast<BlockCoordinate_t>(std::floor(o[k]));
+    const double next = static_cast<double>(cell[k] + (d[k] > 0));
+    t_max[k] = (d[k] == 0) ? INFINITY : (next - o[k]) / d[k];
+    t_delta[k] = (d[k] == 0) ? INFINITY : std::abs(1 / d[k]);
+  }
+
+  for (double t = 0; t <= options.max_distance;) {
+    const BlockCoordinate at(cell[0], cell[1], cell[2]);
+    const Block *block = dim.get_block(at);
+    const FlagL_t f = Block::flags_of(block);
+    if (has_flag(f, options.flags) && ((f & options.excluded) == 0)) {
+      out.hit = true;
+      out.block = at;
+      out.state = block;
+      out.distance = t;
+      return out;
+    }
+    const uint8_t k = (t_max[0] < t_max[1]) ? ((t_max[0] < t_max[2]) ? 0 : 2)
+                                            : ((t_max[1] < t_max[2]) ? 1 : 2);
+    t = t_max[k];
+    cell[k] += (d[k] > 0) ? 1 : -1;
+    t_max[k] += t_delta[k];
+  }
+  return out;
+}
+
+TEST_CASE("raycast: random rays match a naive traversal") {
+  auto dim = sparse_dimension();
+  const RayCaster caster(*dim);
+  std::mt19937 rng(2000);
+  std::uniform_real_distribution<double> position(-16, 208);
+  std::uniform_real_distribution<double> height(-24, 72);
+  std::normal_distribution<double> direction(0, 1);
+
+  RayOptions options;
+  options.max_distance = 160;
+  std::vector<Ray> rays;
+  for (int r = 0; r < 2000; r++)
+    rays.push_back(Ray{WorldCoordinate(position(rng), height(rng),
+                                       position(rng)),
+                       WorldCoordinate(direction(rng), direction(rng),
+                                       direction(rng))});
+
+  const auto hits = caster.cast(rays, options);
+  size_t mismatches = 0, hit_count = 0;
+  for (size_t r = 0; r < rays.size(); r++) {
+    const RayHit expected = naive_cast(*dim, rays[r], options);
+    hit_count += expected.hit;
+    if ((hits[r].hit != expected.hit) ||
+        (expected.hit && ((hits[r].block.x != expected.block.x) ||
+                          (hits[r].block.y != expected.block.y) ||
+                          (hits[r].block.z != expected.block.z) ||
+                          (hits[r].state != expected.state))))
+      mismatches++;
+  }
+  CHECK(mismatches == 0);
+  // Both outcomes are exercised
+  CHECK(hit_count > 100);
+  CHECK(hit_count < rays.size() - 100);
+}
@@ -0,0 +1,212 @@
+#include "solis/utils/errors.hpp"
+#include "solis/world/region_file.hpp"
+#include <cstdio>
+#include <doctest.h>
+#include <algorithm>
+#include <fstream>
+
+using namespace solis;
+using namespace solis::world;
+
+/**
+ * @brief Region file removed at the end of the test.
+ */
+struct TempRegion {
+  std::string path;
+
+  explicit TempRegion(const char *name)
+      : path(std::string("/tmp/solis_test_") + name + ".mca") {
+    std::remove(path.c_str());
+  }
+  ~TempRegion() { std::remove(path.c_str()); }
+};
+
+TEST_CASE("region file: payloads round-trip") {
+  TempRegion tmp("roundtrip");
+  {
+    RegionFile region(tmp.path, true);
+    region.stage_chunk(5, ChunkPayload{CompressionType::ZLIB, "payload"}, 42);
+    region.commit();
+  }
+  RegionFile region(tmp.path);
+  ChunkPayload payload;
+  REQUIRE(region.read_chunk(5, payload));
+  CHECK(payload.data == "payload");
+  CHECK(payload.compression == CompressionType::ZLIB);
+  CHECK(region.get_timestamp(5) == 42);
+  CHECK_FALSE(region.read_chunk(6, payload));
+}
+
+TEST_CASE("region file: corrupted payload lengths are rejected") {
+  TempRegion tmp("corrupted");
+  {
+    RegionFile region(tmp.path, true);
+    region.stage_chunk(0, ChunkPayload{CompressionType::ZLIB, "payload"});
+    region.commit();
+  }
+
+  uint64_t offset;
+  {
+    RegionFile region(tmp.path);
+    offset =
+        static_cast<uint64_t>(region.get_location(0).offset) * SECTOR_SIZE;
+  }
+  for (const uint32_t length :
+       {0u, 0xFFFFFFFFu, 0xFFFFFFFDu, 2 * SECTOR_SIZE}) {
+    std::fstream file(tmp.path,
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(static_cast<std::streamoff>(offset));
+    const char bytes[4]{static_cast<char>(length >> 24),
+                        static_cast<char>(length >> 16),
+                        static_cast<char>(length >> 8),
+                        static_cast<char>(length)};
+    file.write(bytes, 4);
+    file.close();
+
+    RegionFile region(tmp.path);
+    ChunkPayload payload;
+    CHECK_THROWS_AS(region.read_chunk(0, payload), FileIOError);
+  }
+}
+
+/**
+ * @brief Payload of a chunk, spanning a given number of sectors.
+ */
+static ChunkPayload sized_payload(uint32_t sectors, char fill) {
+  return ChunkPayload{CompressionType::ZLIB,
+                      std::string(sectors * SECTOR_SIZE - 64, fill)};
+}
+
+/**
+ * @brief Raw sectors of a chunk, as stored in the file.
+ */
+static std::string raw_sectors(const std::string &path,
+                               const ChunkLocation &loc) {
+  std::ifstream file(path, std::ios::binary);
+  file.seekg(static_cast<std::streamoff>(loc.offset) * SECTOR_SIZE);
+  std::string out(static_cast<size_t>(loc.sectors) * SECTOR_SIZE, '\0');
+  file.read(out.data(), out.size());
+  return out;
+}
+
+/**
+ * @brief Region file holding 32 chunks of 1 to 3 sectors.
+ */
+static void populate(const std::string &path) {
+  RegionFile region(path, true);
+  for (uint16_t i = 0; i < 32; i++)
+    region.stage_chunk(i, sized_payload(1 + i % 3, static_cast<char>('a' + i)),
+                       1000 + i);
+  region.commit();
+}
+
+TEST_CASE("region file: saves only touch the modified chunks") {
+  TempRegion tmp("incremental");
+  populate(tmp.path);
+  const uint16_t modified[5]{3, 7, 12, 20, 31};
+  auto is_modified = [&modified](uint16_t i) {
+    return std::find(std::begin(modified), std::end(modified), i) !=
+           std::end(modified);
+  };
+
+  std::vector<ChunkLocation> before(32);
+  std::vector<std::string> raw(32);
+  uint32_t sectors, moved = 0;
+  {
+    RegionFile region(tmp.path);
+    sectors = region.sector_count();
+    CHECK(region.free_sectors() == 0);
+    for (uint16_t i = 0; i < 32; i++) {
+      before[i] = region.get_location(i);
+      raw[i] = raw_sectors(tmp.path, before[i]);
+    }
+  }
+  for (uint16_t i : modified)
+    moved += before[i].sectors;
+
+  // Out of place: the file grows by the new payloads, and the old sectors
+  // become free
+  {
+    RegionFile region(tmp.path, true);
+    for (uint16_t i : modified)
+      region.stage_chunk(i, sized_payload(before[i].sectors, 'z'));
+    region.commit();
+    CHECK(region.sector_count() == sectors + moved);
+    CHECK(region.free_sectors() == moved);
+  }
+  {
+    RegionFile region(tmp.path);
+    for (uint16_t i = 0; i < 32; i++) {
+      ChunkPayload payload;
+      REQUIRE(region.read_chunk(i, payload));
+      CHECK(payload.data[0] == (is_modified(i) ? 'z' : 'a' + i));
+      if (is_modified(i))
+        continue;
+      CHECK(region.get_location(i).offset == before[i].offset);
+      CHECK(raw_sectors(tmp.path, region.get_location(i)) == raw[i]);
+      CHECK(region.get_timestamp(i) == 1000u + i);
+    }
+  }
+
+  // The next save fills the freed sectors, and the sectors released at the
+  // end of the file are truncated
+  {
+    RegionFile region(tmp.path, true);
+    for (uint16_t i : modified)
+      region.stage_chunk(i, sized_payload(before[i].sectors, 'y'));
+    region.commit();
+    CHECK(region.sector_count() == sectors);
+    CHECK(region.free_sectors() == 0);
+  }
+}
+
+TEST_CASE("region file: the growth budget rewrites chunks in place") {
+  TempRegion tmp("growth");
+  populate(tmp.path);
+  RegionWriteOptions options;
+  options.max_growth = 0;
+
+  RegionFile region(tmp.path, true, options);
+  const uint32_t sectors = region.sector_count();
+  const ChunkLocation old = region.get_location(5);
+  region.stage_chunk(5, sized_payload(old.sectors, 'z'));
+  // A payload larger than its sectors still has to move
+  const ChunkLocation grown = region.get_location(6);
+  region.stage_chunk(6, sized_payload(grown.sectors + 1, 'z'));
+  region.commit();
+
+  CHECK(region.get_location(5).offset == old.offset);
+  CHECK(region.get_location(6).offset != grown.offset);
+  CHECK(region.sector_count() == sectors + grown.sectors + 1);
+  CHECK(region.free_sectors() == grown.sectors);
+  ChunkPayload payload;
+  REQUIRE(region.read_chunk(5, payload));
+  CHECK(payload.data[0] == 'z');
+}
+
+TEST_CASE("region file: removals free the sectors and truncate the file") {
+  TempRegion tmp("removal");
+  populate(tmp.path);
+  RegionFile region(tmp.path, true);
+  const uint32_t sectors = region.sector_count();
+  const ChunkLocation middle = region.get_location(10);
+  const ChunkLocation tail = region.get_location(31);
+
+  region.stage_removal(10);
+  region.commit();
+  CHECK_FALSE(region.has_chunk(10));
+  CHECK(region.free_sectors() == middle.sectors);
+  CHECK(region.sector_count() == sectors);
+
+  // The last chunk leaves no free sectors at the end of the file
+  region.stage_removal(31);
+  region.commit();
+  CHECK(region.sector_count() == sectors - tail.sectors);
+  CHECK(region.free_sectors() == middle.sectors);
+
+  // A new chunk of the same size fills the hole first
+  region.stage_chunk(40, sized_payload(middle.sectors, 'n'));
+  region.commit();
+  CHECK(region.get_location(40).offset == middle.offset);
+  CHECK(region.free_sectors() == 0);
+}
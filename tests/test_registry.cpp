@@ -0,0 +1,41 @@
+#include "solis/resources/registry.hpp"
+#include <doctest.h>
+#include <thread>
+#include <vector>
+
+using namespace solis;
+
+TEST_CASE("registry: vanilla states resolve through the table") {
+  BlockRegistry registry;
+  const vanilla::BlockId id = vanilla::id("oak_stairs");
+  const Block *block = registry.get(id, "facing=north,half=top");
+  REQUIRE(block != nullptr);
+  CHECK(std::string_view(block->resource_name) == "oak_stairs");
+  CHECK(std::string_view(block->properties) == "facing=north,half=top");
+  CHECK(registry.get("minecraft:oak_stairs", "facing=north,half=top") ==
+        block);
+  CHECK(registry.get("minecraft:oak_stairs[facing=north,half=top]") == block);
+  CHECK(registry.get("oak_stairs[facing=north,half=top]") == block);
+  CHECK(registry.get(id, "facing=south,half=top") != block);
+  CHECK(registry.get(id, "") == registry.get("minecraft:oak_stairs"));
+  CHECK(registry.get("somemod:stairs[facing=north]") !=
+        registry.get("minecraft:stairs[facing=north]"));
+}
+
+TEST_CASE("registry: states are interned once across threads") {
+  BlockRegistry registry;
+  constexpr int THREADS{8};
+  std::vector<const Block *> seen(THREADS * 16);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; t++)
+    threads.emplace_back([&registry, &seen, t]() {
+      for (int k = 0; k < 16; k++)
+        seen[t * 16 + k] = registry.get(
+            "minecraft:oak_log", (k % 2 == 0) ? "axis=x" : "axis=y");
+    });
+  for (auto &thread : threads)
+    thread.join();
+  for (size_t i = 0; i < seen.size(); i++)
+    CHECK(seen[i] == seen[i % 2]);
+  CHECK(seen[0] != seen[1]);
+}
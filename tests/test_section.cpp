@@ -0,0 +1,75 @@
+#include "solis/resources/registry.hpp"
+#include "solis/world/section.hpp"
+#include <doctest.h>
+#include <fmt/format.h>
+
+using namespace solis;
+using namespace solis::world;
+
+/**
+ * @brief Distinct blocks, interned once.
+ */
+static const std::vector<const Block *> &distinct_blocks(size_t n) {
+  static std::vector<const Block *> blocks;
+  while (blocks.size() < n)
+    blocks.push_back(BlockRegistry::global().get(
+        fmt::format("solis_test:block_{}", blocks.size())));
+  return blocks;
+}
+
+/**
+ * @brief Section whose every block is distinct (a full palette, all used).
+ */
+static Section full_section() {
+  const auto &blocks = distinct_blocks(SECTION_VOLUME + 1);
+  Section section;
+  for (uint16_t i = 0; i < SECTION_VOLUME; i++)
+    section.set_block(i, blocks[i]);
+  return section;
+}
+
+TEST_CASE("section: set_block on a full palette") {
+  const auto &blocks = distinct_blocks(SECTION_VOLUME + 1);
+  Section section = full_section();
+  REQUIRE(section.get_palette().size() == SECTION_VOLUME);
+
+  CHECK(section.set_block(7, blocks[SECTION_VOLUME]));
+  CHECK(section.get_block(7) == blocks[SECTION_VOLUME]);
+  CHECK(section.get_palette().size() == SECTION_VOLUME);
+  for (uint16_t i = 0; i < SECTION_VOLUME; i++)
+    if (i != 7)
+      REQUIRE(section.get_block(i) == blocks[i]);
+}
+
+TEST_CASE("section: stale palette entries are compacted") {
+  const auto &blocks = distinct_blocks(SECTION_VOLUME + 1);
+  Section section;
+  for (uint16_t i = 0; i < SECTION_VOLUME - 1; i++)
+    section.set_block(0, blocks[i]);
+  REQUIRE(section.get_palette().size() == SECTION_VOLUME);
+  CHECK(section.set_block(0, blocks[SECTION_VOLUME]));
+  CHECK(section.get_block(0) == blocks[SECTION_VOLUME]);
+  CHECK(section.get_palette().size() == 3); // Air, the previous and new block
+}
+
+TEST_CASE("section: box edits and scans on a full palette") {
+  const auto &blocks = distinct_blocks(SECTION_VOLUME + 1);
+  const Block *extra = blocks[SECTION_VOLUME];
+  Section section = full_section();
+  section.fill(extra, SectionBox{0, 0, 0, 1, 0, 0});
+  CHECK(section.get_block(0) == extra);
+  CHECK(section.get_block(1) == extra);
+  CHECK(section.get_block(2) == blocks[2]);
+
+  // The palette now exceeds the section volume until its next compaction
+  Section::BlockMask mask;
+  CHECK(section.match(mask, extra) == 2);
+  CHECK(section.match(mask, blocks[5]) == 1);
+  CHECK(section.count(0, Block::AIR) == SECTION_VOLUME);
+  CHECK(section.any(Block::AIR) == false);
+
+  Section other = full_section();
+  CHECK(other.replace(blocks[3], extra, SectionBox{0, 0, 0, 15, 0, 15}));
+  CHECK(other.get_block(3) == extra);
+  CHECK(other.get_block(4) == blocks[4]);
+}
@@ -0,0 +1,156 @@
+#include "solis/world/anvil.hpp"
+#include "solis/world/section_pool.hpp"
+#include <cstdlib>
+#include <doctest.h>
+#include <random>
+#include <unordered_set>
+
+using namespace solis;
+using namespace solis::world;
+
+/**
+ * @brief Section of stone and dirt whose palette has an unused entry.
+ */
+static Section::SharedPtr stale_section() {
+  auto &registry = BlockRegistry::global();
+  Section::Indices indices(SECTION_VOLUME, 0);
+  for (uint16_t i = 0; i < SECTION_VOLUME; i += 2)
+    indices[i] = 2;
+  return std::make_shared<Section>(
+      Section::Palette{registry.get("minecraft:stone"),
+                       registry.get("minecraft:glass"),
+                       registry.get("minecraft:dirt")},
+      std::move(indices));
+}
+
+/**
+ * @brief Memory of the distinct sections of chunks.
+ */
+static size_t distinct_memory(const std::vector<Chunk::SharedPtr> &chunks) {
+  std::unordered_set<const Section *> seen;
+  size_t bytes = 0;
+  for (const auto &chunk : chunks)
+    for (const auto &[y, section] : *chunk)
+      if (seen.insert(section.get()).second)
+        bytes += section->memory_usage();
+  return bytes;
+}
+
+/**
+ * @brief Decode encoded chunks, with or without a pool.
+ */
+static std::vector<Chunk::SharedPtr>
+decode_all(const std::vector<std::string> &nbts, SectionPool *pool) {
+  std::vector<Chunk::SharedPtr> chunks;
+  for (const auto &nbt : nbts)
+    chunks.push_back(Anvil::decode(nbt, BlockRegistry::global(), pool));
+  return chunks;
+}
+
+TEST_CASE("section pool: shared sections are not compacted in place") {
+  SectionPool pool;
+  auto section = stale_section();
+  REQUIRE_FALSE(section->is_compact());
+  const Section::SharedPtr reader = section;
+
+  auto pooled = pool.intern(section);
+  CHECK(pooled != section);
+  CHECK(section->get_palette().size() == 3);
+  CHECK(pooled->get_palette().size() == 2);
+  CHECK(pooled->is_compact());
+  for (uint16_t i = 0; i < SECTION_VOLUME; i++)
+    REQUIRE(pooled->get_block(i) == section->get_block(i));
+
+  // A section only held by the caller is compacted in place
+  auto owned = stale_section();
+  CHECK(pool.intern(owned) == pooled);
+  CHECK(owned->get_palette().size() == 2);
+}
+
+TEST_CASE("section pool: memory of repeated sections") {
+  auto &registry = BlockRegistry::global();
+  const Block *bedrock = registry.get("minecraft:bedrock");
+  const Block *dirt = registry.get("minecraft:dirt");
+  const Block *grass = registry.get("minecraft:grass_block");
+  const Block *water = registry.get("minecraft:water[level=0]");
+  const Block *sand = registry.get("minecraft:sand");
+  const Block *gravel = registry.get("minecraft:gravel");
+  std::mt19937 random(42);
+
+  // Superflat chunks: identical layered sections
+  std::vector<std::string> flat, ocean;
+  for (int32_t c = 0; c < 256; c++) {
+    Chunk chunk;
+    chunk.coord = ChunkCoordinate(c % 16, c / 16);
+    for (InChunkCoord_t x = 0; x < CHUNK_SIZE; x++)
+      for (InChunkCoord_t z = 0; z < CHUNK_SIZE; z++) {
+        chunk.set_block(x, -64, z, bedrock);
+        chunk.set_block(x, -63, z, dirt);
+        chunk.set_block(x, -62, z, dirt);
+        chunk.set_block(x, -61, z, grass);
+      }
+    flat.push_back(Anvil::encode(chunk));
+  }
+
+  // Ocean chunks: water above a random seabed
+  for (int32_t c = 0; c < 64; c++) {
+    Chunk chunk;
+    chunk.coord = ChunkCoordinate(c % 8, c / 8);
+    for (SectionIndex y = 0; y < 4; y++)
+      chunk.set_section(y, Section::make(water));
+    for (InChunkCoord_t x = 0; x < CHUNK_SIZE; x++)
+      for (InChunkCoord_t z = 0; z < CHUNK_SIZE; z++)
+        for (LayerIndex y = 0; y < 4; y++)
+          chunk.set_block(x, y, z, (random() % 2 == 0) ? sand : gravel);
+    ocean.push_back(Anvil::encode(chunk));
+  }
+
+  SectionPool pool;
+  const size_t flat_plain = distinct_memory(decode_all(flat, nullptr));
+  const size_t flat_pooled = distinct_memory(decode_all(flat, &pool));
+  MESSAGE("superflat: " << flat_plain << " -> " << flat_pooled << " bytes");
+  CHECK(flat_pooled * 100 < flat_plain);
+
+  // Known gap: only the water sections are shared, and being uniform they
+  // are already small, while the random seabeds are all distinct. The pool
+  // saves the water sections, and costs at most 1% of the seabeds.
+  const auto ocean_chunks = decode_all(ocean, nullptr);
+  const auto pooled_chunks = decode_all(ocean, &pool);
+  const size_t ocean_plain = distinct_memory(ocean_chunks);
+  const size_t ocean_pooled = distinct_memory(pooled_chunks);
+  MESSAGE("ocean: " << ocean_plain << " -> " << ocean_pooled << " bytes");
+  size_t water_bytes = 0;
+  std::unordered_set<const Section *> waters, seabeds;
+  for (size_t c = 0; c < ocean.size(); c++) {
+    seabeds.insert(pooled_chunks[c]->get_section(0).get());
+    for (SectionIndex y = 1; y < 4; y++) {
+      water_bytes += ocean_chunks[c]->get_section(y)->memory_usage();
+      waters.insert(pooled_chunks[c]->get_section(y).get());
+    }
+  }
+  CHECK(waters.size() == 1);
+  CHECK(seabeds.size() == ocean.size());
+  CHECK(ocean_pooled < ocean_plain);
+  CHECK(ocean_pooled * 100 < (ocean_plain - water_bytes) * 101);
+}
+
+TEST_CASE("section pool: memory of a real region file" *
+          doctest::skip(std::getenv("SOLIS_TEST_REGION") == nullptr)) {
+  // Measured on the region file given by SOLIS_TEST_REGION
+  const char *path = std::getenv("SOLIS_TEST_REGION");
+  RegionFile file(path);
+  SectionPool pool;
+  std::vector<Chunk::SharedPtr> plain, pooled;
+  for (uint16_t i = 0; i < REGION_CHUNK_COUNT; i++) {
+    if (auto chunk = Anvil::read(file, i); chunk != nullptr)
+      plain.push_back(chunk);
+    if (auto chunk = Anvil::read(file, i, BlockRegistry::global(), &pool);
+        chunk != nullptr)
+      pooled.push_back(chunk);
+  }
+  const size_t before = distinct_memory(plain);
+  const size_t after = distinct_memory(pooled);
+  MESSAGE(path << ": " << plain.size() << " chunks, " << before << " -> "
+               << after << " bytes");
+  CHECK(after <= before);
+}
@@ -0,0 +1,145 @@
+#include "solis/world/anvil.hpp"
+#include "solis/world/stats.hpp"
+#include <doctest.h>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+using namespace solis;
+using namespace solis::world;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Dimension of 3x2 chunks with random blocks, above which a uniform
+ * section.
+ */
+static Dimension::SharedPtr random_dimension() {
+  auto &registry = BlockRegistry::global();
+  const Block *blocks[4]{nullptr, registry.get("minecraft:stone"),
+                         registry.get("minecraft:dirt"),
+                         registry.get("minecraft:glass")};
+  std::mt19937 rng(42);
+  auto dim = std::make_shared<Dimension>(Dimension::OVERWORLD, "overworld");
+  for (ChunkCoordinate_t x = -1; x < 2; x++)
+    for (ChunkCoordinate_t z = 0; z < 2; z++) {
+      auto chunk = std::make_shared<Chunk>();
+      chunk->coord = ChunkCoordinate(x, z);
+      for (int n = 0; n < 2000; n++)
+        chunk->set_block(rng() % CHUNK_SIZE, -20 + rng() % 60,
+                         rng() % CHUNK_SIZE, blocks[rng() % 4]);
+      chunk->set_section(3, Section::make(blocks[1]));
+      chunk->clear_dirty();
+      dim->add_chunk(chunk);
+    }
+  return dim;
+}
+
+/**
+ * @brief Block counts of the stored sections, one block at a time.
+ */
+static BlockHistogram naive_counts(const Dimension &dim,
+                                   const StatsOptions &options) {
+  BlockHistogram out;
+  for (const auto &region : dim.get_regions())
+    for (const auto &chunk : *region) {
+      if (options.filter && !options.filter(chunk->coord))
+        continue;
+      out.chunks++;
+      for (const auto &[y, section] : *chunk) {
+        out.sections++;
+        for (uint16_t i = 0; i < SECTION_VOLUME; i++) {
+          const Block *block = section->get_block(i);
+          out.total[block]++;
+          out.by_y[y * CHUNK_SIZE + i / (CHUNK_SIZE * CHUNK_SIZE)][block]++;
+        }
+      }
+    }
+  return out;
+}
+
+TEST_CASE("stats: scans count every stored block, by Y level if asked") {
+  auto dim = random_dimension();
+  StatsOptions options;
+  options.by_y = true;
+  options.threads = 3;
+  options.filter = [](const ChunkCoordinate &coord) {
+    return (coord.x != 1) || (coord.z != 1);
+  };
+  const BlockHistogram expected = naive_counts(*dim, options);
+  REQUIRE(expected.chunks == 5);
+
+  // Most chunks compressed in memory
+  ColdOptions cold;
+  cold.idle = std::chrono::milliseconds(0);
+  REQUIRE(dim->compress_idle(cold) == 6);
+  dim->get_chunk(ChunkCoordinate(0, 0));
+  REQUIRE(dim->cold_count() == 5);
+
+  const BlockHistogram stats = BlockStats::scan(*dim, options);
+  CHECK(stats.chunks == expected.chunks);
+  CHECK(stats.sections == expected.sections);
+  CHECK(stats.total == expected.total);
+  CHECK(stats.by_y == expected.by_y);
+  // Uniform sections are counted on each layer
+  const Block *stone = BlockRegistry::global().get("minecraft:stone");
+  CHECK(stats.by_y.at(3 * CHUNK_SIZE + 7).at(stone) == 5 * 256);
+  // Only the stored sections are counted, their air included
+  uint64_t blocks = 0;
+  for (const auto &[block, n] : stats.total)
+    blocks += n;
+  CHECK(blocks == stats.sections * SECTION_VOLUME);
+  CHECK(stats.by_y.count(-2 * CHUNK_SIZE) == 1);
+  CHECK(stats.by_y.count(-3 * CHUNK_SIZE) == 0);
+  CHECK(stats.by_y.count(4 * CHUNK_SIZE) == 0);
+
+  const auto sorted = stats.sorted();
+  REQUIRE(sorted.size() == 4);
+  for (size_t i = 1; i < sorted.size(); i++)
+    CHECK(sorted[i - 1].second >= sorted[i].second);
+  CHECK(sorted[0].first == nullptr);
+  CHECK(sorted[1].first == stone);
+
+  // Without by_y, only the totals
+  options.by_y = false;
+  const BlockHistogram totals = BlockStats::scan(*dim, options);
+  CHECK(totals.total == expected.total);
+  CHECK(totals.by_y.empty());
+}
+
+TEST_CASE("stats: region directories are counted as the loaded chunks") {
+  const fs::path dir = fs::temp_directory_path() / "solis_test_stats_dir";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  auto dim = random_dimension();
+  for (const RegionCoordinate_t x : {-1, 0}) {
+    const RegionCoordinate coord(x, 0);
+    RegionFile file((dir / RegionFile::filename(coord)).string(), true);
+    for (const auto &region : dim->get_regions())
+      for (const auto &chunk : *region)
+        if (cvtCoordinate<RegionCoordinate>(chunk->coord).x == x)
+          file.stage_chunk(RegionFile::index(chunk->coord),
+                           Anvil::deflate(*chunk));
+    file.commit();
+  }
+  // Not a region file
+  std::ofstream(dir / "r.0.0.mca.old") << "not a region";
+
+  StatsOptions options;
+  options.by_y = true;
+  options.threads = 2;
+  const BlockHistogram expected = naive_counts(*dim, options);
+  const BlockHistogram stats =
+      BlockStats::scan_directory(dir.string(), options);
+  CHECK(stats.chunks == 6);
+  CHECK(stats.sections == expected.sections);
+  CHECK(stats.total == expected.total);
+  CHECK(stats.by_y == expected.by_y);
+
+  // The filter applies before the chunks are read
+  options.filter = [](const ChunkCoordinate &coord) { return coord.x < 0; };
+  const BlockHistogram west =
+      BlockStats::scan_directory(dir.string(), options);
+  CHECK(west.chunks == 2);
+  CHECK(west.total == naive_counts(*dim, options).total);
+  fs::remove_all(dir);
+}
@@ -0,0 +1,173 @@
+#include "solis/utils/errors.hpp"
+#include "solis/world/anvil.hpp"
+#include "solis/world/transcoder.hpp"
+#include <doctest.h>
+#include <filesystem>
+
+using namespace solis;
+using namespace solis::world;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Region directory removed at the end of the test.
+ */
+struct TempRegionDir {
+  fs::path dir;
+
+  explicit TempRegionDir(const char *name)
+      : dir(fs::temp_directory_path() / (std::string("solis_test_") + name)) {
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+  }
+  ~TempRegionDir() { fs::remove_all(dir); }
+
+  std::string region(ChunkCoordinate_t x, ChunkCoordinate_t z) const {
+    return (dir / RegionFile::filename(RegionCoordinate(x, z))).string();
+  }
+};
+
+/**
+ * @brief NBT-like content of a chunk, compressible but not uniform.
+ */
+static std::string chunk_nbt(uint16_t i, size_t size = 6000) {
+  std::string nbt;
+  while (nbt.size() < size)
+    nbt += fmt::format("chunk {} at {};", i, nbt.size());
+  return nbt;
+}
+
+/**
+ * @brief Setting without dictionary.
+ */
+static CodecSetting setting(uint8_t compression, uint8_t level = 6) {
+  CodecSetting out;
+  out.compression = compression;
+  out.level = level;
+  return out;
+}
+
+/**
+ * @brief Save zlib chunks in a region file.
+ */
+static void
+save_chunks(const std::string &path,
+            const std::vector<std::pair<uint16_t, std::string>> &c) {
+  RegionFile file(path, true);
+  for (const auto &[i, nbt] : c)
+    file.stage_chunk(i, Anvil::compress(nbt, CompressionType::ZLIB), 100 + i);
+  file.commit();
+}
+
+TEST_CASE("transcoder: payloads are transcoded with their timestamps") {
+  TempRegionDir tmp("transcoder_file");
+  save_chunks(tmp.region(0, 0),
+              {{0, chunk_nbt(0)}, {5, chunk_nbt(5)}, {700, chunk_nbt(700)}});
+
+  const CodecSetting none = setting(CompressionType::NONE);
+  CodecReport report{none};
+  const std::string to = (tmp.dir / "out.mca").string();
+  Transcoder::transcode_file(tmp.region(0, 0), to, none, report);
+
+  RegionFile out(to);
+  uint64_t bytes = 0;
+  for (const uint16_t i : {0, 5, 700}) {
+    ChunkPayload payload;
+    REQUIRE(out.read_chunk(i, payload));
+    CHECK(payload.compression == CompressionType::NONE);
+    CHECK(payload.data == chunk_nbt(i));
+    CHECK(out.get_timestamp(i) == 100u + i);
+    bytes += payload.data.size();
+  }
+  CHECK(report.chunks == 3);
+  CHECK(report.raw_bytes == bytes);
+  CHECK(report.bytes == bytes);
+  CHECK_FALSE(fs::exists(to + ".tmp"));
+
+  // In place, back to zlib
+  const CodecSetting zlib = setting(CompressionType::ZLIB, 9);
+  CodecReport back{zlib};
+  Transcoder::transcode_file(to, to, zlib, back);
+  ChunkPayload payload;
+  REQUIRE(RegionFile(to).read_chunk(5, payload));
+  CHECK(payload.compression == CompressionType::ZLIB);
+  CHECK(Anvil::inflate(payload) == chunk_nbt(5));
+  CHECK(back.bytes < back.raw_bytes);
+}
+
+TEST_CASE("transcoder: chunks too large for the target are kept and counted") {
+  TempRegionDir tmp("transcoder_large");
+  const std::string large(2 * CHUNK_MAX_SECTORS * SECTOR_SIZE, 'x');
+  save_chunks(tmp.region(0, 0), {{0, chunk_nbt(0)}, {1, large}});
+  ChunkPayload original;
+  REQUIRE(RegionFile(tmp.region(0, 0)).read_chunk(1, original));
+
+  const CodecSetting none = setting(CompressionType::NONE);
+  CodecReport report{none};
+  Transcoder::transcode_file(tmp.region(0, 0), tmp.region(0, 0), none, report);
+
+  RegionFile out(tmp.region(0, 0));
+  ChunkPayload kept, small;
+  REQUIRE(out.read_chunk(1, kept));
+  REQUIRE(out.read_chunk(0, small));
+  CHECK(kept.compression == CompressionType::ZLIB);
+  CHECK(kept.data == original.data);
+  CHECK(report.chunks == 2);
+  CHECK(report.bytes == kept.data.size() + small.data.size());
+  CHECK(report.sectors == kept.sector_count() + small.sector_count());
+}
+
+TEST_CASE("transcoder: failures leave the destination untouched") {
+  TempRegionDir tmp("transcoder_failure");
+  {
+    RegionFile file(tmp.region(0, 0), true);
+    file.stage_chunk(0, Anvil::compress(chunk_nbt(0), CompressionType::ZLIB));
+    file.stage_chunk(1, ChunkPayload{CompressionType::ZLIB, "not zlib"});
+    file.commit();
+  }
+  const uintmax_t size = fs::file_size(tmp.region(0, 0));
+
+  const CodecSetting none = setting(CompressionType::NONE);
+  CodecReport report{none};
+  CHECK_THROWS(Transcoder::transcode_file(tmp.region(0, 0), tmp.region(0, 0),
+                                          none, report));
+  CHECK_FALSE(fs::exists(tmp.region(0, 0) + ".tmp"));
+  CHECK(fs::file_size(tmp.region(0, 0)) == size);
+  ChunkPayload payload;
+  REQUIRE(RegionFile(tmp.region(0, 0)).read_chunk(0, payload));
+  CHECK(payload.compression == CompressionType::ZLIB);
+
+  CHECK_THROWS_AS(Transcoder::transcode_file(
+                      tmp.region(0, 0), tmp.region(0, 0),
+                      setting(CompressionType::LZ4), report),
+                  SolisError);
+}
+
+TEST_CASE("transcoder: benchmarks measure every setting on the samples") {
+  TempRegionDir tmp("transcoder_benchmark");
+  save_chunks(tmp.region(0, 0), {{0, chunk_nbt(0)}, {1, chunk_nbt(1)}});
+  save_chunks(tmp.region(1, 0), {{2, chunk_nbt(2)}, {3, chunk_nbt(3)}});
+
+  TranscodeOptions options;
+  options.max_chunks = 1;
+  options.measure_decode = true;
+  const auto reports = Transcoder::benchmark_directory(
+      tmp.dir.string(),
+      {setting(CompressionType::ZLIB), setting(CompressionType::NONE)},
+      options);
+  REQUIRE(reports.size() == 2);
+  CHECK(reports[0].setting.name() == "zlib-6");
+  CHECK(reports[1].setting.name() == "none");
+  CHECK(reports[0].chunks == 2);
+  CHECK(reports[1].chunks == 2);
+  CHECK(reports[0].raw_bytes == chunk_nbt(0).size() + chunk_nbt(2).size());
+  CHECK(reports[1].raw_bytes == reports[0].raw_bytes);
+  CHECK(reports[1].bytes == reports[1].raw_bytes);
+  CHECK(reports[0].bytes < reports[0].raw_bytes);
+  CHECK(reports[0].ratio() > 1);
+
+  // Nothing is written
+  size_t files = 0;
+  for (const auto &entry : fs::directory_iterator(tmp.dir))
+    files += entry.is_regular_file();
+  CHECK(files == 2);
+}
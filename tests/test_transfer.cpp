@@ -0,0 +1,160 @@
+#include "solis/world/anvil.hpp"
+#include "solis/world/transfer.hpp"
+#include <doctest.h>
+#include <filesystem>
+
+using namespace solis;
+using namespace solis::world;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Source and target region directories removed at the end of the test.
+ */
+struct TempRegions {
+  fs::path dir;
+
+  explicit TempRegions(const char *name)
+      : dir(fs::temp_directory_path() / (std::string("solis_test_") + name)) {
+    fs::remove_all(dir);
+    fs::create_directories(dir / "from");
+    fs::create_directories(dir / "to");
+  }
+  ~TempRegions() { fs::remove_all(dir); }
+
+  std::string from() const {
+    return (dir / "from" / RegionFile::filename(RegionCoordinate(0, 0)))
+        .string();
+  }
+  std::string to() const {
+    return (dir / "to" / RegionFile::filename(RegionCoordinate(0, 0)))
+        .string();
+  }
+};
+
+/**
+ * @brief Stage chunks whose NBT is their tag, compressed with zlib.
+ */
+static void
+save_chunks(const std::string &path,
+            const std::vector<std::tuple<uint16_t, uint32_t, std::string>> &c) {
+  RegionFile file(path, true);
+  for (const auto &[i, timestamp, tag] : c)
+    file.stage_chunk(i, Anvil::compress(tag, CompressionType::ZLIB),
+                     timestamp);
+  file.commit();
+}
+
+/**
+ * @brief NBT of a chunk, empty if the chunk is absent.
+ */
+static std::string tag_of(const std::string &path, uint16_t i) {
+  RegionFile file(path);
+  ChunkPayload payload;
+  if (!file.read_chunk(i, payload))
+    return "";
+  return Anvil::inflate(payload);
+}
+
+TEST_CASE("transfer: merges follow the conflict mode") {
+  const std::pair<MergeConflict, const char *> modes[]{
+      {MergeConflict::OVERWRITE, "source"},
+      {MergeConflict::KEEP, "target"},
+      {MergeConflict::NEWEST, "source"}};
+  for (const auto &[mode, older] : modes) {
+    TempRegions tmp("transfer_merge");
+    // Chunk 1 is newer in the source, chunk 2 in the target
+    save_chunks(tmp.from(),
+                {{0, 10, "source"}, {1, 20, "source"}, {2, 10, "source"}});
+    save_chunks(tmp.to(), {{1, 10, "target"}, {2, 20, "target"}});
+
+    TransferStats stats;
+    TransferOptions options;
+    options.conflict = mode;
+    ChunkTransfer::merge_file(tmp.from(), tmp.to(), stats, {}, options);
+
+    CHECK(tag_of(tmp.to(), 0) == "source");
+    CHECK(tag_of(tmp.to(), 1) == std::string(older));
+    CHECK(tag_of(tmp.to(), 2) ==
+          ((mode == MergeConflict::OVERWRITE) ? "source" : "target"));
+    CHECK(RegionFile(tmp.to()).get_timestamp(0) == 10);
+    CHECK(stats.copied + stats.skipped == 3);
+    CHECK(stats.read == 0);
+    CHECK(stats.inflated == 0);
+  }
+}
+
+TEST_CASE("transfer: merge filters read the payloads they look at only") {
+  TempRegions tmp("transfer_filter");
+  save_chunks(tmp.from(), {{0, 10, "keep"}, {1, 10, "drop"}, {33, 10, "no"}});
+
+  // Chunk 33 is rejected on its coordinates, without being read
+  TransferStats stats;
+  ChunkTransfer::merge_file(
+      tmp.from(), tmp.to(), stats,
+      [](const ChunkCandidate &c) {
+        return (c.coord.z == 0) && (c.nbt() == "keep");
+      },
+      TransferOptions());
+  CHECK(tag_of(tmp.to(), 0) == "keep");
+  CHECK(tag_of(tmp.to(), 1).empty());
+  CHECK(tag_of(tmp.to(), 33).empty());
+  CHECK(stats.copied == 1);
+  CHECK(stats.skipped == 2);
+  CHECK(stats.read == 2);
+  CHECK(stats.inflated == 2);
+  ChunkPayload payload;
+  REQUIRE(RegionFile(tmp.to()).read_chunk(0, payload));
+  CHECK(stats.bytes == payload.data.size());
+}
+
+TEST_CASE("transfer: trims on coordinates read the headers only") {
+  TempRegions tmp("transfer_trim");
+  save_chunks(tmp.from(), {{0, 10, "a"}, {1, 20, "b"}, {32, 30, "c"}});
+
+  TransferStats stats;
+  ChunkTransfer::trim_file(
+      tmp.from(), stats,
+      [](const ChunkCandidate &c) {
+        return (c.coord.x == 0) && (c.timestamp < 30);
+      },
+      TransferOptions());
+  CHECK(stats.removed == 2);
+  CHECK(stats.read == 0);
+  CHECK(stats.inflated == 0);
+  CHECK(tag_of(tmp.from(), 0) == "a");
+  CHECK(tag_of(tmp.from(), 1).empty());
+  CHECK(tag_of(tmp.from(), 32).empty());
+
+  // Without filter everything is kept, and emptied files are removed
+  ChunkTransfer::trim_file(tmp.from(), stats, {}, TransferOptions());
+  CHECK(stats.removed == 2);
+  ChunkTransfer::trim_file(
+      tmp.from(), stats, [](const ChunkCandidate &) { return false; },
+      TransferOptions());
+  CHECK(stats.removed == 3);
+  CHECK(stats.read == 0);
+  CHECK_FALSE(fs::exists(tmp.from()));
+}
+
+TEST_CASE("transfer: staged copies keep the payload and its timestamp") {
+  TempRegions tmp("transfer_copy");
+  save_chunks(tmp.from(), {{7, 1234, "copied"}});
+
+  RegionFile source(tmp.from());
+  uint64_t bytes = 0;
+  {
+    RegionFile target(tmp.to(), true);
+    CHECK(target.stage_copy(source, 7, 9, &bytes));
+    CHECK_FALSE(target.stage_copy(source, 8, 10, &bytes));
+    target.commit();
+  }
+  ChunkPayload expected, copied;
+  REQUIRE(source.read_chunk(7, expected));
+  RegionFile target(tmp.to());
+  REQUIRE(target.read_chunk(9, copied));
+  CHECK(copied.data == expected.data);
+  CHECK(copied.compression == expected.compression);
+  CHECK(target.get_timestamp(9) == 1234);
+  CHECK_FALSE(target.has_chunk(10));
+  CHECK(bytes == expected.data.size());
+}
@@ -0,0 +1,96 @@
+#include "solis/utils/errors.hpp"
+#include "solis/utils/zdictionary.hpp"
+#include "solis/utils/zlib.hpp"
+#include "solis/world/anvil.hpp"
+#include <doctest.h>
+#include <filesystem>
+
+using namespace solis;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Samples sharing their structure, with a few varying values.
+ */
+static std::vector<std::string> chunk_samples(size_t count) {
+  std::vector<std::string> samples;
+  for (size_t s = 0; s < count; s++)
+    samples.push_back(fmt::format(
+        "{{DataVersion:3465,xPos:{},zPos:{},Status:\"minecraft:full\","
+        "sections:[{{Y:0,block_states:{{palette:[\"minecraft:stone\","
+        "\"minecraft:dirt\"]}},biomes:{{palette:[\"minecraft:plains\"]}}}}],"
+        "Heightmaps:{{MOTION_BLOCKING:{}}}}}",
+        s, s * 7, s * 13));
+  return samples;
+}
+
+/**
+ * @brief Whether a call throws a ZLib error whose message holds a text.
+ */
+template <typename F> static bool throws_zlib(F f, const char *text) {
+  try {
+    f();
+  } catch (const ZLibError &e) {
+    return std::string(e.what()).find(text) != std::string::npos;
+  }
+  return false;
+}
+
+TEST_CASE("zdictionary: trained dictionaries round-trip and help") {
+  const auto samples = chunk_samples(16);
+  auto dict = ZDictionary::train(samples);
+  REQUIRE(!dict->get_data().empty());
+
+  const std::string payload = chunk_samples(20).back();
+  const std::string with = ZLib::encodeFromString(
+      payload, 6, ZLib::FORMAT_ZLIB, dict->get_data());
+  const std::string without =
+      ZLib::encodeFromString(payload, 6, ZLib::FORMAT_ZLIB);
+  CHECK(with.size() < without.size());
+  CHECK(ZLib::decodeFromString(with, ZLib::FORMAT_ZLIB, dict->get_data()) ==
+        payload);
+
+  // Saved dictionaries keep their ID
+  const std::string path =
+      (fs::temp_directory_path() / "solis_test_zdictionary.dict").string();
+  dict->save(path);
+  auto loaded = ZDictionary::load(path);
+  CHECK(loaded->get_id() == dict->get_id());
+  CHECK(loaded->get_data() == dict->get_data());
+  fs::remove(path);
+}
+
+TEST_CASE("zdictionary: payloads need their own dictionary") {
+  auto dict = ZDictionary::train(chunk_samples(16));
+  auto other = ZDictionary::make("another dictionary, unrelated to chunks");
+  REQUIRE(other->get_id() != dict->get_id());
+  const std::string payload = chunk_samples(20).back();
+  const std::string data = ZLib::encodeFromString(
+      payload, 6, ZLib::FORMAT_ZLIB, dict->get_data());
+
+  CHECK(throws_zlib(
+      [&] {
+        ZLib::decodeFromString(data, ZLib::FORMAT_ZLIB, other->get_data());
+      },
+      "wrong preset dictionary"));
+  CHECK(throws_zlib([&] { ZLib::decodeFromString(data, ZLib::FORMAT_ZLIB); },
+                    "need dictionary"));
+
+  // Through the chunk codec
+  using namespace solis::world;
+  const ChunkPayload chunk =
+      Anvil::compress(payload, CompressionType::ZLIB_DICT, 6, dict.get());
+  CHECK(Anvil::inflate(chunk, dict.get()) == payload);
+  CHECK_THROWS_AS(Anvil::inflate(chunk), SolisError);
+  CHECK_THROWS_AS(Anvil::inflate(chunk, other.get()), ZLibError);
+}
+
+TEST_CASE("zdictionary: nothing to train on is an error") {
+  CHECK_THROWS_AS(ZDictionary::train({}), SolisError);
+  CHECK_THROWS_AS(ZDictionary::train({"only one sample"}), SolisError);
+  // No 16-byte segment in common
+  const std::vector<std::string> unrelated{"abcdefghijklmnopq",
+                                           "0123456789abcdefg"};
+  CHECK_THROWS_AS(ZDictionary::train(unrelated), SolisError);
+  CHECK_THROWS_AS(ZDictionary::train(chunk_samples(4), 0), SolisError);
+  CHECK_THROWS_AS(ZDictionary::make(""), SolisError);
+}